@@ -548,6 +548,18 @@ if (PKG_CONFIG_FOUND)
     add_definitions( -DLIBBULLET_VERSION_GT_282 )
   endif()
 
+  # The multithreaded dynamics world of Bullet needs Bullet 2.87 or later
+  # built with BT_THREADSAFE, which its pkgconfig file does not tell.
+  option(BULLET_THREADSAFE "Bullet was built with BT_THREADSAFE" OFF)
+  if (BULLET_FOUND AND BULLET_THREADSAFE)
+    if (BULLET_VERSION VERSION_LESS 2.87)
+      BUILD_WARNING ("Bullet >= 2.87 is needed for its multithreaded dynamics world.")
+    else()
+      add_definitions( -DBT_THREADSAFE=1 -DHAVE_BULLET_MT )
+      message (STATUS "Bullet multithreaded dynamics world enabled")
+    endif()
+  endif()
+
   ########################################
   # Find libusb
   pkg_check_modules(libusb-1.0 libusb-1.0)
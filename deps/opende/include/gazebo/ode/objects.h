@@ -1133,6 +1133,26 @@ ODE_API void dBodySetAutoDisableFlag (dBodyID, int do_auto_disable);
  */
 ODE_API void  dBodySetAutoDisableDefaults (dBodyID);
 
+/**
+ * @brief Get the time and the number of steps the body still has to stay
+ * idle before it is disabled.
+ * @ingroup bodies disable
+ * @param time_left receives the time left, or NULL.
+ * @param steps_left receives the number of steps left, or NULL.
+ */
+ODE_API void dBodyGetAutoDisableLeft (dBodyID, dReal *time_left,
+                                      int *steps_left);
+
+/**
+ * @brief Set the time and the number of steps the body still has to stay
+ * idle before it is disabled, as returned by dBodyGetAutoDisableLeft.
+ * @remarks
+ * dBodyEnable resets these values, so call it first.
+ * @ingroup bodies disable
+ */
+ODE_API void dBodySetAutoDisableLeft (dBodyID, dReal time_left,
+                                      int steps_left);
+
 
 /**
  * @brief Retrieves the world attached to te given body.
@@ -1844,6 +1864,28 @@ ODE_API void dBodySetGyroscopicMode(dBodyID b, int enabled);
 
 ODE_API void dJointReset(dJointID);
 
+/**
+ * @brief Get the constraint forces a joint solved for on the last step.
+ *
+ * The quickstep solver warm starts from these values on the next step.
+ * @ingroup joints
+ * @param lambda array of 6 values receiving the constraint forces, or NULL.
+ * @param lambda_erp array of 6 values receiving the error correcting
+ * constraint forces, or NULL.
+ */
+ODE_API void dJointGetLambda(dJointID, dReal *lambda, dReal *lambda_erp);
+
+/**
+ * @brief Set the constraint forces the solver warm starts from on the next
+ * step, as returned by dJointGetLambda.
+ * @ingroup joints
+ * @param lambda array of 6 values, or NULL to leave the forces unchanged.
+ * @param lambda_erp array of 6 values, or NULL to leave the forces
+ * unchanged.
+ */
+ODE_API void dJointSetLambda(dJointID, const dReal *lambda,
+                             const dReal *lambda_erp);
+
 /**
  * @brief Create a new joint of the ball type.
  * @ingroup joints
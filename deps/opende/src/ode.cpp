@@ -1058,6 +1058,24 @@ void dBodySetAutoDisableDefaults (dBodyID b)
 }
 
 
+void dBodyGetAutoDisableLeft (dBodyID b, dReal *time_left, int *steps_left)
+{
+  dAASSERT(b);
+  if (time_left)
+    *time_left = b->adis_timeleft;
+  if (steps_left)
+    *steps_left = b->adis_stepsleft;
+}
+
+
+void dBodySetAutoDisableLeft (dBodyID b, dReal time_left, int steps_left)
+{
+  dAASSERT(b);
+  b->adis_timeleft = time_left;
+  b->adis_stepsleft = steps_left;
+}
+
+
 // body damping functions
 
 dReal dBodyGetLinearDamping(dBodyID b)
@@ -1222,6 +1240,31 @@ void dJointReset(dJointID _j)
     _j->lambda[i] = 0.0;
 }
 
+void dJointGetLambda(dJointID _j, dReal *lambda, dReal *lambda_erp)
+{
+  dAASSERT (_j);
+  for (unsigned int i=0; i<6; i++)
+  {
+    if (lambda)
+      lambda[i] = _j->lambda[i];
+    if (lambda_erp)
+      lambda_erp[i] = _j->lambda_erp[i];
+  }
+}
+
+void dJointSetLambda(dJointID _j, const dReal *lambda,
+                     const dReal *lambda_erp)
+{
+  dAASSERT (_j);
+  for (unsigned int i=0; i<6; i++)
+  {
+    if (lambda)
+      _j->lambda[i] = lambda[i];
+    if (lambda_erp)
+      _j->lambda_erp[i] = lambda_erp[i];
+  }
+}
+
 dxJoint * dJointCreateBall (dWorldID w, dJointGroupID group)
 {
     dAASSERT (w);
@@ -350,13 +350,26 @@ void dxStepBody (dxBody *b, dReal h)
   dNormalize4 (b->q);
   dQtoR (b->q,b->posr.R);
 
-  // notify all attached geoms that this body has moved
-  for (dxGeom *geom = b->geom; geom; geom = dGeomGetBodyNext (geom))
-    dGeomMoved (geom);
+  // notify all attached geoms that this body has moved, then the user.
+  // when islands are stepped on the island thread pool this is done by
+  // dxProcessIslands after all islands are finished, in island order, so
+  // that the space geom lists and the order of the user callbacks are the
+  // same as with a serial step. the stepper zeroes the force accumulators
+  // before that, so they are kept for the callback.
+  if (b->world->threadpool && b->world->threadpool->size() > 0) {
+    if (b->moved_callback) {
+      dCopyVector3 (b->moved_facc, b->facc);
+      dCopyVector3 (b->moved_tacc, b->tacc);
+    }
+  }
+  else {
+    for (dxGeom *geom = b->geom; geom; geom = dGeomGetBodyNext (geom))
+      dGeomMoved (geom);
 
-  // notify the user
-  if (b->moved_callback)
-    b->moved_callback(b);
+    // notify the user
+    if (b->moved_callback)
+      b->moved_callback(b);
+  }
 
 
   // damping
@@ -650,8 +663,32 @@ void dxProcessIslands (dxWorld *world, dReal stepsize, dstepper_fn_t stepper)
   }
 #ifdef USE_TPISLAND
   IFTIMING(dTimerNow("islands wait"));
-  if (world->threadpool && world->threadpool->size() > 0)
+  if (world->threadpool && world->threadpool->size() > 0) {
     world->threadpool->wait();
+
+    // notify the geoms of all stepped bodies that they have moved, then
+    // the user, see dxStepBody. bodies are visited in island order, which
+    // is the order used by a serial step, so the result does not depend
+    // on the number of threads or on which island finished first.
+    for (dxBody *const *bodycurr = body; bodycurr != bodystart; ++bodycurr) {
+      dxBody *b = *bodycurr;
+      for (dxGeom *geom = b->geom; geom; geom = dGeomGetBodyNext (geom))
+        dGeomMoved (geom);
+
+      if (b->moved_callback) {
+        // the callback sees the accumulators as they were when the body
+        // was stepped
+        dVector3 facc, tacc;
+        dCopyVector3 (facc, b->facc);
+        dCopyVector3 (tacc, b->tacc);
+        dCopyVector3 (b->facc, b->moved_facc);
+        dCopyVector3 (b->tacc, b->moved_tacc);
+        b->moved_callback(b);
+        dCopyVector3 (b->facc, facc);
+        dCopyVector3 (b->tacc, tacc);
+      }
+    }
+  }
 #endif
   IFTIMING(dTimerEnd());
   IFTIMING(dTimerReport (stdout,1));
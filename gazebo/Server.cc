@@ -155,9 +155,12 @@ bool Server::ParseArgs(int _argc, char **_argv)
     ("play,p", po::value<std::string>(), "Play a log file.")
     ("record,r", "Record state data.")
     ("record_encoding", po::value<std::string>()->default_value("zlib"),
-     "Compression encoding format for log data (zlib|bz2|txt).")
+     "Encoding format for log data (zlib|bz2|txt|binary).")
     ("record_path", po::value<std::string>()->default_value(""),
      "Absolute path in which to store state data")
+    ("record_queue", po::value<std::string>()->default_value("block"),
+     "What to do when recording falls behind the simulation "
+     "(block|drop|decimate).")
     ("seed",  po::value<double>(), "Start with a given random number seed.")
     ("iters",  po::value<unsigned int>(), "Number of iterations to simulate.")
     ("minimal_comms", "Reduce the TCP/IP traffic output by gzserver")
@@ -257,6 +260,8 @@ bool Server::ParseArgs(int _argc, char **_argv)
         this->dataPtr->vm["record_path"].as<std::string>();
     this->dataPtr->params["record_encoding"] =
         this->dataPtr->vm["record_encoding"].as<std::string>();
+    this->dataPtr->params["record_queue"] =
+        this->dataPtr->vm["record_queue"].as<std::string>();
   }
 
   if (this->dataPtr->vm.count("iters"))
@@ -614,6 +619,11 @@ void Server::ProcessParams()
     }
     else if (iter->first == "record")
     {
+      if (this->dataPtr->params.count("record_queue"))
+      {
+        util::LogRecord::Instance()->SetQueuePolicy(
+            this->dataPtr->params["record_queue"]);
+      }
       util::LogRecord::Instance()->Start(
           this->dataPtr->params["record_encoding"], iter->second);
     }
@@ -52,11 +52,14 @@ void help()
   << "(ode|bullet|dart|simbody).\n"
   << "  -p [ --play ] arg             Play a log file.\n"
   << "  -r [ --record ]               Record state data.\n"
-  << "  --record_encoding arg (=zlib) Compression encoding format for log "
+  << "  --record_encoding arg (=zlib) Encoding format for log "
   << "data \n"
-  << "                                (zlib|bz2|txt).\n"
+  << "                                (zlib|bz2|txt|binary).\n"
   << "  --record_path arg             Absolute path in which to store "
   << "state data.\n"
+  << "  --record_queue arg (=block)   What to do when recording falls "
+  << "behind the\n"
+  << "                                simulation (block|drop|decimate).\n"
   << "  --seed arg                    Start with a given random number seed.\n"
   << "  --iters arg                   Number of iterations to simulate.\n"
   << "  --minimal_comms               Reduce the TCP/IP traffic output by "
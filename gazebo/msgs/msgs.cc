@@ -3438,5 +3438,86 @@ namespace gazebo
 
       return result;
     }
+
+    /////////////////////////////////////////////
+    bool UnpackContacts(const msgs::PackedContacts &_packed,
+        const std::function<std::string (const uint32_t)> &_name,
+        const std::string &_world, msgs::Contacts &_contacts)
+    {
+      const int count = _packed.collision1_size();
+      if (_packed.collision2_size() != count ||
+          _packed.point_count_size() != count)
+      {
+        return false;
+      }
+
+      int points = 0;
+      for (int i = 0; i < count; ++i)
+        points += _packed.point_count(i);
+
+      if (_packed.position_size() != points * 3 ||
+          _packed.normal_size() != points * 3 ||
+          _packed.depth_size() != points ||
+          _packed.wrench_size() != points * 12)
+      {
+        return false;
+      }
+
+      const msgs::Time &time = _packed.has_contact_time() ?
+        _packed.contact_time() : _packed.time();
+
+      int point = 0;
+      for (int i = 0; i < count; ++i)
+      {
+        msgs::Contact *contact = _contacts.add_contact();
+        const uint32_t id1 = _packed.collision1(i);
+        const uint32_t id2 = _packed.collision2(i);
+        contact->set_collision1(_name(id1));
+        contact->set_collision2(_name(id2));
+        contact->set_world(_world);
+        contact->mutable_time()->CopyFrom(time);
+
+        for (uint32_t j = 0; j < _packed.point_count(i); ++j, ++point)
+        {
+          contact->add_depth(_packed.depth(point));
+
+          msgs::Vector3d *position = contact->add_position();
+          position->set_x(_packed.position(point * 3));
+          position->set_y(_packed.position(point * 3 + 1));
+          position->set_z(_packed.position(point * 3 + 2));
+
+          msgs::Vector3d *normal = contact->add_normal();
+          normal->set_x(_packed.normal(point * 3));
+          normal->set_y(_packed.normal(point * 3 + 1));
+          normal->set_z(_packed.normal(point * 3 + 2));
+
+          msgs::JointWrench *jointWrench = contact->add_wrench();
+          jointWrench->set_body_1_name(contact->collision1());
+          jointWrench->set_body_1_id(id1);
+          jointWrench->set_body_2_name(contact->collision2());
+          jointWrench->set_body_2_id(id2);
+
+          const int w = point * 12;
+          msgs::Wrench *wrench = jointWrench->mutable_body_1_wrench();
+          wrench->mutable_force()->set_x(_packed.wrench(w));
+          wrench->mutable_force()->set_y(_packed.wrench(w + 1));
+          wrench->mutable_force()->set_z(_packed.wrench(w + 2));
+          wrench->mutable_torque()->set_x(_packed.wrench(w + 3));
+          wrench->mutable_torque()->set_y(_packed.wrench(w + 4));
+          wrench->mutable_torque()->set_z(_packed.wrench(w + 5));
+
+          wrench = jointWrench->mutable_body_2_wrench();
+          wrench->mutable_force()->set_x(_packed.wrench(w + 6));
+          wrench->mutable_force()->set_y(_packed.wrench(w + 7));
+          wrench->mutable_force()->set_z(_packed.wrench(w + 8));
+          wrench->mutable_torque()->set_x(_packed.wrench(w + 9));
+          wrench->mutable_torque()->set_y(_packed.wrench(w + 10));
+          wrench->mutable_torque()->set_z(_packed.wrench(w + 11));
+        }
+      }
+
+      _contacts.mutable_time()->CopyFrom(_packed.time());
+      return true;
+    }
   }
 }
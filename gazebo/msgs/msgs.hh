@@ -17,6 +17,7 @@
 #ifndef GAZEBO_MSGS_MSGS_HH_
 #define GAZEBO_MSGS_MSGS_HH_
 
+#include <functional>
 #include <string>
 
 #include <sdf/sdf.hh>
@@ -774,6 +775,20 @@ namespace gazebo
     /// \return The resulting message
     GAZEBO_VISIBLE
     msgs::Material ConvertIgnMsg(const ignition::msgs::Material &_msg);
+
+    /// \brief Unpack a msgs::PackedContacts into msgs::Contact messages.
+    /// \param[in] _packed The packed contacts.
+    /// \param[in] _name Function that returns the scoped name of a
+    /// collision from its id, as published in a msgs::EntityNames.
+    /// \param[in] _world Name of the world of the contacts.
+    /// \param[out] _contacts Message the contacts are appended to. Its time
+    /// is set to the time of _packed.
+    /// \return False if the arrays of _packed do not have matching sizes,
+    /// in which case nothing is appended.
+    GAZEBO_VISIBLE
+    bool UnpackContacts(const msgs::PackedContacts &_packed,
+        const std::function<std::string (const uint32_t)> &_name,
+        const std::string &_world, msgs::Contacts &_contacts);
     /// \}
   }
 }
@@ -3932,3 +3932,82 @@ TEST_F(MsgsTest, ConvertIgnMsgMaterial)
   EXPECT_DOUBLE_EQ(ignMsg.ambient().a(), ignMsg2.ambient().a());
   EXPECT_EQ(ignMsg.lighting(), ignMsg2.lighting());
 }
+
+/////////////////////////////////////////////////
+TEST_F(MsgsTest, UnpackContacts)
+{
+  msgs::PackedContacts packed;
+  msgs::Set(packed.mutable_time(), common::Time(2, 0));
+  msgs::Set(packed.mutable_contact_time(), common::Time(1, 5));
+  packed.set_names_version(3);
+
+  // A contact with 2 points, then one with 1 point.
+  packed.add_collision1(10);
+  packed.add_collision2(20);
+  packed.add_point_count(2);
+  packed.add_collision1(30);
+  packed.add_collision2(10);
+  packed.add_point_count(1);
+  for (int i = 0; i < 3; ++i)
+  {
+    packed.add_depth(i * 0.1);
+    for (int j = 0; j < 3; ++j)
+    {
+      packed.add_position(i * 3 + j);
+      packed.add_normal(-(i * 3 + j));
+    }
+    for (int j = 0; j < 12; ++j)
+      packed.add_wrench(i * 100 + j);
+  }
+
+  auto name = [](const uint32_t _id)
+  {
+    return _id == 30 ? std::string() : "collision" + std::to_string(_id);
+  };
+
+  msgs::Contacts contacts;
+  EXPECT_TRUE(msgs::UnpackContacts(packed, name, "world", contacts));
+  EXPECT_EQ(msgs::Convert(contacts.time()), common::Time(2, 0));
+  ASSERT_EQ(contacts.contact_size(), 2);
+
+  const msgs::Contact &first = contacts.contact(0);
+  EXPECT_EQ(first.collision1(), "collision10");
+  EXPECT_EQ(first.collision2(), "collision20");
+  EXPECT_EQ(first.world(), "world");
+  EXPECT_EQ(msgs::Convert(first.time()), common::Time(1, 5));
+  ASSERT_EQ(first.position_size(), 2);
+  ASSERT_EQ(first.normal_size(), 2);
+  ASSERT_EQ(first.depth_size(), 2);
+  ASSERT_EQ(first.wrench_size(), 2);
+  EXPECT_EQ(msgs::ConvertIgn(first.position(1)),
+      ignition::math::Vector3d(3, 4, 5));
+  EXPECT_EQ(msgs::ConvertIgn(first.normal(1)),
+      ignition::math::Vector3d(-3, -4, -5));
+  EXPECT_DOUBLE_EQ(first.depth(1), 0.1);
+  EXPECT_EQ(first.wrench(1).body_1_name(), "collision10");
+  EXPECT_EQ(first.wrench(1).body_1_id(), 10u);
+  EXPECT_EQ(first.wrench(1).body_2_name(), "collision20");
+  EXPECT_EQ(first.wrench(1).body_2_id(), 20u);
+  EXPECT_EQ(msgs::ConvertIgn(first.wrench(1).body_1_wrench().force()),
+      ignition::math::Vector3d(100, 101, 102));
+  EXPECT_EQ(msgs::ConvertIgn(first.wrench(1).body_1_wrench().torque()),
+      ignition::math::Vector3d(103, 104, 105));
+  EXPECT_EQ(msgs::ConvertIgn(first.wrench(1).body_2_wrench().force()),
+      ignition::math::Vector3d(106, 107, 108));
+  EXPECT_EQ(msgs::ConvertIgn(first.wrench(1).body_2_wrench().torque()),
+      ignition::math::Vector3d(109, 110, 111));
+
+  const msgs::Contact &second = contacts.contact(1);
+  EXPECT_TRUE(second.collision1().empty());
+  EXPECT_EQ(second.collision2(), "collision10");
+  ASSERT_EQ(second.position_size(), 1);
+  EXPECT_EQ(msgs::ConvertIgn(second.position(0)),
+      ignition::math::Vector3d(6, 7, 8));
+  EXPECT_DOUBLE_EQ(second.depth(0), 0.2);
+
+  // Arrays that do not match the point counts.
+  packed.add_depth(1);
+  msgs::Contacts invalid;
+  EXPECT_FALSE(msgs::UnpackContacts(packed, name, "world", invalid));
+  EXPECT_EQ(invalid.contact_size(), 0);
+}
@@ -23,6 +23,8 @@
   #include <Winsock2.h>
 #endif
 
+#include <list>
+
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
@@ -34,6 +36,22 @@
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Search an entity and its descendants for a name, depth first.
+/// \param[in] _base The entity to search from.
+/// \param[in] _name Scoped name or name to look for.
+/// \return The first entity with the name, NULL if not found.
+static BasePtr FindByName(const BasePtr &_base, const std::string &_name)
+{
+  if (_base->GetScopedName() == _name || _base->GetName() == _name)
+    return _base;
+
+  BasePtr result;
+  for (unsigned int i = 0; i < _base->GetChildCount() && !result; ++i)
+    result = FindByName(_base->GetChild(i), _name);
+
+  return result;
+}
+
 //////////////////////////////////////////////////
 Base::Base(BasePtr _parent)
 : parent(_parent)
@@ -81,6 +99,9 @@ void Base::Load(sdf::ElementPtr _sdf)
 
   this->ComputeScopedName();
 
+  if (this->world)
+    this->world->_IndexEntity(shared_from_this());
+
   this->RegisterIntrospectionItems();
 }
 
@@ -97,6 +118,9 @@ void Base::Fini()
 {
   this->UnregisterIntrospectionItems();
 
+  if (this->world)
+    this->world->_UnindexEntity(this->id);
+
   // Remove self as a child of the parent
   if (this->parent)
   {
@@ -145,6 +169,17 @@ void Base::SetName(const std::string &_name)
   this->sdf->GetAttribute("name")->Set(_name);
   this->name = _name;
   this->ComputeScopedName();
+
+  // The scoped names of the descendants change too.
+  std::list<BasePtr> descendants(this->children.begin(), this->children.end());
+  while (!descendants.empty())
+  {
+    BasePtr child = descendants.front();
+    descendants.pop_front();
+    child->ComputeScopedName();
+    descendants.insert(descendants.end(), child->children.begin(),
+        child->children.end());
+  }
 }
 
 //////////////////////////////////////////////////
@@ -285,6 +320,14 @@ void Base::RemoveChildren()
 //////////////////////////////////////////////////
 BasePtr Base::GetById(unsigned int _id) const
 {
+  // Use the index of the world, if the child is in it.
+  if (this->world)
+  {
+    BasePtr child = this->world->BaseById(_id);
+    if (child)
+      return child->GetParent().get() == this ? child : BasePtr();
+  }
+
   BasePtr result;
   Base_V::const_iterator biter;
 
@@ -306,12 +349,28 @@ BasePtr Base::GetByName(const std::string &_name)
   if (this->GetScopedName() == _name || this->GetName() == _name)
     return shared_from_this();
 
-  BasePtr result;
-  Base_V::const_iterator iter;
+  // Look for the exact scoped name in the index of the world first, which
+  // also finds the top level models by name. The entity must be a
+  // descendant of this one. Otherwise the name may be relative, so search
+  // the children.
+  if (this->world)
+  {
+    BasePtr result = this->world->_IndexedEntity(_name);
+    for (BasePtr p = result ? result->GetParent() : BasePtr(); p;
+         p = p->GetParent())
+    {
+      if (p.get() == this)
+        return result;
+    }
+  }
 
-  for (iter = this->children.begin();
-      iter != this->children.end() && result == NULL; ++iter)
-    result = (*iter)->GetByName(_name);
+  BasePtr result;
+  for (auto const &child : this->children)
+  {
+    result = FindByName(child, _name);
+    if (result)
+      break;
+  }
 
   return result;
 }
@@ -379,6 +438,9 @@ void Base::ComputeScopedName()
       this->scopedName.insert(0, p->GetName()+"::");
     p = p->GetParent();
   }
+
+  if (this->world)
+    this->world->_RenameIndexedEntity(this->id, this->scopedName);
 }
 
 //////////////////////////////////////////////////
@@ -160,6 +160,18 @@ bool Collision::IsPlaceable() const
 }
 
 
+//////////////////////////////////////////////////
+unsigned int Collision::GetCategoryBits() const
+{
+  return GZ_ALL_COLLIDE;
+}
+
+//////////////////////////////////////////////////
+unsigned int Collision::GetCollideBits() const
+{
+  return GZ_ALL_COLLIDE;
+}
+
 //////////////////////////////////////////////////
 void Collision::SetLaserRetro(float _retro)
 {
@@ -80,6 +80,16 @@ namespace gazebo
       /// \param[in] _bits The bits to set.
       public: virtual void SetCollideBits(unsigned int _bits) = 0;
 
+      /// \brief Get the category bits, used during collision detection.
+      /// Engines that do not filter collisions return GZ_ALL_COLLIDE.
+      /// \return The category bits.
+      public: virtual unsigned int GetCategoryBits() const;
+
+      /// \brief Get the collide bits, used during collision detection.
+      /// Engines that do not filter collisions return GZ_ALL_COLLIDE.
+      /// \return The collide bits.
+      public: virtual unsigned int GetCollideBits() const;
+
       /// \brief Set the laser retro reflectiveness.
       /// \param[in] _retro The laser retro value.
       public: void SetLaserRetro(float _retro);
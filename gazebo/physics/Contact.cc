@@ -181,3 +181,32 @@ void Contact::FillMsg(msgs::Contact &_msg) const
     msgs::Set(wrenchMsg->mutable_torque(), this->wrench[j].body2Torque);
   }
 }
+
+/////////////////////////////////////////////////
+void Contact::FillMsg(msgs::PackedContacts &_msg) const
+{
+  _msg.add_collision1(this->collision1->GetId());
+  _msg.add_collision2(this->collision2->GetId());
+  _msg.add_point_count(this->count);
+
+  for (int j = 0; j < this->count; ++j)
+  {
+    _msg.add_depth(this->depths[j]);
+
+    for (int k = 0; k < 3; ++k)
+    {
+      _msg.add_position(this->positions[j][k]);
+      _msg.add_normal(this->normals[j][k]);
+    }
+
+    const JointWrench &jointWrench = this->wrench[j];
+    for (const ignition::math::Vector3d *v : {&jointWrench.body1Force,
+        &jointWrench.body1Torque, &jointWrench.body2Force,
+        &jointWrench.body2Torque})
+    {
+      _msg.add_wrench(v->X());
+      _msg.add_wrench(v->Y());
+      _msg.add_wrench(v->Z());
+    }
+  }
+}
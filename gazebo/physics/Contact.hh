@@ -71,6 +71,10 @@ namespace gazebo
       /// \param[out] _msg Contact message the will hold the data.
       public: void FillMsg(msgs::Contact &_msg) const;
 
+      /// \brief Append the data of this to a msgs::PackedContacts.
+      /// \param[out] _msg Packed contacts message the data is appended to.
+      public: void FillMsg(msgs::PackedContacts &_msg) const;
+
       /// \brief Produce a debug string.
       /// \return A string that contains the values of the contact.
       public: std::string DebugString() const;
@@ -20,6 +20,8 @@
   #include <Winsock2.h>
 #endif
 
+#include <algorithm>
+
 #include <boost/algorithm/string.hpp>
 
 #include "gazebo/transport/Node.hh"
@@ -30,6 +32,8 @@
 
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
 #include "gazebo/physics/Contact.hh"
 #include "gazebo/physics/ContactManager.hh"
 
@@ -50,6 +54,8 @@ ContactManager::~ContactManager()
   this->Clear();
   this->node.reset();
   this->contactPub.reset();
+  this->contactPackedPub.reset();
+  this->contactNamesPub.reset();
 
   boost::unordered_map<std::string, ContactPublisher *>::iterator iter;
   for (iter = this->customContactPublishers.begin();
@@ -60,6 +66,7 @@ ContactManager::~ContactManager()
       iter->second->collisions.clear();
       iter->second->collisionNames.clear();
       iter->second->publisher.reset();
+      iter->second->publisherPacked.reset();
       delete iter->second;
       iter->second = NULL;
     }
@@ -81,6 +88,10 @@ void ContactManager::Init(WorldPtr _world)
 
   this->contactPub =
     this->node->Advertise<msgs::Contacts>("~/physics/contacts", 50);
+  this->contactPackedPub = this->node->Advertise<msgs::PackedContacts>(
+      "~/physics/contacts/packed", 50);
+  this->contactNamesPub = this->node->Advertise<msgs::EntityNames>(
+      "~/physics/contacts/names", 1);
 }
 
 /////////////////////////////////////////////////
@@ -102,36 +113,30 @@ bool ContactManager::SubscribersConnected(Collision *_collision1,
   if (this->contactPub->HasConnections()) return true;
 
   boost::recursive_mutex::scoped_lock lock(*this->customMutex);
-  boost::unordered_map<std::string, ContactPublisher *>::const_iterator iter;
-  for (iter = this->customContactPublishers.begin();
-       iter != this->customContactPublishers.end(); ++iter)
+
+  // A model can simply be loaded later, so check the collisionNames as well.
+  if (this->pendingCollisionNames > 0)
   {
-    // A model can simply be loaded later, so check the collisionNames as well.
-    if (!iter->second->collisionNames.empty())
+    for (auto const &publisher : this->routeSlots)
     {
-      std::vector<std::string>::const_iterator it;
-      for (it = iter->second->collisionNames.begin();
-           it != iter->second->collisionNames.end(); ++it)
+      if (!publisher)
+        continue;
+
+      for (auto const &name : publisher->collisionNames)
       {
-        BasePtr b = this->world->BaseByName(*it);
-        if (b)
-        {
+        if (this->world->BaseByName(name))
           return true;
-        }
-        // We could do the same transformation which is done in
-        // GetCustomPublishers() here (insert collisions which now have been
-        // loaded), but this would remove the const qualifier of this function.
-        // It would however speed up repeated calls of this function without
-        // a call of NewContact() or GetCustomPublishers() in between.
       }
     }
+  }
 
-    // only reason _collision1 or _collision1 cannot be const parameters
-    // is that compiler can't find const pointers in unordered set
-    if (iter->second->collisions.find(_collision1) !=
-        iter->second->collisions.end() ||
-        iter->second->collisions.find(_collision2) !=
-        iter->second->collisions.end())
+  // Rows of removed filters are cleared, not removed.
+  const int row1 = this->RouteRow(_collision1);
+  const int row2 = this->RouteRow(_collision2);
+  for (size_t i = 0; i < this->routeWords; ++i)
+  {
+    if ((row1 >= 0 && this->routeBits[row1 * this->routeWords + i]) ||
+        (row2 >= 0 && this->routeBits[row2 * this->routeWords + i]))
     {
       return true;
     }
@@ -140,48 +145,172 @@ bool ContactManager::SubscribersConnected(Collision *_collision1,
 }
 
 /////////////////////////////////////////////////
-void ContactManager::GetCustomPublishers(Collision *_collision1,
-                     Collision *_collision2, const bool _getOnlyConnected,
-                     std::vector<ContactPublisher*> &_publishers)
+/// \brief Get the index of the lowest bit that is set.
+/// \param[in] _bits Bits, at least one of them set.
+/// \return Index of the bit.
+static inline unsigned int LowestBit(uint64_t _bits)
 {
-  boost::recursive_mutex::scoped_lock lock(*this->customMutex);
-  boost::unordered_map<std::string, ContactPublisher *>::iterator iter;
-  for (iter = this->customContactPublishers.begin();
-       iter != this->customContactPublishers.end(); ++iter)
+#if defined(__GNUC__)
+  return static_cast<unsigned int>(__builtin_ctzll(_bits));
+#else
+  unsigned int index = 0;
+  while (!(_bits & 1u))
+  {
+    _bits >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+/////////////////////////////////////////////////
+int ContactManager::RouteRow(const Collision *_collision) const
+{
+  const uint32_t id = _collision->GetId();
+  if (id >= this->routeRows.size())
+    return -1;
+  return this->routeRows[id];
+}
+
+/////////////////////////////////////////////////
+void ContactManager::AddRoute(const Collision *_collision, const size_t _slot)
+{
+  const uint32_t id = _collision->GetId();
+  if (id >= this->routeRows.size())
+    this->routeRows.resize(id + 1, -1);
+
+  int row = this->routeRows[id];
+  if (row < 0)
+  {
+    row = static_cast<int>(this->routeBits.size() / this->routeWords);
+    this->routeBits.resize(this->routeBits.size() + this->routeWords, 0u);
+    this->routeRows[id] = row;
+  }
+
+  this->routeBits[row * this->routeWords + _slot / 64] |=
+    uint64_t(1) << (_slot % 64);
+}
+
+/////////////////////////////////////////////////
+void ContactManager::AddRoutes(ContactPublisher *_publisher)
+{
+  // Reuse the slot of a removed filter, or add one.
+  size_t slot = 0;
+  while (slot < this->routeSlots.size() && this->routeSlots[slot])
+    ++slot;
+  if (slot == this->routeSlots.size())
+    this->routeSlots.push_back(nullptr);
+  this->routeSlots[slot] = _publisher;
+
+  // Widen the rows of the table, 64 filters at a time.
+  const size_t words = (this->routeSlots.size() + 63) / 64;
+  if (words > this->routeWords)
+  {
+    const size_t rows = this->routeWords > 0 ?
+      this->routeBits.size() / this->routeWords : 0;
+    std::vector<uint64_t> bits(rows * words, 0u);
+    for (size_t i = 0; i < rows; ++i)
+    {
+      std::copy(this->routeBits.begin() + i * this->routeWords,
+          this->routeBits.begin() + (i + 1) * this->routeWords,
+          bits.begin() + i * words);
+    }
+    this->routeBits.swap(bits);
+    this->routeWords = words;
+  }
+
+  for (auto const &collision : _publisher->collisions)
+    this->AddRoute(collision, slot);
+
+  this->pendingCollisionNames += _publisher->collisionNames.size();
+}
+
+/////////////////////////////////////////////////
+void ContactManager::RemoveRoutes(ContactPublisher *_publisher)
+{
+  auto iter = std::find(this->routeSlots.begin(), this->routeSlots.end(),
+      _publisher);
+  if (iter == this->routeSlots.end())
+    return;
+
+  const size_t slot = iter - this->routeSlots.begin();
+  const uint64_t mask = ~(uint64_t(1) << (slot % 64));
+  for (size_t i = slot / 64; i < this->routeBits.size(); i += this->routeWords)
+    this->routeBits[i] &= mask;
+
+  *iter = nullptr;
+  this->pendingCollisionNames -= _publisher->collisionNames.size();
+}
+
+/////////////////////////////////////////////////
+void ContactManager::ResolveCollisionNames()
+{
+  // Names can only be found once entities are added to the world.
+  const uint64_t version = this->world->_EntityVersion();
+  if (this->pendingCollisionNames == 0 ||
+      version == this->resolvedEntityVersion)
   {
+    return;
+  }
+  this->resolvedEntityVersion = version;
+
+  for (size_t slot = 0; slot < this->routeSlots.size(); ++slot)
+  {
+    ContactPublisher *publisher = this->routeSlots[slot];
+    if (!publisher || publisher->collisionNames.empty())
+      continue;
+
     // A model can simply be loaded later, so convert ones that are not yet
     // found
-    if (!iter->second->collisionNames.empty())
+    std::vector<std::string>::iterator it;
+    for (it = publisher->collisionNames.begin();
+        it != publisher->collisionNames.end();)
     {
-      std::vector<std::string>::iterator it;
-      for (it = iter->second->collisionNames.begin();
-          it != iter->second->collisionNames.end();)
+      Collision *col = boost::dynamic_pointer_cast<Collision>(
+          this->world->BaseByName(*it)).get();
+      if (!col)
       {
-        Collision *col = boost::dynamic_pointer_cast<Collision>(
-            this->world->BaseByName(*it)).get();
-        if (!col)
-        {
-          ++it;
-          continue;
-        }
-        it = iter->second->collisionNames.erase(it);
-        iter->second->collisions.insert(col);
+        ++it;
+        continue;
       }
+      it = publisher->collisionNames.erase(it);
+      --this->pendingCollisionNames;
+      publisher->collisions.insert(col);
+      this->AddRoute(col, slot);
     }
+  }
+}
 
-    // only reason _collision1 or _collision1 cannot be const parameters
-    // is that compiler can't find const pointers in unordered set
-    if (iter->second->collisions.find(_collision1) !=
-        iter->second->collisions.end() ||
-        iter->second->collisions.find(_collision2) !=
-        iter->second->collisions.end())
+/////////////////////////////////////////////////
+void ContactManager::GetCustomPublishers(Collision *_collision1,
+                     Collision *_collision2, const bool _getOnlyConnected,
+                     std::vector<ContactPublisher*> &_publishers)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->customMutex);
+  this->ResolveCollisionNames();
+
+  const int row1 = this->RouteRow(_collision1);
+  const int row2 = this->RouteRow(_collision2);
+  if (row1 < 0 && row2 < 0)
+    return;
+
+  for (size_t i = 0; i < this->routeWords; ++i)
+  {
+    uint64_t bits = 0;
+    if (row1 >= 0)
+      bits |= this->routeBits[row1 * this->routeWords + i];
+    if (row2 >= 0)
+      bits |= this->routeBits[row2 * this->routeWords + i];
+
+    while (bits)
     {
-      GZ_ASSERT(iter->second->publisher != NULL,
+      ContactPublisher *publisher = this->routeSlots[i * 64 + LowestBit(bits)];
+      bits &= bits - 1;
+
+      GZ_ASSERT(publisher->publisher != NULL,
                 "ContactPublisher must have a valid publisher");
-      if (!_getOnlyConnected || iter->second->publisher->HasConnections())
-      {
-        _publishers.push_back(iter->second);
-      }
+      if (!_getOnlyConnected || publisher->publisher->HasConnections())
+        _publishers.push_back(publisher);
     }
   }
 }
@@ -201,7 +330,9 @@ Contact *ContactManager::NewContact(Collision *_collision1,
   // This is a signal to the Physics engine that it can skip the extra
   // processing necessary to get back contact information.
 
-  std::vector<ContactPublisher *> publishers;
+  boost::recursive_mutex::scoped_lock lock(*this->customMutex);
+  std::vector<ContactPublisher *> &publishers = this->routedPublishers;
+  publishers.clear();
   bool getOnlyConnected = false;
   // TODO check: getOnlyConnected set to false to keep same behaviour as before.
   // But should we not only add publishers which are connected, as is done
@@ -298,8 +429,14 @@ void ContactManager::PublishContacts()
     return;
   }
 
-  // publish to default topic, ~/physics/contacts
-  if (!transport::getMinimalComms())
+  const common::Time simTime = this->world->SimTime();
+  const bool packed = !transport::getMinimalComms() &&
+    this->contactPackedPub->HasConnections();
+
+  // publish to default topic, ~/physics/contacts. Skip it if only the
+  // packed contacts are listened to.
+  if (!transport::getMinimalComms() &&
+      (!packed || this->contactPub->HasConnections()))
   {
     msgs::Contacts msg;
     for (unsigned int i = 0; i < this->contactIndex; ++i)
@@ -311,10 +448,30 @@ void ContactManager::PublishContacts()
       this->contacts[i]->FillMsg(*contactMsg);
     }
 
-    msgs::Set(msg.mutable_time(), this->world->SimTime());
+    msgs::Set(msg.mutable_time(), simTime);
     this->contactPub->Publish(msg);
   }
 
+  // publish to ~/physics/contacts/packed
+  if (packed)
+  {
+    this->PublishContactNames();
+
+    msgs::PackedContacts msg;
+    msgs::Set(msg.mutable_time(), simTime);
+    msg.set_names_version(this->contactNamesVersion);
+    for (unsigned int i = 0; i < this->contactIndex; ++i)
+    {
+      if (this->contacts[i]->count == 0)
+        continue;
+
+      if (!msg.has_contact_time())
+        msgs::Set(msg.mutable_contact_time(), this->contacts[i]->time);
+      this->contacts[i]->FillMsg(msg);
+    }
+    this->contactPackedPub->Publish(msg);
+  }
+
   // publish to other custom topics
   boost::recursive_mutex::scoped_lock lock(*this->customMutex);
   boost::unordered_map<std::string, ContactPublisher *>::iterator iter;
@@ -322,22 +479,88 @@ void ContactManager::PublishContacts()
       iter != this->customContactPublishers.end(); ++iter)
   {
     ContactPublisher *contactPublisher = iter->second;
-    msgs::Contacts msg2;
-    for (unsigned int j = 0;
-        j < contactPublisher->contacts.size(); ++j)
+
+    const bool filterPacked = contactPublisher->publisherPacked &&
+      contactPublisher->publisherPacked->HasConnections();
+    if (filterPacked)
     {
-      if (contactPublisher->contacts[j]->count == 0)
-        continue;
+      this->PublishContactNames();
 
-      msgs::Contact *contactMsg = msg2.add_contact();
-      contactPublisher->contacts[j]->FillMsg(*contactMsg);
+      msgs::PackedContacts msg2;
+      msgs::Set(msg2.mutable_time(), simTime);
+      msg2.set_names_version(this->contactNamesVersion);
+      for (unsigned int j = 0;
+          j < contactPublisher->contacts.size(); ++j)
+      {
+        if (contactPublisher->contacts[j]->count == 0)
+          continue;
+
+        if (!msg2.has_contact_time())
+        {
+          msgs::Set(msg2.mutable_contact_time(),
+              contactPublisher->contacts[j]->time);
+        }
+        contactPublisher->contacts[j]->FillMsg(msg2);
+      }
+      contactPublisher->publisherPacked->Publish(msg2);
+    }
+
+    if (!filterPacked || contactPublisher->publisher->HasConnections())
+    {
+      msgs::Contacts msg2;
+      for (unsigned int j = 0;
+          j < contactPublisher->contacts.size(); ++j)
+      {
+        if (contactPublisher->contacts[j]->count == 0)
+          continue;
+
+        msgs::Contact *contactMsg = msg2.add_contact();
+        contactPublisher->contacts[j]->FillMsg(*contactMsg);
+      }
+      msgs::Set(msg2.mutable_time(), simTime);
+      contactPublisher->publisher->Publish(msg2);
     }
-    msgs::Set(msg2.mutable_time(), this->world->SimTime());
-    contactPublisher->publisher->Publish(msg2);
     contactPublisher->contacts.clear();
   }
 }
 
+/////////////////////////////////////////////////
+/// \brief Add the ids and scoped names of the collisions of a model and of
+/// its nested models to a message.
+/// \param[in] _model The model.
+/// \param[out] _msg The message.
+static void AddCollisionNames(const ModelPtr &_model, msgs::EntityNames &_msg)
+{
+  for (auto const &link : _model->GetLinks())
+  {
+    for (auto const &collision : link->GetCollisions())
+    {
+      _msg.add_id(collision->GetId());
+      _msg.add_name(collision->GetScopedName());
+    }
+  }
+
+  for (auto const &model : _model->NestedModels())
+    AddCollisionNames(model, _msg);
+}
+
+/////////////////////////////////////////////////
+void ContactManager::PublishContactNames()
+{
+  const uint64_t version = this->world->_EntityVersion();
+  if (this->contactNamesPublished && version == this->contactNamesVersion)
+    return;
+
+  msgs::EntityNames msg;
+  msg.set_version(version);
+  for (auto const &model : this->world->Models())
+    AddCollisionNames(model, msg);
+
+  this->contactNamesPub->Publish(msg);
+  this->contactNamesVersion = version;
+  this->contactNamesPublished = true;
+}
+
 /////////////////////////////////////////////////
 std::string ContactManager::CreateFilter(const std::string &_name,
     const std::string &_collision)
@@ -366,6 +589,8 @@ std::string ContactManager::CreateFilter(const std::string &_name,
 
   ContactPublisher *contactPublisher = new ContactPublisher;
   contactPublisher->publisher = this->node->Advertise<msgs::Contacts>(topic);
+  contactPublisher->publisherPacked =
+    this->node->Advertise<msgs::PackedContacts>(topic + "/packed");
 
   std::map<std::string, physics::CollisionPtr>::const_iterator iter;
   for (iter = _collisions.begin(); iter != _collisions.end(); ++iter)
@@ -378,6 +603,7 @@ std::string ContactManager::CreateFilter(const std::string &_name,
   {
     boost::recursive_mutex::scoped_lock lock(*this->customMutex);
     this->customContactPublishers[name] = contactPublisher;
+    this->AddRoutes(contactPublisher);
   }
 
   return topic;
@@ -421,7 +647,11 @@ std::string ContactManager::CreateFilter(const std::string &_name,
         "Failed to create a custom filter");
 
     // Let it know about collisions not yet found.
-    this->customContactPublishers[name]->collisionNames = collisionNames;
+    ContactPublisher *contactPublisher = this->customContactPublishers[name];
+    this->pendingCollisionNames -= contactPublisher->collisionNames.size();
+    contactPublisher->collisionNames = collisionNames;
+    this->pendingCollisionNames += collisionNames.size();
+    this->resolvedEntityVersion = this->world->_EntityVersion();
   }
 
   return topic;
@@ -439,11 +669,14 @@ void ContactManager::RemoveFilter(const std::string &_name)
   if (iter != customContactPublishers.end())
   {
     ContactPublisher *contactPublisher = iter->second;
+    this->RemoveRoutes(contactPublisher);
     contactPublisher->contacts.clear();
     contactPublisher->collisionNames.clear();
     contactPublisher->collisions.clear();
     contactPublisher->publisher->Fini();
     contactPublisher->publisher.reset();
+    contactPublisher->publisherPacked->Fini();
+    contactPublisher->publisherPacked.reset();
     this->customContactPublishers.erase(iter);
   }
 }
@@ -18,6 +18,7 @@
 #ifndef GAZEBO_PHYSICS_CONTACTMANAGER_HH_
 #define GAZEBO_PHYSICS_CONTACTMANAGER_HH_
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <map>
@@ -44,6 +45,10 @@ namespace gazebo
       /// \brief Contact message publisher
       public: transport::PublisherPtr publisher;
 
+      /// \brief Packed contact message publisher, on the topic of
+      /// publisher followed by "/packed".
+      public: transport::PublisherPtr publisherPacked;
+
       /// \brief Pointers of collisions monitored by contact manager for
       /// contacts.
       public: boost::unordered_set<Collision *> collisions;
@@ -160,6 +165,15 @@ namespace gazebo
       public: void Clear();
 
       /// \brief Publish all contacts in a msgs::Contacts message.
+      ///
+      /// The contacts are also published in a msgs::PackedContacts message
+      /// on ~/physics/contacts/packed, and the contacts of each filter on
+      /// the topic of the filter followed by "/packed", when they have
+      /// subscribers. Packed contacts identify collisions by id. The names
+      /// of the collisions of the world are then published in a
+      /// msgs::EntityNames message on ~/physics/contacts/names, once each
+      /// time entities change. Subscribe to it with latching to get the
+      /// last names.
       public: void PublishContacts();
 
       /// \brief Set the contact count to zero.
@@ -170,6 +184,8 @@ namespace gazebo
       /// param[in] _name Filter name.
       /// param[in] _collisions A list of collision names used for filtering.
       /// \return New topic where filtered messages will be published to.
+      /// The packed contacts of the filter are published on this topic
+      /// followed by "/packed", see PublishContacts.
       public: std::string CreateFilter(const std::string &_topic,
                   const std::vector<std::string> &_collisions);
 
@@ -178,6 +194,8 @@ namespace gazebo
       /// param[in] _name Filter name.
       /// param[in] _collision A collision name used for filtering.
       /// \return New topic where filtered messages will be published to.
+      /// The packed contacts of the filter are published on this topic
+      /// followed by "/packed", see PublishContacts.
       public: std::string CreateFilter(const std::string &_topic,
                   const std::string &_collision);
 
@@ -187,6 +205,8 @@ namespace gazebo
       /// param[in] _collisions A map of collision name to collision
       /// object.
       /// \return New topic where filtered messages will be published to.
+      /// The packed contacts of the filter are published on this topic
+      /// followed by "/packed", see PublishContacts.
       public: std::string CreateFilter(const std::string &_name,
                   const std::map<std::string, physics::CollisionPtr>
                   &_collisions);
@@ -215,6 +235,33 @@ namespace gazebo
                        Collision *_collision2, const bool _getOnlyConnected,
                        std::vector<ContactPublisher*> &_publishers);
 
+      /// \brief Add a filter to the routing table, and route the
+      /// collisions it already found.
+      /// \param[in] _publisher Publisher of the filter.
+      private: void AddRoutes(ContactPublisher *_publisher);
+
+      /// \brief Remove a filter from the routing table.
+      /// \param[in] _publisher Publisher of the filter.
+      private: void RemoveRoutes(ContactPublisher *_publisher);
+
+      /// \brief Route the contacts of a collision to a filter.
+      /// \param[in] _collision The collision.
+      /// \param[in] _slot Slot of the filter in the routing table.
+      private: void AddRoute(const Collision *_collision, const size_t _slot);
+
+      /// \brief Look for the collisions that filters did not find yet, if
+      /// entities were added to the world since the last time.
+      private: void ResolveCollisionNames();
+
+      /// \brief Publish the names of the collisions of the world, if
+      /// entities changed since they were last published.
+      private: void PublishContactNames();
+
+      /// \brief Get the routing table row of a collision.
+      /// \param[in] _collision The collision.
+      /// \return Index of the row, -1 if no filter has the collision.
+      private: int RouteRow(const Collision *_collision) const;
+
       private: std::vector<Contact*> contacts;
 
       private: unsigned int contactIndex;
@@ -225,6 +272,20 @@ namespace gazebo
       /// \brief Contact publisher.
       private: transport::PublisherPtr contactPub;
 
+      /// \brief Packed contact publisher.
+      private: transport::PublisherPtr contactPackedPub;
+
+      /// \brief Publisher of the names of the collisions of packed
+      /// contacts.
+      private: transport::PublisherPtr contactNamesPub;
+
+      /// \brief Entity version of the last names published, see
+      /// World::_EntityVersion.
+      private: uint64_t contactNamesVersion = 0;
+
+      /// \brief True once names have been published.
+      private: bool contactNamesPublished = false;
+
       /// \brief Pointer to the world.
       private: WorldPtr world;
 
@@ -236,6 +297,33 @@ namespace gazebo
       /// \brief Mutex to protect the list of custom publishers.
       private: boost::recursive_mutex *customMutex;
 
+      /// \brief Filter of each slot of the routing table, null for a free
+      /// slot. The slot of a filter is its bit in the rows of the table.
+      private: std::vector<ContactPublisher *> routeSlots;
+
+      /// \brief Row of the routing table of each collision, by collision
+      /// id, -1 if no filter has the collision.
+      private: std::vector<int> routeRows;
+
+      /// \brief Routing table, with one row per collision that filters
+      /// have. A row is a bitset of the slots of the filters of the
+      /// collision, stored in routeWords words.
+      private: std::vector<uint64_t> routeBits;
+
+      /// \brief Number of words of each row of the routing table.
+      private: size_t routeWords = 0;
+
+      /// \brief Number of collision names that filters did not find yet.
+      private: size_t pendingCollisionNames = 0;
+
+      /// \brief Entity version of the world when the pending collision names
+      /// were last looked for, see World::_EntityVersion.
+      private: uint64_t resolvedEntityVersion = 0;
+
+      /// \brief Publishers of the contact being added, reused to avoid
+      /// allocations.
+      private: std::vector<ContactPublisher *> routedPublishers;
+
       // Place ignition::transport objects at the end of this file to
       // guarantee they are destructed first.
 
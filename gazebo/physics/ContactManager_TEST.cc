@@ -15,11 +15,78 @@
  *
 */
 
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+
 #include "gazebo/physics/ContactManager.hh"
 #include "gazebo/test/ServerFixture.hh"
 
 using namespace gazebo;
 
+/// \brief Names of the collisions of the contacts received by filter.
+std::map<std::string, std::set<std::string>> g_routedCollisions;
+
+/// \brief Mutex to protect g_routedCollisions.
+std::mutex g_routedMutex;
+
+/// \brief Last packed contacts received.
+msgs::PackedContacts g_packedContacts;
+
+/// \brief Last collision names received.
+msgs::EntityNames g_contactNames;
+
+/////////////////////////////////////////////////
+/// \brief Record packed contacts.
+/// \param[in] _msg Packed contacts.
+void OnPackedContacts(ConstPackedContactsPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_routedMutex);
+  if (_msg->collision1_size() > 0)
+    g_packedContacts = *_msg;
+}
+
+/////////////////////////////////////////////////
+/// \brief Record collision names.
+/// \param[in] _msg Collision names.
+void OnContactNames(ConstEntityNamesPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_routedMutex);
+  g_contactNames = *_msg;
+}
+
+/////////////////////////////////////////////////
+/// \brief Record the collisions of the contacts received by a filter.
+/// \param[in] _filter Name of the filter.
+/// \param[in] _msg Contacts.
+void OnRoutedContacts(const std::string &_filter,
+    ConstContactsPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_routedMutex);
+  for (int i = 0; i < _msg->contact_size(); ++i)
+  {
+    g_routedCollisions[_filter].insert(_msg->contact(i).collision1());
+    g_routedCollisions[_filter].insert(_msg->contact(i).collision2());
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Record the contacts received by the filter of the box.
+/// \param[in] _msg Contacts.
+void OnBoxContacts(ConstContactsPtr &_msg)
+{
+  OnRoutedContacts("box_filter", _msg);
+}
+
+/////////////////////////////////////////////////
+/// \brief Record the contacts received by the filter of the late box.
+/// \param[in] _msg Contacts.
+void OnLateContacts(ConstContactsPtr &_msg)
+{
+  OnRoutedContacts("late_filter", _msg);
+}
+
 class ContactManagerTest : public ServerFixture
 {
 };
@@ -194,6 +261,141 @@ TEST_F(ContactManagerTest, NeverDropContacts)
   }
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that contacts are only routed to the filters of their
+/// collisions, including collisions loaded after the filters.
+TEST_F(ContactManagerTest, RouteContacts)
+{
+  Load("test/worlds/box.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  physics::ContactManager *manager = physics->GetContactManager();
+  ASSERT_TRUE(manager != nullptr);
+
+  // More filters than the 64 of a word of the routing table, on collisions
+  // that do not exist. Removed filters leave a slot to reuse.
+  const unsigned int runs = 70;
+  for (unsigned int i = 0; i < runs; ++i)
+  {
+    std::stringstream ss;
+    ss << "missing" << i;
+    manager->CreateFilter(ss.str(), ss.str() + "::link::collision");
+  }
+  manager->RemoveFilter("missing3");
+  manager->RemoveFilter("missing66");
+
+  std::string boxTopic =
+    manager->CreateFilter("box_filter", "box::link::collision");
+  std::string lateTopic =
+    manager->CreateFilter("late_filter", "late_box::link::collision");
+  EXPECT_EQ(manager->GetFilterCount(), runs);
+
+  auto boxSub = this->node->Subscribe(boxTopic, &OnBoxContacts);
+  auto lateSub = this->node->Subscribe(lateTopic, &OnLateContacts);
+
+  // Contacts of the box are routed to its filter only.
+  world->Step(1);
+  ASSERT_GT(manager->GetContactCount(), 0u);
+  for (unsigned int i = 0; i < manager->GetContactCount(); ++i)
+  {
+    physics::Contact *contact = manager->GetContact(i);
+    EXPECT_TRUE(manager->SubscribersConnected(
+          contact->collision1, contact->collision2));
+  }
+
+  // The late box is found once it is loaded.
+  SpawnBox("late_box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(3, 0, 0.5));
+
+  std::set<std::string> boxCollisions;
+  std::set<std::string> lateCollisions;
+  for (int i = 0; i < 100 && lateCollisions.empty(); ++i)
+  {
+    world->Step(1);
+    common::Time::MSleep(10);
+    std::lock_guard<std::mutex> lock(g_routedMutex);
+    boxCollisions = g_routedCollisions["box_filter"];
+    lateCollisions = g_routedCollisions["late_filter"];
+  }
+
+  EXPECT_EQ(boxCollisions, std::set<std::string>(
+        {"box::link::collision", "ground_plane::link::collision"}));
+  EXPECT_EQ(lateCollisions, std::set<std::string>(
+        {"late_box::link::collision", "ground_plane::link::collision"}));
+
+  // Removed filters get no more contacts.
+  manager->RemoveFilter("box_filter");
+  manager->RemoveFilter("late_filter");
+  EXPECT_EQ(manager->GetFilterCount(), runs - 2);
+  world->Step(1);
+  for (unsigned int i = 0; i < manager->GetContactCount(); ++i)
+  {
+    physics::Contact *contact = manager->GetContact(i);
+    EXPECT_FALSE(manager->SubscribersConnected(
+          contact->collision1, contact->collision2));
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Test the packed contacts and the names of their collisions.
+TEST_F(ContactManagerTest, PackedContacts)
+{
+  Load("test/worlds/box.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::CollisionPtr box = boost::dynamic_pointer_cast<physics::Collision>(
+      world->BaseByName("box::link::collision"));
+  ASSERT_TRUE(box != nullptr);
+
+  auto packedSub = this->node->Subscribe("~/physics/contacts/packed",
+      &OnPackedContacts);
+  auto namesSub = this->node->Subscribe("~/physics/contacts/names",
+      &OnContactNames, true);
+
+  bool received = false;
+  for (int i = 0; i < 100 && !received; ++i)
+  {
+    world->Step(1);
+    common::Time::MSleep(10);
+    std::lock_guard<std::mutex> lock(g_routedMutex);
+    received = g_packedContacts.collision1_size() > 0 &&
+      g_contactNames.id_size() > 0;
+  }
+  ASSERT_TRUE(received);
+
+  std::lock_guard<std::mutex> lock(g_routedMutex);
+  EXPECT_EQ(g_packedContacts.names_version(), world->_EntityVersion());
+  EXPECT_EQ(g_contactNames.version(), world->_EntityVersion());
+  ASSERT_EQ(g_contactNames.id_size(), g_contactNames.name_size());
+
+  std::map<uint32_t, std::string> names;
+  for (int i = 0; i < g_contactNames.id_size(); ++i)
+    names[g_contactNames.id(i)] = g_contactNames.name(i);
+  EXPECT_EQ(names[box->GetId()], "box::link::collision");
+
+  // The box rests on the ground plane.
+  msgs::Contacts contacts;
+  EXPECT_TRUE(msgs::UnpackContacts(g_packedContacts,
+      [&names](const uint32_t _id) {return names[_id];}, world->Name(),
+      contacts));
+  ASSERT_GT(contacts.contact_size(), 0);
+  for (int i = 0; i < contacts.contact_size(); ++i)
+  {
+    std::set<std::string> collisions = {contacts.contact(i).collision1(),
+      contacts.contact(i).collision2()};
+    EXPECT_EQ(collisions, std::set<std::string>(
+          {"box::link::collision", "ground_plane::link::collision"}));
+    EXPECT_GT(contacts.contact(i).position_size(), 0);
+  }
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
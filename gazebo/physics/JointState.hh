@@ -144,6 +144,9 @@ namespace gazebo
         return _out;
       }
 
+      /// \brief WorldSnapshot converts states to and from raw values.
+      private: friend class WorldSnapshotPrivate;
+
       private: std::vector<double> positions;
     };
     /// \}
@@ -1063,6 +1063,9 @@ void Link::DetachAllStaticModels()
 //////////////////////////////////////////////////
 void Link::OnPoseChange()
 {
+  if (this->world)
+    this->world->_SetLinkMoved();
+
   ignition::math::Pose3d p;
   for (unsigned int i = 0; i < this->attachedModels.size(); i++)
   {
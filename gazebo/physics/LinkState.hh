@@ -224,6 +224,12 @@ namespace gazebo
         return _out;
       }
 
+      /// \brief LogFrame fills states from raw values.
+      private: friend class LogFrame;
+
+      /// \brief WorldSnapshot converts states to and from raw values.
+      private: friend class WorldSnapshotPrivate;
+
       /// \brief 3D pose of the link relative to the model.
       private: ignition::math::Pose3d pose;
 
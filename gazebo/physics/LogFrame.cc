@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "gazebo/physics/Light.hh"
+#include "gazebo/physics/LightState.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/LinkState.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/ModelState.hh"
+#include "gazebo/physics/WorldState.hh"
+#include "gazebo/physics/LogFrame.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/////////////////////////////////////////////////
+void LogFrame::Capture(const std::string &_name,
+    const common::Time &_simTime, const common::Time &_realTime,
+    const uint64_t _iterations, const Model_V &_models,
+    const Light_V &_lights, const bool _skipSleeping)
+{
+  this->name = _name;
+  this->simTime = _simTime;
+  this->realTime = _realTime;
+  this->wallTime = common::Time::GetWallTime();
+  this->iterations = _iterations;
+
+  this->modelCount = 0;
+  this->linkCount = 0;
+  for (auto const &model : _models)
+    this->CaptureModel(model, _skipSleeping && model->IsSleeping());
+
+  this->lightCount = 0;
+  for (auto const &light : _lights)
+  {
+    if (this->lightCount == this->lights.size())
+      this->lights.resize(this->lightCount + 1);
+
+    Light &state = this->lights[this->lightCount++];
+    state.name = light->GetName();
+    state.pose = light->WorldPose();
+  }
+}
+
+/////////////////////////////////////////////////
+void LogFrame::CaptureModel(const ModelPtr &_model, const bool _sleeping)
+{
+  if (this->modelCount == this->models.size())
+    this->models.resize(this->modelCount + 1);
+
+  const size_t index = this->modelCount++;
+  {
+    Model &state = this->models[index];
+    state.name = _model->GetName();
+    state.pose = _model->WorldPose();
+    state.scale = _model->Scale();
+    state.firstLink = this->linkCount;
+    state.linkCount = _model->GetLinks().size();
+  }
+
+  for (auto const &link : _model->GetLinks())
+  {
+    if (this->linkCount == this->links.size())
+      this->links.resize(this->linkCount + 1);
+
+    Link &state = this->links[this->linkCount++];
+    state.name = link->GetName();
+    state.pose = link->WorldPose();
+    if (_sleeping)
+    {
+      state.linearVel = ignition::math::Vector3d::Zero;
+      state.angularVel = ignition::math::Vector3d::Zero;
+      state.linearAccel = ignition::math::Vector3d::Zero;
+      state.angularAccel = ignition::math::Vector3d::Zero;
+      state.force = ignition::math::Vector3d::Zero;
+      continue;
+    }
+
+    state.linearVel = link->WorldLinearVel();
+    state.angularVel = link->WorldAngularVel();
+    state.linearAccel = link->WorldLinearAccel();
+    state.angularAccel = link->WorldAngularAccel();
+    state.force = link->WorldForce();
+  }
+
+  for (auto const &nested : _model->NestedModels())
+    this->CaptureModel(nested, _sleeping);
+
+  // The vector may have grown, so don't keep a reference across the
+  // recursion.
+  this->models[index].nestedCount = this->modelCount - index - 1;
+}
+
+/////////////////////////////////////////////////
+void LogFrame::ToWorldState(WorldState &_state) const
+{
+  _state.name = this->name;
+  _state.simTime = this->simTime;
+  _state.realTime = this->realTime;
+  _state.wallTime = this->wallTime;
+  _state.iterations = this->iterations;
+
+  _state.modelStates.clear();
+  for (size_t i = 0; i < this->modelCount;
+       i += this->models[i].nestedCount + 1)
+  {
+    this->ToModelState(i, _state.modelStates[this->models[i].name]);
+  }
+
+  _state.lightStates.clear();
+  for (size_t i = 0; i < this->lightCount; ++i)
+  {
+    const Light &light = this->lights[i];
+    LightState &state = _state.lightStates[light.name];
+    state.name = light.name;
+    state.wallTime = this->wallTime;
+    state.realTime = this->realTime;
+    state.simTime = this->simTime;
+    state.iterations = this->iterations;
+    state.pose = light.pose;
+  }
+}
+
+/////////////////////////////////////////////////
+void LogFrame::ToModelState(const size_t _index, ModelState &_state) const
+{
+  const Model &model = this->models[_index];
+
+  _state.name = model.name;
+  _state.wallTime = this->wallTime;
+  _state.realTime = this->realTime;
+  _state.simTime = this->simTime;
+  _state.iterations = this->iterations;
+  _state.pose = model.pose;
+  _state.scale = model.scale;
+
+  _state.linkStates.clear();
+  for (size_t i = model.firstLink; i < model.firstLink + model.linkCount; ++i)
+  {
+    const Link &link = this->links[i];
+    LinkState &state = _state.linkStates[link.name];
+    state.name = link.name;
+    state.wallTime = this->wallTime;
+    state.realTime = this->realTime;
+    state.simTime = this->simTime;
+    state.iterations = this->iterations;
+    state.pose = link.pose;
+    state.velocity.Set(link.linearVel, link.angularVel);
+    state.acceleration.Set(link.linearAccel, link.angularAccel);
+    state.wrench.Set(link.force, ignition::math::Quaterniond::Identity);
+  }
+
+  _state.modelStates.clear();
+  const size_t end = _index + 1 + model.nestedCount;
+  for (size_t i = _index + 1; i < end; i += this->models[i].nestedCount + 1)
+    this->ToModelState(i, _state.modelStates[this->models[i].name]);
+}
+
+/////////////////////////////////////////////////
+bool LogFrameQueue::Resize(const size_t _capacity)
+{
+  // The consumer only reads the frames once head moves past tail, so they
+  // can be reallocated while the queue is empty. The positions are never
+  // reset: the consumer may be reading them at any time.
+  if (this->Size() != 0)
+    return false;
+
+  this->frames.resize(_capacity);
+  return true;
+}
+
+/////////////////////////////////////////////////
+size_t LogFrameQueue::Capacity() const
+{
+  return this->frames.size();
+}
+
+/////////////////////////////////////////////////
+size_t LogFrameQueue::Size() const
+{
+  return this->head.load(std::memory_order_acquire) -
+      this->tail.load(std::memory_order_acquire);
+}
+
+/////////////////////////////////////////////////
+LogFrame *LogFrameQueue::Back()
+{
+  const uint64_t h = this->head.load(std::memory_order_relaxed);
+  if (this->frames.empty() ||
+      h - this->tail.load(std::memory_order_acquire) >= this->frames.size())
+  {
+    return nullptr;
+  }
+
+  return &this->frames[h % this->frames.size()];
+}
+
+/////////////////////////////////////////////////
+void LogFrameQueue::Push()
+{
+  this->head.fetch_add(1, std::memory_order_release);
+}
+
+/////////////////////////////////////////////////
+LogFrame *LogFrameQueue::Front()
+{
+  const uint64_t t = this->tail.load(std::memory_order_relaxed);
+  if (t == this->head.load(std::memory_order_acquire))
+    return nullptr;
+
+  return &this->frames[t % this->frames.size()];
+}
+
+/////////////////////////////////////////////////
+void LogFrameQueue::Pop()
+{
+  this->tail.fetch_add(1, std::memory_order_release);
+}
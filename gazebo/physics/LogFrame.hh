@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_LOGFRAME_HH_
+#define GAZEBO_PHYSICS_LOGFRAME_HH_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    class WorldState;
+
+    /// \internal
+    /// \brief Raw state of a world, captured on the physics thread and
+    /// turned into a WorldState by the log worker.
+    ///
+    /// A frame is reused from one capture to the next, so that capturing a
+    /// world with the same entities does not allocate memory.
+    class LogFrame
+    {
+      /// \brief Raw state of a link.
+      public: class Link
+      {
+        /// \brief Name of the link.
+        public: std::string name;
+
+        /// \brief World pose.
+        public: ignition::math::Pose3d pose;
+
+        /// \brief World linear velocity.
+        public: ignition::math::Vector3d linearVel;
+
+        /// \brief World angular velocity.
+        public: ignition::math::Vector3d angularVel;
+
+        /// \brief World linear acceleration.
+        public: ignition::math::Vector3d linearAccel;
+
+        /// \brief World angular acceleration.
+        public: ignition::math::Vector3d angularAccel;
+
+        /// \brief World force.
+        public: ignition::math::Vector3d force;
+      };
+
+      /// \brief Raw state of a model. Models are stored depth first, so
+      /// the nested models of a model follow it.
+      public: class Model
+      {
+        /// \brief Name of the model.
+        public: std::string name;
+
+        /// \brief World pose.
+        public: ignition::math::Pose3d pose;
+
+        /// \brief Scale.
+        public: ignition::math::Vector3d scale;
+
+        /// \brief Index of the first link of the model in links.
+        public: size_t firstLink = 0;
+
+        /// \brief Number of links of the model.
+        public: size_t linkCount = 0;
+
+        /// \brief Number of nested models, at any depth.
+        public: size_t nestedCount = 0;
+      };
+
+      /// \brief Raw state of a light.
+      public: class Light
+      {
+        /// \brief Name of the light.
+        public: std::string name;
+
+        /// \brief World pose.
+        public: ignition::math::Pose3d pose;
+      };
+
+      /// \brief Capture the state of a world.
+      /// \param[in] _name Name of the world.
+      /// \param[in] _simTime Simulation time.
+      /// \param[in] _realTime Real time.
+      /// \param[in] _iterations Simulation iterations.
+      /// \param[in] _models Models of the world.
+      /// \param[in] _lights Lights of the world.
+      /// \param[in] _skipSleeping True to record zero velocities,
+      /// accelerations and forces for the links of sleeping models, rather
+      /// than reading them from the physics engine.
+      public: void Capture(const std::string &_name,
+                  const common::Time &_simTime, const common::Time &_realTime,
+                  const uint64_t _iterations, const Model_V &_models,
+                  const Light_V &_lights, const bool _skipSleeping = false);
+
+      /// \brief Fill a world state with the frame. Insertions and deletions
+      /// are not changed.
+      /// \param[out] _state The world state.
+      public: void ToWorldState(WorldState &_state) const;
+
+      /// \brief Capture a model and its nested models.
+      /// \param[in] _model The model.
+      /// \param[in] _sleeping True if the model is sleeping, to record the
+      /// velocities, accelerations and forces of its links as zero.
+      private: void CaptureModel(const ModelPtr &_model, const bool _sleeping);
+
+      /// \brief Fill a model state with a model of the frame.
+      /// \param[in] _index Index of the model in models.
+      /// \param[out] _state The model state.
+      private: void ToModelState(const size_t _index,
+                   ModelState &_state) const;
+
+      /// \brief Name of the world.
+      public: std::string name;
+
+      /// \brief Simulation time.
+      public: common::Time simTime;
+
+      /// \brief Real time.
+      public: common::Time realTime;
+
+      /// \brief Wall time.
+      public: common::Time wallTime;
+
+      /// \brief Simulation iterations.
+      public: uint64_t iterations = 0;
+
+      /// \brief Models, depth first. Only the first modelCount are valid.
+      public: std::vector<Model> models;
+
+      /// \brief Number of valid models.
+      public: size_t modelCount = 0;
+
+      /// \brief Links of all the models. Only the first linkCount are valid.
+      public: std::vector<Link> links;
+
+      /// \brief Number of valid links.
+      public: size_t linkCount = 0;
+
+      /// \brief Lights. Only the first lightCount are valid.
+      public: std::vector<Light> lights;
+
+      /// \brief Number of valid lights.
+      public: size_t lightCount = 0;
+    };
+
+    /// \internal
+    /// \brief Bounded queue of frames between one producer thread and one
+    /// consumer thread. Push and pop are lock free, and the frames are
+    /// allocated once, when the queue is resized.
+    class LogFrameQueue
+    {
+      /// \brief Set the number of frames the queue can hold. Producer
+      /// only, the consumer may keep polling the queue meanwhile.
+      /// \param[in] _capacity Number of frames.
+      /// \return False if the queue is not empty, in which case its
+      /// capacity is not changed.
+      public: bool Resize(const size_t _capacity);
+
+      /// \brief Get the number of frames the queue can hold.
+      /// \return Capacity of the queue.
+      public: size_t Capacity() const;
+
+      /// \brief Get the number of frames in the queue.
+      /// \return Number of frames.
+      public: size_t Size() const;
+
+      /// \brief Get the frame to fill before calling Push. Producer only.
+      /// \return The frame, or nullptr if the queue is full.
+      public: LogFrame *Back();
+
+      /// \brief Add the frame returned by Back to the queue. Producer only.
+      public: void Push();
+
+      /// \brief Get the oldest frame in the queue. Consumer only.
+      /// \return The frame, or nullptr if the queue is empty.
+      public: LogFrame *Front();
+
+      /// \brief Remove the frame returned by Front. Consumer only.
+      public: void Pop();
+
+      /// \brief Storage for the frames.
+      private: std::vector<LogFrame> frames;
+
+      /// \brief Number of frames pushed.
+      private: std::atomic<uint64_t> head{0};
+
+      /// \brief Number of frames popped.
+      private: std::atomic<uint64_t> tail{0};
+    };
+  }
+}
+#endif
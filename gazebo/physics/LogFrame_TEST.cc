@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "gazebo/test/ServerFixture.hh"
+#include "test/util.hh"
+#include "gazebo/physics/LogFrame.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/WorldState.hh"
+
+using namespace gazebo;
+
+class LogFrameTest : public ServerFixture { };
+
+//////////////////////////////////////////////////
+TEST_F(LogFrameTest, Queue)
+{
+  physics::LogFrameQueue queue;
+  EXPECT_EQ(queue.Capacity(), 0u);
+  EXPECT_TRUE(queue.Back() == nullptr);
+  EXPECT_TRUE(queue.Front() == nullptr);
+
+  queue.Resize(2);
+  EXPECT_EQ(queue.Capacity(), 2u);
+  EXPECT_EQ(queue.Size(), 0u);
+
+  // Fill the queue
+  for (uint64_t i = 0; i < 2; ++i)
+  {
+    physics::LogFrame *frame = queue.Back();
+    ASSERT_TRUE(frame != nullptr);
+    frame->iterations = i;
+    queue.Push();
+  }
+  EXPECT_EQ(queue.Size(), 2u);
+  EXPECT_TRUE(queue.Back() == nullptr);
+
+  // Frames come out in order, and free a slot.
+  ASSERT_TRUE(queue.Front() != nullptr);
+  EXPECT_EQ(queue.Front()->iterations, 0u);
+  queue.Pop();
+  EXPECT_TRUE(queue.Back() != nullptr);
+  EXPECT_EQ(queue.Front()->iterations, 1u);
+  queue.Pop();
+  EXPECT_TRUE(queue.Front() == nullptr);
+  EXPECT_EQ(queue.Size(), 0u);
+
+  // Only an empty queue is resized, and it keeps working from where it
+  // was.
+  physics::LogFrame *frame = queue.Back();
+  ASSERT_TRUE(frame != nullptr);
+  frame->iterations = 2;
+  queue.Push();
+  EXPECT_FALSE(queue.Resize(3));
+  EXPECT_EQ(queue.Capacity(), 2u);
+  queue.Pop();
+
+  EXPECT_TRUE(queue.Resize(3));
+  EXPECT_EQ(queue.Capacity(), 3u);
+  EXPECT_EQ(queue.Size(), 0u);
+  EXPECT_TRUE(queue.Front() == nullptr);
+  for (uint64_t i = 0; i < 3; ++i)
+  {
+    frame = queue.Back();
+    ASSERT_TRUE(frame != nullptr);
+    frame->iterations = 10 + i;
+    queue.Push();
+  }
+  EXPECT_TRUE(queue.Back() == nullptr);
+  for (uint64_t i = 0; i < 3; ++i)
+  {
+    ASSERT_TRUE(queue.Front() != nullptr);
+    EXPECT_EQ(queue.Front()->iterations, 10 + i);
+    queue.Pop();
+  }
+  EXPECT_EQ(queue.Size(), 0u);
+}
+
+//////////////////////////////////////////////////
+TEST_F(LogFrameTest, ToWorldState)
+{
+  this->Load("test/worlds/deeply_nested_models.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::LogFrame frame;
+  frame.Capture(world->Name(), world->SimTime(), world->RealTime(),
+      world->Iterations(), world->Models(), world->Lights());
+
+  // Capturing again reuses the frame.
+  frame.Capture(world->Name(), world->SimTime(), world->RealTime(),
+      world->Iterations(), world->Models(), world->Lights());
+  EXPECT_EQ(frame.modelCount, frame.models.size());
+  EXPECT_EQ(frame.linkCount, frame.links.size());
+
+  physics::WorldState state;
+  frame.ToWorldState(state);
+
+  // The state matches a state loaded from the world.
+  physics::WorldState expected(world);
+  EXPECT_EQ(state.GetName(), expected.GetName());
+  EXPECT_EQ(state.GetIterations(), expected.GetIterations());
+  EXPECT_EQ(state.GetModelStateCount(), expected.GetModelStateCount());
+  EXPECT_EQ(state.LightStateCount(), expected.LightStateCount());
+
+  ASSERT_TRUE(state.HasModelState("model_00"));
+  auto model = state.GetModelState("model_00");
+  auto expectedModel = expected.GetModelState("model_00");
+  EXPECT_EQ(model.Pose(), expectedModel.Pose());
+  EXPECT_EQ(model.GetLinkState("link_00").Pose(),
+      expectedModel.GetLinkState("link_00").Pose());
+
+  // Nested models
+  ASSERT_TRUE(model.HasNestedModelState("model_01"));
+  auto nested = model.NestedModelState("model_01");
+  ASSERT_TRUE(nested.HasNestedModelState("model_02"));
+  EXPECT_EQ(nested.NestedModelState("model_02").Pose(),
+      expectedModel.NestedModelState("model_01").NestedModelState(
+        "model_02").Pose());
+
+  // Nothing changed, so the difference is empty.
+  EXPECT_TRUE((state - expected).IsZero());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -150,3 +150,44 @@ void MeshShape::ProcessMsg(const msgs::Geometry &_msg)
       _msg.mesh().has_submesh() ? _msg.mesh().submesh() : std::string(),
       _msg.mesh().has_center_submesh() ? _msg.mesh().center_submesh() :  false);
 }
+
+//////////////////////////////////////////////////
+bool MeshShape::Triangles(std::vector<float> &_vertices,
+    std::vector<int> &_indices) const
+{
+  _vertices.clear();
+  _indices.clear();
+  if (!this->mesh)
+    return false;
+
+  float *vertices = nullptr;
+  int *indices = nullptr;
+  unsigned int vertexCount = 0;
+  unsigned int indexCount = 0;
+  if (this->submesh)
+  {
+    vertexCount = this->submesh->GetVertexCount();
+    indexCount = this->submesh->GetIndexCount();
+    this->submesh->FillArrays(&vertices, &indices);
+  }
+  else
+  {
+    vertexCount = this->mesh->GetVertexCount();
+    indexCount = this->mesh->GetIndexCount();
+    this->mesh->FillArrays(&vertices, &indices);
+  }
+
+  const ignition::math::Vector3d scale = this->Size();
+  _vertices.assign(vertices, vertices + vertexCount * 3);
+  for (unsigned int i = 0; i < vertexCount; ++i)
+  {
+    _vertices[i * 3] *= scale.X();
+    _vertices[i * 3 + 1] *= scale.Y();
+    _vertices[i * 3 + 2] *= scale.Z();
+  }
+  _indices.assign(indices, indices + indexCount);
+
+  delete [] vertices;
+  delete [] indices;
+  return true;
+}
@@ -18,6 +18,7 @@
 #define GAZEBO_PHYSICS_MESHSHAPE_HH_
 
 #include <string>
+#include <vector>
 
 #include "gazebo/common/CommonTypes.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
@@ -78,6 +79,14 @@ namespace gazebo
       /// \param[in] _msg Message that contains triangle mesh info.
       public: virtual void ProcessMsg(const msgs::Geometry &_msg);
 
+      /// \brief Get the triangles of the mesh, or of the submesh if one is
+      /// used, scaled, in the frame of the parent collision.
+      /// \param[out] _vertices Three coordinates per vertex.
+      /// \param[out] _indices Three vertex indices per triangle.
+      /// \return False if no mesh is loaded.
+      public: bool Triangles(std::vector<float> &_vertices,
+                  std::vector<int> &_indices) const;
+
       /// \brief Pointer to the mesh data.
       protected: const common::Mesh *mesh;
 
@@ -305,6 +305,16 @@ void Model::Update()
 
   boost::recursive_mutex::scoped_lock lock(this->updateMutex);
 
+  // The links of a sleeping model don't move, so only the joint controller
+  // is updated, for its commands to wake the model up.
+  if (this->sleeping && this->jointAnimations.empty() &&
+      this->world->SkipSleeping())
+  {
+    if (this->jointController)
+      this->jointController->Update();
+    return;
+  }
+
   for (Joint_V::iterator jiter = this->joints.begin();
        jiter != this->joints.end(); ++jiter)
     (*jiter)->Update();
@@ -862,6 +872,15 @@ const Joint_V &Model::GetJoints() const
 //////////////////////////////////////////////////
 JointPtr Model::GetJoint(const std::string &_name)
 {
+  // Scoped names are found through the index of the world.
+  if (this->world && _name.find("::") != std::string::npos)
+  {
+    JointPtr joint = boost::dynamic_pointer_cast<Joint>(
+        this->world->_IndexedEntity(_name));
+    if (joint && joint->GetParent().get() == this)
+      return joint;
+  }
+
   JointPtr result;
   Joint_V::iterator iter;
 
@@ -924,6 +943,16 @@ LinkPtr Model::GetLink(const std::string &_name) const
   }
   else
   {
+    // Scoped names are found through the index of the world.
+    if (this->world && _name.find("::") != std::string::npos)
+    {
+      result = boost::dynamic_pointer_cast<Link>(
+          this->world->_IndexedEntity(_name));
+      if (result && result->GetParent().get() == this)
+        return result;
+      result.reset();
+    }
+
     for (iter = this->links.begin(); iter != this->links.end(); ++iter)
     {
       if (((*iter)->GetScopedName() == _name) || ((*iter)->GetName() == _name))
@@ -966,6 +995,7 @@ void Model::LoadJoint(sdf::ElementPtr _sdf)
   }
 
   this->joints.push_back(joint);
+  this->GetWorld()->_DirtyModelUpdateGroups();
 
   if (!this->jointController)
     this->jointController.reset(new JointController(
@@ -1447,6 +1477,18 @@ bool Model::GetAutoDisable() const
   return this->sdf->Get<bool>("allow_auto_disable");
 }
 
+/////////////////////////////////////////////////
+bool Model::IsSleeping() const
+{
+  return this->sleeping;
+}
+
+/////////////////////////////////////////////////
+void Model::_SetSleeping(const bool _sleeping)
+{
+  this->sleeping = _sleeping;
+}
+
 /////////////////////////////////////////////////
 void Model::SetSelfCollide(bool _self_collide)
 {
@@ -1550,6 +1592,7 @@ gazebo::physics::JointPtr Model::CreateJoint(
   // need to call Joint::Load to clone Joint::sdfJoint into Joint::sdf
   joint->Load(_parent, _child, ignition::math::Pose3d::Zero);
   this->joints.push_back(joint);
+  this->world->_DirtyModelUpdateGroups();
   return joint;
 }
 
@@ -1603,6 +1646,7 @@ bool Model::RemoveJoint(const std::string &_name)
     this->joints.erase(
       std::remove(this->joints.begin(), this->joints.end(), joint),
       this->joints.end());
+    this->world->_DirtyModelUpdateGroups();
     this->world->SetPaused(paused);
     return true;
   }
@@ -17,6 +17,7 @@
 #ifndef GAZEBO_PHYSICS_MODEL_HH_
 #define GAZEBO_PHYSICS_MODEL_HH_
 
+#include <atomic>
 #include <string>
 #include <map>
 #include <mutex>
@@ -345,6 +346,21 @@ namespace gazebo
       /// \return True if auto disable is allowed for this model.
       public: bool GetAutoDisable() const;
 
+      /// \brief Get whether the physics engine put all the links of this
+      /// model, and of its nested models, to sleep. Only top level models
+      /// are set, on each world update. Only engines that deactivate bodies
+      /// put links to sleep: ODE, and Bullet while the world skips sleeping
+      /// models.
+      /// \return True if the model is sleeping.
+      /// \sa World::SetSkipSleeping
+      public: bool IsSleeping() const;
+
+      /// \internal
+      /// \brief Set whether all the links of this model are sleeping. Only
+      /// the World should call this function.
+      /// \param[in] _sleeping True if the model is sleeping.
+      public: void _SetSleeping(const bool _sleeping);
+
       /// \brief Load all plugins
       ///
       /// Load all plugins specified in the SDF for the model.
@@ -525,6 +541,9 @@ namespace gazebo
       /// \brief Mutex used during the update cycle.
       private: mutable boost::recursive_mutex updateMutex;
 
+      /// \brief True if all the links of this model are sleeping.
+      private: std::atomic<bool> sleeping{false};
+
       /// \brief Mutex to protect incoming message buffers.
       private: std::mutex receiveMutex;
     };
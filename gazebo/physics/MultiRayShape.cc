@@ -23,6 +23,7 @@
 #include "gazebo/common/Exception.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/MultiRayShape.hh"
+#include "gazebo/physics/World.hh"
 
 using namespace gazebo;
 using namespace physics;
@@ -195,6 +196,52 @@ void MultiRayShape::Update()
   this->newLaserScans();
 }
 
+//////////////////////////////////////////////////
+bool MultiRayShape::CastSnapshotRays()
+{
+  WorldPtr world = this->GetWorld();
+  if (!this->collisionParent || !world)
+    return false;
+
+  world->EnableRaySnapshots();
+  std::shared_ptr<const RaycastSnapshot> snapshot = world->RaySnapshot();
+  if (!snapshot || !snapshot->Complete() ||
+      snapshot->EntityVersion() != world->_EntityVersion())
+  {
+    return false;
+  }
+
+  // The world may have stepped once since the snapshot was built, and not
+  // yet built the next one.
+  const uint64_t iterations = world->Iterations();
+  if (iterations < snapshot->Iterations() ||
+      iterations > snapshot->Iterations() + 1)
+  {
+    return false;
+  }
+
+  const size_t rayCount = this->rays.size();
+  this->rayStarts.resize(rayCount);
+  this->rayEnds.resize(rayCount);
+  for (size_t i = 0; i < rayCount; ++i)
+    this->rays[i]->GlobalPoints(this->rayStarts[i], this->rayEnds[i]);
+
+  snapshot->CastRays(this->rayStarts, this->rayEnds, this->rayHits);
+
+  for (size_t i = 0; i < rayCount; ++i)
+  {
+    const RaycastHit &hit = this->rayHits[i];
+    if (hit.collision >= 0 && hit.distance < this->rays[i]->GetLength())
+    {
+      this->rays[i]->SetLength(hit.distance);
+      this->rays[i]->SetRetro(snapshot->LaserRetro(hit.collision));
+      this->rays[i]->SetCollisionName(
+          snapshot->CollisionName(hit.collision));
+    }
+  }
+  return true;
+}
+
 //////////////////////////////////////////////////
 bool MultiRayShape::SetRay(const unsigned int _rayIndex,
     const ignition::math::Vector3d &_start,
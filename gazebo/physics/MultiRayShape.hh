@@ -23,6 +23,7 @@
 
 #include "gazebo/physics/Collision.hh"
 #include "gazebo/physics/Shape.hh"
+#include "gazebo/physics/RaycastSnapshot.hh"
 #include "gazebo/physics/RayShape.hh"
 #include "gazebo/util/system.hh"
 
@@ -179,6 +180,16 @@ namespace gazebo
       /// \sa RayCount()
       public: RayShapePtr Ray(const unsigned int _rayIndex) const;
 
+      /// \brief Cast the rays against the latest RaycastSnapshot of the
+      /// world, without locking the physics engine, and set their lengths,
+      /// retro values and hit collisions. Physics engines call this from
+      /// UpdateRays, and cast the rays themselves if it returns false. The
+      /// first call enables the snapshots of the world.
+      /// \return False if the shape has no parent collision, or if the
+      /// snapshot is missing, incomplete or older than the last update.
+      /// \sa World::RaySnapshot
+      protected: bool CastSnapshotRays();
+
       /// \brief Ray data
       protected: std::vector<RayShapePtr> rays;
 
@@ -208,6 +219,15 @@ namespace gazebo
 
       /// \brief Max range of a ray
       private: double maxRange = 1000;
+
+      /// \brief Start points of the rays cast by CastSnapshotRays.
+      private: std::vector<ignition::math::Vector3d> rayStarts;
+
+      /// \brief End points of the rays cast by CastSnapshotRays.
+      private: std::vector<ignition::math::Vector3d> rayEnds;
+
+      /// \brief Hits of the rays cast by CastSnapshotRays.
+      private: std::vector<RaycastHit> rayHits;
     };
     /// \}
   }
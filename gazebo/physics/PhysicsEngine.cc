@@ -302,6 +302,41 @@ bool PhysicsEngine::GetParam(const std::string &_key,
   return true;
 }
 
+//////////////////////////////////////////////////
+void PhysicsEngine::SaveInternalState(std::vector<double> &_state) const
+{
+  _state.clear();
+}
+
+//////////////////////////////////////////////////
+bool PhysicsEngine::RestoreInternalState(const std::vector<double> &_state)
+{
+  return _state.empty();
+}
+
+//////////////////////////////////////////////////
+bool PhysicsEngine::SetWorkerThreads(const int _threads,
+    const std::string &_name, unsigned int &_count,
+    std::unique_ptr<tbb::task_arena> &_arena)
+{
+  if (_threads < 0)
+  {
+    gzerr << "Invalid number of " << _name << "[" << _threads
+          << "], must be zero or positive\n";
+    return false;
+  }
+
+  // Don't swap the workers in the middle of an update.
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  _count = static_cast<unsigned int>(_threads);
+  if (_threads > 0)
+    _arena.reset(new tbb::task_arena(_threads));
+  else
+    _arena.reset();
+  return true;
+}
+
 //////////////////////////////////////////////////
 ContactManager *PhysicsEngine::GetContactManager() const
 {
@@ -18,8 +18,11 @@
 #define _PHYSICSENGINE_HH_
 
 #include <boost/thread/recursive_mutex.hpp>
+#include <memory>
 #include <string>
+#include <vector>
 #include <ignition/transport/Node.hh>
+#include <tbb/task_arena.h>
 
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/msgs/msgs.hh"
@@ -237,6 +240,21 @@ namespace gazebo
       /// \brief Debug print out of the physic engine state.
       public: virtual void DebugPrint() const = 0;
 
+      /// \brief Save the state of the engine that is not held by links and
+      /// joints, such as the warm start of the solver. Used by
+      /// World::SaveSnapshot. The default engine has no such state.
+      /// \param[out] _state Engine specific values.
+      public: virtual void SaveInternalState(std::vector<double> &_state)
+              const;
+
+      /// \brief Restore a state saved by SaveInternalState. This is called
+      /// after the links and joints of the world are restored.
+      /// \param[in] _state Engine specific values.
+      /// \return False if the state does not match the entities of the
+      /// world, in which case the engine state is left as is.
+      public: virtual bool RestoreInternalState(
+                  const std::vector<double> &_state);
+
       /// \brief Get a pointer to the world.
       /// \return Pointer to the world.
       public: WorldPtr World() const;
@@ -262,6 +280,19 @@ namespace gazebo
       /// \param[in] _msg Physics message.
       protected: virtual void OnPhysicsMsg(ConstPhysicsPtr &_msg);
 
+      /// \brief Set the number of workers of a parallel part of the
+      /// update. The workers are replaced under the physics update mutex,
+      /// so never while they run.
+      /// \param[in] _threads Number of threads, zero to run serially.
+      /// \param[in] _name Name of the threads, used in errors.
+      /// \param[out] _count Set to the number of threads.
+      /// \param[out] _arena Set to the workers, null if _threads is zero.
+      /// \return False if _threads is negative, in which case nothing is
+      /// changed.
+      protected: bool SetWorkerThreads(const int _threads,
+                     const std::string &_name, unsigned int &_count,
+                     std::unique_ptr<tbb::task_arena> &_arena);
+
       /// \brief Pointer to the world.
       protected: WorldPtr world;
 
@@ -15,6 +15,8 @@
  *
 */
 
+#include <sstream>
+
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/test/helper_physics_generator.hh"
 #include "gazebo/msgs/msgs.hh"
@@ -27,6 +29,7 @@ class PhysicsEngineTest : public ServerFixture,
   public: void OnPhysicsMsgResponse(ConstResponsePtr &_msg);
   public: void PhysicsEngineParam(const std::string &_physicsEngine);
   public: void PhysicsEngineGetParamBool(const std::string &_physicsEngine);
+  public: void PoseSync(const std::string &_physicsEngine);
   public: static msgs::Physics physicsPubMsg;
   public: static msgs::Physics physicsResponseMsg;
 };
@@ -224,6 +227,93 @@ TEST_P(PhysicsEngineTest, PhysicsEngineGetParamBool)
   PhysicsEngineGetParamBool(GetParam());
 }
 
+/////////////////////////////////////////////////
+void PhysicsEngineTest::PoseSync(const std::string &_physicsEngine)
+{
+  if (_physicsEngine == "ode" || _physicsEngine == "bullet")
+  {
+    gzwarn << "Pose sync parameters not implemented for " << _physicsEngine
+           << std::endl;
+    return;
+  }
+
+  Load("worlds/empty.world", true, _physicsEngine);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  EXPECT_EQ(boost::any_cast<int>(physics->GetParam("pose_sync_threads")), 0);
+  EXPECT_FALSE(boost::any_cast<bool>(
+        physics->GetParam("pose_sync_moved_only")));
+
+  EXPECT_FALSE(physics->SetParam("pose_sync_threads", -1));
+  EXPECT_EQ(boost::any_cast<int>(physics->GetParam("pose_sync_threads")), 0);
+
+  // More falling boxes than the poses synced on a single thread.
+  const double z = 10;
+  for (int i = 0; i < 9; ++i)
+  {
+    for (int j = 0; j < 9; ++j)
+    {
+      std::ostringstream name;
+      name << "box_" << i << "_" << j;
+      SpawnBox(name.str(), ignition::math::Vector3d::One,
+          ignition::math::Vector3d(i * 2.0, j * 2.0, z));
+    }
+  }
+  SpawnBox("static_box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(-5, 0, 0.5), ignition::math::Vector3d::Zero,
+      true);
+
+  EXPECT_TRUE(physics->SetParam("pose_sync_threads", 4));
+  EXPECT_TRUE(physics->SetParam("pose_sync_moved_only", true));
+  EXPECT_EQ(boost::any_cast<int>(physics->GetParam("pose_sync_threads")), 4);
+  EXPECT_TRUE(boost::any_cast<bool>(
+        physics->GetParam("pose_sync_moved_only")));
+
+  world->Step(100);
+
+  // Every box falls the same distance.
+  physics::ModelPtr first = world->ModelByName("box_0_0");
+  ASSERT_TRUE(first != NULL);
+  const double fallenZ = first->WorldPose().Pos().Z();
+  EXPECT_LT(fallenZ, z - 0.01);
+  for (int i = 0; i < 9; ++i)
+  {
+    for (int j = 0; j < 9; ++j)
+    {
+      std::ostringstream name;
+      name << "box_" << i << "_" << j;
+      physics::ModelPtr model = world->ModelByName(name.str());
+      ASSERT_TRUE(model != NULL);
+      EXPECT_DOUBLE_EQ(model->WorldPose().Pos().Z(), fallenZ) << name.str();
+      EXPECT_NEAR(model->GetLink()->WorldPose().Pos().X(), i * 2.0, 1e-6);
+    }
+  }
+
+  physics::ModelPtr staticBox = world->ModelByName("static_box");
+  ASSERT_TRUE(staticBox != NULL);
+  EXPECT_EQ(staticBox->WorldPose(),
+      ignition::math::Pose3d(-5, 0, 0.5, 0, 0, 0));
+
+  // A model spawned later is synced too.
+  SpawnBox("late_box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(-10, 0, z));
+  world->Step(100);
+  physics::ModelPtr late = world->ModelByName("late_box");
+  ASSERT_TRUE(late != NULL);
+  EXPECT_LT(late->WorldPose().Pos().Z(), z - 0.01);
+
+  EXPECT_TRUE(physics->SetParam("pose_sync_threads", 0));
+  EXPECT_EQ(boost::any_cast<int>(physics->GetParam("pose_sync_threads")), 0);
+}
+
+/////////////////////////////////////////////////
+TEST_P(PhysicsEngineTest, PoseSync)
+{
+  PoseSync(GetParam());
+}
+
 INSTANTIATE_TEST_CASE_P(PhysicsEngines, PhysicsEngineTest,
                         PHYSICS_ENGINE_VALUES);
 
@@ -70,6 +70,7 @@ namespace gazebo
     class LightState;
     class LinkState;
     class JointState;
+    class WorldSnapshot;
     class TrajectoryInfo;
 
     /// \def BasePtr
@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "gazebo/transport/Publisher.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/PosePublisher.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Compare two poses exactly. The comparison operators of
+/// ignition::math have a tolerance, which would hide slow motions.
+/// \param[in] _a A pose.
+/// \param[in] _b Another pose.
+/// \return True if all the components of the poses are equal.
+static bool SamePose(const ignition::math::Pose3d &_a,
+    const ignition::math::Pose3d &_b)
+{
+  return _a.Pos().X() == _b.Pos().X() && _a.Pos().Y() == _b.Pos().Y() &&
+      _a.Pos().Z() == _b.Pos().Z() && _a.Rot().W() == _b.Rot().W() &&
+      _a.Rot().X() == _b.Rot().X() && _a.Rot().Y() == _b.Rot().Y() &&
+      _a.Rot().Z() == _b.Rot().Z();
+}
+
+/////////////////////////////////////////////////
+void PosePublisher::AddChannel(transport::PublisherPtr _pub,
+    const double _rate, const bool _always)
+{
+  if (!_pub)
+    return;
+
+  Channel channel;
+  channel.pub = _pub;
+  channel.topic = _pub->GetTopic();
+  channel.rate = _rate;
+  channel.always = _always;
+  channel.pending.assign(this->entries.size(), 0);
+  this->channels.push_back(std::move(channel));
+}
+
+/////////////////////////////////////////////////
+size_t PosePublisher::FindChannel(const std::string &_topic) const
+{
+  // "~/pose/info" matches "/gazebo/default/pose/info"
+  std::string suffix;
+  if (!_topic.empty() && _topic[0] == '~')
+    suffix = _topic.substr(1);
+
+  size_t i = 0;
+  for (; i < this->channels.size(); ++i)
+  {
+    const std::string &topic = this->channels[i].topic;
+    if (topic == _topic || (!suffix.empty() && topic.size() > suffix.size() &&
+          topic.compare(topic.size() - suffix.size(), suffix.size(),
+            suffix) == 0))
+    {
+      break;
+    }
+  }
+  return i;
+}
+
+/////////////////////////////////////////////////
+bool PosePublisher::SetRate(const std::string &_topic, const double _rate)
+{
+  size_t i = this->FindChannel(_topic);
+  if (i >= this->channels.size() || _rate < 0)
+    return false;
+
+  this->channels[i].rate = _rate;
+  return true;
+}
+
+/////////////////////////////////////////////////
+double PosePublisher::Rate(const std::string &_topic) const
+{
+  size_t i = this->FindChannel(_topic);
+  if (i >= this->channels.size())
+    return -1;
+
+  return this->channels[i].rate;
+}
+
+/////////////////////////////////////////////////
+void PosePublisher::Publish(const common::Time &_simTime,
+    const std::set<ModelPtr> &_models, const uint64_t _version)
+{
+  bool connected = false;
+  for (auto &channel : this->channels)
+  {
+    // New subscribers receive all the poses of the models that moved.
+    const bool hasConnections = channel.pub->HasConnections();
+    channel.resync = hasConnections && !channel.connected;
+    channel.connected = hasConnections;
+    if (!channel.connected)
+    {
+      // No one to send the changes to.
+      for (auto const &i : channel.pendingList)
+        channel.pending[i] = 0;
+      channel.pendingList.clear();
+      channel.prevTime = common::Time::Zero;
+    }
+    connected = connected || channel.connected;
+  }
+
+  if (!connected)
+    return;
+
+  if (_version != this->version)
+  {
+    this->ResetLayout();
+    this->version = _version;
+  }
+
+  for (auto const &model : _models)
+  {
+    auto range = this->ranges.find(model->GetId());
+    if (range == this->ranges.end())
+    {
+      this->AddModel(model);
+      range = this->ranges.find(model->GetId());
+    }
+
+    for (size_t i = range->second.first; i < range->second.second; ++i)
+    {
+      Entry &entry = this->entries[i];
+      const ignition::math::Pose3d pose = entry.entity->RelativePose();
+      const bool changed = !entry.valid || !SamePose(pose, entry.pose);
+      entry.pose = pose;
+      entry.valid = true;
+
+      for (auto &channel : this->channels)
+      {
+        if ((changed || channel.resync) && channel.connected &&
+            !channel.pending[i])
+        {
+          channel.pending[i] = 1;
+          channel.pendingList.push_back(i);
+        }
+      }
+    }
+  }
+
+  for (auto &channel : this->channels)
+  {
+    if (!channel.connected || (channel.pendingList.empty() && !channel.always))
+      continue;
+
+    if (channel.rate > 0)
+    {
+      common::Time wallTime = common::Time::GetWallTime();
+      if (channel.prevTime != common::Time::Zero &&
+          (wallTime - channel.prevTime).Double() < 1.0 / channel.rate)
+      {
+        continue;
+      }
+      channel.prevTime = wallTime;
+    }
+
+    // Clearing keeps the poses allocated, to be reused.
+    channel.msg.mutable_pose()->Clear();
+    msgs::Set(channel.msg.mutable_time(), _simTime);
+
+    for (auto const &i : channel.pendingList)
+    {
+      const Entry &entry = this->entries[i];
+      msgs::Pose *poseMsg = channel.msg.add_pose();
+      poseMsg->set_name(entry.name);
+      poseMsg->set_id(entry.id);
+      msgs::Set(poseMsg, entry.pose);
+      channel.pending[i] = 0;
+    }
+    channel.pendingList.clear();
+
+    channel.pub->Publish(channel.msg);
+  }
+}
+
+/////////////////////////////////////////////////
+void PosePublisher::Clear()
+{
+  this->channels.clear();
+  this->entries.clear();
+  this->ranges.clear();
+}
+
+/////////////////////////////////////////////////
+void PosePublisher::ResetLayout()
+{
+  std::vector<size_t> index(this->entries.size(), this->entries.size());
+  std::vector<Entry> kept;
+  for (auto const &channel : this->channels)
+  {
+    for (auto const &i : channel.pendingList)
+    {
+      if (index[i] == this->entries.size())
+      {
+        index[i] = kept.size();
+        kept.push_back(this->entries[i]);
+        kept.back().entity = nullptr;
+      }
+    }
+  }
+
+  for (auto &channel : this->channels)
+  {
+    channel.pending.assign(kept.size(), 0);
+    for (auto &i : channel.pendingList)
+    {
+      i = index[i];
+      channel.pending[i] = 1;
+    }
+  }
+
+  this->entries.swap(kept);
+  this->ranges.clear();
+}
+
+/////////////////////////////////////////////////
+void PosePublisher::AddModel(const ModelPtr &_model)
+{
+  const size_t first = this->entries.size();
+
+  Entry entry;
+  entry.entity = _model.get();
+  entry.id = _model->GetId();
+  entry.name = _model->GetScopedName();
+  this->entries.push_back(entry);
+
+  for (auto const &link : _model->GetLinks())
+  {
+    entry.entity = link.get();
+    entry.id = link->GetId();
+    entry.name = link->GetScopedName();
+    this->entries.push_back(entry);
+  }
+
+  for (auto const &nested : _model->NestedModels())
+    this->AddModel(nested);
+
+  this->ranges[_model->GetId()] = std::make_pair(first, this->entries.size());
+
+  for (auto &channel : this->channels)
+    channel.pending.resize(this->entries.size(), 0);
+}
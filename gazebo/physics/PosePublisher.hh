@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_POSEPUBLISHER_HH_
+#define GAZEBO_PHYSICS_POSEPUBLISHER_HH_
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/transport/TransportTypes.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Publishes the relative poses of models, and of their links and
+    /// nested models, as msgs::PosesStamped.
+    ///
+    /// The entries of the messages are laid out when a model first moves,
+    /// and are reused until entities are added, removed or renamed. Only
+    /// the entries whose pose changed since they were last published are
+    /// sent. Each channel has its own rate, and accumulates the changes
+    /// between two of its messages, so that a channel with a low rate still
+    /// receives the latest pose of every entity that moved. Each subscriber
+    /// can ask for a lower rate with transport::SubscribeOptions::SetMaxRate,
+    /// the transport then merges the messages it holds back by pose id.
+    class PosePublisher
+    {
+      /// \brief Add a channel.
+      /// \param[in] _pub Publisher of msgs::PosesStamped.
+      /// \param[in] _rate Maximum number of messages per second of wall
+      /// time, 0 to publish on every update.
+      /// \param[in] _always True to publish on every update even if no pose
+      /// changed, for subscribers that rely on the time stamp.
+      public: void AddChannel(transport::PublisherPtr _pub, const double _rate,
+                  const bool _always);
+
+      /// \brief Set the rate of a channel.
+      /// \param[in] _topic Topic of the channel, as advertised or fully
+      /// scoped.
+      /// \param[in] _rate Maximum number of messages per second of wall
+      /// time, 0 to publish on every update.
+      /// \return False if no channel publishes on the topic.
+      public: bool SetRate(const std::string &_topic, const double _rate);
+
+      /// \brief Get the rate of a channel.
+      /// \param[in] _topic Topic of the channel, as advertised or fully
+      /// scoped.
+      /// \return The rate, or -1 if no channel publishes on the topic.
+      public: double Rate(const std::string &_topic) const;
+
+      /// \brief Publish the poses that changed.
+      /// \param[in] _simTime Time stamp of the messages.
+      /// \param[in] _models Models that may have moved since the last update.
+      /// \param[in] _version Version of the entities of the world. The
+      /// layout is discarded when it changes.
+      public: void Publish(const common::Time &_simTime,
+                  const std::set<ModelPtr> &_models, const uint64_t _version);
+
+      /// \brief Remove the channels and the layout.
+      public: void Clear();
+
+      /// \brief An entry of the layout.
+      private: class Entry
+      {
+        /// \brief The entity, nullptr once the layout is discarded.
+        public: Entity *entity = nullptr;
+
+        /// \brief Id of the entity.
+        public: uint32_t id = 0;
+
+        /// \brief Scoped name of the entity.
+        public: std::string name;
+
+        /// \brief Last relative pose of the entity.
+        public: ignition::math::Pose3d pose;
+
+        /// \brief True once pose is set.
+        public: bool valid = false;
+      };
+
+      /// \brief A publisher and the entries it has yet to publish.
+      private: class Channel
+      {
+        /// \brief The publisher.
+        public: transport::PublisherPtr pub;
+
+        /// \brief Fully scoped topic.
+        public: std::string topic;
+
+        /// \brief Maximum number of messages per second, 0 for no limit.
+        public: double rate = 0;
+
+        /// \brief Publish on every update even if no pose changed.
+        public: bool always = false;
+
+        /// \brief Wall time of the last message.
+        public: common::Time prevTime;
+
+        /// \brief Whether the publisher had connections on the last update.
+        public: bool connected = false;
+
+        /// \brief True on the first update with connections, to publish
+        /// the poses that did not change.
+        public: bool resync = false;
+
+        /// \brief Flag per entry, set if the entry is in pendingList.
+        public: std::vector<uint8_t> pending;
+
+        /// \brief Indices of the entries to publish.
+        public: std::vector<size_t> pendingList;
+
+        /// \brief Message reused from one publication to the next.
+        public: msgs::PosesStamped msg;
+      };
+
+      /// \brief Discard the layout. Entries still to be published are kept,
+      /// without their entity.
+      private: void ResetLayout();
+
+      /// \brief Add a model, its links and its nested models to the layout,
+      /// depth first.
+      /// \param[in] _model The model.
+      private: void AddModel(const ModelPtr &_model);
+
+      /// \brief Find a channel.
+      /// \param[in] _topic Topic of the channel, as advertised or fully
+      /// scoped.
+      /// \return Index of the channel, or channels.size() if not found.
+      private: size_t FindChannel(const std::string &_topic) const;
+
+      /// \brief Entries of the layout.
+      private: std::vector<Entry> entries;
+
+      /// \brief Range of entries of each model in the layout, by model id.
+      private: std::unordered_map<uint32_t, std::pair<size_t, size_t>>
+               ranges;
+
+      /// \brief Version of the entities the layout was built for.
+      private: uint64_t version = 0;
+
+      /// \brief The channels.
+      private: std::vector<Channel> channels;
+    };
+  }
+}
+#endif
@@ -164,6 +164,10 @@ namespace gazebo
       /// \brief ODEMultiRayShape needs to call SetCollisionName when it is
       /// updated
       protected: friend class ODEMultiRayShape;
+
+      /// \brief MultiRayShape needs to call SetCollisionName when it casts
+      /// its rays against a RaycastSnapshot
+      protected: friend class MultiRayShape;
     };
     /// \}
   }
@@ -0,0 +1,887 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+#include <unordered_map>
+
+#include "gazebo/physics/BoxShape.hh"
+#include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/CylinderShape.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/MeshShape.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/PlaneShape.hh"
+#include "gazebo/physics/SphereShape.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/RaycastSnapshotPrivate.hh"
+#include "gazebo/physics/RaycastSnapshot.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Maximum number of items in a leaf of a hierarchy.
+static const uint32_t kRaycastLeafSize = 4;
+
+/// \brief Number of builds after which the shapes are read again.
+static const unsigned int kRaycastShapeRefresh = 500;
+
+/// \brief Maximum depth of a hierarchy. Nodes are split at the median, so
+/// the depth grows with the logarithm of the number of items.
+static const int kRaycastMaxDepth = 64;
+
+/// \brief Directions smaller than this are parallel to an axis or a plane.
+static const double kRaycastEpsilon = 1e-12;
+
+/// \brief Used instead of the inverse of a zero component of a direction,
+/// finite so that slab tests do not produce NaNs.
+static const double kRaycastHuge = 1e300;
+
+/// \brief Dot product of two arrays of 3 values.
+/// \param[in] _a First array.
+/// \param[in] _b Second array.
+/// \return The dot product.
+static inline double Dot(const double *_a, const double *_b)
+{
+  return _a[0] * _b[0] + _a[1] * _b[1] + _a[2] * _b[2];
+}
+
+/// \brief Cross product of two arrays of 3 values.
+/// \param[in] _a First array.
+/// \param[in] _b Second array.
+/// \param[out] _out The cross product.
+static inline void Cross(const double *_a, const double *_b, double *_out)
+{
+  _out[0] = _a[1] * _b[2] - _a[2] * _b[1];
+  _out[1] = _a[2] * _b[0] - _a[0] * _b[2];
+  _out[2] = _a[0] * _b[1] - _a[1] * _b[0];
+}
+
+/// \brief Compute the inverse of a direction, for slab tests.
+/// \param[in] _dir The direction.
+/// \param[out] _inv Inverse of each component.
+static inline void InverseDirection(const double *_dir, double *_inv)
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    _inv[i] = std::abs(_dir[i]) > kRaycastEpsilon ? 1.0 / _dir[i] :
+      std::copysign(kRaycastHuge, _dir[i]);
+  }
+}
+
+/// \brief Test a ray against the bounding box of a node.
+/// \param[in] _node The node.
+/// \param[in] _origin Origin of the ray.
+/// \param[in] _inv Inverse direction of the ray.
+/// \param[in] _tMax Length of the ray.
+/// \return True if the ray overlaps the box.
+static inline bool SlabHit(const RaycastBvhNode &_node, const double *_origin,
+    const double *_inv, const double _tMax)
+{
+  double tNear = 0;
+  double tFar = _tMax;
+  for (int i = 0; i < 3; ++i)
+  {
+    double t1 = (_node.min[i] - _origin[i]) * _inv[i];
+    double t2 = (_node.max[i] - _origin[i]) * _inv[i];
+    if (t1 > t2)
+      std::swap(t1, t2);
+    tNear = std::max(tNear, t1);
+    tFar = std::min(tFar, t2);
+    if (tNear > tFar)
+      return false;
+  }
+  return true;
+}
+
+/// \brief Visit the items of a hierarchy whose bounding boxes a ray
+/// overlaps, nearest nodes first.
+/// \param[in] _bvh The hierarchy.
+/// \param[in] _origin Origin of the ray.
+/// \param[in] _dir Direction of the ray.
+/// \param[in] _inv Inverse direction of the ray.
+/// \param[in] _tMax Length of the ray, lowered by _visit as hits are found.
+/// \param[in] _visit Called with each item.
+template<typename Visit>
+static void Traverse(const RaycastBvh &_bvh, const double *_origin,
+    const double *_dir, const double *_inv, const double &_tMax,
+    Visit _visit)
+{
+  if (_bvh.nodes.empty())
+    return;
+
+  uint32_t stack[kRaycastMaxDepth];
+  int top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+  {
+    const uint32_t index = stack[--top];
+    const RaycastBvhNode &node = _bvh.nodes[index];
+    if (!SlabHit(node, _origin, _inv, _tMax))
+      continue;
+
+    if (node.count > 0)
+    {
+      for (uint32_t i = node.offset; i < node.offset + node.count; ++i)
+        _visit(_bvh.items[i]);
+    }
+    else if (_dir[node.axis] < 0)
+    {
+      stack[top++] = index + 1;
+      stack[top++] = node.offset;
+    }
+    else
+    {
+      stack[top++] = node.offset;
+      stack[top++] = index + 1;
+    }
+  }
+}
+
+/// \brief Build a node of a hierarchy, and its children.
+/// \param[in] _bounds Bounding boxes of the items.
+/// \param[in] _begin First item of the node.
+/// \param[in] _end One past the last item of the node.
+/// \param[in,out] _bvh The hierarchy.
+/// \return Index of the node.
+static uint32_t BuildNode(const std::vector<double> &_bounds,
+    const uint32_t _begin, const uint32_t _end, RaycastBvh &_bvh)
+{
+  const uint32_t index = static_cast<uint32_t>(_bvh.nodes.size());
+  _bvh.nodes.emplace_back();
+
+  RaycastBvhNode node;
+  double centerMin[3];
+  double centerMax[3];
+  for (int k = 0; k < 3; ++k)
+  {
+    node.min[k] = centerMin[k] = std::numeric_limits<double>::max();
+    node.max[k] = centerMax[k] = -std::numeric_limits<double>::max();
+  }
+  for (uint32_t i = _begin; i < _end; ++i)
+  {
+    const double *bounds = &_bounds[_bvh.items[i] * 6];
+    for (int k = 0; k < 3; ++k)
+    {
+      node.min[k] = std::min(node.min[k], bounds[k]);
+      node.max[k] = std::max(node.max[k], bounds[k + 3]);
+      const double center = bounds[k] + bounds[k + 3];
+      centerMin[k] = std::min(centerMin[k], center);
+      centerMax[k] = std::max(centerMax[k], center);
+    }
+  }
+
+  if (_end - _begin <= kRaycastLeafSize)
+  {
+    node.offset = _begin;
+    node.count = _end - _begin;
+    _bvh.nodes[index] = node;
+    return index;
+  }
+
+  // Split at the median of the centers, along the axis they spread most.
+  for (uint32_t k = 1; k < 3; ++k)
+  {
+    if (centerMax[k] - centerMin[k] >
+        centerMax[node.axis] - centerMin[node.axis])
+    {
+      node.axis = k;
+    }
+  }
+  const uint32_t axis = node.axis;
+  const uint32_t middle = _begin + (_end - _begin) / 2;
+  std::nth_element(_bvh.items.begin() + _begin,
+      _bvh.items.begin() + middle, _bvh.items.begin() + _end,
+      [&_bounds, axis](const uint32_t _a, const uint32_t _b)
+      {
+        return _bounds[_a * 6 + axis] + _bounds[_a * 6 + axis + 3] <
+               _bounds[_b * 6 + axis] + _bounds[_b * 6 + axis + 3];
+      });
+
+  BuildNode(_bounds, _begin, middle, _bvh);
+  node.offset = BuildNode(_bounds, middle, _end, _bvh);
+  _bvh.nodes[index] = node;
+  return index;
+}
+
+//////////////////////////////////////////////////
+void RaycastBvh::Build(const std::vector<double> &_bounds,
+    const std::vector<uint32_t> &_items)
+{
+  this->nodes.clear();
+  this->items = _items;
+  if (this->items.empty())
+    return;
+
+  this->nodes.reserve(2 * this->items.size() / kRaycastLeafSize + 1);
+  BuildNode(_bounds, 0, static_cast<uint32_t>(this->items.size()), *this);
+}
+
+/// \brief Intersect a ray with a box centered on the origin.
+/// \param[in] _o Origin of the ray, in the frame of the box.
+/// \param[in] _d Unit direction of the ray, in the frame of the box.
+/// \param[in] _half Half size of the box.
+/// \param[out] _t Distance to the hit.
+/// \return True if the ray hits the box.
+static bool HitBox(const double *_o, const double *_d,
+    const ignition::math::Vector3d &_half, double &_t)
+{
+  double tNear = -std::numeric_limits<double>::max();
+  double tFar = std::numeric_limits<double>::max();
+  for (int i = 0; i < 3; ++i)
+  {
+    const double half = _half[i];
+    if (std::abs(_d[i]) < kRaycastEpsilon)
+    {
+      if (_o[i] < -half || _o[i] > half)
+        return false;
+      continue;
+    }
+    double t1 = (-half - _o[i]) / _d[i];
+    double t2 = (half - _o[i]) / _d[i];
+    if (t1 > t2)
+      std::swap(t1, t2);
+    tNear = std::max(tNear, t1);
+    tFar = std::min(tFar, t2);
+  }
+  if (tNear > tFar || tFar < 0)
+    return false;
+
+  _t = tNear >= 0 ? tNear : tFar;
+  return true;
+}
+
+/// \brief Intersect a ray with a sphere centered on the origin.
+/// \param[in] _o Origin of the ray, in the frame of the sphere.
+/// \param[in] _d Unit direction of the ray, in the frame of the sphere.
+/// \param[in] _radius Radius of the sphere.
+/// \param[out] _t Distance to the hit.
+/// \return True if the ray hits the sphere.
+static bool HitSphere(const double *_o, const double *_d,
+    const double _radius, double &_t)
+{
+  const double b = Dot(_o, _d);
+  const double c = Dot(_o, _o) - _radius * _radius;
+  const double disc = b * b - c;
+  if (disc < 0)
+    return false;
+
+  const double root = std::sqrt(disc);
+  _t = -b - root;
+  if (_t < 0)
+    _t = -b + root;
+  return _t >= 0;
+}
+
+/// \brief Intersect a ray with a cylinder centered on the origin, along the
+/// Z axis.
+/// \param[in] _o Origin of the ray, in the frame of the cylinder.
+/// \param[in] _d Unit direction of the ray, in the frame of the cylinder.
+/// \param[in] _radius Radius of the cylinder.
+/// \param[in] _half Half length of the cylinder.
+/// \param[out] _t Distance to the hit.
+/// \return True if the ray hits the cylinder.
+static bool HitCylinder(const double *_o, const double *_d,
+    const double _radius, const double _half, double &_t)
+{
+  double best = std::numeric_limits<double>::max();
+  const double r2 = _radius * _radius;
+
+  // Side
+  const double a = _d[0] * _d[0] + _d[1] * _d[1];
+  if (a > kRaycastEpsilon)
+  {
+    const double b = _o[0] * _d[0] + _o[1] * _d[1];
+    const double c = _o[0] * _o[0] + _o[1] * _o[1] - r2;
+    const double disc = b * b - a * c;
+    if (disc >= 0)
+    {
+      const double root = std::sqrt(disc);
+      for (const double t : {(-b - root) / a, (-b + root) / a})
+      {
+        if (t >= 0 && t < best && std::abs(_o[2] + t * _d[2]) <= _half)
+          best = t;
+      }
+    }
+  }
+
+  // Caps
+  if (std::abs(_d[2]) > kRaycastEpsilon)
+  {
+    for (const double z : {-_half, _half})
+    {
+      const double t = (z - _o[2]) / _d[2];
+      const double x = _o[0] + t * _d[0];
+      const double y = _o[1] + t * _d[1];
+      if (t >= 0 && t < best && x * x + y * y <= r2)
+        best = t;
+    }
+  }
+
+  if (best == std::numeric_limits<double>::max())
+    return false;
+  _t = best;
+  return true;
+}
+
+/// \brief Intersect a ray with both sides of a triangle, with the
+/// Moller-Trumbore algorithm.
+/// \param[in] _o Origin of the ray.
+/// \param[in] _d Unit direction of the ray.
+/// \param[in] _triangle First vertex, then the two edges from it.
+/// \param[out] _t Distance to the hit.
+/// \return True if the ray hits the triangle.
+static bool HitTriangle(const double *_o, const double *_d,
+    const double *_triangle, double &_t)
+{
+  const double *edge1 = _triangle + 3;
+  const double *edge2 = _triangle + 6;
+
+  double p[3];
+  Cross(_d, edge2, p);
+  const double det = Dot(edge1, p);
+  if (std::abs(det) < kRaycastEpsilon)
+    return false;
+  const double invDet = 1.0 / det;
+
+  const double s[3] = {_o[0] - _triangle[0], _o[1] - _triangle[1],
+                       _o[2] - _triangle[2]};
+  const double u = Dot(s, p) * invDet;
+  if (u < 0 || u > 1)
+    return false;
+
+  double q[3];
+  Cross(s, edge1, q);
+  const double v = Dot(_d, q) * invDet;
+  if (v < 0 || u + v > 1)
+    return false;
+
+  _t = Dot(edge2, q) * invDet;
+  return _t >= 0;
+}
+
+/// \brief Intersect a ray with a mesh.
+/// \param[in] _o Origin of the ray, in the frame of the mesh.
+/// \param[in] _d Unit direction of the ray, in the frame of the mesh.
+/// \param[in] _mesh The mesh.
+/// \param[in] _tMax Length of the ray.
+/// \param[out] _t Distance to the closest hit.
+/// \return True if the ray hits the mesh before _tMax.
+static bool HitMesh(const double *_o, const double *_d,
+    const RaycastMesh &_mesh, const double _tMax, double &_t)
+{
+  double inv[3];
+  InverseDirection(_d, inv);
+
+  double best = _tMax;
+  bool hit = false;
+  Traverse(_mesh.bvh, _o, _d, inv, best,
+      [&](const uint32_t _triangle)
+      {
+        double t;
+        if (HitTriangle(_o, _d, &_mesh.triangles[_triangle * 9], t) &&
+            t < best)
+        {
+          best = t;
+          hit = true;
+        }
+      });
+
+  _t = best;
+  return hit;
+}
+
+/// \brief Read the triangles of a mesh shape and build their hierarchy.
+/// \param[in] _shape The shape.
+/// \return The mesh.
+static std::shared_ptr<const RaycastMesh> LoadMesh(const MeshShape &_shape)
+{
+  auto mesh = std::make_shared<RaycastMesh>();
+  mesh->shape = &_shape;
+  mesh->uri = _shape.GetMeshURI();
+  mesh->scale = _shape.Size();
+
+  std::vector<float> vertices;
+  std::vector<int> indices;
+  _shape.Triangles(vertices, indices);
+
+  const int vertexCount = static_cast<int>(vertices.size() / 3);
+  std::vector<double> bounds;
+  std::vector<uint32_t> items;
+  ignition::math::Vector3d min(std::numeric_limits<double>::max(),
+      std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+  ignition::math::Vector3d max = -min;
+  for (size_t i = 0; i + 3 <= indices.size(); i += 3)
+  {
+    ignition::math::Vector3d v[3];
+    bool valid = true;
+    for (int j = 0; j < 3; ++j)
+    {
+      const int index = indices[i + j];
+      if (index < 0 || index >= vertexCount)
+      {
+        valid = false;
+        break;
+      }
+      v[j].Set(vertices[index * 3], vertices[index * 3 + 1],
+          vertices[index * 3 + 2]);
+    }
+    if (!valid)
+      continue;
+
+    items.push_back(static_cast<uint32_t>(items.size()));
+    const ignition::math::Vector3d edge1 = v[1] - v[0];
+    const ignition::math::Vector3d edge2 = v[2] - v[0];
+    for (int k = 0; k < 3; ++k)
+      mesh->triangles.push_back(v[0][k]);
+    for (int k = 0; k < 3; ++k)
+      mesh->triangles.push_back(edge1[k]);
+    for (int k = 0; k < 3; ++k)
+      mesh->triangles.push_back(edge2[k]);
+
+    ignition::math::Vector3d triMin = v[0];
+    ignition::math::Vector3d triMax = v[0];
+    triMin.Min(v[1]);
+    triMin.Min(v[2]);
+    triMax.Max(v[1]);
+    triMax.Max(v[2]);
+    for (int k = 0; k < 3; ++k)
+      bounds.push_back(triMin[k]);
+    for (int k = 0; k < 3; ++k)
+      bounds.push_back(triMax[k]);
+    min.Min(triMin);
+    max.Max(triMax);
+  }
+
+  if (!items.empty())
+  {
+    mesh->center = (min + max) * 0.5;
+    mesh->extent = (max - min) * 0.5;
+  }
+  mesh->bvh.Build(bounds, items);
+  return mesh;
+}
+
+/// \brief Add a collision to a layout.
+/// \param[in] _collision The collision.
+/// \param[in] _meshes Meshes of the previous layout, by shape.
+/// \param[in,out] _layout The layout.
+static void AddCollision(const CollisionPtr &_collision,
+    const std::unordered_map<const Shape *,
+        std::shared_ptr<const RaycastMesh>> &_meshes,
+    RaycastSnapshotLayout &_layout)
+{
+  ShapePtr shape = _collision->GetShape();
+  if (!shape || shape->HasType(Base::RAY_SHAPE) ||
+      shape->HasType(Base::MULTIRAY_SHAPE))
+  {
+    return;
+  }
+
+  RaycastSnapshotLayout::Kind kind = RaycastSnapshotLayout::BOX;
+  ignition::math::Vector3d size;
+  ignition::math::Vector3d center;
+  ignition::math::Vector3d extent;
+  std::shared_ptr<const RaycastMesh> mesh;
+  double planeScale = 0;
+
+  if (shape->HasType(Base::BOX_SHAPE))
+  {
+    kind = RaycastSnapshotLayout::BOX;
+    size = boost::static_pointer_cast<BoxShape>(shape)->Size() * 0.5;
+    extent = size;
+  }
+  else if (shape->HasType(Base::SPHERE_SHAPE))
+  {
+    kind = RaycastSnapshotLayout::SPHERE;
+    const double radius =
+      boost::static_pointer_cast<SphereShape>(shape)->GetRadius();
+    size.Set(radius, 0, 0);
+    extent.Set(radius, radius, radius);
+  }
+  else if (shape->HasType(Base::CYLINDER_SHAPE))
+  {
+    kind = RaycastSnapshotLayout::CYLINDER;
+    auto cylinder = boost::static_pointer_cast<CylinderShape>(shape);
+    const double radius = cylinder->GetRadius();
+    const double half = cylinder->GetLength() * 0.5;
+    size.Set(radius, 0, half);
+    extent.Set(radius, radius, half);
+  }
+  else if (shape->HasType(Base::PLANE_SHAPE))
+  {
+    kind = RaycastSnapshotLayout::PLANE;
+    size = boost::static_pointer_cast<PlaneShape>(shape)->Normal();
+    const double length = size.Length();
+    if (length < kRaycastEpsilon)
+      return;
+    size /= length;
+    planeScale = 1.0 / length;
+  }
+  else if (shape->HasType(Base::MESH_SHAPE))
+  {
+    kind = RaycastSnapshotLayout::MESH;
+    auto meshShape = boost::static_pointer_cast<MeshShape>(shape);
+    auto iter = _meshes.find(meshShape.get());
+    if (iter != _meshes.end() &&
+        iter->second->uri == meshShape->GetMeshURI() &&
+        iter->second->scale == meshShape->Size())
+    {
+      mesh = iter->second;
+    }
+    else
+    {
+      mesh = LoadMesh(*meshShape);
+    }
+    center = mesh->center;
+    extent = mesh->extent;
+  }
+  else
+  {
+    // Heightmaps, polylines and maps.
+    _layout.complete = false;
+    return;
+  }
+
+  const uint32_t index = static_cast<uint32_t>(_layout.collisions.size());
+  if (kind == RaycastSnapshotLayout::PLANE)
+  {
+    _layout.planes.push_back(index);
+    _layout.planeScales.push_back(planeScale);
+  }
+  else
+  {
+    _layout.solids.push_back(index);
+  }
+  _layout.collisions.push_back(_collision.get());
+  _layout.names.push_back(_collision->GetScopedName());
+  _layout.kinds.push_back(kind);
+  _layout.sizes.push_back(size);
+  _layout.centers.push_back(center);
+  _layout.extents.push_back(extent);
+  _layout.meshes.push_back(mesh);
+}
+
+/// \brief Get whether a ray can hit a collision. The ODE ray geoms have
+/// the category GZ_SENSOR_COLLIDE and collide with everything else, and
+/// ODE tests a pair of geoms only if the category of one of them is in the
+/// collide bits of the other.
+/// \param[in] _collision The collision.
+/// \return True if a ray can hit the collision.
+static bool RayCollides(const Collision &_collision)
+{
+  return (_collision.GetCollideBits() & GZ_SENSOR_COLLIDE) ||
+    (_collision.GetCategoryBits() & ~GZ_SENSOR_COLLIDE);
+}
+
+/// \brief Add the collisions of a model and its nested models to a layout.
+/// \param[in] _model The model.
+/// \param[in] _meshes Meshes of the previous layout, by shape.
+/// \param[in,out] _layout The layout.
+static void AddModel(const ModelPtr &_model,
+    const std::unordered_map<const Shape *,
+        std::shared_ptr<const RaycastMesh>> &_meshes,
+    RaycastSnapshotLayout &_layout)
+{
+  for (auto const &link : _model->GetLinks())
+  {
+    for (auto const &collision : link->GetCollisions())
+      AddCollision(collision, _meshes, _layout);
+  }
+
+  for (auto const &nested : _model->NestedModels())
+    AddModel(nested, _meshes, _layout);
+}
+
+//////////////////////////////////////////////////
+void RaycastSnapshotPrivate::Cast(const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end, RaycastHit &_hit) const
+{
+  _hit.distance = 0;
+  _hit.collision = -1;
+  if (!this->layout)
+    return;
+
+  const RaycastSnapshotLayout &collisions = *this->layout;
+  const double origin[3] = {_start.X(), _start.Y(), _start.Z()};
+  double dir[3] = {_end.X() - _start.X(), _end.Y() - _start.Y(),
+                   _end.Z() - _start.Z()};
+  const double length = std::sqrt(Dot(dir, dir));
+  if (length < kRaycastEpsilon)
+    return;
+  for (int i = 0; i < 3; ++i)
+    dir[i] /= length;
+
+  double best = length;
+  int bestIndex = -1;
+
+  for (size_t i = 0; i < collisions.planes.size(); ++i)
+  {
+    if (!this->rayCollide[collisions.planes[i]])
+      continue;
+
+    const ignition::math::Vector3d &normal =
+      collisions.sizes[collisions.planes[i]];
+    const double n[3] = {normal.X(), normal.Y(), normal.Z()};
+    const double denom = Dot(n, dir);
+    if (std::abs(denom) < kRaycastEpsilon)
+      continue;
+
+    const double t = (this->planeOffsets[i] - Dot(n, origin)) / denom;
+    if (t >= 0 && t < best)
+    {
+      best = t;
+      bestIndex = static_cast<int>(collisions.planes[i]);
+    }
+  }
+
+  double inv[3];
+  InverseDirection(dir, inv);
+  Traverse(this->bvh, origin, dir, inv, best,
+      [&](const uint32_t _index)
+      {
+        // Move the ray to the frame of the collision.
+        const double *transform = &this->transforms[_index * 12];
+        const double rel[3] = {origin[0] - transform[9],
+                               origin[1] - transform[10],
+                               origin[2] - transform[11]};
+        double o[3];
+        double d[3];
+        for (int k = 0; k < 3; ++k)
+        {
+          o[k] = transform[k] * rel[0] + transform[3 + k] * rel[1] +
+                 transform[6 + k] * rel[2];
+          d[k] = transform[k] * dir[0] + transform[3 + k] * dir[1] +
+                 transform[6 + k] * dir[2];
+        }
+
+        const ignition::math::Vector3d &size = collisions.sizes[_index];
+        double t = 0;
+        bool hit = false;
+        switch (collisions.kinds[_index])
+        {
+          case RaycastSnapshotLayout::BOX:
+            hit = HitBox(o, d, size, t);
+            break;
+          case RaycastSnapshotLayout::SPHERE:
+            hit = HitSphere(o, d, size.X(), t);
+            break;
+          case RaycastSnapshotLayout::CYLINDER:
+            hit = HitCylinder(o, d, size.X(), size.Z(), t);
+            break;
+          case RaycastSnapshotLayout::MESH:
+            hit = HitMesh(o, d, *collisions.meshes[_index], best, t);
+            break;
+          default:
+            break;
+        }
+
+        if (hit && t < best)
+        {
+          best = t;
+          bestIndex = static_cast<int>(_index);
+        }
+      });
+
+  if (bestIndex >= 0)
+  {
+    _hit.distance = best;
+    _hit.collision = bestIndex;
+  }
+}
+
+//////////////////////////////////////////////////
+RaycastSnapshot::RaycastSnapshot()
+  : dataPtr(new RaycastSnapshotPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+RaycastSnapshot::~RaycastSnapshot()
+{
+}
+
+//////////////////////////////////////////////////
+void RaycastSnapshot::Build(const WorldPtr &_world,
+    const std::shared_ptr<const RaycastSnapshot> &_previous)
+{
+  if (!_world)
+    return;
+
+  const uint64_t version = _world->_EntityVersion();
+  std::shared_ptr<const RaycastSnapshotLayout> layout;
+  this->dataPtr->layoutBuilds = 0;
+  if (_previous)
+  {
+    layout = _previous->dataPtr->layout;
+    this->dataPtr->layoutBuilds = _previous->dataPtr->layoutBuilds + 1;
+  }
+
+  // The shapes are read again from time to time, since changes of their
+  // size do not change the entity version.
+  if (!layout || layout->world != _world.get() ||
+      layout->version != version ||
+      this->dataPtr->layoutBuilds >= kRaycastShapeRefresh)
+  {
+    std::unordered_map<const Shape *, std::shared_ptr<const RaycastMesh>>
+      meshes;
+    if (layout && layout->world == _world.get())
+    {
+      for (auto const &mesh : layout->meshes)
+      {
+        if (mesh)
+          meshes[mesh->shape] = mesh;
+      }
+    }
+
+    auto newLayout = std::make_shared<RaycastSnapshotLayout>();
+    newLayout->world = _world.get();
+    newLayout->version = version;
+    for (auto const &model : _world->Models())
+      AddModel(model, meshes, *newLayout);
+
+    layout = newLayout;
+    this->dataPtr->layoutBuilds = 0;
+  }
+  this->dataPtr->layout = layout;
+  this->dataPtr->iterations = _world->Iterations();
+
+  const size_t count = layout->collisions.size();
+  this->dataPtr->transforms.resize(count * 12);
+  this->dataPtr->retros.resize(count);
+  this->dataPtr->rayCollide.resize(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    const Collision *collision = layout->collisions[i];
+    const ignition::math::Pose3d &pose = collision->WorldPose();
+    double *transform = &this->dataPtr->transforms[i * 12];
+    for (int j = 0; j < 3; ++j)
+    {
+      const ignition::math::Vector3d axis = pose.Rot().RotateVector(
+          ignition::math::Vector3d(j == 0, j == 1, j == 2));
+      transform[j] = axis.X();
+      transform[3 + j] = axis.Y();
+      transform[6 + j] = axis.Z();
+    }
+    transform[9] = pose.Pos().X();
+    transform[10] = pose.Pos().Y();
+    transform[11] = pose.Pos().Z();
+    this->dataPtr->retros[i] = collision->GetLaserRetro();
+    this->dataPtr->rayCollide[i] = RayCollides(*collision);
+  }
+
+  // Planes are not rotated, and are placed at the altitude of their
+  // collision, as in ODE.
+  this->dataPtr->planeOffsets.resize(layout->planes.size());
+  for (size_t i = 0; i < layout->planes.size(); ++i)
+  {
+    this->dataPtr->planeOffsets[i] =
+      this->dataPtr->transforms[layout->planes[i] * 12 + 11] *
+      layout->planeScales[i];
+  }
+
+  // The collide bits are read at each build, since changing them does not
+  // change the entity version. Collisions that rays cannot hit are left
+  // out of the hierarchy.
+  std::vector<double> bounds(count * 6);
+  std::vector<uint32_t> solids;
+  solids.reserve(layout->solids.size());
+  for (const uint32_t index : layout->solids)
+  {
+    if (!this->dataPtr->rayCollide[index])
+      continue;
+    solids.push_back(index);
+
+    const double *transform = &this->dataPtr->transforms[index * 12];
+    const ignition::math::Vector3d &center = layout->centers[index];
+    const ignition::math::Vector3d &extent = layout->extents[index];
+    for (int k = 0; k < 3; ++k)
+    {
+      const double *row = transform + k * 3;
+      const double worldCenter = transform[9 + k] + row[0] * center.X() +
+        row[1] * center.Y() + row[2] * center.Z();
+      const double worldExtent = std::abs(row[0]) * extent.X() +
+        std::abs(row[1]) * extent.Y() + std::abs(row[2]) * extent.Z();
+      bounds[index * 6 + k] = worldCenter - worldExtent;
+      bounds[index * 6 + 3 + k] = worldCenter + worldExtent;
+    }
+  }
+  this->dataPtr->bvh.Build(bounds, solids);
+}
+
+//////////////////////////////////////////////////
+bool RaycastSnapshot::Complete() const
+{
+  return this->dataPtr->layout && this->dataPtr->layout->complete;
+}
+
+//////////////////////////////////////////////////
+uint64_t RaycastSnapshot::EntityVersion() const
+{
+  return this->dataPtr->layout ? this->dataPtr->layout->version : 0;
+}
+
+//////////////////////////////////////////////////
+uint64_t RaycastSnapshot::Iterations() const
+{
+  return this->dataPtr->iterations;
+}
+
+//////////////////////////////////////////////////
+size_t RaycastSnapshot::CollisionCount() const
+{
+  return this->dataPtr->layout ? this->dataPtr->layout->collisions.size() : 0;
+}
+
+//////////////////////////////////////////////////
+std::string RaycastSnapshot::CollisionName(const int _index) const
+{
+  if (_index < 0 || static_cast<size_t>(_index) >= this->CollisionCount())
+    return std::string();
+  return this->dataPtr->layout->names[_index];
+}
+
+//////////////////////////////////////////////////
+float RaycastSnapshot::LaserRetro(const int _index) const
+{
+  if (_index < 0 || static_cast<size_t>(_index) >= this->CollisionCount())
+    return 0;
+  return this->dataPtr->retros[_index];
+}
+
+//////////////////////////////////////////////////
+void RaycastSnapshot::CastRays(
+    const std::vector<ignition::math::Vector3d> &_starts,
+    const std::vector<ignition::math::Vector3d> &_ends,
+    std::vector<RaycastHit> &_hits) const
+{
+  const size_t count = std::min(_starts.size(), _ends.size());
+  _hits.resize(count);
+  for (size_t i = 0; i < count; ++i)
+    this->dataPtr->Cast(_starts[i], _ends[i], _hits[i]);
+}
+
+//////////////////////////////////////////////////
+RaycastHit RaycastSnapshot::CastRay(const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end) const
+{
+  RaycastHit hit;
+  this->dataPtr->Cast(_start, _end, hit);
+  return hit;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_RAYCASTSNAPSHOT_HH_
+#define GAZEBO_PHYSICS_RAYCASTSNAPSHOT_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class RaycastSnapshotPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \brief Result of a ray cast against a RaycastSnapshot.
+    class GZ_PHYSICS_VISIBLE RaycastHit
+    {
+      /// \brief Distance from the start of the ray to the hit point. Only
+      /// valid if collision is not negative.
+      public: double distance = 0;
+
+      /// \brief Index of the collision that was hit, see
+      /// RaycastSnapshot::CollisionName, or -1 if nothing was hit.
+      public: int collision = -1;
+    };
+
+    /// \class RaycastSnapshot RaycastSnapshot.hh physics/physics.hh
+    /// \brief Read only copy of the collision geometry of a world, to cast
+    /// rays without locking the physics engine.
+    ///
+    /// A snapshot holds the world poses of the collisions of the world at
+    /// one iteration, and a bounding volume hierarchy over their bounding
+    /// boxes. Boxes, spheres, cylinders, planes and triangle meshes are
+    /// supported, see Complete. Meshes have their own hierarchy over their
+    /// triangles, which is shared with the next snapshots.
+    ///
+    /// A snapshot is never changed once built, so rays can be cast from any
+    /// thread, see World::RaySnapshot. As with the physics engines, a ray
+    /// that starts inside a shape hits the surface it leaves the shape
+    /// through. Rays skip the collisions whose category and collide bits
+    /// filter out GZ_SENSOR_COLLIDE, as the ODE rays do.
+    class GZ_PHYSICS_VISIBLE RaycastSnapshot
+    {
+      /// \brief Constructor. The snapshot is empty until built.
+      public: RaycastSnapshot();
+
+      /// \brief Destructor.
+      public: ~RaycastSnapshot();
+
+      /// \brief Build the snapshot of a world. This must be called from the
+      /// world thread, or while the world is paused. The shapes of the
+      /// collisions and the mesh hierarchies are taken from the previous
+      /// snapshot, if the world has the same entities, and only the poses
+      /// are read. Shapes are read again every few hundred builds, so that
+      /// changes of their size are picked up.
+      /// \param[in] _world The world.
+      /// \param[in] _previous Previous snapshot of the world, can be null.
+      public: void Build(const WorldPtr &_world,
+                  const std::shared_ptr<const RaycastSnapshot> &_previous);
+
+      /// \brief Get whether every collision of the world is in the
+      /// snapshot. Heightmaps, polylines and maps are not supported, rays
+      /// cast against a snapshot that misses them can miss hits.
+      /// \return True if all the collisions are supported.
+      public: bool Complete() const;
+
+      /// \brief Get the entity version of the world at the build, see
+      /// World::_EntityVersion.
+      /// \return The entity version.
+      public: uint64_t EntityVersion() const;
+
+      /// \brief Get the number of iterations of the world at the build.
+      /// \return Simulation iterations.
+      public: uint64_t Iterations() const;
+
+      /// \brief Get the number of collisions in the snapshot.
+      /// \return Number of collisions.
+      public: size_t CollisionCount() const;
+
+      /// \brief Get the scoped name of a collision.
+      /// \param[in] _index Index of the collision, from a RaycastHit.
+      /// \return The name, empty if the index is invalid.
+      public: std::string CollisionName(const int _index) const;
+
+      /// \brief Get the laser retro reflectivity of a collision.
+      /// \param[in] _index Index of the collision, from a RaycastHit.
+      /// \return The laser retro value, 0 if the index is invalid.
+      public: float LaserRetro(const int _index) const;
+
+      /// \brief Cast rays, and find their closest hits.
+      /// \param[in] _starts Start points of the rays, in the world frame.
+      /// \param[in] _ends End points of the rays, in the world frame, with
+      /// as many points as _starts.
+      /// \param[out] _hits Closest hit of each ray, resized to the number of
+      /// rays.
+      public: void CastRays(
+                  const std::vector<ignition::math::Vector3d> &_starts,
+                  const std::vector<ignition::math::Vector3d> &_ends,
+                  std::vector<RaycastHit> &_hits) const;
+
+      /// \brief Cast a ray, and find its closest hit.
+      /// \param[in] _start Start point of the ray, in the world frame.
+      /// \param[in] _end End point of the ray, in the world frame.
+      /// \return The closest hit.
+      public: RaycastHit CastRay(const ignition::math::Vector3d &_start,
+                  const ignition::math::Vector3d &_end) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<RaycastSnapshotPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_RAYCASTSNAPSHOTPRIVATE_HH_
+#define GAZEBO_PHYSICS_RAYCASTSNAPSHOTPRIVATE_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    class RaycastHit;
+
+    /// \internal
+    /// \brief Node of a bounding volume hierarchy.
+    class RaycastBvhNode
+    {
+      /// \brief Minimum corner of the bounding box.
+      public: double min[3];
+
+      /// \brief Maximum corner of the bounding box.
+      public: double max[3];
+
+      /// \brief For a leaf, index of its first item. For an inner node,
+      /// index of its second child, the first child follows the node.
+      public: uint32_t offset = 0;
+
+      /// \brief Number of items of a leaf, 0 for an inner node.
+      public: uint32_t count = 0;
+
+      /// \brief Axis the items of an inner node are split along.
+      public: uint32_t axis = 0;
+    };
+
+    /// \internal
+    /// \brief Binary bounding volume hierarchy, stored depth first.
+    class RaycastBvh
+    {
+      /// \brief Build the hierarchy.
+      /// \param[in] _bounds Bounding boxes of the items, 6 values per item:
+      /// minimum corner, then maximum corner.
+      /// \param[in] _items Items to store, indices into _bounds.
+      public: void Build(const std::vector<double> &_bounds,
+                  const std::vector<uint32_t> &_items);
+
+      /// \brief Nodes, the root first.
+      public: std::vector<RaycastBvhNode> nodes;
+
+      /// \brief Items, leaves refer to ranges of it.
+      public: std::vector<uint32_t> items;
+    };
+
+    /// \internal
+    /// \brief Triangles of a mesh collision, in the frame of the collision.
+    class RaycastMesh
+    {
+      /// \brief Shape the triangles were read from.
+      public: const Shape *shape = nullptr;
+
+      /// \brief URI of the mesh of the shape.
+      public: std::string uri;
+
+      /// \brief Scale of the mesh of the shape.
+      public: ignition::math::Vector3d scale;
+
+      /// \brief 9 values per triangle: first vertex, then the edges from the
+      /// first vertex to the second and third vertices.
+      public: std::vector<double> triangles;
+
+      /// \brief Hierarchy over the triangles.
+      public: RaycastBvh bvh;
+
+      /// \brief Center of the bounding box of the triangles.
+      public: ignition::math::Vector3d center;
+
+      /// \brief Half size of the bounding box of the triangles.
+      public: ignition::math::Vector3d extent;
+    };
+
+    /// \internal
+    /// \brief Collisions of a snapshot and their shapes. A layout is never
+    /// changed once built, so that it can be shared between snapshots.
+    class RaycastSnapshotLayout
+    {
+      /// \brief Kinds of shapes.
+      public: enum Kind
+      {
+        /// \brief Box
+        BOX,
+
+        /// \brief Sphere
+        SPHERE,
+
+        /// \brief Cylinder along the Z axis
+        CYLINDER,
+
+        /// \brief Triangle mesh
+        MESH,
+
+        /// \brief Infinite plane
+        PLANE
+      };
+
+      /// \brief World the layout was built from. Only used to validate the
+      /// collision pointers.
+      public: const World *world = nullptr;
+
+      /// \brief Entity version of the world, see World::_EntityVersion.
+      public: uint64_t version = 0;
+
+      /// \brief False if the world has collisions that are not supported.
+      public: bool complete = true;
+
+      /// \brief Collisions, valid while the world has the same version.
+      public: std::vector<Collision *> collisions;
+
+      /// \brief Scoped names of the collisions.
+      public: std::vector<std::string> names;
+
+      /// \brief Kind of shape of each collision.
+      public: std::vector<Kind> kinds;
+
+      /// \brief Size of each shape: half size of a box, radius of a sphere
+      /// in X, radius and half length of a cylinder in X and Z, unit normal
+      /// of a plane.
+      public: std::vector<ignition::math::Vector3d> sizes;
+
+      /// \brief Center of the bounding box of each shape, in the frame of
+      /// its collision.
+      public: std::vector<ignition::math::Vector3d> centers;
+
+      /// \brief Half size of the bounding box of each shape, in the frame of
+      /// its collision.
+      public: std::vector<ignition::math::Vector3d> extents;
+
+      /// \brief Triangles of each mesh, null for other shapes.
+      public: std::vector<std::shared_ptr<const RaycastMesh>> meshes;
+
+      /// \brief Indices of the collisions that are not planes.
+      public: std::vector<uint32_t> solids;
+
+      /// \brief Indices of the collisions that are planes.
+      public: std::vector<uint32_t> planes;
+
+      /// \brief Inverse of the length of the normal of each plane, as set
+      /// on the shape. The altitude of a plane is scaled by it, as ODE does.
+      public: std::vector<double> planeScales;
+    };
+
+    /// \internal
+    /// \brief Private data for RaycastSnapshot.
+    class RaycastSnapshotPrivate
+    {
+      /// \brief Cast a ray.
+      /// \param[in] _start Start point of the ray.
+      /// \param[in] _end End point of the ray.
+      /// \param[out] _hit The closest hit.
+      public: void Cast(const ignition::math::Vector3d &_start,
+                  const ignition::math::Vector3d &_end,
+                  RaycastHit &_hit) const;
+
+      /// \brief Collisions of the snapshot.
+      public: std::shared_ptr<const RaycastSnapshotLayout> layout;
+
+      /// \brief Number of builds since the layout was built.
+      public: unsigned int layoutBuilds = 0;
+
+      /// \brief Simulation iterations.
+      public: uint64_t iterations = 0;
+
+      /// \brief World transform of each collision, 12 values per collision:
+      /// the rotation matrix, row by row, then the position.
+      public: std::vector<double> transforms;
+
+      /// \brief Laser retro value of each collision.
+      public: std::vector<float> retros;
+
+      /// \brief Whether the collide bits of each collision let rays hit it.
+      public: std::vector<bool> rayCollide;
+
+      /// \brief Distance of each plane from the origin along its normal.
+      public: std::vector<double> planeOffsets;
+
+      /// \brief Hierarchy over the world bounding boxes of the collisions
+      /// that are not planes.
+      public: RaycastBvh bvh;
+    };
+  }
+}
+#endif
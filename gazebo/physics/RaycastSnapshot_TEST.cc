@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/RaycastSnapshot.hh"
+#include "gazebo/physics/RayShape.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/test/ServerFixture.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class RaycastSnapshotTest : public ServerFixture { };
+
+//////////////////////////////////////////////////
+TEST_F(RaycastSnapshotTest, Shapes)
+{
+  this->Load("worlds/shapes.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::RaycastSnapshot empty;
+  EXPECT_EQ(empty.CollisionCount(), 0u);
+  EXPECT_EQ(empty.CastRay(ignition::math::Vector3d(0, 0, 5),
+        ignition::math::Vector3d(0, 0, -5)).collision, -1);
+
+  physics::RaycastSnapshot snapshot;
+  snapshot.Build(world, nullptr);
+  EXPECT_TRUE(snapshot.Complete());
+  EXPECT_EQ(snapshot.EntityVersion(), world->_EntityVersion());
+  EXPECT_EQ(snapshot.Iterations(), world->Iterations());
+  EXPECT_EQ(snapshot.CollisionCount(), 4u);
+  EXPECT_TRUE(snapshot.CollisionName(-1).empty());
+  EXPECT_TRUE(snapshot.CollisionName(100).empty());
+
+  // Box, from above
+  physics::RaycastHit hit = snapshot.CastRay(
+      ignition::math::Vector3d(0, 0, 5), ignition::math::Vector3d(0, 0, -5));
+  ASSERT_GE(hit.collision, 0);
+  EXPECT_NEAR(hit.distance, 4, 1e-6);
+  EXPECT_EQ(snapshot.CollisionName(hit.collision), "box::link::collision");
+
+  // Box, from inside
+  hit = snapshot.CastRay(ignition::math::Vector3d(0, 0, 0.5),
+      ignition::math::Vector3d(0, 0, 5));
+  ASSERT_GE(hit.collision, 0);
+  EXPECT_NEAR(hit.distance, 0.5, 1e-6);
+  EXPECT_EQ(snapshot.CollisionName(hit.collision), "box::link::collision");
+
+  // Sphere
+  hit = snapshot.CastRay(ignition::math::Vector3d(0, 1.5, 5),
+      ignition::math::Vector3d(0, 1.5, -5));
+  ASSERT_GE(hit.collision, 0);
+  EXPECT_NEAR(hit.distance, 4, 1e-6);
+  EXPECT_EQ(snapshot.CollisionName(hit.collision), "sphere::link::collision");
+
+  // Cylinder, rotated so that its axis is along X
+  hit = snapshot.CastRay(ignition::math::Vector3d(-5, -1.5, 0.5),
+      ignition::math::Vector3d(5, -1.5, 0.5));
+  ASSERT_GE(hit.collision, 0);
+  EXPECT_NEAR(hit.distance, 4.5, 1e-3);
+  EXPECT_EQ(snapshot.CollisionName(hit.collision),
+      "cylinder::link::collision");
+
+  // Ground plane
+  hit = snapshot.CastRay(ignition::math::Vector3d(3, 3, 5),
+      ignition::math::Vector3d(3, 3, -5));
+  ASSERT_GE(hit.collision, 0);
+  EXPECT_NEAR(hit.distance, 5, 1e-6);
+  EXPECT_EQ(snapshot.CollisionName(hit.collision),
+      "ground_plane::link::collision");
+
+  // Too short
+  hit = snapshot.CastRay(ignition::math::Vector3d(3, 3, 5),
+      ignition::math::Vector3d(3, 3, 1));
+  EXPECT_EQ(hit.collision, -1);
+
+  // Batch, against the rays of the physics engine
+  physics::RayShapePtr ray = boost::dynamic_pointer_cast<physics::RayShape>(
+      world->Physics()->CreateShape("ray", physics::CollisionPtr()));
+  ASSERT_TRUE(ray != nullptr);
+
+  std::vector<ignition::math::Vector3d> starts;
+  std::vector<ignition::math::Vector3d> ends;
+  for (double x = -2; x <= 2; x += 0.25)
+  {
+    for (double y = -2.5; y <= 2.5; y += 0.25)
+    {
+      starts.push_back(ignition::math::Vector3d(x, y, 3));
+      ends.push_back(ignition::math::Vector3d(x + 0.3, y - 0.2, -1));
+    }
+  }
+
+  std::vector<physics::RaycastHit> hits;
+  snapshot.CastRays(starts, ends, hits);
+  ASSERT_EQ(hits.size(), starts.size());
+  for (size_t i = 0; i < starts.size(); ++i)
+  {
+    double dist;
+    std::string entity;
+    ray->SetPoints(starts[i], ends[i]);
+    ray->GetIntersection(dist, entity);
+
+    EXPECT_EQ(snapshot.CollisionName(hits[i].collision), entity)
+      << starts[i];
+    if (hits[i].collision >= 0)
+      EXPECT_NEAR(hits[i].distance, dist, 1e-3) << starts[i];
+  }
+}
+
+//////////////////////////////////////////////////
+TEST_F(RaycastSnapshotTest, Mesh)
+{
+  this->Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // 2 m cube, scaled down to 1 m
+  const std::string meshPath =
+    std::string(PROJECT_SOURCE_PATH) + "/test/data/box.obj";
+  this->SpawnTrimesh("mesh", meshPath,
+      ignition::math::Vector3d(0.5, 0.5, 0.5),
+      ignition::math::Vector3d(5, 0, 0.5),
+      ignition::math::Vector3d(0, 0, 0.3), true);
+
+  physics::RaycastSnapshot snapshot;
+  snapshot.Build(world, nullptr);
+  EXPECT_TRUE(snapshot.Complete());
+
+  physics::RaycastHit hit = snapshot.CastRay(
+      ignition::math::Vector3d(5, 0, 5), ignition::math::Vector3d(5, 0, -5));
+  ASSERT_GE(hit.collision, 0);
+  EXPECT_NEAR(hit.distance, 4, 1e-4);
+  EXPECT_EQ(snapshot.CollisionName(hit.collision), "mesh::link::collision");
+
+  hit = snapshot.CastRay(ignition::math::Vector3d(6, 0, 5),
+      ignition::math::Vector3d(6, 0, 0.5));
+  EXPECT_EQ(hit.collision, -1);
+
+  // The next snapshot reuses the triangles of the mesh.
+  auto previous = std::make_shared<physics::RaycastSnapshot>();
+  previous->Build(world, nullptr);
+  physics::RaycastSnapshot next;
+  next.Build(world, previous);
+  hit = next.CastRay(ignition::math::Vector3d(5, 0, 5),
+      ignition::math::Vector3d(5, 0, -5));
+  ASSERT_GE(hit.collision, 0);
+  EXPECT_NEAR(hit.distance, 4, 1e-4);
+  EXPECT_EQ(next.CollisionName(hit.collision), "mesh::link::collision");
+}
+
+//////////////////////////////////////////////////
+TEST_F(RaycastSnapshotTest, CollideBits)
+{
+  this->Load("worlds/shapes.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  physics::CollisionPtr collision =
+    model->GetLink("link")->GetCollision("collision");
+  ASSERT_TRUE(collision != nullptr);
+
+  physics::RayShapePtr ray = boost::dynamic_pointer_cast<physics::RayShape>(
+      world->Physics()->CreateShape("ray", physics::CollisionPtr()));
+  ASSERT_TRUE(ray != nullptr);
+  const ignition::math::Vector3d start(0, 0, 5);
+  const ignition::math::Vector3d end(0, 0, -5);
+  ray->SetPoints(start, end);
+
+  // Rays still collide with the category of the box.
+  collision->SetCollideBits(~GZ_SENSOR_COLLIDE);
+  auto snapshot = std::make_shared<physics::RaycastSnapshot>();
+  snapshot->Build(world, nullptr);
+  physics::RaycastHit hit = snapshot->CastRay(start, end);
+  double dist;
+  std::string entity;
+  ray->GetIntersection(dist, entity);
+  EXPECT_EQ(entity, "box::link::collision");
+  EXPECT_EQ(snapshot->CollisionName(hit.collision), entity);
+
+  // Neither bits let rays hit the box, which hit the ground plane instead.
+  // The next snapshot shares the layout, and reads the bits again.
+  collision->SetCategoryBits(GZ_SENSOR_COLLIDE);
+  physics::RaycastSnapshot next;
+  next.Build(world, snapshot);
+  EXPECT_EQ(next.EntityVersion(), snapshot->EntityVersion());
+  hit = next.CastRay(start, end);
+  ray->GetIntersection(dist, entity);
+  EXPECT_EQ(entity, "ground_plane::link::collision");
+  EXPECT_EQ(next.CollisionName(hit.collision), entity);
+  EXPECT_NEAR(hit.distance, dist, 1e-6);
+
+  // Planes are filtered too.
+  physics::CollisionPtr ground = world->ModelByName("ground_plane")->
+    GetLink("link")->GetCollision("collision");
+  ASSERT_TRUE(ground != nullptr);
+  ground->SetCategoryBits(GZ_NONE_COLLIDE);
+  ground->SetCollideBits(GZ_NONE_COLLIDE);
+  physics::RaycastSnapshot last;
+  last.Build(world, nullptr);
+  EXPECT_EQ(last.CastRay(start, end).collision, -1);
+  ray->GetIntersection(dist, entity);
+  EXPECT_TRUE(entity.empty());
+}
+
+//////////////////////////////////////////////////
+TEST_F(RaycastSnapshotTest, World)
+{
+  this->Load("worlds/shapes.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Snapshots are only built once enabled.
+  world->Step(1);
+  EXPECT_TRUE(world->RaySnapshot() == nullptr);
+
+  world->EnableRaySnapshots();
+  world->Step(1);
+  auto snapshot = world->RaySnapshot();
+  ASSERT_TRUE(snapshot != nullptr);
+  EXPECT_EQ(snapshot->Iterations(), world->Iterations());
+  EXPECT_EQ(snapshot->EntityVersion(), world->_EntityVersion());
+
+  // A snapshot that is held is not changed by the next updates.
+  world->Step(1);
+  EXPECT_NE(snapshot, world->RaySnapshot());
+  EXPECT_EQ(snapshot->Iterations() + 1, world->Iterations());
+  EXPECT_EQ(world->RaySnapshot()->Iterations(), world->Iterations());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
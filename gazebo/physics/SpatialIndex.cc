@@ -0,0 +1,584 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "gazebo/physics/SpatialIndexPrivate.hh"
+#include "gazebo/physics/SpatialIndex.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Surface area of a box, the cost of a node of the tree.
+/// \param[in] _min Minimum corner.
+/// \param[in] _max Maximum corner.
+/// \return The area.
+static inline double Area(const double *_min, const double *_max)
+{
+  const double x = _max[0] - _min[0];
+  const double y = _max[1] - _min[1];
+  const double z = _max[2] - _min[2];
+  return 2.0 * (x * y + y * z + z * x);
+}
+
+/// \brief Surface area of the union of two boxes.
+/// \param[in] _a First node.
+/// \param[in] _b Second node.
+/// \return The area.
+static inline double CombinedArea(const SpatialIndexNode &_a,
+    const SpatialIndexNode &_b)
+{
+  double min[3];
+  double max[3];
+  for (int i = 0; i < 3; ++i)
+  {
+    min[i] = std::min(_a.min[i], _b.min[i]);
+    max[i] = std::max(_a.max[i], _b.max[i]);
+  }
+  return Area(min, max);
+}
+
+/// \brief Get whether a box is finite and not empty, so that it can be
+/// stored in the tree.
+/// \param[in] _box The box.
+/// \return True if the box is bounded.
+static inline bool Bounded(const ignition::math::Box &_box)
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    if (!std::isfinite(_box.Min()[i]) || !std::isfinite(_box.Max()[i]) ||
+        _box.Min()[i] > _box.Max()[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// \brief Copy the corners of a box.
+/// \param[in] _box The box.
+/// \param[out] _min Minimum corner.
+/// \param[out] _max Maximum corner.
+static inline void Corners(const ignition::math::Box &_box, double *_min,
+    double *_max)
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    _min[i] = _box.Min()[i];
+    _max[i] = _box.Max()[i];
+  }
+}
+
+/// \brief Get whether two boxes intersect. Boxes that touch intersect.
+/// \param[in] _min Minimum corner of the first box.
+/// \param[in] _max Maximum corner of the first box.
+/// \param[in] _box Second box.
+/// \return True if they intersect.
+static inline bool Intersects(const double *_min, const double *_max,
+    const ignition::math::Box &_box)
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    if (!(_min[i] <= _box.Max()[i] && _box.Min()[i] <= _max[i]))
+      return false;
+  }
+  return true;
+}
+
+/// \brief Get whether a box intersects a sphere.
+/// \param[in] _min Minimum corner of the box.
+/// \param[in] _max Maximum corner of the box.
+/// \param[in] _center Center of the sphere.
+/// \param[in] _radius Radius of the sphere.
+/// \return True if they intersect.
+static inline bool Intersects(const double *_min, const double *_max,
+    const ignition::math::Vector3d &_center, const double _radius)
+{
+  double dist = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    if (!(_min[i] <= _max[i]))
+      return false;
+
+    double d = 0;
+    if (_center[i] < _min[i])
+      d = _min[i] - _center[i];
+    else if (_center[i] > _max[i])
+      d = _center[i] - _max[i];
+    dist += d * d;
+  }
+  return dist <= _radius * _radius;
+}
+
+//////////////////////////////////////////////////
+template<typename Overlaps, typename Accept>
+void SpatialIndexPrivate::Query(Overlaps _overlaps, Accept _accept,
+    std::vector<uint32_t> &_ids) const
+{
+  for (auto const &item : this->unbounded)
+  {
+    if (_accept(item.second))
+      _ids.push_back(item.first);
+  }
+
+  if (this->root < 0)
+    return;
+
+  std::vector<int> stack;
+  stack.reserve(64);
+  stack.push_back(this->root);
+  while (!stack.empty())
+  {
+    const SpatialIndexNode &node = this->nodes[stack.back()];
+    stack.pop_back();
+
+    if (!_overlaps(node.min, node.max))
+      continue;
+
+    if (node.IsLeaf())
+    {
+      if (_accept(node.box))
+        _ids.push_back(node.id);
+    }
+    else
+    {
+      stack.push_back(node.child1);
+      stack.push_back(node.child2);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+SpatialIndex::SpatialIndex()
+: dataPtr(new SpatialIndexPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+SpatialIndex::~SpatialIndex()
+{
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::SetMargin(const double _margin)
+{
+  if (_margin >= 0)
+    this->dataPtr->margin = _margin;
+}
+
+//////////////////////////////////////////////////
+double SpatialIndex::Margin() const
+{
+  return this->dataPtr->margin;
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::Update(const uint32_t _id, const ignition::math::Box &_box)
+{
+  auto iter = this->dataPtr->leaves.find(_id);
+
+  if (!Bounded(_box))
+  {
+    if (iter != this->dataPtr->leaves.end())
+    {
+      this->dataPtr->RemoveLeaf(iter->second);
+      this->dataPtr->Free(iter->second);
+      this->dataPtr->leaves.erase(iter);
+    }
+    this->dataPtr->unbounded[_id] = _box;
+    return;
+  }
+
+  this->dataPtr->unbounded.erase(_id);
+
+  int leaf;
+  if (iter != this->dataPtr->leaves.end())
+  {
+    leaf = iter->second;
+    SpatialIndexNode &node = this->dataPtr->nodes[leaf];
+
+    // Still within the enlarged box, the tree does not change.
+    bool inside = true;
+    for (int i = 0; i < 3 && inside; ++i)
+    {
+      inside = node.min[i] <= _box.Min()[i] && _box.Max()[i] <= node.max[i];
+    }
+    if (inside)
+    {
+      node.box = _box;
+      return;
+    }
+
+    this->dataPtr->RemoveLeaf(leaf);
+  }
+  else
+  {
+    leaf = this->dataPtr->Allocate();
+    this->dataPtr->leaves[_id] = leaf;
+  }
+
+  SpatialIndexNode &node = this->dataPtr->nodes[leaf];
+  for (int i = 0; i < 3; ++i)
+  {
+    node.min[i] = _box.Min()[i] - this->dataPtr->margin;
+    node.max[i] = _box.Max()[i] + this->dataPtr->margin;
+  }
+  node.box = _box;
+  node.id = _id;
+  node.child1 = -1;
+  node.child2 = -1;
+  node.height = 0;
+
+  this->dataPtr->InsertLeaf(leaf);
+}
+
+//////////////////////////////////////////////////
+bool SpatialIndex::Remove(const uint32_t _id)
+{
+  auto iter = this->dataPtr->leaves.find(_id);
+  if (iter == this->dataPtr->leaves.end())
+    return this->dataPtr->unbounded.erase(_id) > 0;
+
+  this->dataPtr->RemoveLeaf(iter->second);
+  this->dataPtr->Free(iter->second);
+  this->dataPtr->leaves.erase(iter);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::Clear()
+{
+  this->dataPtr->nodes.clear();
+  this->dataPtr->root = -1;
+  this->dataPtr->freeNodes = -1;
+  this->dataPtr->leaves.clear();
+  this->dataPtr->unbounded.clear();
+}
+
+//////////////////////////////////////////////////
+size_t SpatialIndex::Size() const
+{
+  return this->dataPtr->leaves.size() + this->dataPtr->unbounded.size();
+}
+
+//////////////////////////////////////////////////
+bool SpatialIndex::Has(const uint32_t _id) const
+{
+  return this->dataPtr->leaves.count(_id) > 0 ||
+    this->dataPtr->unbounded.count(_id) > 0;
+}
+
+//////////////////////////////////////////////////
+unsigned int SpatialIndex::Height() const
+{
+  if (this->dataPtr->root < 0)
+    return 0;
+  return this->dataPtr->nodes[this->dataPtr->root].height + 1;
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::QueryBox(const ignition::math::Box &_box,
+    std::vector<uint32_t> &_ids) const
+{
+  this->dataPtr->Query(
+      [&_box](const double *_min, const double *_max)
+      {
+        return Intersects(_min, _max, _box);
+      },
+      [&_box](const ignition::math::Box &_itemBox)
+      {
+        double min[3];
+        double max[3];
+        Corners(_itemBox, min, max);
+        return Intersects(min, max, _box);
+      }, _ids);
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::QuerySphere(const ignition::math::Vector3d &_center,
+    const double _radius, std::vector<uint32_t> &_ids) const
+{
+  this->dataPtr->Query(
+      [&_center, _radius](const double *_min, const double *_max)
+      {
+        return Intersects(_min, _max, _center, _radius);
+      },
+      [&_center, _radius](const ignition::math::Box &_itemBox)
+      {
+        double min[3];
+        double max[3];
+        Corners(_itemBox, min, max);
+        return Intersects(min, max, _center, _radius);
+      }, _ids);
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::QueryFrustum(const ignition::math::Frustum &_frustum,
+    std::vector<uint32_t> &_ids) const
+{
+  // A box on the outer side of a plane of the frustum has all its children
+  // on the same side, so nodes are tested as the items are.
+  this->dataPtr->Query(
+      [&_frustum](const double *_min, const double *_max)
+      {
+        return _frustum.Contains(ignition::math::Box(
+              ignition::math::Vector3d(_min[0], _min[1], _min[2]),
+              ignition::math::Vector3d(_max[0], _max[1], _max[2])));
+      },
+      [&_frustum](const ignition::math::Box &_itemBox)
+      {
+        return _frustum.Contains(_itemBox);
+      }, _ids);
+}
+
+//////////////////////////////////////////////////
+int SpatialIndexPrivate::Allocate()
+{
+  if (this->freeNodes < 0)
+  {
+    this->nodes.push_back(SpatialIndexNode());
+    return static_cast<int>(this->nodes.size()) - 1;
+  }
+
+  const int node = this->freeNodes;
+  this->freeNodes = this->nodes[node].parent;
+  this->nodes[node] = SpatialIndexNode();
+  return node;
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::Free(const int _node)
+{
+  this->nodes[_node].parent = this->freeNodes;
+  this->nodes[_node].child1 = -1;
+  this->nodes[_node].child2 = -1;
+  this->nodes[_node].height = -1;
+  this->freeNodes = _node;
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::Combine(const int _node, const int _a, const int _b)
+{
+  SpatialIndexNode &node = this->nodes[_node];
+  const SpatialIndexNode &a = this->nodes[_a];
+  const SpatialIndexNode &b = this->nodes[_b];
+  for (int i = 0; i < 3; ++i)
+  {
+    node.min[i] = std::min(a.min[i], b.min[i]);
+    node.max[i] = std::max(a.max[i], b.max[i]);
+  }
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::InsertLeaf(const int _leaf)
+{
+  if (this->root < 0)
+  {
+    this->root = _leaf;
+    this->nodes[_leaf].parent = -1;
+    return;
+  }
+
+  // Walk down to the sibling whose box grows the least, counting the
+  // growth of the ancestors that would also have to be enlarged.
+  const SpatialIndexNode &leaf = this->nodes[_leaf];
+  int index = this->root;
+  while (!this->nodes[index].IsLeaf())
+  {
+    const SpatialIndexNode &node = this->nodes[index];
+    const double area = Area(node.min, node.max);
+    const double combinedArea = CombinedArea(node, leaf);
+
+    // Cost of making a new parent for this node and the leaf, and minimum
+    // cost of pushing the leaf further down.
+    const double cost = 2.0 * combinedArea;
+    const double inheritance = 2.0 * (combinedArea - area);
+
+    double childCosts[2];
+    const int children[2] = {node.child1, node.child2};
+    for (int i = 0; i < 2; ++i)
+    {
+      const SpatialIndexNode &child = this->nodes[children[i]];
+      childCosts[i] = CombinedArea(child, leaf) + inheritance;
+      if (!child.IsLeaf())
+        childCosts[i] -= Area(child.min, child.max);
+    }
+
+    if (cost < childCosts[0] && cost < childCosts[1])
+      break;
+
+    index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+  }
+  const int sibling = index;
+
+  const int oldParent = this->nodes[sibling].parent;
+  const int newParent = this->Allocate();
+  this->nodes[newParent].parent = oldParent;
+  this->nodes[newParent].child1 = sibling;
+  this->nodes[newParent].child2 = _leaf;
+  this->nodes[newParent].height = this->nodes[sibling].height + 1;
+  this->Combine(newParent, sibling, _leaf);
+  this->nodes[sibling].parent = newParent;
+  this->nodes[_leaf].parent = newParent;
+
+  if (oldParent < 0)
+  {
+    this->root = newParent;
+  }
+  else if (this->nodes[oldParent].child1 == sibling)
+  {
+    this->nodes[oldParent].child1 = newParent;
+  }
+  else
+  {
+    this->nodes[oldParent].child2 = newParent;
+  }
+
+  this->Refit(oldParent);
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::RemoveLeaf(const int _leaf)
+{
+  if (_leaf == this->root)
+  {
+    this->root = -1;
+    return;
+  }
+
+  const int parent = this->nodes[_leaf].parent;
+  const int grandParent = this->nodes[parent].parent;
+  const int sibling = this->nodes[parent].child1 == _leaf ?
+    this->nodes[parent].child2 : this->nodes[parent].child1;
+
+  this->nodes[sibling].parent = grandParent;
+  if (grandParent < 0)
+  {
+    this->root = sibling;
+  }
+  else if (this->nodes[grandParent].child1 == parent)
+  {
+    this->nodes[grandParent].child1 = sibling;
+  }
+  else
+  {
+    this->nodes[grandParent].child2 = sibling;
+  }
+
+  this->nodes[_leaf].parent = -1;
+  this->Free(parent);
+  this->Refit(grandParent);
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::Refit(int _node)
+{
+  while (_node >= 0)
+  {
+    _node = this->Balance(_node);
+
+    SpatialIndexNode &node = this->nodes[_node];
+    node.height = 1 + std::max(this->nodes[node.child1].height,
+        this->nodes[node.child2].height);
+    this->Combine(_node, node.child1, node.child2);
+
+    _node = node.parent;
+  }
+}
+
+//////////////////////////////////////////////////
+int SpatialIndexPrivate::Balance(const int _node)
+{
+  SpatialIndexNode &a = this->nodes[_node];
+  if (a.IsLeaf() || a.height < 2)
+    return _node;
+
+  const int iB = a.child1;
+  const int iC = a.child2;
+  SpatialIndexNode &b = this->nodes[iB];
+  SpatialIndexNode &c = this->nodes[iC];
+  const int balance = c.height - b.height;
+
+  if (balance > 1)
+  {
+    // Rotate C up, A takes the shorter child of C.
+    const int iF = c.child1;
+    const int iG = c.child2;
+
+    c.child1 = _node;
+    c.parent = a.parent;
+    a.parent = iC;
+
+    if (c.parent < 0)
+      this->root = iC;
+    else if (this->nodes[c.parent].child1 == _node)
+      this->nodes[c.parent].child1 = iC;
+    else
+      this->nodes[c.parent].child2 = iC;
+
+    const bool keepF = this->nodes[iF].height > this->nodes[iG].height;
+    const int iKeep = keepF ? iF : iG;
+    const int iMove = keepF ? iG : iF;
+
+    c.child2 = iKeep;
+    a.child2 = iMove;
+    this->nodes[iMove].parent = _node;
+
+    this->Combine(_node, iB, iMove);
+    this->Combine(iC, _node, iKeep);
+    a.height = 1 + std::max(b.height, this->nodes[iMove].height);
+    c.height = 1 + std::max(a.height, this->nodes[iKeep].height);
+
+    return iC;
+  }
+
+  if (balance < -1)
+  {
+    // Rotate B up, A takes the shorter child of B.
+    const int iD = b.child1;
+    const int iE = b.child2;
+
+    b.child1 = _node;
+    b.parent = a.parent;
+    a.parent = iB;
+
+    if (b.parent < 0)
+      this->root = iB;
+    else if (this->nodes[b.parent].child1 == _node)
+      this->nodes[b.parent].child1 = iB;
+    else
+      this->nodes[b.parent].child2 = iB;
+
+    const bool keepD = this->nodes[iD].height > this->nodes[iE].height;
+    const int iKeep = keepD ? iD : iE;
+    const int iMove = keepD ? iE : iD;
+
+    b.child2 = iKeep;
+    a.child1 = iMove;
+    this->nodes[iMove].parent = _node;
+
+    this->Combine(_node, iC, iMove);
+    this->Combine(iB, _node, iKeep);
+    a.height = 1 + std::max(c.height, this->nodes[iMove].height);
+    b.height = 1 + std::max(a.height, this->nodes[iKeep].height);
+
+    return iB;
+  }
+
+  return _node;
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_SPATIALINDEX_HH_
+#define GAZEBO_PHYSICS_SPATIALINDEX_HH_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <ignition/math/Box.hh>
+#include <ignition/math/Frustum.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class SpatialIndexPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class SpatialIndex SpatialIndex.hh physics/physics.hh
+    /// \brief Dynamic bounding box tree over items identified by an id,
+    /// such as the models or links of a world, see World::ModelsInFrustum.
+    ///
+    /// The tree stores a box enlarged by a margin for each item. An item
+    /// that moves within its enlarged box only has its box replaced, the
+    /// tree is only changed when it leaves it. The tree is kept balanced
+    /// with rotations, as items are inserted and removed.
+    ///
+    /// Queries test the boxes the items were last updated with. Items with
+    /// boxes that are empty or not finite, such as planes, are kept outside
+    /// the tree and tested by every query.
+    ///
+    /// A SpatialIndex is not thread safe, the caller must lock it.
+    class GZ_PHYSICS_VISIBLE SpatialIndex
+    {
+      /// \brief Constructor.
+      public: SpatialIndex();
+
+      /// \brief Destructor.
+      public: ~SpatialIndex();
+
+      /// \brief Set the margin the boxes of the items are enlarged by in
+      /// the tree. Larger margins change the tree less often as items move,
+      /// but make queries visit more nodes. Only applies to the boxes
+      /// inserted afterwards.
+      /// \param[in] _margin Margin in meters, negative values are ignored.
+      public: void SetMargin(const double _margin);
+
+      /// \brief Get the margin the boxes of the items are enlarged by.
+      /// \return Margin in meters.
+      public: double Margin() const;
+
+      /// \brief Insert an item, or update the box of an item.
+      /// \param[in] _id Id of the item.
+      /// \param[in] _box Bounding box of the item.
+      public: void Update(const uint32_t _id, const ignition::math::Box &_box);
+
+      /// \brief Remove an item.
+      /// \param[in] _id Id of the item.
+      /// \return False if there is no item with this id.
+      public: bool Remove(const uint32_t _id);
+
+      /// \brief Remove all the items.
+      public: void Clear();
+
+      /// \brief Get the number of items.
+      /// \return Number of items.
+      public: size_t Size() const;
+
+      /// \brief Get whether an item is in the index.
+      /// \param[in] _id Id of the item.
+      /// \return True if there is an item with this id.
+      public: bool Has(const uint32_t _id) const;
+
+      /// \brief Get the height of the tree, for diagnostics.
+      /// \return Number of levels of the tree, 0 if it is empty.
+      public: unsigned int Height() const;
+
+      /// \brief Find the items whose boxes intersect a box.
+      /// \param[in] _box The box.
+      /// \param[out] _ids Ids of the items, appended in no specific order.
+      public: void QueryBox(const ignition::math::Box &_box,
+                  std::vector<uint32_t> &_ids) const;
+
+      /// \brief Find the items whose boxes intersect a sphere.
+      /// \param[in] _center Center of the sphere.
+      /// \param[in] _radius Radius of the sphere.
+      /// \param[out] _ids Ids of the items, appended in no specific order.
+      public: void QuerySphere(const ignition::math::Vector3d &_center,
+                  const double _radius, std::vector<uint32_t> &_ids) const;
+
+      /// \brief Find the items whose boxes are in a frustum, as tested by
+      /// ignition::math::Frustum::Contains.
+      /// \param[in] _frustum The frustum.
+      /// \param[out] _ids Ids of the items, appended in no specific order.
+      public: void QueryFrustum(const ignition::math::Frustum &_frustum,
+                  std::vector<uint32_t> &_ids) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<SpatialIndexPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
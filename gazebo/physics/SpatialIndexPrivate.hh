@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_SPATIALINDEXPRIVATE_HH_
+#define GAZEBO_PHYSICS_SPATIALINDEXPRIVATE_HH_
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <ignition/math/Box.hh>
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Node of the tree of a SpatialIndex.
+    class SpatialIndexNode
+    {
+      /// \brief Get whether the node is a leaf.
+      /// \return True if the node is a leaf.
+      public: bool IsLeaf() const
+              {
+                return this->child1 < 0;
+              }
+
+      /// \brief Minimum corner of the enlarged box of a leaf, or of the
+      /// box of the children of an inner node.
+      public: double min[3];
+
+      /// \brief Maximum corner of the enlarged box of a leaf, or of the
+      /// box of the children of an inner node.
+      public: double max[3];
+
+      /// \brief Box of the item of a leaf, as it was last updated.
+      public: ignition::math::Box box;
+
+      /// \brief Parent node, -1 for the root. Next free node for a free
+      /// node.
+      public: int parent = -1;
+
+      /// \brief First child, -1 for a leaf.
+      public: int child1 = -1;
+
+      /// \brief Second child, -1 for a leaf.
+      public: int child2 = -1;
+
+      /// \brief Height of the node above the leaves, 0 for a leaf and -1
+      /// for a free node.
+      public: int height = -1;
+
+      /// \brief Id of the item of a leaf.
+      public: uint32_t id = 0;
+    };
+
+    /// \internal
+    /// \brief Private data for SpatialIndex.
+    class SpatialIndexPrivate
+    {
+      /// \brief Get a free node.
+      /// \return Index of the node.
+      public: int Allocate();
+
+      /// \brief Return a node to the free list.
+      /// \param[in] _node Index of the node.
+      public: void Free(const int _node);
+
+      /// \brief Insert a leaf in the tree, next to the node whose box grows
+      /// the least.
+      /// \param[in] _leaf Index of the leaf.
+      public: void InsertLeaf(const int _leaf);
+
+      /// \brief Remove a leaf from the tree. The leaf is not freed.
+      /// \param[in] _leaf Index of the leaf.
+      public: void RemoveLeaf(const int _leaf);
+
+      /// \brief Recompute the boxes and heights of the ancestors of a
+      /// node, rotating them where their children are unbalanced.
+      /// \param[in] _node Index of the first ancestor.
+      public: void Refit(int _node);
+
+      /// \brief Rotate a node if its children are unbalanced.
+      /// \param[in] _node Index of the node.
+      /// \return Index of the node that replaced it in the tree.
+      public: int Balance(const int _node);
+
+      /// \brief Set the box of a node to the union of the boxes of two
+      /// other nodes.
+      /// \param[in] _node Index of the node to set.
+      /// \param[in] _a Index of the first node.
+      /// \param[in] _b Index of the second node.
+      public: void Combine(const int _node, const int _a, const int _b);
+
+      /// \brief Visit the leaves of the tree.
+      /// \param[in] _overlaps Called with the minimum and maximum corners
+      /// of a node, returns false to skip the node and its children.
+      /// \param[in] _accept Called with the box of the item of a leaf
+      /// whose node overlaps, returns true to report its id.
+      /// \param[out] _ids Ids of the reported items.
+      public: template<typename Overlaps, typename Accept>
+              void Query(Overlaps _overlaps, Accept _accept,
+                  std::vector<uint32_t> &_ids) const;
+
+      /// \brief Margin the boxes of the leaves are enlarged by.
+      public: double margin = 0.1;
+
+      /// \brief Nodes of the tree, and free nodes.
+      public: std::vector<SpatialIndexNode> nodes;
+
+      /// \brief Root of the tree, -1 if it is empty.
+      public: int root = -1;
+
+      /// \brief First free node, -1 if there is none.
+      public: int freeNodes = -1;
+
+      /// \brief Leaf of each item in the tree, by id.
+      public: std::unordered_map<uint32_t, int> leaves;
+
+      /// \brief Items kept outside the tree, because their boxes are empty
+      /// or not finite, by id.
+      public: std::unordered_map<uint32_t, ignition::math::Box> unbounded;
+    };
+  }
+}
+#endif
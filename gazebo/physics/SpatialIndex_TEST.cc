@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "gazebo/physics/SpatialIndex.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class SpatialIndexTest : public gazebo::testing::AutoLogFixture { };
+
+/// \brief Sorted ids.
+/// \param[in] _ids Ids in any order.
+/// \return The ids as a set.
+static std::set<uint32_t> Ids(const std::vector<uint32_t> &_ids)
+{
+  return std::set<uint32_t>(_ids.begin(), _ids.end());
+}
+
+//////////////////////////////////////////////////
+TEST_F(SpatialIndexTest, Basic)
+{
+  physics::SpatialIndex index;
+  EXPECT_EQ(index.Size(), 0u);
+  EXPECT_EQ(index.Height(), 0u);
+  EXPECT_DOUBLE_EQ(index.Margin(), 0.1);
+
+  index.SetMargin(-1);
+  EXPECT_DOUBLE_EQ(index.Margin(), 0.1);
+  index.SetMargin(0.5);
+  EXPECT_DOUBLE_EQ(index.Margin(), 0.5);
+
+  index.Update(1, ignition::math::Box(
+        ignition::math::Vector3d(0, 0, 0), ignition::math::Vector3d(1, 1, 1)));
+  index.Update(2, ignition::math::Box(
+        ignition::math::Vector3d(5, 0, 0), ignition::math::Vector3d(6, 1, 1)));
+  EXPECT_EQ(index.Size(), 2u);
+  EXPECT_TRUE(index.Has(1));
+  EXPECT_FALSE(index.Has(3));
+  EXPECT_EQ(index.Height(), 2u);
+
+  std::vector<uint32_t> ids;
+  index.QueryBox(ignition::math::Box(
+        ignition::math::Vector3d(0.5, 0.5, 0.5),
+        ignition::math::Vector3d(2, 2, 2)), ids);
+  EXPECT_EQ(Ids(ids), std::set<uint32_t>({1}));
+
+  // Queries test the boxes, not the enlarged boxes of the tree.
+  ids.clear();
+  index.QueryBox(ignition::math::Box(
+        ignition::math::Vector3d(1.2, 0, 0),
+        ignition::math::Vector3d(4.8, 1, 1)), ids);
+  EXPECT_TRUE(ids.empty());
+
+  ids.clear();
+  index.QuerySphere(ignition::math::Vector3d(3, 0.5, 0.5), 2.1, ids);
+  EXPECT_EQ(Ids(ids), std::set<uint32_t>({1, 2}));
+
+  // Move within the margin, then out of it.
+  index.Update(1, ignition::math::Box(
+        ignition::math::Vector3d(0.2, 0, 0),
+        ignition::math::Vector3d(1.2, 1, 1)));
+  ids.clear();
+  index.QuerySphere(ignition::math::Vector3d(1.15, 0.5, 0.5), 0.01, ids);
+  EXPECT_EQ(Ids(ids), std::set<uint32_t>({1}));
+
+  index.Update(1, ignition::math::Box(
+        ignition::math::Vector3d(10, 0, 0),
+        ignition::math::Vector3d(11, 1, 1)));
+  ids.clear();
+  index.QuerySphere(ignition::math::Vector3d(1.15, 0.5, 0.5), 0.01, ids);
+  EXPECT_TRUE(ids.empty());
+  index.QuerySphere(ignition::math::Vector3d(10.5, 0.5, 0.5), 0.05, ids);
+  EXPECT_EQ(Ids(ids), std::set<uint32_t>({1}));
+
+  EXPECT_TRUE(index.Remove(1));
+  EXPECT_FALSE(index.Remove(1));
+  EXPECT_EQ(index.Size(), 1u);
+
+  index.Clear();
+  EXPECT_EQ(index.Size(), 0u);
+  EXPECT_FALSE(index.Has(2));
+}
+
+//////////////////////////////////////////////////
+TEST_F(SpatialIndexTest, Unbounded)
+{
+  physics::SpatialIndex index;
+  const double inf = std::numeric_limits<double>::infinity();
+
+  // A plane, and a model without collisions.
+  index.Update(1, ignition::math::Box(
+        ignition::math::Vector3d(-inf, -inf, -inf),
+        ignition::math::Vector3d(inf, inf, 0)));
+  ignition::math::Box empty;
+  empty.Min().Set(1, 1, 1);
+  empty.Max().Set(-1, -1, -1);
+  index.Update(2, empty);
+  EXPECT_EQ(index.Size(), 2u);
+  EXPECT_EQ(index.Height(), 0u);
+
+  std::vector<uint32_t> ids;
+  index.QuerySphere(ignition::math::Vector3d(100, 100, -5), 1, ids);
+  EXPECT_EQ(Ids(ids), std::set<uint32_t>({1}));
+
+  ids.clear();
+  index.QueryBox(ignition::math::Box(
+        ignition::math::Vector3d(-1, -1, 1),
+        ignition::math::Vector3d(1, 1, 2)), ids);
+  EXPECT_TRUE(ids.empty());
+
+  // Bounded again
+  index.Update(1, ignition::math::Box(
+        ignition::math::Vector3d(0, 0, 0), ignition::math::Vector3d(1, 1, 1)));
+  EXPECT_EQ(index.Height(), 1u);
+  ids.clear();
+  index.QuerySphere(ignition::math::Vector3d(100, 100, -5), 1, ids);
+  EXPECT_TRUE(ids.empty());
+
+  EXPECT_TRUE(index.Remove(2));
+  EXPECT_EQ(index.Size(), 1u);
+}
+
+//////////////////////////////////////////////////
+TEST_F(SpatialIndexTest, Frustum)
+{
+  physics::SpatialIndex index;
+  for (uint32_t i = 0; i < 20; ++i)
+  {
+    const double x = i * 2.0 - 19.0;
+    index.Update(i, ignition::math::Box(
+          ignition::math::Vector3d(x, -0.5, -0.5),
+          ignition::math::Vector3d(x + 1, 0.5, 0.5)));
+  }
+
+  // Looking along X from the origin, up to 4.5 meters.
+  ignition::math::Frustum frustum;
+  frustum.SetNear(0.1);
+  frustum.SetFar(4.5);
+  frustum.SetFOV(1.0);
+  frustum.SetAspectRatio(1.0);
+  frustum.SetPose(ignition::math::Pose3d(0, 0, 0, 0, 0, 0));
+
+  std::vector<uint32_t> ids;
+  index.QueryFrustum(frustum, ids);
+  EXPECT_EQ(Ids(ids), std::set<uint32_t>({10, 11}));
+}
+
+//////////////////////////////////////////////////
+TEST_F(SpatialIndexTest, Random)
+{
+  physics::SpatialIndex index;
+  std::map<uint32_t, ignition::math::Box> boxes;
+
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> pos(-100, 100);
+  std::uniform_real_distribution<double> size(0, 4);
+
+  for (int i = 0; i < 20000; ++i)
+  {
+    const uint32_t id = gen() % 1000;
+    if (gen() % 10 == 0)
+    {
+      EXPECT_EQ(index.Remove(id), boxes.erase(id) > 0);
+    }
+    else
+    {
+      const ignition::math::Vector3d min(pos(gen), pos(gen), pos(gen));
+      const ignition::math::Vector3d max = min +
+        ignition::math::Vector3d(size(gen), size(gen), size(gen));
+      index.Update(id, ignition::math::Box(min, max));
+      boxes[id] = ignition::math::Box(min, max);
+    }
+
+    if (i % 500 != 0)
+      continue;
+
+    ASSERT_EQ(index.Size(), boxes.size());
+
+    // Compare with testing every box.
+    const ignition::math::Vector3d center(pos(gen), pos(gen), pos(gen));
+    const double radius = 20;
+    std::set<uint32_t> expected;
+    for (auto const &box : boxes)
+    {
+      double dist = 0;
+      for (int j = 0; j < 3; ++j)
+      {
+        const double v = std::max(box.second.Min()[j],
+            std::min(center[j], box.second.Max()[j]));
+        dist += (v - center[j]) * (v - center[j]);
+      }
+      if (dist <= radius * radius)
+        expected.insert(box.first);
+    }
+
+    std::vector<uint32_t> ids;
+    index.QuerySphere(center, radius, ids);
+    EXPECT_EQ(ids.size(), expected.size());
+    EXPECT_EQ(Ids(ids), expected);
+  }
+
+  // The tree stays balanced.
+  EXPECT_LT(index.Height(), 30u);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -25,15 +25,25 @@
 
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
+#include <tbb/task_arena.h>
 
 #include <sdf/sdf.hh>
 
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
 #include <deque>
+#include <functional>
+#include <iterator>
 #include <list>
+#include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include <ignition/math/Helpers.hh>
 #include <ignition/math/Rand.hh>
 
 #include <ignition/msgs/plugin_v.pb.h>
@@ -76,6 +86,8 @@
 #include "gazebo/physics/Light.hh"
 #include "gazebo/physics/Actor.hh"
 #include "gazebo/physics/Wind.hh"
+#include "gazebo/physics/RaycastSnapshot.hh"
+#include "gazebo/physics/WorldSnapshot.hh"
 #include "gazebo/physics/WorldPrivate.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/common/SphericalCoordinates.hh"
@@ -91,20 +103,144 @@ using namespace physics;
 /// This will be replaced with a class member variable in Gazebo 3.0
 bool g_clearModels;
 
+/// \brief Updates groups of models in parallel. The models of a group
+/// are updated in order, on the same thread.
 class ModelUpdate_TBB
 {
-  public: explicit ModelUpdate_TBB(Model_V *_models) : models(_models) {}
+  public: explicit ModelUpdate_TBB(std::vector<Model_V> *_groups)
+          : groups(_groups) {}
   public: void operator() (const tbb::blocked_range<size_t> &_r) const
   {
     for (size_t i = _r.begin(); i != _r.end(); i++)
     {
-      (*models)[i]->Update();
+      for (auto &model : (*groups)[i])
+        model->Update();
     }
   }
 
-  private: Model_V *models;
+  private: std::vector<Model_V> *groups;
 };
 
+/// \brief Remove an entity from the name index of a world.
+/// \param[in] _index The name index.
+/// \param[in] _name Scoped name the entity is indexed by.
+/// \param[in] _id Id of the entity.
+static void EraseIndexedName(
+    std::unordered_multimap<std::string, uint32_t> &_index,
+    const std::string &_name, const uint32_t _id)
+{
+  auto range = _index.equal_range(_name);
+  for (auto iter = range.first; iter != range.second; ++iter)
+  {
+    if (iter->second == _id)
+    {
+      _index.erase(iter);
+      return;
+    }
+  }
+}
+
+/// \brief Number of updates of the spatial index after which the boxes of
+/// all the links are computed again, so that resized shapes are picked up.
+static const uint64_t kSpatialIndexRefresh = 500;
+
+/// \brief Get the entities of a world from their ids.
+/// \param[in] _data Private data of the world.
+/// \param[in] _ids Ids of the entities, sorted by this function.
+/// \return The entities that still exist and are of type T, ordered by id.
+template<typename T>
+static std::vector<boost::shared_ptr<T>> IndexedEntities(
+    const WorldPrivate &_data, std::vector<uint32_t> &_ids)
+{
+  std::sort(_ids.begin(), _ids.end());
+
+  std::vector<boost::shared_ptr<T>> result;
+  result.reserve(_ids.size());
+
+  std::lock_guard<std::mutex> lock(_data.entityIndexMutex);
+  for (auto const id : _ids)
+  {
+    auto iter = _data.entitiesById.find(id);
+    if (iter == _data.entitiesById.end())
+      continue;
+
+    auto entity = boost::dynamic_pointer_cast<T>(iter->second.first.lock());
+    if (entity)
+      result.push_back(entity);
+  }
+  return result;
+}
+
+/// \brief Add a model state, and everything it contains, to a log chunk.
+/// \param[in] _chunk Chunk to add the state to.
+/// \param[in] _parent Index of the parent model in the chunk, -1 for none.
+/// \param[in] _state State of the model.
+static void AddToLogChunk(util::LogChunk &_chunk, const int _parent,
+    const ModelState &_state)
+{
+  const ignition::math::Pose3d &pose = _state.Pose();
+  const ignition::math::Vector3d &scale = _state.Scale();
+  const double modelValues[util::LogChunk::kModelWidth] = {
+      pose.Pos().X(), pose.Pos().Y(), pose.Pos().Z(),
+      pose.Rot().W(), pose.Rot().X(), pose.Rot().Y(), pose.Rot().Z(),
+      scale.X(), scale.Y(), scale.Z()};
+
+  int index = _chunk.AddEntity(util::LogChunk::MODEL, _parent,
+      _state.GetName(), modelValues, util::LogChunk::kModelWidth);
+
+  for (auto const &link : _state.GetLinkStates())
+  {
+    const ignition::math::Pose3d &linkPose = link.second.Pose();
+    const ignition::math::Pose3d &vel = link.second.Velocity();
+    const ignition::math::Vector3d angular = vel.Rot().Euler();
+    const double linkValues[util::LogChunk::kLinkWidth] = {
+        linkPose.Pos().X(), linkPose.Pos().Y(), linkPose.Pos().Z(),
+        linkPose.Rot().W(), linkPose.Rot().X(), linkPose.Rot().Y(),
+        linkPose.Rot().Z(),
+        vel.Pos().X(), vel.Pos().Y(), vel.Pos().Z(),
+        angular.X(), angular.Y(), angular.Z()};
+
+    _chunk.AddEntity(util::LogChunk::LINK, index, link.first, linkValues,
+        util::LogChunk::kLinkWidth);
+  }
+
+  for (auto const &joint : _state.GetJointStates())
+  {
+    const std::vector<double> &positions = joint.second.Positions();
+    _chunk.AddEntity(util::LogChunk::JOINT, index, joint.first,
+        positions.data(), positions.size());
+  }
+
+  for (auto const &nested : _state.NestedModelStates())
+    AddToLogChunk(_chunk, index, nested.second);
+}
+
+/// \brief Add a world state to a log chunk as a new frame.
+/// \param[in] _chunk Chunk to add the state to.
+/// \param[in] _state State of the world.
+static void AddToLogChunk(util::LogChunk &_chunk, const WorldState &_state)
+{
+  _chunk.BeginFrame(_state.GetName(), _state.GetIterations(),
+      _state.GetSimTime(), _state.GetRealTime(), _state.GetWallTime(),
+      _state.Insertions(), _state.Deletions());
+
+  for (auto const &model : _state.GetModelStates())
+    AddToLogChunk(_chunk, -1, model.second);
+
+  for (auto const &light : _state.LightStates())
+  {
+    const ignition::math::Pose3d pose = light.second.Pose();
+    const double values[util::LogChunk::kLightWidth] = {
+        pose.Pos().X(), pose.Pos().Y(), pose.Pos().Z(),
+        pose.Rot().W(), pose.Rot().X(), pose.Rot().Y(), pose.Rot().Z()};
+
+    _chunk.AddEntity(util::LogChunk::LIGHT, -1, light.first, values,
+        util::LogChunk::kLightWidth);
+  }
+
+  _chunk.EndFrame();
+}
+
 //////////////////////////////////////////////////
 World::World(const std::string &_name)
   : dataPtr(new WorldPrivate)
@@ -195,9 +331,18 @@ void World::Load(sdf::ElementPtr _sdf)
     this->dataPtr->node->Advertise<msgs::PosesStamped>("~/pose/local/info", 10);
 
   // pose pub for client with a cap on publishing rate to reduce traffic
-  // overhead
+  // overhead. The cap is applied by posePublisher, which accumulates the
+  // poses that changed between two messages.
   this->dataPtr->posePub = this->dataPtr->node->Advertise<msgs::PosesStamped>(
-    "~/pose/info", 10, 60);
+    "~/pose/info", 10);
+
+  // rendering::Scene depends on the time stamp of the local poses, which is
+  // used by rendering sensors to time stamp their data, so they are
+  // published on every update. Other subscribers of either topic can
+  // lower their own rate, see transport::SubscribeOptions::SetMaxRate.
+  this->dataPtr->posePublisher.AddChannel(this->dataPtr->poseLocalPub, 0,
+      true);
+  this->dataPtr->posePublisher.AddChannel(this->dataPtr->posePub, 60, false);
 
   this->dataPtr->guiPub = this->dataPtr->node->Advertise<msgs::GUI>("~/gui", 5);
   if (this->dataPtr->sdf->HasElement("gui"))
@@ -316,13 +461,13 @@ void World::Load(sdf::ElementPtr _sdf)
       this->ModelByIndex(i)->LoadJoints();
   }
 
-  // TODO: Performance test to see if TBB model updating is necessary
-  // Choose threaded or unthreaded model updating depending on the number of
-  // models in the scene
-  // if (this->ModelCount() < 20)
+  // Models are updated serially unless model update threads are requested.
   this->dataPtr->modelUpdateFunc = &World::ModelUpdateSingleLoop;
-  // else
-  // this->dataPtr->modelUpdateFunc = &World::ModelUpdateTBB;
+  if (this->dataPtr->sdf->HasElement("model_update_threads"))
+  {
+    this->SetModelUpdateThreads(
+        this->dataPtr->sdf->Get<unsigned int>("model_update_threads"));
+  }
 
   event::Events::worldCreated(this->Name());
 
@@ -384,7 +529,6 @@ void World::Init()
   this->dataPtr->updateInfo.worldName = this->Name();
 
   this->dataPtr->iterations = 0;
-  this->dataPtr->logPrevIteration = 0;
 
   util::DiagnosticManager::Instance()->Init(this->Name());
 
@@ -697,6 +841,11 @@ void World::Step()
       if (util::LogRecord::Instance()->BufferSize() > 0)
         util::LogRecord::Instance()->Notify();
       this->dataPtr->pauseTime += stepTime;
+
+      // Build the spatial index enabled, or update the links moved,
+      // while paused.
+      if (this->dataPtr->spatialIndexPending.exchange(false))
+        this->UpdateSpatialIndex();
     }
   }
 
@@ -769,21 +918,6 @@ void World::Update()
 
   DIAG_TIMER_LAP("World::Update", "PhysicsEngine::UpdateCollision");
 
-  // Wait for logging to finish, if it's running.
-  if (util::LogRecord::Instance()->Running())
-  {
-    std::unique_lock<std::mutex> lock(this->dataPtr->logMutex);
-
-    // It's possible the logWorker thread never processed the previous
-    // state. This checks to make sure that we don't continute until the log
-    // worker catchs up.
-    if (this->dataPtr->iterations - this->dataPtr->logPrevIteration > 1)
-    {
-      this->dataPtr->logCondition.notify_one();
-      this->dataPtr->logContinueCondition.wait(lock);
-    }
-  }
-
   // Give clients a possibility to react to collisions before the physics
   // gets updated.
   this->dataPtr->updateInfo.realTime = this->RealTime();
@@ -816,11 +950,49 @@ void World::Update()
     }
 
     DIAG_TIMER_LAP("World::Update", "SetWorldPose(dirtyPoses)");
+
+    this->UpdateSleeping();
+
+    DIAG_TIMER_LAP("World::Update", "UpdateSleeping");
+  }
+
+  // Sensors cast rays against the snapshot from their own threads, after
+  // the poses of this update were propagated.
+  if (this->dataPtr->raySnapshotsEnabled)
+  {
+    auto snapshot = std::make_shared<RaycastSnapshot>();
+    snapshot->Build(shared_from_this(), this->RaySnapshot());
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->raySnapshotMutex);
+      this->dataPtr->raySnapshot = snapshot;
+    }
+
+    DIAG_TIMER_LAP("World::Update", "RaycastSnapshot::Build");
+  }
+
+  if (this->dataPtr->spatialIndexEnabled)
+  {
+    this->dataPtr->spatialIndexPending = false;
+    this->UpdateSpatialIndex();
+
+    DIAG_TIMER_LAP("World::Update", "UpdateSpatialIndex");
   }
 
   // Only update state information if logging data.
   if (util::LogRecord::Instance()->Running())
-    this->dataPtr->logCondition.notify_one();
+  {
+    this->PushLogState();
+  }
+  else if (this->dataPtr->logQueueActive)
+  {
+    this->dataPtr->logQueueActive = false;
+    if (this->dataPtr->logDropped > 0)
+    {
+      gzwarn << "The log worker fell behind, and "
+             << this->dataPtr->logDropped << " states of world["
+             << this->Name() << "] were not recorded.\n";
+    }
+  }
   DIAG_TIMER_LAP("World::Update", "LogRecordNotify");
 
   // Output the contact information
@@ -853,6 +1025,7 @@ void World::Fini()
     this->dataPtr->lightFactoryMsgs.clear();
     this->dataPtr->lightModifyMsgs.clear();
 
+    this->dataPtr->posePublisher.Clear();
     this->dataPtr->poseLocalPub.reset();
     this->dataPtr->posePub.reset();
     this->dataPtr->guiPub.reset();
@@ -881,6 +1054,8 @@ void World::Fini()
   this->dataPtr->testRay.reset();
   this->dataPtr->plugins.clear();
 
+  this->dataPtr->snapshots.clear();
+
   this->dataPtr->publishModelPoses.clear();
   this->dataPtr->publishModelScales.clear();
   this->dataPtr->publishLightPoses.clear();
@@ -1023,11 +1198,104 @@ BasePtr World::BaseByName(const std::string &_name) const
     return BasePtr();
 }
 
+//////////////////////////////////////////////////
+BasePtr World::BaseById(const uint32_t _id) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->entityIndexMutex);
+
+  auto iter = this->dataPtr->entitiesById.find(_id);
+  if (iter == this->dataPtr->entitiesById.end())
+    return BasePtr();
+
+  return iter->second.first.lock();
+}
+
 /////////////////////////////////////////////////
 ModelPtr World::ModelById(unsigned int _id) const
 {
-  return boost::dynamic_pointer_cast<Model>(
-      this->dataPtr->rootElement->GetById(_id));
+  return boost::dynamic_pointer_cast<Model>(this->BaseById(_id));
+}
+
+//////////////////////////////////////////////////
+void World::_IndexEntity(const BasePtr &_base)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->entityIndexMutex);
+
+  const uint32_t id = _base->GetId();
+  const std::string scopedName = _base->GetScopedName();
+
+  auto iter = this->dataPtr->entitiesById.find(id);
+  if (iter != this->dataPtr->entitiesById.end())
+  {
+    if (iter->second.second == scopedName)
+      return;
+
+    // Loaded again with another name
+    EraseIndexedName(this->dataPtr->entityIdsByName, iter->second.second, id);
+  }
+
+  this->dataPtr->entitiesById[id] = std::make_pair(
+      boost::weak_ptr<Base>(_base), scopedName);
+  this->dataPtr->entityIdsByName.insert(std::make_pair(scopedName, id));
+  ++this->dataPtr->entityIndexVersion;
+}
+
+//////////////////////////////////////////////////
+void World::_RenameIndexedEntity(const uint32_t _id,
+    const std::string &_scopedName)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->entityIndexMutex);
+
+  auto iter = this->dataPtr->entitiesById.find(_id);
+  if (iter == this->dataPtr->entitiesById.end() ||
+      iter->second.second == _scopedName)
+  {
+    return;
+  }
+
+  EraseIndexedName(this->dataPtr->entityIdsByName, iter->second.second, _id);
+
+  iter->second.second = _scopedName;
+  this->dataPtr->entityIdsByName.insert(std::make_pair(_scopedName, _id));
+  ++this->dataPtr->entityIndexVersion;
+}
+
+//////////////////////////////////////////////////
+void World::_UnindexEntity(const uint32_t _id)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->entityIndexMutex);
+
+  auto iter = this->dataPtr->entitiesById.find(_id);
+  if (iter == this->dataPtr->entitiesById.end())
+    return;
+
+  EraseIndexedName(this->dataPtr->entityIdsByName, iter->second.second, _id);
+
+  this->dataPtr->entitiesById.erase(iter);
+  ++this->dataPtr->entityIndexVersion;
+}
+
+//////////////////////////////////////////////////
+BasePtr World::_IndexedEntity(const std::string &_scopedName) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->entityIndexMutex);
+
+  auto range = this->dataPtr->entityIdsByName.equal_range(_scopedName);
+  if (range.first == range.second || std::next(range.first) != range.second)
+    return BasePtr();
+
+  auto iter = this->dataPtr->entitiesById.find(range.first->second);
+  if (iter == this->dataPtr->entitiesById.end())
+    return BasePtr();
+
+  return iter->second.first.lock();
+}
+
+//////////////////////////////////////////////////
+uint64_t World::_EntityVersion() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->entityIndexMutex);
+  return this->dataPtr->entityIndexVersion;
 }
 
 //////////////////////////////////////////////////
@@ -1077,6 +1345,7 @@ ModelPtr World::LoadModel(sdf::ElementPtr _sdf , BasePtr _parent)
 
   this->PublishModelPose(model);
   this->dataPtr->models.push_back(model);
+  this->dataPtr->modelUpdateGroupsDirty = true;
   return model;
 }
 
@@ -1122,6 +1391,7 @@ ActorPtr World::LoadActor(sdf::ElementPtr _sdf , BasePtr _parent)
   this->EnableAllModels();
   this->PublishModelPose(actor);
   this->dataPtr->models.push_back(actor);
+  this->dataPtr->modelUpdateGroupsDirty = true;
 
   return actor;
 }
@@ -1511,12 +1781,263 @@ void World::BuildSceneMsg(msgs::Scene &_scene, BasePtr _entity)
 
 
 //////////////////////////////////////////////////
-// void World::ModelUpdateTBB()
-// {
-//   tbb::parallel_for (tbb::blocked_range<size_t>(0,
-//   this->dataPtr->models.size(), 10),
-//       ModelUpdate_TBB(&this->dataPtr->models));
-// }
+void World::SetModelUpdateThreads(const unsigned int _threads)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+
+  this->dataPtr->modelUpdateThreads = _threads;
+  if (_threads > 0)
+  {
+    this->dataPtr->modelUpdateArena.reset(new tbb::task_arena(_threads));
+    this->dataPtr->modelUpdateGroupsDirty = true;
+    this->dataPtr->modelUpdateFunc = &World::ModelUpdateTBB;
+  }
+  else
+  {
+    this->dataPtr->modelUpdateFunc = &World::ModelUpdateSingleLoop;
+    this->dataPtr->modelUpdateArena.reset();
+    this->dataPtr->modelUpdateGroups.clear();
+    this->dataPtr->serialUpdateEntities.clear();
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int World::ModelUpdateThreads() const
+{
+  return this->dataPtr->modelUpdateThreads;
+}
+
+//////////////////////////////////////////////////
+void World::SetSkipSleeping(const bool _skip)
+{
+  this->dataPtr->skipSleeping = _skip;
+}
+
+//////////////////////////////////////////////////
+bool World::SkipSleeping() const
+{
+  return this->dataPtr->skipSleeping;
+}
+
+//////////////////////////////////////////////////
+void World::_SetLinkSleeping(Link *_link, const bool _sleeping)
+{
+  GZ_ASSERT(_link != nullptr, "_link is nullptr");
+
+  // Engines may report links from their own threads.
+  std::lock_guard<std::mutex> lock(this->dataPtr->sleepChangesMutex);
+  this->dataPtr->sleepChanges.push_back(
+      std::make_pair(_link->GetId(), _sleeping));
+}
+
+//////////////////////////////////////////////////
+void World::_SetLinkMoved()
+{
+  if (!this->dataPtr->spatialIndexEnabled)
+    return;
+
+  this->dataPtr->spatialIndexMoved = true;
+  this->dataPtr->spatialIndexPending = true;
+}
+
+//////////////////////////////////////////////////
+void World::UpdateSleeping()
+{
+  std::vector<WorldSleepingModel> &models = this->dataPtr->sleepingModels;
+  auto &modelOfLink = this->dataPtr->sleepingModelOfLink;
+  auto &sleepingLinks = this->dataPtr->sleepingLinks;
+
+  // Models were added or removed, count their sleeping links again.
+  const uint64_t version = this->_EntityVersion();
+  if (!this->dataPtr->sleepingBuilt ||
+      version != this->dataPtr->sleepingVersion)
+  {
+    models.clear();
+    modelOfLink.clear();
+    std::unordered_set<uint32_t> stillSleeping;
+    std::vector<ModelPtr> nested;
+    for (auto const &model : this->dataPtr->models)
+    {
+      if (!model)
+        continue;
+
+      WorldSleepingModel item;
+      item.model = model.get();
+
+      nested.assign(1, model);
+      while (!nested.empty())
+      {
+        const ModelPtr current = nested.back();
+        nested.pop_back();
+
+        for (auto const &link : current->GetLinks())
+        {
+          if (!link || link->IsStatic())
+            continue;
+
+          ++item.links;
+          modelOfLink[link->GetId()] = models.size();
+          if (sleepingLinks.count(link->GetId()))
+          {
+            ++item.sleepingLinks;
+            stillSleeping.insert(link->GetId());
+          }
+        }
+
+        for (auto const &child : current->NestedModels())
+        {
+          if (child)
+            nested.push_back(child);
+        }
+      }
+
+      model->_SetSleeping(item.links > 0 && item.sleepingLinks == item.links);
+      if (item.links > 0)
+        models.push_back(item);
+    }
+
+    // Forget the links that were removed.
+    sleepingLinks.swap(stillSleeping);
+    this->dataPtr->sleepingVersion = version;
+    this->dataPtr->sleepingBuilt = true;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->sleepChangesMutex);
+    this->dataPtr->appliedSleepChanges.swap(this->dataPtr->sleepChanges);
+  }
+
+  for (auto const &change : this->dataPtr->appliedSleepChanges)
+  {
+    const bool changed = change.second ?
+      sleepingLinks.insert(change.first).second :
+      sleepingLinks.erase(change.first) > 0;
+
+    auto iter = modelOfLink.find(change.first);
+    if (!changed || iter == modelOfLink.end())
+      continue;
+
+    WorldSleepingModel &item = models[iter->second];
+    if (change.second)
+      ++item.sleepingLinks;
+    else
+      --item.sleepingLinks;
+    item.model->_SetSleeping(item.sleepingLinks == item.links);
+  }
+  this->dataPtr->appliedSleepChanges.clear();
+}
+
+//////////////////////////////////////////////////
+void World::_DirtyModelUpdateGroups()
+{
+  this->dataPtr->modelUpdateGroupsDirty = true;
+}
+
+//////////////////////////////////////////////////
+void World::BuildModelUpdateGroups()
+{
+  this->dataPtr->modelUpdateGroups.clear();
+  this->dataPtr->serialUpdateEntities.clear();
+
+  // Top level models that can be updated in parallel, in update order.
+  Model_V models;
+  std::map<Model *, size_t> modelIndices;
+
+  for (unsigned int i = 0; i < this->dataPtr->rootElement->GetChildCount(); ++i)
+  {
+    BasePtr child = this->dataPtr->rootElement->GetChild(i);
+
+    // Actors move their links kinematically every update, so they are
+    // kept on the world thread together with non-model entities.
+    ModelPtr model = boost::dynamic_pointer_cast<Model>(child);
+    if (!model || child->HasType(Base::ACTOR))
+    {
+      this->dataPtr->serialUpdateEntities.push_back(child);
+      continue;
+    }
+
+    modelIndices[model.get()] = models.size();
+    models.push_back(model);
+  }
+
+  // Models connected by a joint must be updated on the same thread, since
+  // updating one of them may apply forces to the other one's links.
+  std::vector<size_t> groupOf(models.size());
+  for (size_t i = 0; i < groupOf.size(); ++i)
+    groupOf[i] = i;
+
+  std::function<size_t(size_t)> findGroup = [&](size_t _index)
+  {
+    while (groupOf[_index] != _index)
+    {
+      groupOf[_index] = groupOf[groupOf[_index]];
+      _index = groupOf[_index];
+    }
+    return _index;
+  };
+
+  std::function<void(size_t, const ModelPtr &)> joinJointModels =
+    [&](size_t _index, const ModelPtr &_model)
+  {
+    for (auto const &joint : _model->GetJoints())
+    {
+      for (auto const &link : {joint->GetParent(), joint->GetChild()})
+      {
+        if (!link)
+          continue;
+
+        auto iter = modelIndices.find(link->GetParentModel().get());
+        if (iter != modelIndices.end())
+        {
+          size_t a = findGroup(_index);
+          size_t b = findGroup(iter->second);
+          if (a != b)
+            groupOf[std::max(a, b)] = std::min(a, b);
+        }
+      }
+    }
+
+    for (auto const &nested : _model->NestedModels())
+      joinJointModels(_index, nested);
+  };
+
+  for (size_t i = 0; i < models.size(); ++i)
+    joinJointModels(i, models[i]);
+
+  // Keep the groups, and the models inside them, in update order.
+  std::map<size_t, size_t> groupIndices;
+  for (size_t i = 0; i < models.size(); ++i)
+  {
+    size_t root = findGroup(i);
+    auto iter = groupIndices.find(root);
+    if (iter == groupIndices.end())
+    {
+      iter = groupIndices.insert(
+          std::make_pair(root, this->dataPtr->modelUpdateGroups.size())).first;
+      this->dataPtr->modelUpdateGroups.push_back(Model_V());
+    }
+    this->dataPtr->modelUpdateGroups[iter->second].push_back(models[i]);
+  }
+
+  this->dataPtr->modelUpdateGroupsDirty = false;
+}
+
+//////////////////////////////////////////////////
+void World::ModelUpdateTBB()
+{
+  if (this->dataPtr->modelUpdateGroupsDirty)
+    this->BuildModelUpdateGroups();
+
+  for (auto &entity : this->dataPtr->serialUpdateEntities)
+    entity->Update();
+
+  std::vector<Model_V> *groups = &this->dataPtr->modelUpdateGroups;
+  this->dataPtr->modelUpdateArena->execute([groups]()
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, groups->size(), 1),
+        ModelUpdate_TBB(groups));
+  });
+}
 
 //////////////////////////////////////////////////
 void World::ModelUpdateSingleLoop()
@@ -1761,6 +2282,31 @@ void World::ProcessRequestMsgs()
       this->dataPtr->sceneMsg.SerializeToString(serializedData);
       response.set_type(this->dataPtr->sceneMsg.GetTypeName());
     }
+    else if (requestMsg.request() == "save_snapshot")
+    {
+      msgs::Int handleMsg;
+      handleMsg.set_data(static_cast<int32_t>(this->SaveSnapshot()));
+
+      std::string *serializedData = response.mutable_serialized_data();
+      handleMsg.SerializeToString(serializedData);
+      response.set_type(handleMsg.GetTypeName());
+    }
+    else if (requestMsg.request() == "restore_snapshot" ||
+             requestMsg.request() == "remove_snapshot")
+    {
+      const int handle = ignition::math::parseInt(requestMsg.data());
+      bool found = false;
+      if (handle > 0 && requestMsg.request() == "restore_snapshot")
+        found = this->RestoreSnapshot(static_cast<uint32_t>(handle));
+      else if (handle > 0)
+        found = this->RemoveSnapshot(static_cast<uint32_t>(handle));
+
+      if (!found)
+      {
+        response.set_type("error");
+        response.set_response("nonexistent");
+      }
+    }
     else if (requestMsg.request() == "spherical_coordinates_info")
     {
       msgs::SphericalCoordinates sphereCoordMsg;
@@ -2248,6 +2794,269 @@ void World::SetState(const WorldState &_state)
   }
 }
 
+//////////////////////////////////////////////////
+void World::SetState(const WorldSnapshot &_snapshot)
+{
+  this->SetSimTime(_snapshot.SimTime());
+  this->dataPtr->logRealTime = _snapshot.RealTime();
+  this->dataPtr->iterations = _snapshot.Iterations();
+
+  _snapshot.Apply(shared_from_this());
+}
+
+//////////////////////////////////////////////////
+uint32_t World::SaveSnapshot()
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+
+  const uint32_t handle = this->dataPtr->nextSnapshotHandle++;
+  auto &entry = this->dataPtr->snapshots[handle];
+
+  // Start from the last snapshot, so that the layout is shared as long as
+  // the entities don't change.
+  if (this->dataPtr->snapshots.size() > 1)
+    entry.first = std::prev(this->dataPtr->snapshots.end(), 2)->second.first;
+
+  entry.first.Capture(shared_from_this());
+  this->dataPtr->physicsEngine->SaveInternalState(entry.second);
+
+  return handle;
+}
+
+//////////////////////////////////////////////////
+bool World::RestoreSnapshot(const uint32_t _handle)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+
+  auto iter = this->dataPtr->snapshots.find(_handle);
+  if (iter == this->dataPtr->snapshots.end())
+  {
+    gzerr << "Unable to restore snapshot [" << _handle
+          << "], no such snapshot" << std::endl;
+    return false;
+  }
+
+  const bool rewind = iter->second.first.SimTime() < this->dataPtr->simTime;
+
+  this->SetState(iter->second.first);
+  if (!this->dataPtr->physicsEngine->RestoreInternalState(iter->second.second))
+  {
+    gzwarn << "Entities changed since snapshot [" << _handle
+           << "] was saved, the physics engine state is not restored"
+           << std::endl;
+  }
+
+  // Sensors wait for the time of their next update, which is in the future
+  // once the time goes back.
+  if (rewind)
+    event::Events::timeReset();
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool World::RemoveSnapshot(const uint32_t _handle)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+  return this->dataPtr->snapshots.erase(_handle) > 0;
+}
+
+//////////////////////////////////////////////////
+void World::EnableRaySnapshots()
+{
+  this->dataPtr->raySnapshotsEnabled = true;
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<const RaycastSnapshot> World::RaySnapshot() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->raySnapshotMutex);
+  return this->dataPtr->raySnapshot;
+}
+
+//////////////////////////////////////////////////
+void World::EnableSpatialIndex()
+{
+  // This is called from sensor threads, which must not walk the models
+  // while the world thread changes them. The world thread builds the
+  // index, even while paused.
+  if (!this->dataPtr->spatialIndexEnabled.exchange(true))
+    this->dataPtr->spatialIndexPending = true;
+}
+
+//////////////////////////////////////////////////
+Model_V World::ModelsInFrustum(const ignition::math::Frustum &_frustum) const
+{
+  std::vector<uint32_t> ids;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->spatialIndexMutex);
+    this->dataPtr->modelIndex.QueryFrustum(_frustum, ids);
+  }
+  return IndexedEntities<Model>(*this->dataPtr, ids);
+}
+
+//////////////////////////////////////////////////
+Model_V World::ModelsInSphere(const ignition::math::Vector3d &_center,
+    const double _radius) const
+{
+  std::vector<uint32_t> ids;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->spatialIndexMutex);
+    this->dataPtr->modelIndex.QuerySphere(_center, _radius, ids);
+  }
+  return IndexedEntities<Model>(*this->dataPtr, ids);
+}
+
+//////////////////////////////////////////////////
+Model_V World::ModelsInBox(const ignition::math::Box &_box) const
+{
+  std::vector<uint32_t> ids;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->spatialIndexMutex);
+    this->dataPtr->modelIndex.QueryBox(_box, ids);
+  }
+  return IndexedEntities<Model>(*this->dataPtr, ids);
+}
+
+//////////////////////////////////////////////////
+Link_V World::LinksInSphere(const ignition::math::Vector3d &_center,
+    const double _radius) const
+{
+  std::vector<uint32_t> ids;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->spatialIndexMutex);
+    this->dataPtr->linkIndex.QuerySphere(_center, _radius, ids);
+  }
+  return IndexedEntities<Link>(*this->dataPtr, ids);
+}
+
+//////////////////////////////////////////////////
+Link_V World::LinksInBox(const ignition::math::Box &_box) const
+{
+  std::vector<uint32_t> ids;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->spatialIndexMutex);
+    this->dataPtr->linkIndex.QueryBox(_box, ids);
+  }
+  return IndexedEntities<Link>(*this->dataPtr, ids);
+}
+
+//////////////////////////////////////////////////
+uint64_t World::SpatialIndexUpdates() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->spatialIndexMutex);
+  return this->dataPtr->spatialIndexUpdates;
+}
+
+//////////////////////////////////////////////////
+void World::UpdateSpatialIndex()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->spatialIndexMutex);
+
+  const uint64_t update = ++this->dataPtr->spatialIndexUpdates;
+  const uint64_t version = this->_EntityVersion();
+  const bool entitiesChanged = version != this->dataPtr->spatialIndexVersion;
+  const bool refresh = update % kSpatialIndexRefresh == 0;
+  const bool skipSleeping = this->dataPtr->skipSleeping;
+  const bool moved = this->dataPtr->spatialIndexMoved.exchange(false);
+
+  std::vector<ModelPtr> nested;
+  for (auto const &model : this->dataPtr->models)
+  {
+    if (!model)
+      continue;
+
+    // The links of a sleeping model did not move. They are only visited
+    // when entities change, to find the ones that were removed, on
+    // refreshes, in case an engine did not report a link it moved, and
+    // when a link was moved, which wakes its model on the next update.
+    if (skipSleeping && !entitiesChanged && !refresh && !moved &&
+        model->IsSleeping() && this->dataPtr->modelIndex.Has(model->GetId()))
+    {
+      continue;
+    }
+
+    bool changed = refresh || entitiesChanged ||
+      !this->dataPtr->modelIndex.Has(model->GetId());
+
+    // As Model::BoundingBox, the box of a model only covers its own links.
+    // The links of nested models are only in the link index.
+    ignition::math::Box box;
+    box.Min().Set(FLT_MAX, FLT_MAX, FLT_MAX);
+    box.Max().Set(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+    nested.assign(1, model);
+    while (!nested.empty())
+    {
+      const ModelPtr current = nested.back();
+      nested.pop_back();
+
+      for (auto const &link : current->GetLinks())
+      {
+        if (!link)
+          continue;
+
+        WorldSpatialLink &item = this->dataPtr->indexedLinks[link->GetId()];
+        const ignition::math::Pose3d pose = link->WorldPose();
+        if (refresh || item.seen == 0 || pose != item.pose)
+        {
+          item.pose = pose;
+          item.box = link->BoundingBox();
+          this->dataPtr->linkIndex.Update(link->GetId(), item.box);
+          changed = changed || current == model;
+        }
+        item.seen = update;
+
+        if (current == model)
+          box += item.box;
+      }
+
+      for (auto const &child : current->NestedModels())
+      {
+        if (child)
+          nested.push_back(child);
+      }
+    }
+
+    if (changed)
+      this->dataPtr->modelIndex.Update(model->GetId(), box);
+    this->dataPtr->indexedModels[model->GetId()] = update;
+  }
+
+  if (!entitiesChanged)
+    return;
+
+  for (auto iter = this->dataPtr->indexedLinks.begin();
+       iter != this->dataPtr->indexedLinks.end();)
+  {
+    if (iter->second.seen != update)
+    {
+      this->dataPtr->linkIndex.Remove(iter->first);
+      iter = this->dataPtr->indexedLinks.erase(iter);
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+
+  for (auto iter = this->dataPtr->indexedModels.begin();
+       iter != this->dataPtr->indexedModels.end();)
+  {
+    if (iter->second != update)
+    {
+      this->dataPtr->modelIndex.Remove(iter->first);
+      iter = this->dataPtr->indexedModels.erase(iter);
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+
+  this->dataPtr->spatialIndexVersion = version;
+}
+
 //////////////////////////////////////////////////
 void World::InsertModelFile(const std::string &_sdfFilename)
 {
@@ -2317,15 +3126,26 @@ void World::UpdateStateSDF()
 bool World::OnLog(std::ostringstream &_stream)
 {
   int bufferIndex = this->dataPtr->currentStateBuffer;
+  const bool binary = util::LogRecord::Instance()->Encoding() == "binary";
+
   // Save the entire state when its the first call to OnLog.
   if (util::LogRecord::Instance()->FirstUpdate())
   {
     this->dataPtr->sdf->Update();
-    _stream << "<sdf version ='";
-    _stream << SDF_VERSION;
-    _stream << "'>\n";
-    _stream << this->dataPtr->sdf->ToString("");
-    _stream << "</sdf>\n";
+    std::ostringstream sdfStream;
+    sdfStream << "<sdf version ='";
+    sdfStream << SDF_VERSION;
+    sdfStream << "'>\n";
+    sdfStream << this->dataPtr->sdf->ToString("");
+    sdfStream << "</sdf>\n";
+
+    if (binary)
+    {
+      this->dataPtr->logChunk.Clear();
+      util::LogChunk::WriteSDF(_stream, sdfStream.str());
+    }
+    else
+      _stream << sdfStream.str();
   }
   else if (this->dataPtr->states[bufferIndex].size() >= 1)
   {
@@ -2335,11 +3155,21 @@ bool World::OnLog(std::ostringstream &_stream)
     }
     for (auto const &worldState : this->dataPtr->states[bufferIndex])
     {
+      if (binary)
+      {
+        AddToLogChunk(this->dataPtr->logChunk, worldState);
+        continue;
+      }
+
       _stream << "<sdf version='" << SDF_VERSION << "'>"
               << worldState
               << "</sdf>";
     }
 
+    // Only full chunks are written while recording.
+    if (binary)
+      this->dataPtr->logChunk.Write(_stream, false);
+
     this->dataPtr->states[bufferIndex].clear();
   }
 
@@ -2347,6 +3177,18 @@ bool World::OnLog(std::ostringstream &_stream)
   // of data, and reset states.
   if (!util::LogRecord::Instance()->Running())
   {
+    // Give the log worker a chance to buffer the states that are still
+    // queued. It notifies logContinueCondition after each state.
+    {
+      std::unique_lock<std::mutex> lock(this->dataPtr->logMutex);
+      this->dataPtr->logContinueCondition.wait_for(lock,
+          std::chrono::seconds(1), [this]
+          {
+            return this->dataPtr->logQueue.Size() == 0 ||
+              this->dataPtr->stop;
+          });
+    }
+
     std::lock_guard<std::mutex> lock(this->dataPtr->logBufferMutex);
 
     // Output any data that may have been pushed onto the queue
@@ -2354,6 +3196,13 @@ bool World::OnLog(std::ostringstream &_stream)
         i < this->dataPtr->states[this->dataPtr->currentStateBuffer^1].size();
         ++i)
     {
+      if (binary)
+      {
+        AddToLogChunk(this->dataPtr->logChunk,
+            this->dataPtr->states[this->dataPtr->currentStateBuffer^1][i]);
+        continue;
+      }
+
       _stream << "<sdf version='" << SDF_VERSION << "'>"
         << this->dataPtr->states[this->dataPtr->currentStateBuffer^1][i]
         << "</sdf>";
@@ -2363,17 +3212,33 @@ bool World::OnLog(std::ostringstream &_stream)
         i < this->dataPtr->states[this->dataPtr->currentStateBuffer].size();
         ++i)
     {
+      if (binary)
+      {
+        AddToLogChunk(this->dataPtr->logChunk,
+            this->dataPtr->states[this->dataPtr->currentStateBuffer][i]);
+        continue;
+      }
+
       _stream << "<sdf version='" << SDF_VERSION << "'>"
         << this->dataPtr->states[this->dataPtr->currentStateBuffer][i]
         << "</sdf>";
     }
 
+    // Write every frame, including the chunk that isn't full yet.
+    if (binary)
+      this->dataPtr->logChunk.Write(_stream);
+
     // Clear everything.
     this->dataPtr->states[0].clear();
     this->dataPtr->states[1].clear();
     this->dataPtr->stateToggle = 0;
     this->dataPtr->prevStates[0] = WorldState();
     this->dataPtr->prevStates[1] = WorldState();
+
+    // The log worker only fills the states from the captured frames, so
+    // keep the world it resolves the insertions of the next recording with.
+    this->dataPtr->prevStates[0].SetWorld(shared_from_this());
+    this->dataPtr->prevStates[1].SetWorld(shared_from_this());
   }
 
   return true;
@@ -2385,61 +3250,8 @@ void World::ProcessMessages()
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
 
-    if ((this->dataPtr->posePub && this->dataPtr->posePub->HasConnections()) ||
-        (this->dataPtr->poseLocalPub &&
-         this->dataPtr->poseLocalPub->HasConnections()))
-    {
-      msgs::PosesStamped msg;
-
-      // Time stamp this PosesStamped message
-      msgs::Set(msg.mutable_time(), this->SimTime());
-
-      if (!this->dataPtr->publishModelPoses.empty())
-      {
-        for (auto const &model : this->dataPtr->publishModelPoses)
-        {
-          std::list<ModelPtr> modelList;
-          modelList.push_back(model);
-          while (!modelList.empty())
-          {
-            ModelPtr m = modelList.front();
-            modelList.pop_front();
-            msgs::Pose *poseMsg = msg.add_pose();
-
-            // Publish the model's relative pose
-            poseMsg->set_name(m->GetScopedName());
-            poseMsg->set_id(m->GetId());
-            msgs::Set(poseMsg, m->RelativePose());
-
-            // Publish each of the model's child links relative poses
-            Link_V links = m->GetLinks();
-            for (auto const &link : links)
-            {
-              poseMsg = msg.add_pose();
-              poseMsg->set_name(link->GetScopedName());
-              poseMsg->set_id(link->GetId());
-              msgs::Set(poseMsg, link->RelativePose());
-            }
-
-            // add all nested models to the queue
-            Model_V models = m->NestedModels();
-            for (auto const &n : models)
-              modelList.push_back(n);
-          }
-        }
-
-        if (this->dataPtr->posePub && this->dataPtr->posePub->HasConnections())
-          this->dataPtr->posePub->Publish(msg);
-      }
-
-      if (this->dataPtr->poseLocalPub &&
-          this->dataPtr->poseLocalPub->HasConnections())
-      {
-        // rendering::Scene depends on this timestamp, which is used by
-        // rendering sensors to time stamp their data
-        this->dataPtr->poseLocalPub->Publish(msg);
-      }
-    }
+    this->dataPtr->posePublisher.Publish(this->SimTime(),
+        this->dataPtr->publishModelPoses, this->_EntityVersion());
     this->dataPtr->publishModelPoses.clear();
   }
 
@@ -2560,6 +3372,20 @@ void World::PublishModelPose(physics::ModelPtr _model)
   this->dataPtr->publishModelPoses.insert(_model);
 }
 
+//////////////////////////////////////////////////
+bool World::SetPosePublishRate(const std::string &_topic, const double _rate)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+  return this->dataPtr->posePublisher.SetRate(_topic, _rate);
+}
+
+//////////////////////////////////////////////////
+double World::PosePublishRate(const std::string &_topic) const
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+  return this->dataPtr->posePublisher.Rate(_topic);
+}
+
 //////////////////////////////////////////////////
 void World::PublishModelScale(physics::ModelPtr _model)
 {
@@ -2579,23 +3405,107 @@ void World::PublishLightPose(const physics::LightPtr _light)
 }
 
 //////////////////////////////////////////////////
-void World::LogWorker()
+void World::PushLogState()
 {
-  std::unique_lock<std::mutex> lock(this->dataPtr->logMutex);
+  // Set up the queue when recording starts. The log worker does not touch
+  // an empty queue, so it can be resized. A queue that still holds states
+  // of the previous recording keeps its capacity.
+  if (!this->dataPtr->logQueueActive)
+  {
+    this->dataPtr->logQueue.Resize(util::LogRecord::Instance()->QueueSize());
+    this->dataPtr->logQueuePolicy = util::LogRecord::Instance()->QueuePolicy();
+    this->dataPtr->logDecimation = 1;
+    this->dataPtr->logSkipped = 0;
+    this->dataPtr->logDropped = 0;
+    this->dataPtr->logQueueActive = true;
+  }
 
-  WorldPtr self = shared_from_this();
-  this->dataPtr->logPrevIteration = this->dataPtr->iterations;
+  if (++this->dataPtr->logSkipped < this->dataPtr->logDecimation)
+  {
+    ++this->dataPtr->logDropped;
+    return;
+  }
+  this->dataPtr->logSkipped = 0;
 
-  GZ_ASSERT(self, "Self pointer to World is invalid");
+  LogFrame *frame = this->dataPtr->logQueue.Back();
+  if (!frame)
+  {
+    if (this->dataPtr->logQueuePolicy != "block")
+    {
+      ++this->dataPtr->logDropped;
+
+      // Capture fewer states until the log worker catches up.
+      if (this->dataPtr->logQueuePolicy == "decimate" &&
+          this->dataPtr->logDecimation < this->dataPtr->logQueue.Capacity())
+      {
+        this->dataPtr->logDecimation *= 2;
+      }
+      return;
+    }
+
+    // Wait for the log worker to make room.
+    std::unique_lock<std::mutex> lock(this->dataPtr->logMutex);
+    this->dataPtr->logContinueCondition.wait(lock, [this, &frame]
+        {
+          frame = this->dataPtr->logQueue.Back();
+          return frame || this->dataPtr->stop;
+        });
+
+    if (!frame)
+      return;
+  }
+  else if (this->dataPtr->logQueue.Size() == 0)
+  {
+    this->dataPtr->logDecimation = 1;
+  }
 
+  // Only copy the raw state here. WorldState is built by the log worker.
+  frame->Capture(this->Name(), this->dataPtr->simTime, this->RealTime(),
+      this->dataPtr->iterations, this->dataPtr->models,
+      this->dataPtr->lights, this->dataPtr->skipSleeping);
+  this->dataPtr->logQueue.Push();
+
+  // Taking logMutex, even briefly, makes sure the log worker is either
+  // waiting or has yet to check the queue, so the notification can't be
+  // lost.
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->logMutex);
+  }
+  this->dataPtr->logCondition.notify_one();
+}
+
+//////////////////////////////////////////////////
+uint64_t World::DroppedLogStates() const
+{
+  return this->dataPtr->logDropped;
+}
+
+//////////////////////////////////////////////////
+void World::LogWorker()
+{
   while (!this->dataPtr->stop)
   {
+    LogFrame *frame = this->dataPtr->logQueue.Front();
+    if (!frame)
+    {
+      // Wait until there is work to be done.
+      std::unique_lock<std::mutex> lock(this->dataPtr->logMutex);
+      this->dataPtr->logCondition.wait(lock, [this]
+          {
+            return this->dataPtr->logQueue.Size() > 0 ||
+              this->dataPtr->stop;
+          });
+      continue;
+    }
+
     int currState = (this->dataPtr->stateToggle + 1) % 2;
 
-    this->dataPtr->prevStates[currState].Load(self);
+    // Only the captured frame is read here, never the live world, so the
+    // world thread doesn't have to wait for this thread.
+    frame->ToWorldState(this->dataPtr->prevStates[currState]);
+
     WorldState diffState = this->dataPtr->prevStates[currState] -
       this->dataPtr->prevStates[this->dataPtr->stateToggle];
-    this->dataPtr->logPrevIteration = this->dataPtr->iterations;
 
     if (!diffState.IsZero())
     {
@@ -2622,13 +3532,20 @@ void World::LogWorker()
       }
     }
 
+    // Pop last, so that an empty queue means every state was buffered.
+    // As in PushLogState, logMutex makes sure the waiters can't miss the
+    // notification.
+    this->dataPtr->logQueue.Pop();
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->logMutex);
+    }
     this->dataPtr->logContinueCondition.notify_all();
-
-    // Wait until there is work to be done.
-    this->dataPtr->logCondition.wait(lock);
   }
 
   // Make sure nothing is blocked by this thread.
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->logMutex);
+  }
   this->dataPtr->logContinueCondition.notify_all();
 }
 
@@ -2720,6 +3637,8 @@ void World::RemoveModel(const std::string &_name)
         break;
       }
     }
+
+    this->dataPtr->modelUpdateGroupsDirty = true;
   }
 
   // Cleanup the publishModelPoses list.
@@ -2829,9 +3748,21 @@ void World::SetAtmosphereEnabled(const bool _enable)
 void World::_AddDirty(Entity *_entity)
 {
   GZ_ASSERT(_entity != nullptr, "_entity is nullptr");
+
+  // Physics engines may call this from several threads at once, e.g. when
+  // ODE steps islands in parallel.
+  std::lock_guard<std::mutex> lock(this->dataPtr->dirtyPosesMutex);
   this->dataPtr->dirtyPoses.push_back(_entity);
 }
 
+/////////////////////////////////////////////////
+void World::_AddDirty(const std::vector<Entity *> &_entities)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->dirtyPosesMutex);
+  this->dataPtr->dirtyPoses.insert(this->dataPtr->dirtyPoses.end(),
+      _entities.begin(), _entities.end());
+}
+
 /////////////////////////////////////////////////
 void World::ResetPhysicsStates()
 {
@@ -32,6 +32,9 @@
 
 #include <boost/enable_shared_from_this.hpp>
 
+#include <ignition/math/Box.hh>
+#include <ignition/math/Frustum.hh>
+
 #include <sdf/sdf.hh>
 
 #include "gazebo/transport/TransportTypes.hh"
@@ -66,6 +69,8 @@ namespace gazebo
     /// Forward declare private data class.
     class WorldPrivate;
 
+    class RaycastSnapshot;
+
     /// \addtogroup gazebo_physics
     /// \{
 
@@ -240,11 +245,19 @@ namespace gazebo
 
       /// \brief Get an element by name.
       /// Searches the list of entities, and return a pointer to the model
-      /// with a matching _name.
+      /// with a matching _name. Scoped names are found in constant time
+      /// through an index. Other names are searched for in the tree of
+      /// entities.
       /// \param[in] _name The name of the Model to find.
       /// \return A pointer to the entity, or NULL if no entity was found.
       public: BasePtr BaseByName(const std::string &_name) const;
 
+      /// \brief Get an element by id.
+      /// \param[in] _id Id of the element, see Base::GetId.
+      /// \return A pointer to the element, or NULL if no loaded element has
+      /// the id.
+      public: BasePtr BaseById(const uint32_t _id) const;
+
       /// \brief Get a model by name.
       /// This function is the same as BaseByName, but limits the search to
       /// only models.
@@ -288,6 +301,111 @@ namespace gazebo
       /// \param _state The state to set the World to.
       public: void SetState(const WorldState &_state);
 
+      /// \brief Set the current world state from a snapshot. This is much
+      /// faster than setting a WorldState, but cannot insert or delete
+      /// entities.
+      /// \param[in] _snapshot The snapshot to set the World to.
+      /// \sa WorldSnapshot::Apply
+      public: void SetState(const WorldSnapshot &_snapshot);
+
+      /// \brief Save the state of the world in memory, to be restored with
+      /// RestoreSnapshot. On top of the state of the entities, the snapshot
+      /// holds the internal state of the physics engine, such as the warm
+      /// start of the solver, so that the world steps from a restored
+      /// snapshot as it did from the saved state. Snapshots can also be
+      /// saved, restored and removed with the "save_snapshot",
+      /// "restore_snapshot" and "remove_snapshot" requests on "~/request",
+      /// whose data is the handle of the snapshot.
+      /// \return Handle of the snapshot.
+      /// \sa PhysicsEngine::SaveInternalState
+      public: uint32_t SaveSnapshot();
+
+      /// \brief Restore a snapshot saved by SaveSnapshot, including the
+      /// simulation time. Entities inserted since the snapshot was saved are
+      /// left as they are, and the state of the physics engine is only
+      /// restored if no entity was inserted or removed.
+      /// \param[in] _handle Handle of the snapshot.
+      /// \return False if there is no snapshot with this handle.
+      public: bool RestoreSnapshot(const uint32_t _handle);
+
+      /// \brief Remove a snapshot saved by SaveSnapshot.
+      /// \param[in] _handle Handle of the snapshot.
+      /// \return False if there is no snapshot with this handle.
+      public: bool RemoveSnapshot(const uint32_t _handle);
+
+      /// \brief Start building a RaycastSnapshot of the world after each
+      /// update, see RaySnapshot. Snapshots are not built until this is
+      /// called once, so that worlds without ray sensors do not pay for
+      /// them.
+      public: void EnableRaySnapshots();
+
+      /// \brief Get the latest RaycastSnapshot of the world, to cast rays
+      /// without locking the physics engine. This can be called from any
+      /// thread, and the snapshot stays valid while it is held.
+      /// \return The snapshot, null if none was built yet.
+      /// \sa EnableRaySnapshots
+      public: std::shared_ptr<const RaycastSnapshot> RaySnapshot() const;
+
+      /// \brief Start updating a SpatialIndex over the bounding boxes of
+      /// the models and links of the world after each update, see
+      /// ModelsInFrustum. The index is built by the world thread once this
+      /// is first called, also while paused, and the queries return nothing
+      /// before, so that worlds that do not query it do not pay for it.
+      /// Only the boxes of the links that moved are computed again on each
+      /// update. This can be called from any thread.
+      public: void EnableSpatialIndex();
+
+      /// \brief Get the top level models whose bounding boxes are in a
+      /// frustum, as tested by ignition::math::Frustum::Contains. This can
+      /// be called from any thread.
+      /// \param[in] _frustum The frustum, in the world frame.
+      /// \return The models as of the last update, ordered by id.
+      /// \sa EnableSpatialIndex
+      public: Model_V ModelsInFrustum(
+                  const ignition::math::Frustum &_frustum) const;
+
+      /// \brief Get the top level models whose bounding boxes intersect a
+      /// sphere. This can be called from any thread.
+      /// \param[in] _center Center of the sphere, in the world frame.
+      /// \param[in] _radius Radius of the sphere.
+      /// \return The models as of the last update, ordered by id.
+      /// \sa EnableSpatialIndex
+      public: Model_V ModelsInSphere(const ignition::math::Vector3d &_center,
+                  const double _radius) const;
+
+      /// \brief Get the top level models whose bounding boxes intersect a
+      /// box. This can be called from any thread.
+      /// \param[in] _box The box, in the world frame.
+      /// \return The models as of the last update, ordered by id.
+      /// \sa EnableSpatialIndex
+      public: Model_V ModelsInBox(const ignition::math::Box &_box) const;
+
+      /// \brief Get the links, of all models including nested ones, whose
+      /// bounding boxes intersect a sphere. This can be called from any
+      /// thread.
+      /// \param[in] _center Center of the sphere, in the world frame.
+      /// \param[in] _radius Radius of the sphere.
+      /// \return The links as of the last update, ordered by id.
+      /// \sa EnableSpatialIndex
+      public: Link_V LinksInSphere(const ignition::math::Vector3d &_center,
+                  const double _radius) const;
+
+      /// \brief Get the links, of all models including nested ones, whose
+      /// bounding boxes intersect a box. This can be called from any
+      /// thread.
+      /// \param[in] _box The box, in the world frame.
+      /// \return The links as of the last update, ordered by id.
+      /// \sa EnableSpatialIndex
+      public: Link_V LinksInBox(const ignition::math::Box &_box) const;
+
+      /// \brief Get the number of updates of the spatial index, which
+      /// changes whenever the results of its queries may have changed,
+      /// including when a link is moved while paused. This can be called
+      /// from any thread.
+      /// \return The number of updates.
+      /// \sa EnableSpatialIndex
+      public: uint64_t SpatialIndexUpdates() const;
+
       /// \brief Insert a model from an SDF file.
       /// Spawns a model into the world base on and SDF file.
       /// \param[in] _sdfFilename The name of the SDF file (including path).
@@ -391,6 +509,28 @@ namespace gazebo
       /// \param[in] _light Pointer to the light to publish.
       public: void PublishLightPose(const physics::LightPtr _light);
 
+      /// \brief Set the maximum rate at which model poses are published on
+      /// a pose topic. Only the poses that changed are published, and the
+      /// changes are accumulated between two messages, so that subscribers
+      /// always receive the latest pose of the entities that moved.
+      /// By default "~/pose/info" is limited to 60 messages per second,
+      /// and "~/pose/local/info" is published on every update.
+      /// \param[in] _topic "~/pose/info" or "~/pose/local/info".
+      /// \param[in] _rate Maximum number of messages per second of wall
+      /// time, 0 to publish on every update.
+      /// \return False if _topic is not a pose topic of the world, or
+      /// _rate is negative.
+      public: bool SetPosePublishRate(const std::string &_topic,
+                  const double _rate);
+
+      /// \brief Get the maximum rate at which model poses are published on
+      /// a pose topic.
+      /// \param[in] _topic "~/pose/info" or "~/pose/local/info".
+      /// \return Maximum number of messages per second, 0 if poses are
+      /// published on every update, -1 if _topic is not a pose topic of the
+      /// world.
+      public: double PosePublishRate(const std::string &_topic) const;
+
       /// \brief Get the total number of iterations.
       /// \return Number of iterations that simulation has taken.
       public: uint32_t Iterations() const;
@@ -421,6 +561,68 @@ namespace gazebo
       /// all child models.
       public: void ResetPhysicsStates();
 
+      /// \brief Set the number of threads used to update models.
+      ///
+      /// By default all models are updated serially on the world thread.
+      /// With a non-zero number of threads, Model::Update runs on a pool of
+      /// worker threads. Models connected by a joint are updated together,
+      /// in load order, on the same thread, and actors are updated on the
+      /// world thread before the parallel stage.
+      ///
+      /// The following callbacks may then run concurrently for different
+      /// models, and must not access state owned by other models without
+      /// their own locking:
+      ///   - callbacks registered with Joint::ConnectJointUpdate,
+      ///   - the completion callback passed to Model::SetJointAnimation.
+      ///
+      /// World events such as worldUpdateBegin, beforePhysicsUpdate and
+      /// worldUpdateEnd are still fired from the world thread, and model
+      /// plugins connected to them are not affected.
+      /// \param[in] _threads Number of threads, zero to update models
+      /// serially.
+      public: void SetModelUpdateThreads(const unsigned int _threads);
+
+      /// \brief Get the number of threads used to update models.
+      /// \return Number of threads, zero if models are updated serially.
+      public: unsigned int ModelUpdateThreads() const;
+
+      /// \brief Skip the work done for sleeping models on each update, see
+      /// Model::IsSleeping. For a sleeping model, an update then skips:
+      ///   - the update of its joints, and the callbacks registered with
+      ///     Joint::ConnectJointUpdate, unless a joint animation is running.
+      ///     The joint controller is still updated, so that its commands
+      ///     wake the model up;
+      ///   - the bounding boxes of its links in the spatial index, see
+      ///     EnableSpatialIndex;
+      ///   - reading the velocities, accelerations and forces of its links
+      ///     from the physics engine for the state log. They are recorded
+      ///     as zero, since the engines clear them when a body goes to
+      ///     sleep.
+      ///
+      /// Poses are only propagated and published for the links the physics
+      /// engine moved, which excludes sleeping links whether or not this is
+      /// enabled.
+      /// \param[in] _skip True to skip sleeping models.
+      public: void SetSkipSleeping(const bool _skip);
+
+      /// \brief Get whether the work done for sleeping models is skipped.
+      /// \return True if sleeping models are skipped.
+      /// \sa SetSkipSleeping
+      public: bool SkipSleeping() const;
+
+      /// \brief Get the number of states that were not recorded during the
+      /// current or last log recording, because the log worker fell behind.
+      /// \return Number of states skipped by the "drop" and "decimate"
+      /// queue policies.
+      /// \sa util::LogRecord::SetQueuePolicy
+      public: uint64_t DroppedLogStates() const;
+
+      /// \internal
+      /// \brief Inform the World that joints were added to or removed from
+      /// a model, so that models connected by joints are regrouped before
+      /// the next parallel model update.
+      public: void _DirtyModelUpdateGroups();
+
       /// \internal
       /// \brief Inform the World that an Entity has moved. The Entity
       /// is added to a list that will be processed by the World.
@@ -429,6 +631,64 @@ namespace gazebo
       /// \param[in] _entity Entity that has moved.
       public: void _AddDirty(Entity *_entity);
 
+      /// \internal
+      /// \brief Inform the World that several Entities have moved, with a
+      /// single lock. Only a physics engine implementation should call this
+      /// function.
+      /// \param[in] _entities Entities that have moved.
+      public: void _AddDirty(const std::vector<Entity *> &_entities);
+
+      /// \internal
+      /// \brief Inform the World that the physics engine put a link to
+      /// sleep, or woke it up. The change is applied on the next update.
+      /// This can be called from any thread. Only a physics engine
+      /// implementation should call this function.
+      /// \param[in] _link The link.
+      /// \param[in] _sleeping True if the link was put to sleep.
+      public: void _SetLinkSleeping(Link *_link, const bool _sleeping);
+
+      /// \internal
+      /// \brief Inform the World that a link was moved by
+      /// Entity::SetWorldPose, for the spatial index to be updated on the
+      /// next step, even while paused, and to visit sleeping models. This
+      /// can be called from any thread. Only Link should call this
+      /// function.
+      public: void _SetLinkMoved();
+
+      /// \internal
+      /// \brief Add a loaded entity to the index of entities, or update the
+      /// scoped name it is indexed by. Only Base should call this function.
+      /// \param[in] _base The entity.
+      public: void _IndexEntity(const BasePtr &_base);
+
+      /// \internal
+      /// \brief Update the scoped name of an indexed entity. Nothing is
+      /// done if the entity is not indexed. Only Base should call this
+      /// function.
+      /// \param[in] _id Id of the entity.
+      /// \param[in] _scopedName New scoped name of the entity.
+      public: void _RenameIndexedEntity(const uint32_t _id,
+                  const std::string &_scopedName);
+
+      /// \internal
+      /// \brief Remove an entity from the index of entities. Only Base
+      /// should call this function.
+      /// \param[in] _id Id of the entity.
+      public: void _UnindexEntity(const uint32_t _id);
+
+      /// \internal
+      /// \brief Get an entity from the index of entities.
+      /// \param[in] _scopedName Scoped name of the entity.
+      /// \return The entity, or NULL if no entity or more than one entity
+      /// has the scoped name.
+      public: BasePtr _IndexedEntity(const std::string &_scopedName) const;
+
+      /// \internal
+      /// \brief Get the version of the entities of the world, which changes
+      /// when an entity is added, removed or renamed.
+      /// \return The version.
+      public: uint64_t _EntityVersion() const;
+
       /// \brief Get whether sensors have been initialized.
       /// \return True if sensors have been initialized.
       public: bool SensorsInitialized() const;
@@ -547,9 +807,21 @@ namespace gazebo
       /// \brief TBB version of model updating.
       private: void ModelUpdateTBB();
 
+      /// \brief Split the models into groups that can be updated in
+      /// parallel.
+      private: void BuildModelUpdateGroups();
+
       /// \brief Single loop version of model updating.
       private: void ModelUpdateSingleLoop();
 
+      /// \brief Update the spatial index with the bounding boxes of the
+      /// links that moved since the last update.
+      private: void UpdateSpatialIndex();
+
+      /// \brief Apply the links put to sleep or woken up by the physics
+      /// engine since the last update, and set which models are sleeping.
+      private: void UpdateSleeping();
+
       /// \brief Helper function to load a plugin from SDF.
       /// \param[in] _sdf SDF plugin description.
       private: void LoadPlugin(sdf::ElementPtr _sdf);
@@ -592,6 +864,10 @@ namespace gazebo
       /// \brief Publish the world stats message.
       private: void PublishWorldStats();
 
+      /// \brief Capture the state of the world, and queue it for the log
+      /// worker.
+      private: void PushLogState();
+
       /// \brief Thread function for logging state data.
       private: void LogWorker();
 
@@ -21,14 +21,25 @@
 #include <deque>
 #include <vector>
 #include <list>
+#include <map>
 #include <memory>
 #include <set>
 #include <sdf/sdf.hh>
 #include <string>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <condition_variable>
 
+#include <boost/weak_ptr.hpp>
+
+#include <ignition/math/Box.hh>
+#include <ignition/math/Pose3.hh>
+
+#include <tbb/task_arena.h>
+
 #include <ignition/transport.hh>
 
 #include "gazebo/common/Event.hh"
@@ -39,13 +50,49 @@
 
 #include "gazebo/transport/TransportTypes.hh"
 
+#include "gazebo/util/LogChunk.hh"
+
+#include "gazebo/physics/LogFrame.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/physics/PosePublisher.hh"
+#include "gazebo/physics/RaycastSnapshot.hh"
+#include "gazebo/physics/SpatialIndex.hh"
+#include "gazebo/physics/WorldSnapshot.hh"
 #include "gazebo/physics/WorldState.hh"
 
 namespace gazebo
 {
   namespace physics
   {
+    /// \internal
+    /// \brief A link in the spatial index of a world.
+    class WorldSpatialLink
+    {
+      /// \brief World pose of the link when its box was computed.
+      public: ignition::math::Pose3d pose;
+
+      /// \brief Bounding box of the link.
+      public: ignition::math::Box box;
+
+      /// \brief Number of the index update the link was last seen at.
+      public: uint64_t seen = 0;
+    };
+
+    /// \internal
+    /// \brief A top level model whose links can be put to sleep.
+    class WorldSleepingModel
+    {
+      /// \brief The model.
+      public: Model *model = nullptr;
+
+      /// \brief Number of links of the model and of its nested models that
+      /// are not static.
+      public: unsigned int links = 0;
+
+      /// \brief Number of these links that are sleeping.
+      public: unsigned int sleepingLinks = 0;
+    };
+
     /// \brief Private data class for World.
     class WorldPrivate
     {
@@ -119,6 +166,10 @@ namespace gazebo
       /// \brief Publisher for local pose messages.
       public: transport::PublisherPtr poseLocalPub;
 
+      /// \brief Publishes the poses that changed on posePub and
+      /// poseLocalPub.
+      public: PosePublisher posePublisher;
+
       /// \brief Subscriber to world control messages.
       public: transport::SubscriberPtr controlSub;
 
@@ -155,6 +206,24 @@ namespace gazebo
       /// \brief Function pointer to the model update function.
       public: void (World::*modelUpdateFunc)();
 
+      /// \brief Number of threads used to update models, zero if models are
+      /// updated serially.
+      public: unsigned int modelUpdateThreads = 0;
+
+      /// \brief Worker pool used by the parallel model update.
+      public: std::unique_ptr<tbb::task_arena> modelUpdateArena;
+
+      /// \brief Groups of models that are updated in parallel. Models of
+      /// the same group are updated in order on a single thread.
+      public: std::vector<Model_V> modelUpdateGroups;
+
+      /// \brief Entities updated on the world thread by the parallel
+      /// model update.
+      public: Base_V serialUpdateEntities;
+
+      /// \brief True when modelUpdateGroups must be rebuilt.
+      public: std::atomic<bool> modelUpdateGroupsDirty{true};
+
       /// \brief Last time a world statistics message was sent.
       public: common::Time prevStatTime;
 
@@ -165,11 +234,82 @@ namespace gazebo
       public: common::Time realTimeOffset;
 
       /// \brief Mutex to protect incoming message buffers.
-      public: std::recursive_mutex receiveMutex;
+      public: mutable std::recursive_mutex receiveMutex;
 
       /// \brief Mutex to protext loading of models.
       public: std::mutex loadModelMutex;
 
+      /// \brief Loaded entities by id, with the scoped name each entity is
+      /// indexed by in entityIdsByName.
+      public: std::unordered_map<uint32_t,
+              std::pair<boost::weak_ptr<Base>, std::string>> entitiesById;
+
+      /// \brief Ids of the loaded entities by scoped name. Entities such as
+      /// a link and a joint of the same model can share a scoped name.
+      public: std::unordered_multimap<std::string, uint32_t> entityIdsByName;
+
+      /// \brief Incremented when an entity is added to, removed from or
+      /// renamed in the index.
+      public: uint64_t entityIndexVersion = 0;
+
+      /// \brief Mutex to protect entitiesById, entityIdsByName and
+      /// entityIndexVersion.
+      public: mutable std::mutex entityIndexMutex;
+
+      /// \brief Snapshots saved by World::SaveSnapshot, by handle, with the
+      /// internal state of the physics engine.
+      public: std::map<uint32_t, std::pair<WorldSnapshot, std::vector<double>>>
+              snapshots;
+
+      /// \brief Handle of the next snapshot saved by World::SaveSnapshot.
+      public: uint32_t nextSnapshotHandle = 1;
+
+      /// \brief True if a ray snapshot is built after each update, see
+      /// World::EnableRaySnapshots.
+      public: std::atomic<bool> raySnapshotsEnabled{false};
+
+      /// \brief Latest ray snapshot, see World::RaySnapshot.
+      public: std::shared_ptr<const RaycastSnapshot> raySnapshot;
+
+      /// \brief Mutex to protect raySnapshot.
+      public: mutable std::mutex raySnapshotMutex;
+
+      /// \brief True if the spatial index is updated after each update, see
+      /// World::EnableSpatialIndex.
+      public: std::atomic<bool> spatialIndexEnabled{false};
+
+      /// \brief True when the world thread has to update the spatial index
+      /// even while paused: when it is first enabled, and when a link was
+      /// moved, see World::EnableSpatialIndex and World::_SetLinkMoved.
+      public: std::atomic<bool> spatialIndexPending{false};
+
+      /// \brief True when a link was moved since the last update of the
+      /// spatial index, see World::_SetLinkMoved.
+      public: std::atomic<bool> spatialIndexMoved{false};
+
+      /// \brief Bounding boxes of the top level models, by id.
+      public: SpatialIndex modelIndex;
+
+      /// \brief Bounding boxes of the links of all the models, by id.
+      public: SpatialIndex linkIndex;
+
+      /// \brief Links in linkIndex, by id.
+      public: std::unordered_map<uint32_t, WorldSpatialLink> indexedLinks;
+
+      /// \brief Number of the index update each model in modelIndex was
+      /// last seen at, by id.
+      public: std::unordered_map<uint32_t, uint64_t> indexedModels;
+
+      /// \brief Number of updates of the spatial index.
+      public: uint64_t spatialIndexUpdates = 0;
+
+      /// \brief Entity version of the world at the last update of the
+      /// spatial index, see World::_EntityVersion.
+      public: uint64_t spatialIndexVersion = 0;
+
+      /// \brief Mutex to protect the spatial index.
+      public: mutable std::mutex spatialIndexMutex;
+
       /// \brief Mutex to protext loading of lights.
       public: std::mutex loadLightMutex;
 
@@ -293,15 +433,34 @@ namespace gazebo
       /// \brief The number of simulation iterations to take before stopping.
       public: uint64_t stopIterations;
 
-      /// \brief Condition used for log worker.
+      /// \brief Condition used to wake up the log worker.
       public: std::condition_variable logCondition;
 
-      /// \brief Condition used to guarantee the log worker thread doesn't
-      /// skip an interation.
+      /// \brief Condition used to tell the world thread that the log worker
+      /// made room in logQueue.
       public: std::condition_variable logContinueCondition;
 
-      /// \brief Last iteration recorded by the log worker thread.
-      public: uint64_t logPrevIteration;
+      /// \brief States captured by the world thread, waiting for the log
+      /// worker.
+      public: LogFrameQueue logQueue;
+
+      /// \brief Policy applied when logQueue is full, copied from
+      /// util::LogRecord when recording starts.
+      public: std::string logQueuePolicy;
+
+      /// \brief True if logQueue was set up for the current recording.
+      public: bool logQueueActive = false;
+
+      /// \brief Only every logDecimation-th state is captured, with the
+      /// decimate policy.
+      public: unsigned int logDecimation = 1;
+
+      /// \brief Number of states skipped since the last captured state.
+      public: unsigned int logSkipped = 0;
+
+      /// \brief Number of states that were not recorded because logQueue
+      /// was full.
+      public: std::atomic<uint64_t> logDropped{0};
 
       /// \brief Real time value set from a log file.
       public: common::Time logRealTime;
@@ -312,6 +471,10 @@ namespace gazebo
       /// \brief Mutex to protect the log state buffers
       public: std::mutex logBufferMutex;
 
+      /// \brief World states waiting to be written by the binary log
+      /// encoding.
+      public: util::LogChunk logChunk;
+
       /// \brief Mutex to protect the deleteEntity list.
       public: std::mutex entityDeleteMutex;
 
@@ -333,6 +496,42 @@ namespace gazebo
       /// physics::Link in World::Update.
       public: std::list<Entity*> dirtyPoses;
 
+      /// \brief Mutex to protect dirtyPoses while the physics engine adds
+      /// to it.
+      public: std::mutex dirtyPosesMutex;
+
+      /// \brief True if the work done for sleeping models is skipped, see
+      /// World::SetSkipSleeping.
+      public: std::atomic<bool> skipSleeping{false};
+
+      /// \brief Links put to sleep (true) or woken up (false) by the
+      /// physics engine since the last update, by id, in order.
+      public: std::vector<std::pair<uint32_t, bool>> sleepChanges;
+
+      /// \brief Changes being applied, swapped with sleepChanges so that
+      /// neither is reallocated.
+      public: std::vector<std::pair<uint32_t, bool>> appliedSleepChanges;
+
+      /// \brief Mutex to protect sleepChanges.
+      public: std::mutex sleepChangesMutex;
+
+      /// \brief Ids of the sleeping links.
+      public: std::unordered_set<uint32_t> sleepingLinks;
+
+      /// \brief Top level models whose links can be put to sleep.
+      public: std::vector<WorldSleepingModel> sleepingModels;
+
+      /// \brief Index in sleepingModels of the model of each link that is
+      /// not static, by link id.
+      public: std::unordered_map<uint32_t, size_t> sleepingModelOfLink;
+
+      /// \brief Entity version of the world sleepingModels was built at,
+      /// see World::_EntityVersion.
+      public: uint64_t sleepingVersion = 0;
+
+      /// \brief True once sleepingModels was built.
+      public: bool sleepingBuilt = false;
+
       /// \brief Class to manage preset simulation parameter profiles.
       public: PresetManagerPtr presetManager;
 
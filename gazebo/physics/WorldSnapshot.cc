@@ -0,0 +1,786 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cmath>
+#include <vector>
+
+#include <ignition/math/Helpers.hh>
+
+#include "gazebo/physics/Joint.hh"
+#include "gazebo/physics/JointState.hh"
+#include "gazebo/physics/Light.hh"
+#include "gazebo/physics/LightState.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/LinkState.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/ModelState.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/WorldState.hh"
+#include "gazebo/physics/WorldSnapshotPrivate.hh"
+#include "gazebo/physics/WorldSnapshot.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Store a pose as 7 values.
+/// \param[in] _pose The pose.
+/// \param[out] _values x, y, z, qw, qx, qy, qz.
+static void StorePose(const ignition::math::Pose3d &_pose, double *_values)
+{
+  _values[0] = _pose.Pos().X();
+  _values[1] = _pose.Pos().Y();
+  _values[2] = _pose.Pos().Z();
+  _values[3] = _pose.Rot().W();
+  _values[4] = _pose.Rot().X();
+  _values[5] = _pose.Rot().Y();
+  _values[6] = _pose.Rot().Z();
+}
+
+/// \brief Load a pose stored by StorePose.
+/// \param[in] _values x, y, z, qw, qx, qy, qz.
+/// \return The pose.
+static ignition::math::Pose3d LoadPose(const double *_values)
+{
+  return ignition::math::Pose3d(_values[0], _values[1], _values[2],
+      _values[3], _values[4], _values[5], _values[6]);
+}
+
+/// \brief Store two vectors as 6 values.
+/// \param[in] _a First vector.
+/// \param[in] _b Second vector.
+/// \param[out] _values Components of _a, then of _b.
+static void StoreVectors(const ignition::math::Vector3d &_a,
+    const ignition::math::Vector3d &_b, double *_values)
+{
+  _values[0] = _a.X();
+  _values[1] = _a.Y();
+  _values[2] = _a.Z();
+  _values[3] = _b.X();
+  _values[4] = _b.Y();
+  _values[5] = _b.Z();
+}
+
+/// \brief Combine arrays of poses, as the pose operators of WorldState do.
+/// \param[in] _a First array.
+/// \param[in] _b Second array, of the same size.
+/// \param[in] _diff True for _a - _b, false for _a + _b.
+/// \param[out] _result The result, resized to the size of _a.
+static void CombinePoses(const std::vector<double> &_a,
+    const std::vector<double> &_b, const bool _diff,
+    std::vector<double> &_result)
+{
+  _result.resize(_a.size());
+  for (size_t i = 0; i + 7 <= _a.size(); i += 7)
+  {
+    const ignition::math::Quaterniond qa(_a[i+3], _a[i+4], _a[i+5], _a[i+6]);
+    const ignition::math::Quaterniond qb(_b[i+3], _b[i+4], _b[i+5], _b[i+6]);
+    const double sign = _diff ? -1.0 : 1.0;
+    for (size_t j = 0; j < 3; ++j)
+      _result[i+j] = _a[i+j] + sign * _b[i+j];
+
+    const ignition::math::Quaterniond q = _diff ? qb.Inverse() * qa : qb * qa;
+    _result[i+3] = q.W();
+    _result[i+4] = q.X();
+    _result[i+5] = q.Y();
+    _result[i+6] = q.Z();
+  }
+}
+
+/// \brief Combine arrays of values component wise.
+/// \param[in] _a First array.
+/// \param[in] _b Second array, of the same size.
+/// \param[in] _diff True for _a - _b, false for _a + _b.
+/// \param[out] _result The result, resized to the size of _a.
+static void CombineValues(const std::vector<double> &_a,
+    const std::vector<double> &_b, const bool _diff,
+    std::vector<double> &_result)
+{
+  _result.resize(_a.size());
+  const double sign = _diff ? -1.0 : 1.0;
+  for (size_t i = 0; i < _a.size(); ++i)
+    _result[i] = _a[i] + sign * _b[i];
+}
+
+/// \brief Check that poses are zero differences.
+/// \param[in] _poses Array of poses.
+/// \return True if all positions are zero and all rotations identities.
+static bool ZeroPoses(const std::vector<double> &_poses)
+{
+  for (size_t i = 0; i + 7 <= _poses.size(); i += 7)
+  {
+    if (!ignition::math::equal(_poses[i], 0.0) ||
+        !ignition::math::equal(_poses[i+1], 0.0) ||
+        !ignition::math::equal(_poses[i+2], 0.0) ||
+        !ignition::math::equal(std::abs(_poses[i+3]), 1.0) ||
+        !ignition::math::equal(_poses[i+4], 0.0) ||
+        !ignition::math::equal(_poses[i+5], 0.0) ||
+        !ignition::math::equal(_poses[i+6], 0.0))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// \brief Check that values are zero.
+/// \param[in] _values Array of values.
+/// \return True if all values are zero.
+static bool ZeroValues(const std::vector<double> &_values)
+{
+  for (auto const &value : _values)
+  {
+    if (!ignition::math::equal(value, 0.0))
+      return false;
+  }
+  return true;
+}
+
+/// \brief Add a model, its links, joints and nested models to a layout.
+/// \param[in] _model The model.
+/// \param[in,out] _layout The layout.
+static void AddModel(const ModelPtr &_model, WorldSnapshotLayout &_layout)
+{
+  const size_t index = _layout.modelIds.size();
+  _layout.modelIds.push_back(_model->GetId());
+  _layout.modelNames.push_back(_model->GetName());
+  _layout.models.push_back(_model.get());
+  _layout.modelNestedCounts.push_back(0);
+  _layout.modelFirstLinks.push_back(_layout.linkIds.size());
+  _layout.modelLinkCounts.push_back(_model->GetLinks().size());
+  _layout.modelFirstJoints.push_back(_layout.jointIds.size());
+  _layout.modelJointCounts.push_back(_model->GetJoints().size());
+  _layout.index[_model->GetId()] =
+      std::make_pair(WorldSnapshotLayout::MODEL, index);
+
+  for (auto const &link : _model->GetLinks())
+  {
+    _layout.index[link->GetId()] =
+        std::make_pair(WorldSnapshotLayout::LINK, _layout.linkIds.size());
+    _layout.linkIds.push_back(link->GetId());
+    _layout.linkNames.push_back(link->GetName());
+    _layout.links.push_back(link.get());
+  }
+
+  for (auto const &joint : _model->GetJoints())
+  {
+    _layout.index[joint->GetId()] =
+        std::make_pair(WorldSnapshotLayout::JOINT, _layout.jointIds.size());
+    _layout.jointIds.push_back(joint->GetId());
+    _layout.jointNames.push_back(joint->GetName());
+    _layout.joints.push_back(joint.get());
+    _layout.jointOffsets.push_back(_layout.jointOffsets.back() + joint->DOF());
+  }
+
+  for (auto const &nested : _model->NestedModels())
+    AddModel(nested, _layout);
+
+  _layout.modelNestedCounts[index] = _layout.modelIds.size() - index - 1;
+}
+
+/// \brief Get an entity of a snapshot.
+/// \param[in] _world The world.
+/// \param[in] _cached True if the entity pointers of the layout are valid.
+/// \param[in] _entity Entity pointer of the layout.
+/// \param[in] _id Id of the entity.
+/// \param[out] _holder Keeps the entity alive, if it was looked up.
+/// \return The entity, nullptr if it is not in the world.
+template<typename T>
+static T *Resolve(const WorldPtr &_world, const bool _cached, T *_entity,
+    const uint32_t _id, boost::shared_ptr<T> &_holder)
+{
+  if (_cached)
+    return _entity;
+
+  _holder = boost::dynamic_pointer_cast<T>(_world->BaseById(_id));
+  return _holder.get();
+}
+
+/////////////////////////////////////////////////
+WorldSnapshot::WorldSnapshot()
+  : dataPtr(new WorldSnapshotPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+WorldSnapshot::WorldSnapshot(const WorldSnapshot &_snapshot)
+  : dataPtr(new WorldSnapshotPrivate(*_snapshot.dataPtr))
+{
+}
+
+/////////////////////////////////////////////////
+WorldSnapshot::~WorldSnapshot()
+{
+}
+
+/////////////////////////////////////////////////
+WorldSnapshot &WorldSnapshot::operator=(const WorldSnapshot &_snapshot)
+{
+  if (this != &_snapshot)
+    *this->dataPtr = *_snapshot.dataPtr;
+  return *this;
+}
+
+/////////////////////////////////////////////////
+void WorldSnapshot::Capture(const WorldPtr &_world)
+{
+  if (!_world)
+    return;
+
+  const uint64_t version = _world->_EntityVersion();
+  auto layout = this->dataPtr->layout;
+  if (!layout || layout->world != _world.get() || layout->version != version)
+  {
+    auto newLayout = std::make_shared<WorldSnapshotLayout>();
+    newLayout->world = _world.get();
+    newLayout->version = version;
+    newLayout->jointOffsets.push_back(0);
+    for (auto const &model : _world->Models())
+      AddModel(model, *newLayout);
+
+    for (auto const &light : _world->Lights())
+    {
+      newLayout->index[light->GetId()] = std::make_pair(
+          WorldSnapshotLayout::LIGHT, newLayout->lightIds.size());
+      newLayout->lightIds.push_back(light->GetId());
+      newLayout->lightNames.push_back(light->GetName());
+      newLayout->lights.push_back(light.get());
+    }
+
+    layout = newLayout;
+    this->dataPtr->layout = layout;
+  }
+
+  this->dataPtr->worldName = _world->Name();
+  this->dataPtr->simTime = _world->SimTime();
+  this->dataPtr->realTime = _world->RealTime();
+  this->dataPtr->wallTime = common::Time::GetWallTime();
+  this->dataPtr->iterations = _world->Iterations();
+
+  this->dataPtr->modelPoses.resize(layout->models.size() * 7);
+  this->dataPtr->modelScales.resize(layout->models.size() * 3);
+  for (size_t i = 0; i < layout->models.size(); ++i)
+  {
+    const Model *model = layout->models[i];
+    StorePose(model->WorldPose(), &this->dataPtr->modelPoses[i * 7]);
+    const ignition::math::Vector3d scale = model->Scale();
+    this->dataPtr->modelScales[i * 3] = scale.X();
+    this->dataPtr->modelScales[i * 3 + 1] = scale.Y();
+    this->dataPtr->modelScales[i * 3 + 2] = scale.Z();
+  }
+
+  this->dataPtr->linkPoses.resize(layout->links.size() * 7);
+  this->dataPtr->linkVels.resize(layout->links.size() * 6);
+  this->dataPtr->linkAccels.resize(layout->links.size() * 6);
+  this->dataPtr->linkWrenches.resize(layout->links.size() * 6);
+  for (size_t i = 0; i < layout->links.size(); ++i)
+  {
+    const Link *link = layout->links[i];
+    StorePose(link->WorldPose(), &this->dataPtr->linkPoses[i * 7]);
+    StoreVectors(link->WorldLinearVel(), link->WorldAngularVel(),
+        &this->dataPtr->linkVels[i * 6]);
+    StoreVectors(link->WorldLinearAccel(), link->WorldAngularAccel(),
+        &this->dataPtr->linkAccels[i * 6]);
+    StoreVectors(link->WorldForce(), link->WorldTorque(),
+        &this->dataPtr->linkWrenches[i * 6]);
+  }
+
+  this->dataPtr->jointPositions.resize(layout->jointOffsets.back());
+  for (size_t i = 0; i < layout->joints.size(); ++i)
+  {
+    const Joint *joint = layout->joints[i];
+    const size_t offset = layout->jointOffsets[i];
+    for (size_t axis = 0; offset + axis < layout->jointOffsets[i + 1]; ++axis)
+      this->dataPtr->jointPositions[offset + axis] = joint->Position(axis);
+  }
+
+  this->dataPtr->lightPoses.resize(layout->lights.size() * 7);
+  for (size_t i = 0; i < layout->lights.size(); ++i)
+  {
+    StorePose(layout->lights[i]->WorldPose(),
+        &this->dataPtr->lightPoses[i * 7]);
+  }
+}
+
+/////////////////////////////////////////////////
+void WorldSnapshot::Apply(const WorldPtr &_world) const
+{
+  auto layout = this->dataPtr->layout;
+  if (!_world || !layout)
+    return;
+
+  const bool cached = layout->world == _world.get() &&
+      layout->version == _world->_EntityVersion();
+
+  for (size_t i = 0; i < layout->models.size(); ++i)
+  {
+    ModelPtr modelHolder;
+    Model *model = Resolve(_world, cached, layout->models[i],
+        layout->modelIds[i], modelHolder);
+    if (!model)
+      continue;
+
+    const double *scale = &this->dataPtr->modelScales[i * 3];
+    model->SetWorldPose(LoadPose(&this->dataPtr->modelPoses[i * 7]), true);
+    model->SetScale(ignition::math::Vector3d(scale[0], scale[1], scale[2]),
+        true);
+
+    const size_t firstLink = layout->modelFirstLinks[i];
+    const size_t endLink = firstLink + layout->modelLinkCounts[i];
+    for (size_t j = firstLink; j < endLink; ++j)
+    {
+      LinkPtr linkHolder;
+      Link *link = Resolve(_world, cached, layout->links[j],
+          layout->linkIds[j], linkHolder);
+      if (!link)
+        continue;
+
+      // The wrenches are not applied. They are the forces of the last
+      // step, and setting them would apply them again on the next one.
+      const double *vel = &this->dataPtr->linkVels[j * 6];
+      link->SetWorldPose(LoadPose(&this->dataPtr->linkPoses[j * 7]));
+      link->SetLinearVel(ignition::math::Vector3d(vel[0], vel[1], vel[2]));
+      link->SetAngularVel(ignition::math::Vector3d(vel[3], vel[4], vel[5]));
+    }
+  }
+
+  for (size_t i = 0; i < layout->lights.size(); ++i)
+  {
+    LightPtr lightHolder;
+    Light *light = Resolve(_world, cached, layout->lights[i],
+        layout->lightIds[i], lightHolder);
+    if (light)
+      light->SetWorldPose(LoadPose(&this->dataPtr->lightPoses[i * 7]));
+  }
+}
+
+/////////////////////////////////////////////////
+bool WorldSnapshot::SameLayout(const WorldSnapshot &_snapshot) const
+{
+  auto a = this->dataPtr->layout;
+  auto b = _snapshot.dataPtr->layout;
+  if (a == b)
+    return true;
+  if (!a || !b)
+    return false;
+
+  return a->modelIds == b->modelIds && a->linkIds == b->linkIds &&
+      a->jointIds == b->jointIds && a->jointOffsets == b->jointOffsets &&
+      a->lightIds == b->lightIds;
+}
+
+/////////////////////////////////////////////////
+bool WorldSnapshot::Diff(const WorldSnapshot &_snapshot,
+    WorldSnapshot &_diff) const
+{
+  if (!this->SameLayout(_snapshot))
+    return false;
+
+  const WorldSnapshotPrivate &a = *this->dataPtr;
+  const WorldSnapshotPrivate &b = *_snapshot.dataPtr;
+  WorldSnapshotPrivate &result = *_diff.dataPtr;
+
+  result.layout = a.layout;
+  result.worldName = a.worldName;
+  result.simTime = a.simTime;
+  result.realTime = a.realTime;
+  result.wallTime = a.wallTime;
+  result.iterations = a.iterations;
+
+  CombinePoses(a.modelPoses, b.modelPoses, true, result.modelPoses);
+  CombineValues(a.modelScales, b.modelScales, true, result.modelScales);
+  CombinePoses(a.linkPoses, b.linkPoses, true, result.linkPoses);
+  CombineValues(a.linkVels, b.linkVels, true, result.linkVels);
+  CombineValues(a.linkAccels, b.linkAccels, true, result.linkAccels);
+  CombineValues(a.linkWrenches, b.linkWrenches, true, result.linkWrenches);
+  CombineValues(a.jointPositions, b.jointPositions, true,
+      result.jointPositions);
+  CombinePoses(a.lightPoses, b.lightPoses, true, result.lightPoses);
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool WorldSnapshot::Add(const WorldSnapshot &_diff,
+    WorldSnapshot &_result) const
+{
+  if (!this->SameLayout(_diff))
+    return false;
+
+  const WorldSnapshotPrivate &a = *this->dataPtr;
+  const WorldSnapshotPrivate &b = *_diff.dataPtr;
+  WorldSnapshotPrivate &result = *_result.dataPtr;
+
+  result.layout = a.layout;
+  result.worldName = a.worldName;
+  result.simTime = a.simTime;
+  result.realTime = a.realTime;
+  result.wallTime = a.wallTime;
+  result.iterations = a.iterations;
+
+  CombinePoses(a.modelPoses, b.modelPoses, false, result.modelPoses);
+  CombineValues(a.modelScales, b.modelScales, false, result.modelScales);
+  CombinePoses(a.linkPoses, b.linkPoses, false, result.linkPoses);
+  CombineValues(a.linkVels, b.linkVels, false, result.linkVels);
+  CombineValues(a.linkAccels, b.linkAccels, false, result.linkAccels);
+  CombineValues(a.linkWrenches, b.linkWrenches, false, result.linkWrenches);
+  CombineValues(a.jointPositions, b.jointPositions, false,
+      result.jointPositions);
+  CombinePoses(a.lightPoses, b.lightPoses, false, result.lightPoses);
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool WorldSnapshot::IsZero() const
+{
+  return ZeroPoses(this->dataPtr->modelPoses) &&
+      ZeroValues(this->dataPtr->modelScales) &&
+      ZeroPoses(this->dataPtr->linkPoses) &&
+      ZeroValues(this->dataPtr->linkVels) &&
+      ZeroValues(this->dataPtr->linkAccels) &&
+      ZeroValues(this->dataPtr->linkWrenches) &&
+      ZeroValues(this->dataPtr->jointPositions) &&
+      ZeroPoses(this->dataPtr->lightPoses);
+}
+
+/////////////////////////////////////////////////
+void WorldSnapshotPrivate::ToModelState(const size_t _index,
+    ModelState &_state) const
+{
+  const WorldSnapshotLayout &layout = *this->layout;
+  const double *scale = &this->modelScales[_index * 3];
+
+  _state.name = layout.modelNames[_index];
+  _state.wallTime = this->wallTime;
+  _state.realTime = this->realTime;
+  _state.simTime = this->simTime;
+  _state.iterations = this->iterations;
+  _state.pose = LoadPose(&this->modelPoses[_index * 7]);
+  _state.scale.Set(scale[0], scale[1], scale[2]);
+
+  _state.linkStates.clear();
+  const size_t firstLink = layout.modelFirstLinks[_index];
+  const size_t endLink = firstLink + layout.modelLinkCounts[_index];
+  for (size_t i = firstLink; i < endLink; ++i)
+  {
+    const double *vel = &this->linkVels[i * 6];
+    const double *accel = &this->linkAccels[i * 6];
+    const double *wrench = &this->linkWrenches[i * 6];
+
+    LinkState &state = _state.linkStates[layout.linkNames[i]];
+    state.name = layout.linkNames[i];
+    state.wallTime = this->wallTime;
+    state.realTime = this->realTime;
+    state.simTime = this->simTime;
+    state.iterations = this->iterations;
+    state.pose = LoadPose(&this->linkPoses[i * 7]);
+    state.velocity.Set(ignition::math::Vector3d(vel[0], vel[1], vel[2]),
+        ignition::math::Vector3d(vel[3], vel[4], vel[5]));
+    state.acceleration.Set(
+        ignition::math::Vector3d(accel[0], accel[1], accel[2]),
+        ignition::math::Vector3d(accel[3], accel[4], accel[5]));
+    state.wrench.Set(ignition::math::Vector3d(wrench[0], wrench[1], wrench[2]),
+        ignition::math::Vector3d(wrench[3], wrench[4], wrench[5]));
+  }
+
+  _state.jointStates.clear();
+  const size_t firstJoint = layout.modelFirstJoints[_index];
+  const size_t endJoint = firstJoint + layout.modelJointCounts[_index];
+  for (size_t i = firstJoint; i < endJoint; ++i)
+  {
+    JointState &state = _state.jointStates[layout.jointNames[i]];
+    state.name = layout.jointNames[i];
+    state.wallTime = this->wallTime;
+    state.realTime = this->realTime;
+    state.simTime = this->simTime;
+    state.iterations = this->iterations;
+    state.positions.assign(
+        this->jointPositions.begin() + layout.jointOffsets[i],
+        this->jointPositions.begin() + layout.jointOffsets[i + 1]);
+  }
+
+  _state.modelStates.clear();
+  const size_t end = _index + 1 + layout.modelNestedCounts[_index];
+  for (size_t i = _index + 1; i < end; i += layout.modelNestedCounts[i] + 1)
+    this->ToModelState(i, _state.modelStates[layout.modelNames[i]]);
+}
+
+/////////////////////////////////////////////////
+void WorldSnapshotPrivate::ToWorldState(WorldState &_state) const
+{
+  _state.name = this->worldName;
+  _state.wallTime = this->wallTime;
+  _state.realTime = this->realTime;
+  _state.simTime = this->simTime;
+  _state.iterations = this->iterations;
+  _state.modelStates.clear();
+  _state.lightStates.clear();
+  _state.insertions.clear();
+  _state.deletions.clear();
+
+  auto layout = this->layout;
+  if (!layout)
+    return;
+
+  for (size_t i = 0; i < layout->modelIds.size();
+       i += layout->modelNestedCounts[i] + 1)
+  {
+    this->ToModelState(i, _state.modelStates[layout->modelNames[i]]);
+  }
+
+  for (size_t i = 0; i < layout->lightIds.size(); ++i)
+  {
+    LightState &state = _state.lightStates[layout->lightNames[i]];
+    state.name = layout->lightNames[i];
+    state.wallTime = this->wallTime;
+    state.realTime = this->realTime;
+    state.simTime = this->simTime;
+    state.iterations = this->iterations;
+    state.pose = LoadPose(&this->lightPoses[i * 7]);
+  }
+}
+
+/////////////////////////////////////////////////
+bool WorldSnapshotPrivate::FromModelState(const ModelState &_state,
+    const size_t _index)
+{
+  const WorldSnapshotLayout &layout = *this->layout;
+  bool complete = true;
+
+  StorePose(_state.pose, &this->modelPoses[_index * 7]);
+  this->modelScales[_index * 3] = _state.scale.X();
+  this->modelScales[_index * 3 + 1] = _state.scale.Y();
+  this->modelScales[_index * 3 + 2] = _state.scale.Z();
+
+  const size_t firstLink = layout.modelFirstLinks[_index];
+  const size_t endLink = firstLink + layout.modelLinkCounts[_index];
+  for (size_t i = firstLink; i < endLink; ++i)
+  {
+    auto iter = _state.linkStates.find(layout.linkNames[i]);
+    if (iter == _state.linkStates.end())
+    {
+      complete = false;
+      continue;
+    }
+
+    const LinkState &state = iter->second;
+    StorePose(state.pose, &this->linkPoses[i * 7]);
+    StoreVectors(state.velocity.Pos(), state.velocity.Rot().Euler(),
+        &this->linkVels[i * 6]);
+    StoreVectors(state.acceleration.Pos(), state.acceleration.Rot().Euler(),
+        &this->linkAccels[i * 6]);
+    StoreVectors(state.wrench.Pos(), state.wrench.Rot().Euler(),
+        &this->linkWrenches[i * 6]);
+  }
+
+  const size_t firstJoint = layout.modelFirstJoints[_index];
+  const size_t endJoint = firstJoint + layout.modelJointCounts[_index];
+  for (size_t i = firstJoint; i < endJoint; ++i)
+  {
+    auto iter = _state.jointStates.find(layout.jointNames[i]);
+    if (iter == _state.jointStates.end())
+    {
+      complete = false;
+      continue;
+    }
+
+    const std::vector<double> &positions = iter->second.positions;
+    for (size_t j = layout.jointOffsets[i], axis = 0;
+         j < layout.jointOffsets[i + 1] && axis < positions.size();
+         ++j, ++axis)
+    {
+      this->jointPositions[j] = positions[axis];
+    }
+  }
+
+  const size_t end = _index + 1 + layout.modelNestedCounts[_index];
+  for (size_t i = _index + 1; i < end; i += layout.modelNestedCounts[i] + 1)
+  {
+    auto iter = _state.modelStates.find(layout.modelNames[i]);
+    if (iter == _state.modelStates.end())
+      complete = false;
+    else
+      complete = this->FromModelState(iter->second, i) && complete;
+  }
+
+  return complete;
+}
+
+/////////////////////////////////////////////////
+bool WorldSnapshotPrivate::FromWorldState(const WorldState &_state)
+{
+  auto layout = this->layout;
+  if (!layout)
+    return false;
+
+  this->worldName = _state.name;
+  this->wallTime = _state.wallTime;
+  this->realTime = _state.realTime;
+  this->simTime = _state.simTime;
+  this->iterations = _state.iterations;
+
+  bool complete = true;
+  for (size_t i = 0; i < layout->modelIds.size();
+       i += layout->modelNestedCounts[i] + 1)
+  {
+    auto iter = _state.modelStates.find(layout->modelNames[i]);
+    if (iter == _state.modelStates.end())
+      complete = false;
+    else
+      complete = this->FromModelState(iter->second, i) && complete;
+  }
+
+  for (size_t i = 0; i < layout->lightIds.size(); ++i)
+  {
+    auto iter = _state.lightStates.find(layout->lightNames[i]);
+    if (iter == _state.lightStates.end())
+      complete = false;
+    else
+      StorePose(iter->second.pose, &this->lightPoses[i * 7]);
+  }
+
+  return complete;
+}
+
+/////////////////////////////////////////////////
+void WorldSnapshot::ToWorldState(WorldState &_state) const
+{
+  this->dataPtr->ToWorldState(_state);
+}
+
+/////////////////////////////////////////////////
+bool WorldSnapshot::FromWorldState(const WorldState &_state)
+{
+  return this->dataPtr->FromWorldState(_state);
+}
+
+/////////////////////////////////////////////////
+bool WorldSnapshot::Pose(const uint32_t _id,
+    ignition::math::Pose3d &_pose) const
+{
+  auto layout = this->dataPtr->layout;
+  if (!layout)
+    return false;
+
+  auto iter = layout->index.find(_id);
+  if (iter == layout->index.end())
+    return false;
+
+  const size_t i = iter->second.second;
+  switch (iter->second.first)
+  {
+    case WorldSnapshotLayout::MODEL:
+      _pose = LoadPose(&this->dataPtr->modelPoses[i * 7]);
+      return true;
+    case WorldSnapshotLayout::LINK:
+      _pose = LoadPose(&this->dataPtr->linkPoses[i * 7]);
+      return true;
+    case WorldSnapshotLayout::LIGHT:
+      _pose = LoadPose(&this->dataPtr->lightPoses[i * 7]);
+      return true;
+    default:
+      return false;
+  }
+}
+
+/////////////////////////////////////////////////
+bool WorldSnapshot::Velocity(const uint32_t _id,
+    ignition::math::Vector3d &_linear,
+    ignition::math::Vector3d &_angular) const
+{
+  auto layout = this->dataPtr->layout;
+  if (!layout)
+    return false;
+
+  auto iter = layout->index.find(_id);
+  if (iter == layout->index.end() ||
+      iter->second.first != WorldSnapshotLayout::LINK)
+  {
+    return false;
+  }
+
+  const double *vel = &this->dataPtr->linkVels[iter->second.second * 6];
+  _linear.Set(vel[0], vel[1], vel[2]);
+  _angular.Set(vel[3], vel[4], vel[5]);
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool WorldSnapshot::JointPosition(const uint32_t _id,
+    const unsigned int _axis, double &_position) const
+{
+  auto layout = this->dataPtr->layout;
+  if (!layout)
+    return false;
+
+  auto iter = layout->index.find(_id);
+  if (iter == layout->index.end() ||
+      iter->second.first != WorldSnapshotLayout::JOINT)
+  {
+    return false;
+  }
+
+  const size_t i = iter->second.second;
+  const size_t offset = layout->jointOffsets[i] + _axis;
+  if (offset >= layout->jointOffsets[i + 1])
+    return false;
+
+  _position = this->dataPtr->jointPositions[offset];
+  return true;
+}
+
+/////////////////////////////////////////////////
+size_t WorldSnapshot::ModelCount() const
+{
+  return this->dataPtr->layout ? this->dataPtr->layout->modelIds.size() : 0;
+}
+
+/////////////////////////////////////////////////
+size_t WorldSnapshot::LinkCount() const
+{
+  return this->dataPtr->layout ? this->dataPtr->layout->linkIds.size() : 0;
+}
+
+/////////////////////////////////////////////////
+size_t WorldSnapshot::JointCount() const
+{
+  return this->dataPtr->layout ? this->dataPtr->layout->jointIds.size() : 0;
+}
+
+/////////////////////////////////////////////////
+size_t WorldSnapshot::LightCount() const
+{
+  return this->dataPtr->layout ? this->dataPtr->layout->lightIds.size() : 0;
+}
+
+/////////////////////////////////////////////////
+common::Time WorldSnapshot::SimTime() const
+{
+  return this->dataPtr->simTime;
+}
+
+/////////////////////////////////////////////////
+common::Time WorldSnapshot::RealTime() const
+{
+  return this->dataPtr->realTime;
+}
+
+/////////////////////////////////////////////////
+uint64_t WorldSnapshot::Iterations() const
+{
+  return this->dataPtr->iterations;
+}
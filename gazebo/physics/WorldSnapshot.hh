@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_WORLDSNAPSHOT_HH_
+#define GAZEBO_PHYSICS_WORLDSNAPSHOT_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    class WorldState;
+
+    // Forward declare private data class.
+    class WorldSnapshotPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class WorldSnapshot WorldSnapshot.hh physics/physics.hh
+    /// \brief Flat state of a World, for fast copies.
+    ///
+    /// A snapshot stores the poses of models, links and lights, the
+    /// velocities, accelerations and wrenches of links, and the positions of
+    /// joints in contiguous arrays, with one entry per entity. The entities
+    /// and their ids make up the layout of the snapshot, which is built on
+    /// the first capture, and shared by the copies and differences of the
+    /// snapshot. Capturing a world whose entities did not change since the
+    /// last capture does not allocate memory.
+    ///
+    /// Unlike WorldState, a snapshot contains no insertions nor deletions.
+    /// Use ToWorldState and FromWorldState to convert between the two.
+    class GZ_PHYSICS_VISIBLE WorldSnapshot
+    {
+      /// \brief Constructor. The snapshot is empty until captured.
+      public: WorldSnapshot();
+
+      /// \brief Copy constructor. The layout is shared.
+      /// \param[in] _snapshot Snapshot to copy.
+      public: WorldSnapshot(const WorldSnapshot &_snapshot);
+
+      /// \brief Destructor.
+      public: ~WorldSnapshot();
+
+      /// \brief Assignment operator. The layout is shared.
+      /// \param[in] _snapshot Snapshot to copy.
+      /// \return Reference to this snapshot.
+      public: WorldSnapshot &operator=(const WorldSnapshot &_snapshot);
+
+      /// \brief Capture the state of a world. This should be called from
+      /// the world thread, or while the world is paused. The layout is
+      /// rebuilt if entities were added, removed or renamed since the last
+      /// capture.
+      /// \param[in] _world The world.
+      public: void Capture(const WorldPtr &_world);
+
+      /// \brief Set the state of the entities of a world. Models are set
+      /// before their links, and parent models before nested models, as
+      /// World::SetState does. Joint positions follow from the poses of the
+      /// links, and are not set. Wrenches are not set either: they are the
+      /// forces of the last step, which the physics engine would apply
+      /// again on the next step. Entities are found by id, so entities
+      /// removed from the world since the capture are skipped. Time and
+      /// iterations are not set, see World::SetState.
+      /// \param[in] _world The world.
+      public: void Apply(const WorldPtr &_world) const;
+
+      /// \brief Get whether two snapshots have the same entities, in the
+      /// same order.
+      /// \param[in] _snapshot The other snapshot.
+      /// \return True if the layouts are the same.
+      public: bool SameLayout(const WorldSnapshot &_snapshot) const;
+
+      /// \brief Compute the difference between this snapshot and another,
+      /// as WorldState::operator- does for poses. Other values are
+      /// subtracted component wise. The time stamps of this snapshot are
+      /// kept.
+      /// \param[in] _snapshot The snapshot to subtract.
+      /// \param[out] _diff The difference.
+      /// \return False if the snapshots have different layouts.
+      public: bool Diff(const WorldSnapshot &_snapshot,
+                  WorldSnapshot &_diff) const;
+
+      /// \brief Add a difference computed by Diff to this snapshot, as
+      /// WorldState::operator+ does for poses. The time stamps of this
+      /// snapshot are kept.
+      /// \param[in] _diff The difference.
+      /// \param[out] _result The sum.
+      /// \return False if the snapshots have different layouts.
+      public: bool Add(const WorldSnapshot &_diff,
+                  WorldSnapshot &_result) const;
+
+      /// \brief Get whether a difference is zero.
+      /// \return True if all the values are zero, and all the rotations
+      /// are identities.
+      public: bool IsZero() const;
+
+      /// \brief Fill a world state with the snapshot, including the joint
+      /// states. Insertions and deletions are cleared.
+      /// \param[out] _state The world state.
+      public: void ToWorldState(WorldState &_state) const;
+
+      /// \brief Set the values of the snapshot from a world state. The
+      /// layout is not changed: entities are matched by name, and entities
+      /// missing from the state keep their values.
+      /// \param[in] _state The world state.
+      /// \return True if every entity of the snapshot is in the state.
+      public: bool FromWorldState(const WorldState &_state);
+
+      /// \brief Get the pose of an entity.
+      /// \param[in] _id Id of a model, link or light.
+      /// \param[out] _pose World pose of the entity.
+      /// \return False if the entity is not in the snapshot.
+      public: bool Pose(const uint32_t _id,
+                  ignition::math::Pose3d &_pose) const;
+
+      /// \brief Get the velocity of a link.
+      /// \param[in] _id Id of the link.
+      /// \param[out] _linear World linear velocity.
+      /// \param[out] _angular World angular velocity.
+      /// \return False if the link is not in the snapshot.
+      public: bool Velocity(const uint32_t _id,
+                  ignition::math::Vector3d &_linear,
+                  ignition::math::Vector3d &_angular) const;
+
+      /// \brief Get the position of a joint.
+      /// \param[in] _id Id of the joint.
+      /// \param[in] _axis Index of the axis.
+      /// \param[out] _position Position of the joint along the axis.
+      /// \return False if the joint is not in the snapshot, or has no such
+      /// axis.
+      public: bool JointPosition(const uint32_t _id, const unsigned int _axis,
+                  double &_position) const;
+
+      /// \brief Get the number of models, including nested models.
+      /// \return Number of models.
+      public: size_t ModelCount() const;
+
+      /// \brief Get the number of links.
+      /// \return Number of links.
+      public: size_t LinkCount() const;
+
+      /// \brief Get the number of joints.
+      /// \return Number of joints.
+      public: size_t JointCount() const;
+
+      /// \brief Get the number of lights.
+      /// \return Number of lights.
+      public: size_t LightCount() const;
+
+      /// \brief Get the simulation time of the capture.
+      /// \return Simulation time.
+      public: common::Time SimTime() const;
+
+      /// \brief Get the real time of the capture.
+      /// \return Real time.
+      public: common::Time RealTime() const;
+
+      /// \brief Get the number of iterations of the capture.
+      /// \return Simulation iterations.
+      public: uint64_t Iterations() const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<WorldSnapshotPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
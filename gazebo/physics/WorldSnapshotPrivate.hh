@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_WORLDSNAPSHOTPRIVATE_HH_
+#define GAZEBO_PHYSICS_WORLDSNAPSHOTPRIVATE_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    class WorldState;
+
+    /// \internal
+    /// \brief Entities of a snapshot. A layout is never changed once built,
+    /// so that it can be shared between snapshots.
+    class WorldSnapshotLayout
+    {
+      /// \brief Kinds of entities.
+      public: enum Kind
+      {
+        /// \brief Model
+        MODEL,
+
+        /// \brief Link
+        LINK,
+
+        /// \brief Joint
+        JOINT,
+
+        /// \brief Light
+        LIGHT
+      };
+
+      /// \brief World the layout was built from. Only used to validate the
+      /// entity pointers.
+      public: const World *world = nullptr;
+
+      /// \brief Entity version of the world, see World::_EntityVersion.
+      public: uint64_t version = 0;
+
+      /// \brief Model ids. Models are stored depth first, so the nested
+      /// models of a model follow it.
+      public: std::vector<uint32_t> modelIds;
+
+      /// \brief Model names.
+      public: std::vector<std::string> modelNames;
+
+      /// \brief Number of nested models of each model, at any depth.
+      public: std::vector<size_t> modelNestedCounts;
+
+      /// \brief Index of the first link of each model.
+      public: std::vector<size_t> modelFirstLinks;
+
+      /// \brief Number of links of each model.
+      public: std::vector<size_t> modelLinkCounts;
+
+      /// \brief Index of the first joint of each model.
+      public: std::vector<size_t> modelFirstJoints;
+
+      /// \brief Number of joints of each model.
+      public: std::vector<size_t> modelJointCounts;
+
+      /// \brief Models, valid while the world has the same version.
+      public: std::vector<Model *> models;
+
+      /// \brief Link ids.
+      public: std::vector<uint32_t> linkIds;
+
+      /// \brief Link names.
+      public: std::vector<std::string> linkNames;
+
+      /// \brief Links, valid while the world has the same version.
+      public: std::vector<Link *> links;
+
+      /// \brief Joint ids.
+      public: std::vector<uint32_t> jointIds;
+
+      /// \brief Joint names.
+      public: std::vector<std::string> jointNames;
+
+      /// \brief Offset of the positions of each joint in the positions of
+      /// the snapshot. Has one more element than jointIds.
+      public: std::vector<size_t> jointOffsets;
+
+      /// \brief Joints, valid while the world has the same version.
+      public: std::vector<Joint *> joints;
+
+      /// \brief Light ids.
+      public: std::vector<uint32_t> lightIds;
+
+      /// \brief Light names.
+      public: std::vector<std::string> lightNames;
+
+      /// \brief Lights, valid while the world has the same version.
+      public: std::vector<Light *> lights;
+
+      /// \brief Kind and index of each entity, by id.
+      public: std::unordered_map<uint32_t, std::pair<Kind, size_t>> index;
+    };
+
+    /// \internal
+    /// \brief Private data for WorldSnapshot.
+    class WorldSnapshotPrivate
+    {
+      /// \brief Fill a world state.
+      /// \param[out] _state The world state.
+      public: void ToWorldState(WorldState &_state) const;
+
+      /// \brief Fill a model state, and its nested model states.
+      /// \param[in] _index Index of the model.
+      /// \param[out] _state The model state.
+      public: void ToModelState(const size_t _index, ModelState &_state) const;
+
+      /// \brief Set the values from a world state.
+      /// \param[in] _state The world state.
+      /// \return True if every entity is in the state.
+      public: bool FromWorldState(const WorldState &_state);
+
+      /// \brief Set the values of a model, and of its nested models, from a
+      /// model state.
+      /// \param[in] _state The model state.
+      /// \param[in] _index Index of the model.
+      /// \return True if every entity of the model is in the state.
+      public: bool FromModelState(const ModelState &_state,
+                  const size_t _index);
+
+      /// \brief Entities of the snapshot.
+      public: std::shared_ptr<const WorldSnapshotLayout> layout;
+
+      /// \brief Name of the world.
+      public: std::string worldName;
+
+      /// \brief Simulation time.
+      public: common::Time simTime;
+
+      /// \brief Real time.
+      public: common::Time realTime;
+
+      /// \brief Wall time.
+      public: common::Time wallTime;
+
+      /// \brief Simulation iterations.
+      public: uint64_t iterations = 0;
+
+      /// \brief Model poses, 7 values per model: x, y, z, qw, qx, qy, qz.
+      public: std::vector<double> modelPoses;
+
+      /// \brief Model scales, 3 values per model.
+      public: std::vector<double> modelScales;
+
+      /// \brief Link poses, 7 values per link, as modelPoses.
+      public: std::vector<double> linkPoses;
+
+      /// \brief Link velocities, 6 values per link: linear, then angular.
+      public: std::vector<double> linkVels;
+
+      /// \brief Link accelerations, 6 values per link: linear, then angular.
+      public: std::vector<double> linkAccels;
+
+      /// \brief Link wrenches, 6 values per link: force, then torque.
+      public: std::vector<double> linkWrenches;
+
+      /// \brief Joint positions, one value per axis.
+      public: std::vector<double> jointPositions;
+
+      /// \brief Light poses, 7 values per light, as modelPoses.
+      public: std::vector<double> lightPoses;
+    };
+  }
+}
+#endif
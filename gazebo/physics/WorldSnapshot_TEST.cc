@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "gazebo/physics/Joint.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/WorldSnapshot.hh"
+#include "gazebo/physics/WorldState.hh"
+#include "gazebo/test/ServerFixture.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class WorldSnapshotTest : public ServerFixture { };
+
+//////////////////////////////////////////////////
+TEST_F(WorldSnapshotTest, Capture)
+{
+  this->Load("test/worlds/simple_pendulums.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::WorldSnapshot empty;
+  EXPECT_EQ(empty.ModelCount(), 0u);
+  ignition::math::Pose3d pose;
+  EXPECT_FALSE(empty.Pose(0, pose));
+
+  world->Step(10);
+
+  physics::WorldSnapshot snapshot;
+  snapshot.Capture(world);
+  EXPECT_EQ(snapshot.ModelCount(), world->ModelCount());
+  EXPECT_EQ(snapshot.LightCount(), world->Lights().size());
+  EXPECT_EQ(snapshot.Iterations(), world->Iterations());
+  EXPECT_EQ(snapshot.SimTime(), world->SimTime());
+
+  auto model = world->ModelByName("model_1");
+  ASSERT_TRUE(model != nullptr);
+  auto link = model->GetLink("link_2");
+  ASSERT_TRUE(link != nullptr);
+  auto joint = model->GetJoint("joint_1");
+  ASSERT_TRUE(joint != nullptr);
+
+  ASSERT_TRUE(snapshot.Pose(model->GetId(), pose));
+  EXPECT_EQ(pose, model->WorldPose());
+  ASSERT_TRUE(snapshot.Pose(link->GetId(), pose));
+  EXPECT_EQ(pose, link->WorldPose());
+
+  ignition::math::Vector3d linear, angular;
+  ASSERT_TRUE(snapshot.Velocity(link->GetId(), linear, angular));
+  EXPECT_EQ(linear, link->WorldLinearVel());
+  EXPECT_EQ(angular, link->WorldAngularVel());
+  EXPECT_FALSE(snapshot.Velocity(model->GetId(), linear, angular));
+
+  double position = 0;
+  ASSERT_TRUE(snapshot.JointPosition(joint->GetId(), 0, position));
+  EXPECT_DOUBLE_EQ(position, joint->Position(0));
+  EXPECT_FALSE(snapshot.JointPosition(joint->GetId(), 1, position));
+  EXPECT_FALSE(snapshot.JointPosition(link->GetId(), 0, position));
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldSnapshotTest, DiffAdd)
+{
+  this->Load("test/worlds/simple_pendulums.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::WorldSnapshot start;
+  start.Capture(world);
+
+  // Nothing moved
+  physics::WorldSnapshot same(start);
+  EXPECT_TRUE(same.SameLayout(start));
+  physics::WorldSnapshot diff;
+  ASSERT_TRUE(same.Diff(start, diff));
+  EXPECT_TRUE(diff.IsZero());
+
+  world->Step(100);
+  physics::WorldSnapshot end;
+  end.Capture(world);
+  EXPECT_TRUE(end.SameLayout(start));
+
+  ASSERT_TRUE(end.Diff(start, diff));
+  EXPECT_FALSE(diff.IsZero());
+
+  // start + (end - start) == end
+  physics::WorldSnapshot sum;
+  ASSERT_TRUE(start.Add(diff, sum));
+  auto link = world->ModelByName("model_1")->GetLink("link_2");
+  ASSERT_TRUE(link != nullptr);
+  ignition::math::Pose3d pose;
+  ASSERT_TRUE(sum.Pose(link->GetId(), pose));
+  EXPECT_EQ(pose, link->WorldPose());
+
+  // Snapshots of different worlds can't be combined.
+  physics::WorldSnapshot empty;
+  EXPECT_FALSE(empty.SameLayout(start));
+  EXPECT_FALSE(start.Diff(empty, diff));
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldSnapshotTest, SetState)
+{
+  this->Load("test/worlds/simple_pendulums.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  world->Step(50);
+  physics::WorldSnapshot snapshot;
+  snapshot.Capture(world);
+
+  auto link = world->ModelByName("model_1")->GetLink("link_2");
+  ASSERT_TRUE(link != nullptr);
+  const ignition::math::Pose3d pose = link->WorldPose();
+  const ignition::math::Vector3d vel = link->WorldLinearVel();
+
+  world->Step(200);
+  EXPECT_NE(link->WorldPose(), pose);
+
+  world->SetState(snapshot);
+  EXPECT_EQ(world->Iterations(), snapshot.Iterations());
+  EXPECT_EQ(world->SimTime(), snapshot.SimTime());
+  EXPECT_EQ(link->WorldPose(), pose);
+  EXPECT_EQ(link->WorldLinearVel(), vel);
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldSnapshotTest, WorldState)
+{
+  this->Load("test/worlds/deeply_nested_models.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::WorldSnapshot snapshot;
+  snapshot.Capture(world);
+
+  physics::WorldState state;
+  snapshot.ToWorldState(state);
+
+  // The state matches a state loaded from the world.
+  physics::WorldState expected(world);
+  EXPECT_EQ(state.GetName(), expected.GetName());
+  EXPECT_EQ(state.GetModelStateCount(), expected.GetModelStateCount());
+  EXPECT_EQ(state.LightStateCount(), expected.LightStateCount());
+  ASSERT_TRUE(state.HasModelState("model_00"));
+  auto model = state.GetModelState("model_00");
+  auto expectedModel = expected.GetModelState("model_00");
+  EXPECT_EQ(model.Pose(), expectedModel.Pose());
+  ASSERT_TRUE(model.HasNestedModelState("model_01"));
+  EXPECT_EQ(model.NestedModelState("model_01").NestedModelState(
+        "model_02").Pose(), expectedModel.NestedModelState(
+        "model_01").NestedModelState("model_02").Pose());
+
+  // Moving a model and reading the state back restores the snapshot.
+  physics::WorldSnapshot copy(snapshot);
+  auto nested = world->ModelByName("model_00::model_01");
+  ASSERT_TRUE(nested != nullptr);
+  nested->SetWorldPose(ignition::math::Pose3d(1, 2, 3, 0, 0, 0));
+  copy.Capture(world);
+
+  physics::WorldSnapshot diff;
+  ASSERT_TRUE(copy.Diff(snapshot, diff));
+  EXPECT_FALSE(diff.IsZero());
+
+  EXPECT_TRUE(copy.FromWorldState(state));
+  ASSERT_TRUE(copy.Diff(snapshot, diff));
+  EXPECT_TRUE(diff.IsZero());
+
+  // A state without the entities of the snapshot
+  EXPECT_FALSE(copy.FromWorldState(physics::WorldState()));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -250,6 +250,12 @@ namespace gazebo
         return _out;
       }
 
+      /// \brief LogFrame fills states from raw values.
+      private: friend class LogFrame;
+
+      /// \brief WorldSnapshot converts states to and from raw values.
+      private: friend class WorldSnapshotPrivate;
+
       /// \brief State of all the models.
       private: ModelState_M modelStates;
 
@@ -15,15 +15,58 @@
  *
 */
 
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "gazebo/physics/Joint.hh"
+#include "gazebo/physics/JointController.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/test/ServerFixture.hh"
+#include "gazebo/transport/TransportIface.hh"
+#include "gazebo/util/LogRecord.hh"
 #include "test/util.hh"
 
 using namespace gazebo;
 
 class WorldTest : public ServerFixture {};
 
+/// \brief Pose messages received on ~/pose/info.
+std::vector<msgs::PosesStamped> g_poseMsgs;
+
+/// \brief Mutex to protect g_poseMsgs.
+std::mutex g_poseMutex;
+
+/////////////////////////////////////////////////
+/// \brief Callback for ~/pose/info.
+/// \param[in] _msg The poses.
+void OnPoseInfo(ConstPosesStampedPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_poseMutex);
+  g_poseMsgs.push_back(*_msg);
+}
+
+/// \brief Pose messages received on ~/pose/info at a lower rate.
+std::vector<msgs::PosesStamped> g_slowPoseMsgs;
+
+/////////////////////////////////////////////////
+/// \brief Callback for ~/pose/info at a lower rate.
+/// \param[in] _msg The poses.
+void OnSlowPoseInfo(ConstPosesStampedPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_poseMutex);
+  g_slowPoseMsgs.push_back(*_msg);
+}
+
 //////////////////////////////////////////////////
 /// \brief Test the factory message's allow_renaming flag and unique model name
 /// generation.
@@ -194,6 +237,499 @@ TEST_F(WorldTest, EditName)
   }
 }
 
+//////////////////////////////////////////////////
+/// \brief Test that updating models in parallel gives the same result as
+/// updating them serially.
+TEST_F(WorldTest, ModelUpdateThreads)
+{
+  this->Load("test/worlds/simple_pendulums.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Serial by default
+  EXPECT_EQ(world->ModelUpdateThreads(), 0u);
+
+  const unsigned int steps = 200;
+
+  // Drive one of the pendulums through its joint controller, which runs in
+  // Model::Update, and let the others swing.
+  auto runPendulums = [&]()
+  {
+    world->Reset();
+    auto model = world->ModelByName("model_2");
+    ASSERT_TRUE(model != nullptr);
+    auto joint = model->GetJoint("joint_0");
+    ASSERT_TRUE(joint != nullptr);
+    model->GetJointController()->SetVelocityTarget(
+        joint->GetScopedName(), 1.0);
+    world->Step(steps);
+  };
+
+  runPendulums();
+  std::map<std::string, ignition::math::Pose3d> serialPoses;
+  for (auto const &model : world->Models())
+  {
+    for (auto const &link : model->GetLinks())
+      serialPoses[link->GetScopedName()] = link->WorldPose();
+  }
+
+  world->SetModelUpdateThreads(4);
+  EXPECT_EQ(world->ModelUpdateThreads(), 4u);
+
+  runPendulums();
+  for (auto const &model : world->Models())
+  {
+    for (auto const &link : model->GetLinks())
+      EXPECT_EQ(link->WorldPose(), serialPoses[link->GetScopedName()]);
+  }
+
+  world->SetModelUpdateThreads(0);
+  EXPECT_EQ(world->ModelUpdateThreads(), 0u);
+}
+
+//////////////////////////////////////////////////
+/// \brief Test that models are put to sleep and woken up by ODE.
+TEST_F(WorldTest, Sleeping)
+{
+  this->Load("worlds/empty.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  EXPECT_FALSE(world->SkipSleeping());
+
+  // A box resting on the ground, and one high enough to still be falling.
+  this->SpawnBox("resting", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.5));
+  this->SpawnBox("falling", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(5, 0, 50));
+  auto resting = world->ModelByName("resting");
+  auto falling = world->ModelByName("falling");
+  ASSERT_TRUE(resting != nullptr);
+  ASSERT_TRUE(falling != nullptr);
+  EXPECT_FALSE(resting->IsSleeping());
+
+  // ODE disables bodies that stay idle for a second.
+  world->Step(1500);
+  EXPECT_TRUE(resting->IsSleeping());
+  EXPECT_FALSE(falling->IsSleeping());
+
+  world->SetSkipSleeping(true);
+  EXPECT_TRUE(world->SkipSleeping());
+
+  const ignition::math::Pose3d pose = resting->WorldPose();
+  const double fallingZ = falling->WorldPose().Pos().Z();
+  world->Step(100);
+  EXPECT_TRUE(resting->IsSleeping());
+  EXPECT_EQ(resting->WorldPose(), pose);
+  EXPECT_LT(falling->WorldPose().Pos().Z(), fallingZ);
+
+  // A sleeping model that is teleported is found where it was moved.
+  world->EnableSpatialIndex();
+  world->Step(1);
+  const ignition::math::Vector3d moved(-5, 0, 0.5);
+  resting->SetWorldPose(ignition::math::Pose3d(moved, pose.Rot()));
+  world->Step(1);
+  bool found = false;
+  for (const auto &model : world->ModelsInSphere(moved, 0.1))
+    found = found || model->GetName() == "resting";
+  EXPECT_TRUE(found);
+  resting->SetWorldPose(pose);
+  world->Step(1);
+
+  // A force enables the body again.
+  resting->GetLink()->AddForce(ignition::math::Vector3d(0, 0, 1000));
+  world->Step(1);
+  EXPECT_FALSE(resting->IsSleeping());
+  world->Step(10);
+  EXPECT_GT(resting->WorldPose().Pos().Z(), pose.Pos().Z());
+
+  // Removed models are forgotten.
+  world->RemoveModel("resting");
+  world->Step(1);
+  EXPECT_FALSE(falling->IsSleeping());
+
+  world->SetSkipSleeping(false);
+  EXPECT_FALSE(world->SkipSleeping());
+}
+
+//////////////////////////////////////////////////
+/// \brief Test that entities are found through the index of the world.
+TEST_F(WorldTest, EntityIndex)
+{
+  this->Load("test/worlds/deeply_nested_models.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Scoped names and names
+  auto model = world->ModelByName("model_00");
+  ASSERT_TRUE(model != nullptr);
+  auto nested = world->ModelByName("model_00::model_01::model_02");
+  ASSERT_TRUE(nested != nullptr);
+  EXPECT_EQ(nested->GetScopedName(), "model_00::model_01::model_02");
+  EXPECT_TRUE(world->BaseByName("model_02") == nested);
+
+  auto link = world->BaseByName("model_00::model_01::link_01");
+  ASSERT_TRUE(link != nullptr);
+  EXPECT_TRUE(model->GetByName("model_00::model_01::link_01") == link);
+  EXPECT_TRUE(nested->GetByName("model_00::model_01::link_01") == nullptr);
+
+  auto joint = model->GetJoint("model_00::joint_00");
+  ASSERT_TRUE(joint != nullptr);
+  EXPECT_EQ(joint->GetName(), "joint_00");
+
+  // Ids
+  EXPECT_TRUE(world->BaseById(link->GetId()) == link);
+  EXPECT_TRUE(world->ModelById(nested->GetId()) == nested);
+  EXPECT_TRUE(link->GetParent()->GetById(link->GetId()) == link);
+  EXPECT_TRUE(model->GetById(link->GetId()) == nullptr);
+
+  // Renaming a model renames the entities it contains.
+  model->SetName("renamed");
+  EXPECT_TRUE(world->ModelByName("renamed") == model);
+  EXPECT_TRUE(world->ModelByName("model_00") == nullptr);
+  EXPECT_TRUE(world->BaseByName("model_00::model_01::link_01") == nullptr);
+  EXPECT_TRUE(world->BaseByName("renamed::model_01::link_01") == link);
+  EXPECT_EQ(link->GetScopedName(), "renamed::model_01::link_01");
+
+  // Removed entities are removed from the index.
+  const uint32_t linkId = link->GetId();
+  link.reset();
+  nested.reset();
+  joint.reset();
+  world->RemoveModel(model);
+  model.reset();
+  EXPECT_TRUE(world->BaseById(linkId) == nullptr);
+  EXPECT_TRUE(world->BaseByName("renamed::model_01::link_01") == nullptr);
+}
+
+//////////////////////////////////////////////////
+/// \brief Test that only the poses that changed are published.
+TEST_F(WorldTest, PosePublication)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Rates
+  EXPECT_DOUBLE_EQ(world->PosePublishRate("~/pose/info"), 60.0);
+  EXPECT_DOUBLE_EQ(world->PosePublishRate("~/pose/local/info"), 0.0);
+  EXPECT_LT(world->PosePublishRate("~/pose/other"), 0.0);
+  EXPECT_FALSE(world->SetPosePublishRate("~/pose/other", 10.0));
+  EXPECT_FALSE(world->SetPosePublishRate("~/pose/info", -1.0));
+  EXPECT_TRUE(world->SetPosePublishRate("~/pose/info", 0.0));
+  EXPECT_DOUBLE_EQ(world->PosePublishRate("/gazebo/default/pose/info"), 0.0);
+
+  auto sub = this->node->Subscribe("~/pose/info", &OnPoseInfo);
+
+  auto box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+  box->SetWorldPose(ignition::math::Pose3d(1, 2, 3, 0, 0, 0));
+
+  bool received = false;
+  for (int i = 0; i < 100 && !received; ++i)
+  {
+    common::Time::MSleep(10);
+    std::lock_guard<std::mutex> lock(g_poseMutex);
+    for (auto const &msg : g_poseMsgs)
+    {
+      for (int j = 0; j < msg.pose_size(); ++j)
+      {
+        if (msg.pose(j).id() == box->GetId())
+        {
+          received = true;
+          EXPECT_EQ(msg.pose(j).name(), "box");
+          EXPECT_EQ(msgs::ConvertIgn(msg.pose(j)),
+              ignition::math::Pose3d(1, 2, 3, 0, 0, 0));
+        }
+      }
+    }
+  }
+  EXPECT_TRUE(received);
+
+  // The world is paused, nothing moves, so nothing is published.
+  common::Time::MSleep(100);
+  {
+    std::lock_guard<std::mutex> lock(g_poseMutex);
+    g_poseMsgs.clear();
+  }
+  common::Time::MSleep(100);
+  {
+    std::lock_guard<std::mutex> lock(g_poseMutex);
+    EXPECT_TRUE(g_poseMsgs.empty());
+  }
+
+  // A subscriber with a lower rate gets the changes held back by its rate
+  // merged into one message.
+  transport::SubscribeOptions ops;
+  ops.SetMaxRate(2);
+  auto slowSub = this->node->Subscribe("~/pose/info", &OnSlowPoseInfo, ops);
+
+  auto sphere = world->ModelByName("sphere");
+  ASSERT_TRUE(sphere != nullptr);
+  const ignition::math::Pose3d boxPose(4, 5, 6, 0, 0, 0);
+  const ignition::math::Pose3d spherePose(7, 8, 9, 0, 0, 0);
+  box->SetWorldPose(boxPose);
+  common::Time::MSleep(50);
+  sphere->SetWorldPose(spherePose);
+
+  std::map<uint32_t, ignition::math::Pose3d> latest;
+  for (int i = 0; i < 200 && latest.size() < 2u; ++i)
+  {
+    common::Time::MSleep(10);
+    std::lock_guard<std::mutex> lock(g_poseMutex);
+    latest.clear();
+    for (auto const &msg : g_slowPoseMsgs)
+    {
+      for (int j = 0; j < msg.pose_size(); ++j)
+      {
+        const uint32_t id = msg.pose(j).id();
+        if (id == box->GetId() || id == sphere->GetId())
+          latest[id] = msgs::ConvertIgn(msg.pose(j));
+      }
+    }
+  }
+  EXPECT_EQ(latest[box->GetId()], boxPose);
+  EXPECT_EQ(latest[sphere->GetId()], spherePose);
+  std::lock_guard<std::mutex> lock(g_poseMutex);
+  EXPECT_LE(g_slowPoseMsgs.size(), 2u);
+}
+
+//////////////////////////////////////////////////
+/// \brief Test that a restored snapshot steps as the saved state did.
+TEST_F(WorldTest, Snapshot)
+{
+  this->Load("test/worlds/simple_pendulums.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  auto model = world->ModelByName("model_1");
+  ASSERT_TRUE(model != nullptr);
+  auto link = model->GetLink("link_2");
+  ASSERT_TRUE(link != nullptr);
+  auto joint = model->GetJoint("joint_1");
+  ASSERT_TRUE(joint != nullptr);
+
+  world->Step(50);
+  const uint32_t handle = world->SaveSnapshot();
+  const common::Time simTime = world->SimTime();
+  const uint64_t iterations = world->Iterations();
+
+  world->Step(100);
+  const ignition::math::Pose3d pose = link->WorldPose();
+  const ignition::math::Vector3d vel = link->WorldLinearVel();
+  const double position = joint->Position(0);
+
+  world->Step(100);
+  EXPECT_TRUE(world->RestoreSnapshot(handle));
+  EXPECT_EQ(world->SimTime(), simTime);
+  EXPECT_EQ(world->Iterations(), iterations);
+
+  world->Step(100);
+  EXPECT_NEAR(link->WorldPose().Pos().Distance(pose.Pos()), 0.0, 1e-6);
+  EXPECT_NEAR(link->WorldLinearVel().Distance(vel), 0.0, 1e-6);
+  EXPECT_NEAR(joint->Position(0), position, 1e-6);
+
+  // Snapshots over transport
+  auto response = transport::request(world->Name(), "save_snapshot");
+  ASSERT_TRUE(response != nullptr);
+  EXPECT_EQ(response->response(), "success");
+  msgs::Int handleMsg;
+  ASSERT_TRUE(handleMsg.ParseFromString(response->serialized_data()));
+  EXPECT_GT(handleMsg.data(), static_cast<int>(handle));
+
+  response = transport::request(world->Name(), "restore_snapshot",
+      std::to_string(handle));
+  ASSERT_TRUE(response != nullptr);
+  EXPECT_EQ(response->response(), "success");
+  EXPECT_EQ(world->SimTime(), simTime);
+
+  response = transport::request(world->Name(), "remove_snapshot",
+      std::to_string(handleMsg.data()));
+  ASSERT_TRUE(response != nullptr);
+  EXPECT_EQ(response->response(), "success");
+
+  response = transport::request(world->Name(), "restore_snapshot",
+      std::to_string(handleMsg.data()));
+  ASSERT_TRUE(response != nullptr);
+  EXPECT_EQ(response->response(), "nonexistent");
+
+  EXPECT_TRUE(world->RemoveSnapshot(handle));
+  EXPECT_FALSE(world->RemoveSnapshot(handle));
+  EXPECT_FALSE(world->RestoreSnapshot(handle));
+}
+
+//////////////////////////////////////////////////
+/// \brief Test that a restored snapshot doesn't apply the forces of the
+/// step before it was saved a second time.
+TEST_F(WorldTest, SnapshotForce)
+{
+  this->Load("worlds/empty.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  this->SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.5));
+  auto model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  auto link = model->GetLink();
+  ASSERT_TRUE(link != nullptr);
+
+  // Save right after a step that applied a force.
+  link->AddForce(ignition::math::Vector3d(50, 0, 0));
+  world->Step(1);
+  const uint32_t handle = world->SaveSnapshot();
+
+  auto run = [&]()
+  {
+    std::vector<ignition::math::Pose3d> poses;
+    for (int i = 0; i < 50; ++i)
+    {
+      link->AddForce(ignition::math::Vector3d(0, 20, 0));
+      world->Step(1);
+      poses.push_back(link->WorldPose());
+    }
+    return poses;
+  };
+
+  const std::vector<ignition::math::Pose3d> first = run();
+  EXPECT_TRUE(world->RestoreSnapshot(handle));
+  const std::vector<ignition::math::Pose3d> second = run();
+
+  ASSERT_EQ(first.size(), second.size());
+  for (size_t i = 0; i < first.size(); ++i)
+  {
+    EXPECT_NEAR(first[i].Pos().Distance(second[i].Pos()), 0.0, 1e-6)
+      << "step " << i;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Test that models and links are found through the spatial index
+/// as they move.
+TEST_F(WorldTest, SpatialIndex)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  auto names = [](const physics::Model_V &_models)
+  {
+    std::set<std::string> result;
+    for (auto const &model : _models)
+      result.insert(model->GetName());
+    return result;
+  };
+
+  const ignition::math::Vector3d boxPos(0, 0, 0.5);
+  const ignition::math::Vector3d spherePos(0, 1.5, 0.5);
+
+  // Nothing is found before the index is enabled.
+  EXPECT_TRUE(world->ModelsInSphere(boxPos, 0.1).empty());
+
+  // The index is built by the world thread, also while paused.
+  world->EnableSpatialIndex();
+  for (int i = 0; i < 1000 && world->ModelsInSphere(boxPos, 0.1).empty();
+      ++i)
+  {
+    common::Time::MSleep(1);
+  }
+
+  // The ground plane is in every query.
+  auto found = names(world->ModelsInSphere(boxPos, 0.1));
+  EXPECT_EQ(found.size(), 2u);
+  EXPECT_EQ(found.count("box"), 1u);
+  EXPECT_EQ(found.count("ground_plane"), 1u);
+
+  found = names(world->ModelsInBox(ignition::math::Box(
+          ignition::math::Vector3d(-5, -5, -5),
+          ignition::math::Vector3d(5, 5, 5))));
+  EXPECT_EQ(found.size(), 4u);
+
+  auto links = world->LinksInBox(ignition::math::Box(
+        spherePos - ignition::math::Vector3d(0.1, 0.1, 0.1),
+        spherePos + ignition::math::Vector3d(0.1, 0.1, 0.1)));
+  bool sphereLink = false;
+  for (auto const &link : links)
+    sphereLink = sphereLink || link->GetScopedName() == "sphere::link";
+  EXPECT_TRUE(sphereLink);
+
+  // The index follows a model that is moved, after the next update.
+  auto sphere = world->ModelByName("sphere");
+  ASSERT_TRUE(sphere != nullptr);
+  const ignition::math::Vector3d movedPos(10, 0, 0.5);
+  sphere->SetWorldPose(ignition::math::Pose3d(movedPos,
+        ignition::math::Quaterniond::Identity));
+  world->Step(1);
+  EXPECT_EQ(names(world->ModelsInSphere(spherePos, 0.1)).count("sphere"), 0u);
+  EXPECT_EQ(names(world->ModelsInSphere(movedPos, 0.1)).count("sphere"), 1u);
+
+  // Frustum along X, which sees the box but not the moved sphere.
+  ignition::math::Frustum frustum;
+  frustum.SetNear(0.1);
+  frustum.SetFar(5);
+  frustum.SetFOV(1.0);
+  frustum.SetAspectRatio(1.0);
+  frustum.SetPose(ignition::math::Pose3d(-3, 0, 0.5, 0, 0, 0));
+  found = names(world->ModelsInFrustum(frustum));
+  EXPECT_EQ(found.count("box"), 1u);
+  EXPECT_EQ(found.count("sphere"), 0u);
+
+  // Removed models are removed from the index.
+  world->RemoveModel("box");
+  world->Step(1);
+  found = names(world->ModelsInSphere(boxPos, 0.1));
+  EXPECT_EQ(found.count("box"), 0u);
+  EXPECT_EQ(found.count("ground_plane"), 1u);
+}
+
+//////////////////////////////////////////////////
+/// \brief Test that models inserted while recording are logged, also
+/// after the recording was stopped and started again.
+TEST_F(WorldTest, LogInsertions)
+{
+  util::LogRecord *recorder = util::LogRecord::Instance();
+  ASSERT_TRUE(recorder != nullptr);
+  recorder->Init("test");
+
+  this->Load("worlds/empty.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  const boost::filesystem::path logPath =
+    boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gazebo_log_%%%%%%%%");
+
+  for (int i = 0; i < 2; ++i)
+  {
+    const std::string name = "box_" + std::to_string(i);
+    const boost::filesystem::path path = logPath / std::to_string(i);
+
+    ASSERT_TRUE(recorder->Start("txt", path.string()));
+    world->Step(10);
+    this->SpawnBox(name, ignition::math::Vector3d::One,
+        ignition::math::Vector3d(i * 2.0, 0, 0.5));
+    world->Step(10);
+
+    const std::string filename = recorder->Filename("default");
+    recorder->Stop();
+    EXPECT_FALSE(recorder->Running());
+
+    std::ifstream file(filename);
+    ASSERT_TRUE(file.good()) << filename;
+    std::stringstream content;
+    content << file.rdbuf();
+    const std::string log = content.str();
+
+    // The box is not in the world description at the start of the log.
+    const size_t insertions = log.find("<insertions>");
+    ASSERT_NE(insertions, std::string::npos) << "recording " << i;
+    EXPECT_NE(log.find("<model name='" + name + "'>", insertions),
+        std::string::npos) << "recording " << i;
+  }
+
+  boost::filesystem::remove_all(logPath);
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -116,8 +116,6 @@ void BulletCollision::SetCollideBits(unsigned int _bits)
 //////////////////////////////////////////////////
 unsigned int BulletCollision::GetCategoryBits() const
 {
-  gzwarn << "GetCategoryBits is not implemented" << std::endl;
-  // Prevent unused variable warning
   return this->categoryBits;
 }
 
@@ -323,6 +323,15 @@ void BulletLink::OnPoseChange()
 
   this->rigidLink->setCenterOfMassTransform(
     BulletTypes::ConvertPose(myPose));
+
+  // Bullet doesn't wake up a body that is moved. Wake it, and report the
+  // link awake for the world to stop skipping its model.
+  this->rigidLink->activate(true);
+  if (this->sleeping)
+  {
+    this->sleeping = false;
+    this->world->_SetLinkSleeping(this, false);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -504,6 +513,21 @@ btRigidBody *BulletLink::GetBulletLink() const
   return this->rigidLink;
 }
 
+//////////////////////////////////////////////////
+void BulletLink::UpdateSleeping()
+{
+  if (!this->rigidLink)
+    return;
+
+  const bool deactivated =
+    this->rigidLink->getActivationState() == ISLAND_SLEEPING;
+  if (deactivated != this->sleeping)
+  {
+    this->sleeping = deactivated;
+    this->world->_SetLinkSleeping(this, deactivated);
+  }
+}
+
 
 //////////////////////////////////////////////////
 void BulletLink::RemoveAndAddBody() const
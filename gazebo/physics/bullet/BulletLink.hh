@@ -109,6 +109,11 @@ namespace gazebo
       /// \brief Remove and re-add this rigid body from the world.
       public: void RemoveAndAddBody() const;
 
+      /// \internal
+      /// \brief Tell the world if Bullet deactivated the rigid body, or
+      /// activated it again, since the last call.
+      public: void UpdateSleeping();
+
       /// \internal
       /// \brief Clear bullet collision cache needed when the body is resized.
       public: void ClearCollisionCache();
@@ -175,6 +180,10 @@ namespace gazebo
 
       /// \brief Pointer to the bullet physics engine.
       private: BulletPhysicsPtr bulletPhysics;
+
+      /// \brief True if the world was told that Bullet deactivated the
+      ///        rigid body.
+      private: bool sleeping = false;
     };
     /// \}
   }
@@ -17,6 +17,10 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
 #include <ignition/math/Rand.hh>
 
@@ -127,25 +131,159 @@ struct CollisionFilter : public btOverlapFilterCallback
     }
 };
 
+//////////////////////////////////////////////////
+/// \brief A contact manifold, and the contact of the contact manager its
+/// points are copied to.
+class BulletContactFeedback
+{
+  /// \brief The manifold.
+  public: const btPersistentManifold *manifold;
+
+  /// \brief Link of the first body of the manifold.
+  public: BulletLink *link1;
+
+  /// \brief Link of the second body of the manifold.
+  public: BulletLink *link2;
+
+  /// \brief Contact to fill.
+  public: Contact *contact;
+};
+
+//////////////////////////////////////////////////
+/// \brief Copy the points of a contact manifold to its contact, with the
+/// forces and torques applied to the bodies.
+/// \param[in] _feedback The manifold and its contact.
+/// \param[in] _timeStep Time step the forces are computed from.
+static void FillContact(const BulletContactFeedback &_feedback,
+    const btScalar _timeStep)
+{
+  const btPersistentManifold *contactManifold = _feedback.manifold;
+  BulletLink *link1 = _feedback.link1;
+  BulletLink *link2 = _feedback.link2;
+  Contact *contactFeedback = _feedback.contact;
+
+  const btRigidBody *rbA = btRigidBody::upcast(
+      static_cast<const btCollisionObject *>(contactManifold->getBody0()));
+  const btRigidBody *rbB = btRigidBody::upcast(
+      static_cast<const btCollisionObject *>(contactManifold->getBody1()));
+
+  auto body1Pose = link1->WorldPose();
+  auto body2Pose = link2->WorldPose();
+  ignition::math::Vector3d localForce1;
+  ignition::math::Vector3d localForce2;
+  ignition::math::Vector3d localTorque1;
+  ignition::math::Vector3d localTorque2;
+
+  int numContacts = contactManifold->getNumContacts();
+  for (int j = 0; j < numContacts; ++j)
+  {
+    const btManifoldPoint &pt = contactManifold->getContactPoint(j);
+    if (pt.getDistance() <= 0.f)
+    {
+      const btVector3 &ptB = pt.getPositionWorldOnB();
+      const btVector3 &normalOnB = pt.m_normalWorldOnB;
+      btVector3 impulse = pt.m_appliedImpulse * normalOnB;
+
+      // calculate force in world frame
+      btVector3 force = impulse/_timeStep;
+
+      // calculate torque in world frame
+      btVector3 torqueA = (ptB-rbA->getCenterOfMassPosition()).cross(force);
+      btVector3 torqueB = (ptB-rbB->getCenterOfMassPosition()).cross(-force);
+
+      // Convert from world to link frame
+      localForce1 = body1Pose.Rot().RotateVectorReverse(
+          BulletTypes::ConvertVector3Ign(force));
+      localForce2 = body2Pose.Rot().RotateVectorReverse(
+          BulletTypes::ConvertVector3Ign(-force));
+      localTorque1 = body1Pose.Rot().RotateVectorReverse(
+          BulletTypes::ConvertVector3Ign(torqueA));
+      localTorque2 = body2Pose.Rot().RotateVectorReverse(
+          BulletTypes::ConvertVector3Ign(torqueB));
+
+      // Points that are not penetrating are skipped, so the points are
+      // stored at the contact count rather than at j.
+      const int k = contactFeedback->count;
+      contactFeedback->positions[k] = BulletTypes::ConvertVector3Ign(ptB);
+      contactFeedback->normals[k] = BulletTypes::ConvertVector3Ign(normalOnB);
+      contactFeedback->depths[k] = -pt.getDistance();
+      if (!link1->IsStatic())
+      {
+        contactFeedback->wrench[k].body1Force = localForce1;
+        contactFeedback->wrench[k].body1Torque = localTorque1;
+      }
+      if (!link2->IsStatic())
+      {
+        contactFeedback->wrench[k].body2Force = localForce2;
+        contactFeedback->wrench[k].body2Torque = localTorque2;
+      }
+      contactFeedback->count++;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Fill contacts on multiple threads.
+class FillContacts_TBB
+{
+  /// \brief Constructor.
+  /// \param[in] _feedbacks Manifolds and their contacts.
+  /// \param[in] _timeStep Time step the forces are computed from.
+  public: FillContacts_TBB(
+              const std::vector<BulletContactFeedback> &_feedbacks,
+              const btScalar _timeStep)
+          : feedbacks(_feedbacks), timeStep(_timeStep)
+  {
+  }
+
+  /// \brief Fill the contacts of a range of manifolds.
+  /// \param[in] _r Range of manifolds.
+  public: void operator() (const tbb::blocked_range<size_t> &_r) const
+  {
+    for (size_t i = _r.begin(); i != _r.end(); ++i)
+      FillContact(this->feedbacks[i], this->timeStep);
+  }
+
+  /// \brief Manifolds and their contacts.
+  private: const std::vector<BulletContactFeedback> &feedbacks;
+
+  /// \brief Time step the forces are computed from.
+  private: const btScalar timeStep;
+};
+
+//////////////////////////////////////////////////
+void BulletPhysics::InternalTickCallback(btDynamicsWorld *_world,
+    btScalar _timeStep)
+{
+  static_cast<BulletPhysics *>(_world->getWorldUserInfo())->UpdateContacts(
+      _timeStep);
+}
+
 //////////////////////////////////////////////////
 // Gets the contact information in the current state of
 // the world, updates the contact manager and
 // and sets the contact feedback information.
-void UpdateContacts(btDynamicsWorld *_world, btScalar _timeStep)
+void BulletPhysics::UpdateContacts(btScalar _timeStep)
 {
-  int numManifolds = _world->getDispatcher()->getNumManifolds();
+  // Reused by the next updates of this thread.
+  static thread_local std::vector<BulletContactFeedback> feedbacks;
+  feedbacks.clear();
+
+  const common::Time simTime = this->world->SimTime();
+  btDispatcher *worldDispatcher = this->dynamicsWorld->getDispatcher();
+
+  // Contacts are added to the contact manager in the order of the
+  // manifolds, on this thread.
+  int numManifolds = worldDispatcher->getNumManifolds();
   for (int i = 0; i < numManifolds; ++i)
   {
     btPersistentManifold *contactManifold =
-        _world->getDispatcher()->getManifoldByIndexInternal(i);
+        worldDispatcher->getManifoldByIndexInternal(i);
     const btCollisionObject *obA =
         static_cast<const btCollisionObject *>(contactManifold->getBody0());
     const btCollisionObject *obB =
         static_cast<const btCollisionObject *>(contactManifold->getBody1());
 
-    const btRigidBody *rbA = btRigidBody::upcast(obA);
-    const btRigidBody *rbB = btRigidBody::upcast(obB);
-
     BulletLink *link1 = static_cast<BulletLink *>(
         obA->getUserPointer());
     GZ_ASSERT(link1 != nullptr, "Link1 in collision pair is null");
@@ -161,78 +299,36 @@ void UpdateContacts(btDynamicsWorld *_world, btScalar _timeStep)
     if (!collisionPtr1 || !collisionPtr2)
       continue;
 
-    PhysicsEnginePtr engine = collisionPtr1->GetWorld()->Physics();
-    BulletPhysicsPtr bulletPhysics =
-          boost::static_pointer_cast<BulletPhysics>(engine);
-
     // Add a new contact to the manager. This will return nullptr if no one is
     // listening for contact information.
-    Contact *contactFeedback = bulletPhysics->GetContactManager()->NewContact(
-        collisionPtr1.get(), collisionPtr2.get(),
-        collisionPtr1->GetWorld()->SimTime());
+    Contact *contactFeedback = this->contactManager->NewContact(
+        collisionPtr1.get(), collisionPtr2.get(), simTime);
 
     if (!contactFeedback)
       continue;
 
-    auto body1Pose = link1->WorldPose();
-    auto body2Pose = link2->WorldPose();
-    auto cg1Pos = link1->GetInertial()->Pose().Pos();
-    auto cg2Pos = link2->GetInertial()->Pose().Pos();
-    ignition::math::Vector3d localForce1;
-    ignition::math::Vector3d localForce2;
-    ignition::math::Vector3d localTorque1;
-    ignition::math::Vector3d localTorque2;
-
-    int numContacts = contactManifold->getNumContacts();
-    for (int j = 0; j < numContacts; ++j)
-    {
-      btManifoldPoint &pt = contactManifold->getContactPoint(j);
-      if (pt.getDistance() <= 0.f)
-      {
-        const btVector3 &ptB = pt.getPositionWorldOnB();
-        const btVector3 &normalOnB = pt.m_normalWorldOnB;
-        btVector3 impulse = pt.m_appliedImpulse * normalOnB;
-
-        // calculate force in world frame
-        btVector3 force = impulse/_timeStep;
-
-        // calculate torque in world frame
-        btVector3 torqueA = (ptB-rbA->getCenterOfMassPosition()).cross(force);
-        btVector3 torqueB = (ptB-rbB->getCenterOfMassPosition()).cross(-force);
-
-        // Convert from world to link frame
-        localForce1 = body1Pose.Rot().RotateVectorReverse(
-            BulletTypes::ConvertVector3Ign(force));
-        localForce2 = body2Pose.Rot().RotateVectorReverse(
-            BulletTypes::ConvertVector3Ign(-force));
-        localTorque1 = body1Pose.Rot().RotateVectorReverse(
-            BulletTypes::ConvertVector3Ign(torqueA));
-        localTorque2 = body2Pose.Rot().RotateVectorReverse(
-            BulletTypes::ConvertVector3Ign(torqueB));
-
-        contactFeedback->positions[j] = BulletTypes::ConvertVector3Ign(ptB);
-        contactFeedback->normals[j] = BulletTypes::ConvertVector3Ign(normalOnB);
-        contactFeedback->depths[j] = -pt.getDistance();
-        if (!link1->IsStatic())
-        {
-          contactFeedback->wrench[j].body1Force = localForce1;
-          contactFeedback->wrench[j].body1Torque = localTorque1;
-        }
-        if (!link2->IsStatic())
-        {
-          contactFeedback->wrench[j].body2Force = localForce2;
-          contactFeedback->wrench[j].body2Torque = localTorque2;
-        }
-        contactFeedback->count++;
-      }
-    }
+    feedbacks.push_back({contactManifold, link1, link2, contactFeedback});
   }
-}
 
-//////////////////////////////////////////////////
-void InternalTickCallback(btDynamicsWorld *_world, btScalar _timeStep)
-{
-  UpdateContacts(_world, _timeStep);
+  // The points of each manifold go to its own contact, so manifolds can be
+  // converted in parallel.
+  if (this->contactArena && feedbacks.size() > 32)
+  {
+    // The arena may run this on one of its threads, which has its own
+    // feedbacks, so the size is captured.
+    FillContacts_TBB fillContacts(feedbacks, _timeStep);
+    const size_t count = feedbacks.size();
+    this->contactArena->execute([&fillContacts, count]()
+    {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, count, 16),
+          fillContacts);
+    });
+  }
+  else
+  {
+    for (auto const &feedback : feedbacks)
+      FillContact(feedback, _timeStep);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -300,7 +396,7 @@ BulletPhysics::BulletPhysics(WorldPtr _world)
   gContactProcessedCallback = ContactProcessed;
 
   this->dynamicsWorld->setInternalTickCallback(
-      InternalTickCallback, static_cast<void *>(this));
+      &BulletPhysics::InternalTickCallback, static_cast<void *>(this));
 
   // Set random seed for physics engine based on gazebo's random seed.
   // Note: this was moved from physics::PhysicsEngine constructor.
@@ -322,6 +418,14 @@ void BulletPhysics::Load(sdf::ElementPtr _sdf)
 
   sdf::ElementPtr bulletElem = this->sdf->GetElement("bullet");
 
+  sdf::ElementPtr solverElem = bulletElem->GetElement("solver");
+  if (solverElem->HasElement("threads"))
+    this->SetThreads(solverElem->Get<int>("threads"));
+
+  // The world is still empty, so it can be replaced.
+  if (this->threads > 0)
+    this->CreateDynamicsWorldMt();
+
   auto g = this->world->Gravity();
   // ODEPhysics checks this, so we will too.
   if (g == ignition::math::Vector3d::Zero)
@@ -374,6 +478,98 @@ void BulletPhysics::Load(sdf::ElementPtr _sdf)
   // info.m_splitImpulsePenetrationThreshold = 0.0;
 }
 
+//////////////////////////////////////////////////
+void BulletPhysics::CreateDynamicsWorldMt()
+{
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  if (this->worldMt)
+    return;
+
+  if (this->dynamicsWorld->getNumCollisionObjects() > 0)
+  {
+    gzwarn << "The multithreaded Bullet world can only be created before "
+           << "models are loaded, set <bullet><solver><threads> instead.\n";
+    return;
+  }
+
+#ifdef HAVE_BULLET_MT
+  // Bullet has a single task scheduler per process. Prefer the one that
+  // runs on TBB, which Gazebo already uses, if Bullet was built with it.
+  btITaskScheduler *scheduler = btGetTaskScheduler();
+  if (!scheduler || scheduler == btGetSequentialTaskScheduler())
+  {
+    static btITaskScheduler *defaultScheduler = btCreateDefaultTaskScheduler();
+    scheduler = btGetTBBTaskScheduler();
+    if (!scheduler)
+      scheduler = defaultScheduler;
+    if (!scheduler)
+    {
+      gzwarn << "Bullet has no task scheduler, "
+             << "the single threaded world is used.\n";
+      return;
+    }
+    btSetTaskScheduler(scheduler);
+  }
+  scheduler->setNumThreads(std::max(1, std::min(
+          static_cast<int>(this->threads), scheduler->getMaxNumThreads())));
+
+  // Replace the dispatcher, the solver and the world. The broadphase, and
+  // the collision filter of its pair cache, are kept.
+  delete this->dynamicsWorld;
+  delete this->solver;
+  delete this->dispatcher;
+
+  this->dispatcher = new btCollisionDispatcherMt(this->collisionConfig);
+  btGImpactCollisionAlgorithm::registerAlgorithm(this->dispatcher);
+
+  // Islands are solved in parallel by a pool of solvers. Large islands,
+  // such as piles, are solved by a solver that batches their constraints.
+  btConstraintSolverPoolMt *solverPool =
+    new btConstraintSolverPoolMt(BT_MAX_THREAD_COUNT);
+  this->solver = solverPool;
+#if BT_BULLET_VERSION >= 288
+  this->solverMt = new btSequentialImpulseConstraintSolverMt();
+  this->dynamicsWorld = new btDiscreteDynamicsWorldMt(this->dispatcher,
+      this->broadPhase, solverPool, this->solverMt, this->collisionConfig);
+#else
+  this->dynamicsWorld = new btDiscreteDynamicsWorldMt(this->dispatcher,
+      this->broadPhase, solverPool, this->collisionConfig);
+#endif
+
+  this->dynamicsWorld->setInternalTickCallback(
+      &BulletPhysics::InternalTickCallback, static_cast<void *>(this));
+  this->worldMt = true;
+#else
+  gzwarn << "Bullet is older than 2.87 or was not built with BT_THREADSAFE, "
+         << "the single threaded world is used. Contacts are still updated "
+         << "on " << this->threads << " threads.\n";
+#endif
+}
+
+//////////////////////////////////////////////////
+bool BulletPhysics::SetThreads(int _threads)
+{
+  // The scheduler of the world is updated under the same lock.
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  if (!this->SetWorkerThreads(_threads, "threads", this->threads,
+        this->contactArena))
+  {
+    return false;
+  }
+
+#ifdef HAVE_BULLET_MT
+  btITaskScheduler *scheduler = btGetTaskScheduler();
+  if (this->worldMt && scheduler)
+  {
+    scheduler->setNumThreads(std::max(1, std::min(_threads,
+            scheduler->getMaxNumThreads())));
+  }
+#endif
+  return true;
+}
+
 //////////////////////////////////////////////////
 void BulletPhysics::Init()
 {
@@ -500,7 +696,7 @@ void BulletPhysics::UpdateCollision()
     this->dynamicsWorld->performDiscreteCollisionDetection();
     // In addition, the contacts have to be updated in the contact
     // manager and for the feedback.
-    UpdateContacts(this->dynamicsWorld, this->maxStepSize);
+    this->UpdateContacts(this->maxStepSize);
   }
 }
 
@@ -512,6 +708,24 @@ void BulletPhysics::UpdatePhysics()
 
   this->dynamicsWorld->stepSimulation(
     this->maxStepSize, 1, this->maxStepSize);
+
+  // Bullet has no callback for deactivation, so the bodies are polled, and
+  // only when the world uses it.
+  if (this->world->SkipSleeping())
+  {
+    const btCollisionObjectArray &objects =
+      this->dynamicsWorld->getCollisionObjectArray();
+    for (int i = 0; i < objects.size(); ++i)
+    {
+      if (objects[i]->isStaticOrKinematicObject())
+        continue;
+
+      BulletLink *link = static_cast<BulletLink *>(
+          objects[i]->getUserPointer());
+      if (link)
+        link->UpdateSleeping();
+    }
+  }
 }
 
 //////////////////////////////////////////////////
@@ -522,6 +736,10 @@ void BulletPhysics::Fini()
     delete this->dynamicsWorld;
   this->dynamicsWorld = nullptr;
 
+  if (this->solverMt)
+    delete this->solverMt;
+  this->solverMt = nullptr;
+
   if (this->solver)
     delete this->solver;
   this->solver = nullptr;
@@ -631,6 +849,14 @@ bool BulletPhysics::SetParam(const std::string &_key, const boost::any &_value)
       bulletElem->GetElement("constraints")->GetElement(
           "split_impulse_penetration_threshold")->Set(value);
     }
+    else if (_key == "threads")
+    {
+      int value = boost::any_cast<int>(_value);
+      if (!this->SetThreads(value))
+        return false;
+      if (value > 0)
+        this->CreateDynamicsWorldMt();
+    }
     else if (_key == "max_contacts")
     {
       /// TODO: Implement max contacts param
@@ -695,6 +921,8 @@ bool BulletPhysics::GetParam(const std::string &_key, boost::any &_value) const
     _value = bulletElem->GetElement("constraints")->Get<double>(
       "split_impulse_penetration_threshold");
   }
+  else if (_key == "threads")
+    _value = static_cast<int>(this->threads);
   else if (_key == "max_contacts")
     _value = this->sdf->GetElement("max_contacts")->Get<int>();
   else if (_key == "min_step_size")
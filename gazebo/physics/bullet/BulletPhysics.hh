@@ -21,8 +21,11 @@
 
 #ifndef BULLETPHYSICS_HH
 #define BULLETPHYSICS_HH
+#include <memory>
 #include <string>
 
+#include <tbb/task_arena.h>
+
 #include <boost/thread/thread.hpp>
 #include <boost/thread/mutex.hpp>
 
@@ -172,12 +175,50 @@ namespace gazebo
       // Documentation inherited
       public: virtual void SetSORPGSIters(unsigned int iters);
 
+      /// \brief Called by Bullet after each internal step, to update the
+      /// contact manager and the contact feedbacks.
+      /// \param[in] _world The dynamics world, whose user info is the
+      /// BulletPhysics.
+      /// \param[in] _timeStep Time step.
+      private: static void InternalTickCallback(btDynamicsWorld *_world,
+                   btScalar _timeStep);
+
+      /// \brief Get the contacts of the current state of the world, update
+      /// the contact manager and set the contact feedbacks.
+      /// \param[in] _timeStep Time step the forces are computed from.
+      private: void UpdateContacts(btScalar _timeStep);
+
+      /// \brief Set the number of threads of the dynamics world and of the
+      /// contact updates.
+      /// \param[in] _threads Number of threads, zero for a single
+      /// threaded world.
+      /// \return False if the number of threads is negative.
+      private: bool SetThreads(int _threads);
+
+      /// \brief Replace the dynamics world with the multithreaded world of
+      /// Bullet, if it is available. Must be called before anything is
+      /// added to the world.
+      private: void CreateDynamicsWorldMt();
+
       private: btBroadphaseInterface *broadPhase;
       private: btDefaultCollisionConfiguration *collisionConfig;
       private: btCollisionDispatcher *dispatcher;
-      private: btSequentialImpulseConstraintSolver *solver;
+      private: btConstraintSolver *solver;
       private: btDiscreteDynamicsWorld *dynamicsWorld;
 
+      /// \brief Constraint solver for large islands, used by the
+      /// multithreaded world.
+      private: btConstraintSolver *solverMt = nullptr;
+
+      /// \brief Number of threads, zero for a single threaded world.
+      private: unsigned int threads = 0;
+
+      /// \brief True if the dynamics world is multithreaded.
+      private: bool worldMt = false;
+
+      /// \brief Workers of the contact updates, null if threads is zero.
+      private: std::unique_ptr<tbb::task_arena> contactArena;
+
       private: common::Time lastUpdateTime;
 
       /// \brief The type of the solver.
@@ -16,7 +16,9 @@
 */
 
 #include <gtest/gtest.h>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "gazebo/physics/physics.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
@@ -259,6 +261,70 @@ TEST_F(BulletPhysics_TEST, PhysicsMsgParam)
   PhysicsMsgParam();
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that contacts are the same when they are updated on
+/// multiple threads.
+TEST_F(BulletPhysics_TEST, Threads)
+{
+  Load("worlds/empty.world", true, "bullet");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  BulletPhysicsPtr bulletPhysics =
+    boost::dynamic_pointer_cast<BulletPhysics>(world->Physics());
+  ASSERT_TRUE(bulletPhysics != nullptr);
+
+  EXPECT_EQ(boost::any_cast<int>(bulletPhysics->GetParam("threads")), 0);
+  EXPECT_FALSE(bulletPhysics->SetParam("threads", -1));
+  EXPECT_EQ(boost::any_cast<int>(bulletPhysics->GetParam("threads")), 0);
+
+  // More boxes on the ground than the contacts updated on a single thread.
+  for (int i = 0; i < 6; ++i)
+  {
+    for (int j = 0; j < 6; ++j)
+    {
+      std::ostringstream name;
+      name << "box_" << i << "_" << j;
+      SpawnBox(name.str(), ignition::math::Vector3d::One,
+          ignition::math::Vector3d(i * 1.5, j * 1.5, 0.49));
+    }
+  }
+
+  // Without physics, steps only update the contacts of the same state.
+  ContactManager *manager = bulletPhysics->GetContactManager();
+  manager->SetNeverDropContacts(true);
+  world->SetPhysicsEnabled(false);
+
+  world->Step(1);
+  std::vector<Contact> expected;
+  for (unsigned int i = 0; i < manager->GetContactCount(); ++i)
+    expected.push_back(*manager->GetContact(i));
+  EXPECT_GE(expected.size(), 36u);
+
+  EXPECT_TRUE(bulletPhysics->SetParam("threads", 4));
+  EXPECT_EQ(boost::any_cast<int>(bulletPhysics->GetParam("threads")), 4);
+
+  world->Step(1);
+  ASSERT_EQ(manager->GetContactCount(), expected.size());
+  for (unsigned int i = 0; i < expected.size(); ++i)
+  {
+    Contact *contact = manager->GetContact(i);
+    EXPECT_EQ(contact->collision1, expected[i].collision1);
+    EXPECT_EQ(contact->collision2, expected[i].collision2);
+    ASSERT_EQ(contact->count, expected[i].count);
+    EXPECT_GT(contact->count, 0);
+    for (int j = 0; j < contact->count; ++j)
+    {
+      EXPECT_EQ(contact->positions[j], expected[i].positions[j]);
+      EXPECT_EQ(contact->normals[j], expected[i].normals[j]);
+      EXPECT_DOUBLE_EQ(contact->depths[j], expected[i].depths[j]);
+    }
+  }
+
+  EXPECT_TRUE(bulletPhysics->SetParam("threads", 0));
+  EXPECT_EQ(boost::any_cast<int>(bulletPhysics->GetParam("threads")), 0);
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
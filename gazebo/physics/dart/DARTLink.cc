@@ -953,6 +953,12 @@ void DARTLink::updateDirtyPoseFromDARTTransformation()
   this->world->dataPtr->dirtyPoses.push_back(this);
 }
 
+//////////////////////////////////////////////////
+void DARTLink::SetDirtyPose(const ignition::math::Pose3d &_pose)
+{
+  this->dirtyPose = _pose;
+}
+
 //////////////////////////////////////////////////
 DARTPhysicsPtr DARTLink::GetDARTPhysics(void) const
 {
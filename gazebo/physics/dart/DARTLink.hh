@@ -161,6 +161,11 @@ namespace gazebo
       ///        Entity::SetWorldPose() for this link.
       public: void updateDirtyPoseFromDARTTransformation();
 
+      /// \brief Set the pose World::Update() will set to this link, without
+      ///        adding this link to World::dirtyPoses.
+      /// \param[in] _pose The pose of the link in the world frame.
+      public: void SetDirtyPose(const ignition::math::Pose3d &_pose);
+
       /// \brief Get pointer to DART Physics engine associated with this link.
       /// \return Pointer to the DART Physics engine.
       public: DARTPhysicsPtr GetDARTPhysics(void) const;
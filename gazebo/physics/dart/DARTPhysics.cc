@@ -15,6 +15,12 @@
  *
 */
 
+#include <string>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
@@ -61,6 +67,73 @@ using namespace physics;
 
 GZ_REGISTER_PHYSICS_ENGINE("dart", DARTPhysics)
 
+//////////////////////////////////////////////////
+/// \brief Set the dirty pose of a link from the transform of its body node.
+/// \param[in] _link The link, whose body node must exist.
+/// \param[in] _movedOnly True to leave the link alone if its pose did not
+/// change.
+/// \return True if the dirty pose of the link was set.
+static bool SyncLinkPose(DARTLink *_link, const bool _movedOnly)
+{
+  const ignition::math::Pose3d pose = DARTTypes::ConvPoseIgn(
+      _link->DARTBodyNode()->getTransform());
+
+  // Pose3d::operator== has a tolerance, the components are compared
+  // exactly so that small motions are not lost.
+  if (_movedOnly)
+  {
+    const ignition::math::Pose3d &current = _link->WorldPose();
+    if (pose.Pos().X() == current.Pos().X() &&
+        pose.Pos().Y() == current.Pos().Y() &&
+        pose.Pos().Z() == current.Pos().Z() &&
+        pose.Rot().W() == current.Rot().W() &&
+        pose.Rot().X() == current.Rot().X() &&
+        pose.Rot().Y() == current.Rot().Y() &&
+        pose.Rot().Z() == current.Rot().Z())
+    {
+      return false;
+    }
+  }
+
+  _link->SetDirtyPose(pose);
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Sync the poses of links on multiple threads.
+class SyncLinkPoses_TBB
+{
+  /// \brief Constructor.
+  /// \param[in] _links Links to sync.
+  /// \param[in] _movedOnly True to leave the links that did not move alone.
+  /// \param[out] _moved For each link, whether its dirty pose was set.
+  public: SyncLinkPoses_TBB(const std::vector<DARTLink *> &_links,
+              const bool _movedOnly, std::vector<char> &_moved)
+          : links(_links), movedOnly(_movedOnly), moved(_moved)
+  {
+  }
+
+  /// \brief Sync the poses of a range of links.
+  /// \param[in] _r Range of links.
+  public: void operator() (const tbb::blocked_range<size_t> &_r) const
+  {
+    for (size_t i = _r.begin(); i != _r.end(); ++i)
+    {
+      if (this->links[i]->DARTBodyNode())
+        this->moved[i] = SyncLinkPose(this->links[i], this->movedOnly);
+    }
+  }
+
+  /// \brief Links to sync.
+  private: const std::vector<DARTLink *> &links;
+
+  /// \brief True to leave the links that did not move alone.
+  private: const bool movedOnly;
+
+  /// \brief For each link, whether its dirty pose was set.
+  private: std::vector<char> &moved;
+};
+
 //////////////////////////////////////////////////
 DARTPhysics::DARTPhysics(WorldPtr _world)
     : PhysicsEngine(_world), dataPtr(new DARTPhysicsPrivate())
@@ -393,25 +466,89 @@ void DARTPhysics::UpdatePhysics()
   this->dataPtr->dtWorld->step();
 
   // Update all the transformation of DART's links to gazebo's links
-  // TODO: How to visit all the links in the world?
-  unsigned int modelCount = this->world->ModelCount();
-  ModelPtr modelItr;
+  if (!this->dataPtr->syncBuilt ||
+      this->dataPtr->syncEntityVersion != this->world->_EntityVersion())
+  {
+    this->RebuildPoseSync();
+  }
+  this->SyncLinkPoses();
+}
 
-  for (unsigned int i = 0; i < modelCount; ++i)
+//////////////////////////////////////////////////
+void DARTPhysics::RebuildPoseSync()
+{
+  this->dataPtr->syncLinks.clear();
+
+  for (auto const &model : this->world->Models())
   {
-    modelItr = this->world->ModelByIndex(i);
-    // TODO: need to improve speed
-    Link_V links = modelItr->GetLinks();
-    unsigned int linkCount = links.size();
-    DARTLinkPtr dartLinkItr;
+    for (auto const &link : model->GetLinks())
+    {
+      DARTLinkPtr dartLink = boost::dynamic_pointer_cast<DARTLink>(link);
+      if (dartLink)
+        this->dataPtr->syncLinks.push_back(dartLink.get());
+    }
+  }
+
+  this->dataPtr->syncMoved.assign(this->dataPtr->syncLinks.size(), 0);
+  this->dataPtr->syncDirty.reserve(this->dataPtr->syncLinks.size());
+  this->dataPtr->syncEntityVersion = this->world->_EntityVersion();
+  this->dataPtr->syncBuilt = true;
+}
+
+//////////////////////////////////////////////////
+void DARTPhysics::SyncLinkPoses()
+{
+  std::vector<DARTLink *> &links = this->dataPtr->syncLinks;
+  std::vector<char> &moved = this->dataPtr->syncMoved;
+  const bool movedOnly = this->dataPtr->poseSyncMovedOnly;
 
-    for (unsigned int j = 0; j < linkCount; ++j)
+  // Below this, the threads cost more than they save.
+  const size_t minParallelLinks = 64;
+
+  if (this->dataPtr->poseSyncArena && links.size() >= minParallelLinks)
+  {
+    // DART computes the transforms of the body nodes when they are first
+    // read, which must not happen on several threads at once.
+    for (size_t i = 0; i < this->dataPtr->dtWorld->getNumSkeletons(); ++i)
+    {
+      this->dataPtr->dtWorld->getSkeleton(i)->computeForwardKinematics(
+          true, false, false);
+    }
+
+    SyncLinkPoses_TBB sync(links, movedOnly, moved);
+    this->dataPtr->poseSyncArena->execute([&]
+    {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, links.size()), sync);
+    });
+  }
+  else
+  {
+    for (size_t i = 0; i < links.size(); ++i)
     {
-      dartLinkItr
-          = boost::dynamic_pointer_cast<DARTLink>(links.at(j));
-      dartLinkItr->updateDirtyPoseFromDARTTransformation();
+      if (links[i]->DARTBodyNode())
+        moved[i] = SyncLinkPose(links[i], movedOnly);
     }
   }
+
+  std::vector<Entity *> &dirty = this->dataPtr->syncDirty;
+  dirty.clear();
+  for (size_t i = 0; i < links.size(); ++i)
+  {
+    // Links without a body node yet cache the update until they are
+    // initialized.
+    if (!links[i]->DARTBodyNode())
+      links[i]->updateDirtyPoseFromDARTTransformation();
+    else if (moved[i])
+      dirty.push_back(links[i]);
+  }
+  this->world->_AddDirty(dirty);
+}
+
+//////////////////////////////////////////////////
+bool DARTPhysics::SetPoseSyncThreads(int _threads)
+{
+  return this->SetWorkerThreads(_threads, "pose sync threads",
+      this->dataPtr->poseSyncThreads, this->dataPtr->poseSyncArena);
 }
 
 //////////////////////////////////////////////////
@@ -547,6 +684,17 @@ boost::any DARTPhysics::GetParam(const std::string &_key) const
 //////////////////////////////////////////////////
 bool DARTPhysics::GetParam(const std::string &_key, boost::any &_value) const
 {
+  if (_key == "pose_sync_threads")
+  {
+    _value = static_cast<int>(this->dataPtr->poseSyncThreads);
+    return true;
+  }
+  else if (_key == "pose_sync_moved_only")
+  {
+    _value = this->dataPtr->poseSyncMovedOnly;
+    return true;
+  }
+
   if (!this->sdf->HasElement("dart"))
   {
     return PhysicsEngine::GetParam(_key, _value);
@@ -590,6 +738,15 @@ bool DARTPhysics::SetParam(const std::string &_key, const boost::any &_value)
       gzerr << "Setting [" << _key << "] in DART to [" << value
             << "] not yet supported.\n";
     }
+    else if (_key == "pose_sync_threads")
+    {
+      if (!this->SetPoseSyncThreads(boost::any_cast<int>(_value)))
+        return false;
+    }
+    else if (_key == "pose_sync_moved_only")
+    {
+      this->dataPtr->poseSyncMovedOnly = boost::any_cast<bool>(_value);
+    }
     else
     {
       if (_key == "max_step_size")
@@ -159,6 +159,22 @@ namespace gazebo
       private: DARTLinkPtr FindDARTLink(
           const dart::dynamics::BodyNode *_dtBodyNode);
 
+      /// \brief Rebuild the links whose poses are synced after each step,
+      /// from the models of the world.
+      private: void RebuildPoseSync();
+
+      /// \brief Set the dirty poses of the links from the transforms of
+      /// their body nodes, and add the links to the dirty poses of the
+      /// world.
+      private: void SyncLinkPoses();
+
+      /// \brief Set the number of threads the poses of the links are synced
+      /// on after each step.
+      /// \param[in] _threads Number of threads, zero to sync them on the
+      /// physics thread.
+      /// \return False if the number of threads is negative.
+      private: bool SetPoseSyncThreads(int _threads);
+
       /// \internal
       /// \brief Pointer to private data.
       private: DARTPhysicsPrivate *dataPtr = nullptr;
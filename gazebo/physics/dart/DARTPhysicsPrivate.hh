@@ -18,7 +18,15 @@
 #ifndef _GAZEBO_DARTPHYSICS_PRIVATE_HH_
 #define _GAZEBO_DARTPHYSICS_PRIVATE_HH_
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <tbb/task_arena.h>
+
+#include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/dart/dart_inc.h"
+#include "gazebo/physics/dart/DARTTypes.hh"
 
 namespace gazebo
 {
@@ -44,6 +52,33 @@ namespace gazebo
 
       /// \brief Pointer to DART World associated with this DART Physics.
       public: dart::simulation::WorldPtr dtWorld;
+
+      /// \brief Links whose poses are synced after each step.
+      public: std::vector<DARTLink *> syncLinks;
+
+      /// \brief For each link, whether its pose was synced by the last
+      /// step.
+      public: std::vector<char> syncMoved;
+
+      /// \brief Links whose poses were synced by the last step.
+      public: std::vector<Entity *> syncDirty;
+
+      /// \brief Entity version of the world the links were gathered at.
+      public: uint64_t syncEntityVersion = 0;
+
+      /// \brief True once the links have been gathered.
+      public: bool syncBuilt = false;
+
+      /// \brief Number of threads the poses are synced on, zero to sync
+      /// them on the physics thread.
+      public: unsigned int poseSyncThreads = 0;
+
+      /// \brief True to only add the links whose poses changed to the
+      /// dirty poses of the world.
+      public: bool poseSyncMovedOnly = false;
+
+      /// \brief Workers of the pose sync, null if poseSyncThreads is zero.
+      public: std::unique_ptr<tbb::task_arena> poseSyncArena;
     };
   }
 }
@@ -173,6 +173,26 @@ void ODECollision::SetCollideBits(unsigned int _bits)
     dGeomSetCollideBits((dGeomID)this->spaceId, _bits);
 }
 
+//////////////////////////////////////////////////
+unsigned int ODECollision::GetCategoryBits() const
+{
+  if (this->collisionId)
+    return dGeomGetCategoryBits(this->collisionId);
+  if (this->spaceId)
+    return dGeomGetCategoryBits((dGeomID)this->spaceId);
+  return GZ_ALL_COLLIDE;
+}
+
+//////////////////////////////////////////////////
+unsigned int ODECollision::GetCollideBits() const
+{
+  if (this->collisionId)
+    return dGeomGetCollideBits(this->collisionId);
+  if (this->spaceId)
+    return dGeomGetCollideBits((dGeomID)this->spaceId);
+  return GZ_ALL_COLLIDE;
+}
+
 //////////////////////////////////////////////////
 ignition::math::Box ODECollision::BoundingBox() const
 {
@@ -74,6 +74,12 @@ namespace gazebo
       // Documentation inherited.
       public: virtual void SetCollideBits(unsigned int bits);
 
+      // Documentation inherited.
+      public: virtual unsigned int GetCategoryBits() const;
+
+      // Documentation inherited.
+      public: virtual unsigned int GetCollideBits() const;
+
       // Documentation inherited.
       public: virtual ignition::math::Box BoundingBox() const;
 
@@ -269,6 +269,12 @@ double ODEJoint::GetCFM()
   return this->GetParam(dParamSuspensionCFM);
 }
 
+//////////////////////////////////////////////////
+dJointID ODEJoint::GetJointId() const
+{
+  return this->jointId;
+}
+
 //////////////////////////////////////////////////
 dJointFeedback *ODEJoint::GetFeedback()
 {
@@ -122,6 +122,10 @@ namespace gazebo
       /// \return The Constraint Force Mixing value
       public: double GetCFM();
 
+      /// \brief Get the ODE id of this joint.
+      /// \return The joint id, NULL if the joint is not created.
+      public: dJointID GetJointId() const;
+
       /// \brief Get the feedback data structure for this joint, if set
       /// \return Pointer to the joint feedback.
       public: dJointFeedback *GetFeedback();
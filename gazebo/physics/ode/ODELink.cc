@@ -133,8 +133,11 @@ void ODELink::Init()
 }
 
 //////////////////////////////////////////////////
-void ODELink::DisabledCallback(dBodyID /*_id*/)
+void ODELink::DisabledCallback(dBodyID _id)
 {
+  ODELink *self = static_cast<ODELink*>(dBodyGetData(_id));
+  self->sleeping = true;
+  self->world->_SetLinkSleeping(self, true);
 }
 
 //////////////////////////////////////////////////
@@ -161,6 +164,13 @@ void ODELink::MoveCallback(dBodyID _id)
   // Tell the world that our pose has changed.
   self->world->_AddDirty(self);
 
+  // Only enabled bodies are moved, so a disabled body was woken up.
+  if (self->sleeping)
+  {
+    self->sleeping = false;
+    self->world->_SetLinkSleeping(self, false);
+  }
+
   // self->poseMutex->unlock();
 
   // get force and applied to this body
@@ -196,6 +196,9 @@ namespace gazebo
 
       /// \brief Cache torque applied on body
       private: ignition::math::Vector3d torque;
+
+      /// \brief True if the world was told that ODE disabled the body.
+      private: bool sleeping = false;
     };
     /// \}
   }
@@ -86,6 +86,11 @@ void ODEMultiRayShape::UpdateRays()
   if (ode == nullptr)
     gzthrow("Invalid physics engine. Must use ODE.");
 
+  // Cast against the snapshot of the world when possible, which does not
+  // block the physics update.
+  if (this->CastSnapshotRays())
+    return;
+
   // Do we need to lock the physics engine here? YES!
   // especially when spawning models with sensors
   {
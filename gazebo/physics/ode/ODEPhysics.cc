@@ -55,6 +55,7 @@
 #include "gazebo/physics/ContactManager.hh"
 
 #include "gazebo/physics/ode/ODECollision.hh"
+#include "gazebo/physics/ode/ODEJoint.hh"
 #include "gazebo/physics/ode/ODELink.hh"
 #include "gazebo/physics/ode/ODEScrewJoint.hh"
 #include "gazebo/physics/ode/ODEHingeJoint.hh"
@@ -103,31 +104,141 @@ class ContactUpdate_TBB
 };
 */
 
+/////////////////////////////////////////////////
+/// \brief Generate the contacts between two collisions. This only reads
+/// from the gazebo and ODE data structures, so it is safe to call from
+/// several threads at once as long as each thread passes its own buffers.
+/// \param[in] _collision1 First collision object.
+/// \param[in] _collision2 Second collision object.
+/// \param[in] _maxContacts Global maximum number of contacts per pair.
+/// \param[out] _contactCollisions Contacts returned by dCollide.
+/// \param[out] _indices Indices of the contacts to keep.
+/// \return Number of contacts to keep.
+static unsigned int CollideShapes(ODECollision *_collision1,
+    ODECollision *_collision2, unsigned int _maxContacts,
+    dContactGeom *_contactCollisions, int *_indices)
+{
+  // Filter collisions based on collide bitmask.
+  if ((_collision1->GetSurface()->collideBitmask &
+        _collision2->GetSurface()->collideBitmask) == 0)
+    return 0;
+
+  // Filter collisions based on contact bitmask if collide_without_contact is
+  // on.The bitmask is set mainly for speed improvements otherwise a collision
+  // with collide_without_contact may potentially generate a large number of
+  // contacts.
+  if (_collision1->GetSurface()->collideWithoutContact ||
+      _collision2->GetSurface()->collideWithoutContact)
+  {
+    if ((_collision1->GetSurface()->collideWithoutContactBitmask &
+         _collision2->GetSurface()->collideWithoutContactBitmask) == 0)
+    {
+      return 0;
+    }
+  }
+
+  unsigned int numc = 0;
+
+  // maxCollide must less than the size of _indices
+  // Check the header
+  unsigned int maxCollide = MAX_CONTACT_JOINTS;
+
+  // max_contacts specified globally
+  if (_maxContacts > 0 && _maxContacts < MAX_CONTACT_JOINTS)
+    maxCollide = _maxContacts;
+
+  // over-ride with minimum of max_contacts from both collisions
+  if (_collision1->GetMaxContacts() < maxCollide)
+    maxCollide = _collision1->GetMaxContacts();
+
+  if (_collision2->GetMaxContacts() < maxCollide)
+    maxCollide = _collision2->GetMaxContacts();
+
+  // Generate the contacts
+  numc = dCollide(_collision1->GetCollisionId(), _collision2->GetCollisionId(),
+      MAX_COLLIDE_RETURNS, _contactCollisions, sizeof(_contactCollisions[0]));
+
+  // Return if no contacts.
+  if (numc == 0)
+    return 0;
+
+  // Store the indices of the contacts.
+  for (int i = 0; i < MAX_CONTACT_JOINTS; i++)
+    _indices[i] = i;
+
+  // Choose only the best contacts if too many were generated.
+  if (maxCollide > 0 && numc > maxCollide)
+  {
+    double max = _contactCollisions[maxCollide-1].depth;
+    for (unsigned int i = maxCollide; i < numc; ++i)
+    {
+      if (_contactCollisions[i].depth > max)
+      {
+        max = _contactCollisions[i].depth;
+        _indices[maxCollide-1] = i;
+      }
+    }
+
+    // Make sure numc has the valid number of contacts.
+    numc = maxCollide;
+  }
+
+  return numc;
+}
+
+/////////////////////////////////////////////////
+/// \brief Narrowphase job for the parallel collision mode. Each pair
+/// writes its contacts into the buffer of the thread that processed it,
+/// and records where they are in ODEPhysicsPrivate::narrowphaseResults.
 class Colliders_TBB
 {
-  public: Colliders_TBB(
-              std::vector<std::pair<ODECollision*, ODECollision*> > *_colliders,
-              ODEPhysics *_engine,
-              dContactGeom* _contactCollisions) :
-    colliders(_colliders),
-              engine(_engine), contactCollisions(_contactCollisions)
+  public: Colliders_TBB(ODEPhysicsPrivate *_dataPtr,
+              unsigned int _maxContacts)
+    : dataPtr(_dataPtr), maxContacts(_maxContacts)
   {
-    // dAllocateODEDataForThread(dAllocateMaskAll);
   }
 
   public: void operator() (const tbb::blocked_range<size_t> &_r) const
   {
+    // OPCODE and GIMPACT keep their collider caches in ODE's thread local
+    // storage, so every worker must allocate its own. This is a no-op on
+    // threads that already did.
+    dAllocateODEDataForThread(dAllocateMaskAll);
+
+    ODENarrowphaseBuffer &buffer = this->dataPtr->narrowphaseBuffers.local();
+    const size_t collidersCount = this->dataPtr->collidersCount;
+
     for (size_t i = _r.begin(); i != _r.end(); i++)
     {
-      ODECollision *collision1 = (*this->colliders)[i].first;
-      ODECollision *collision2 = (*this->colliders)[i].second;
-      this->engine->Collide(collision1, collision2, contactCollisions);
+      const std::pair<ODECollision*, ODECollision*> &pair =
+        i < collidersCount ? this->dataPtr->colliders[i] :
+        this->dataPtr->trimeshColliders[i - collidersCount];
+
+      ODENarrowphaseResult &result = this->dataPtr->narrowphaseResults[i];
+      result.buffer = &buffer;
+      result.offset = buffer.contacts.size();
+      result.count = 0;
+
+      // Heightfields reuse scratch buffers stored in the geom itself.
+      result.deferred = pair.first->HasType(Base::HEIGHTMAP_SHAPE) ||
+        pair.second->HasType(Base::HEIGHTMAP_SHAPE);
+      if (result.deferred)
+        continue;
+
+      unsigned int numc = CollideShapes(pair.first, pair.second,
+          this->maxContacts, buffer.contactCollisions, buffer.indices);
+
+      for (unsigned int j = 0; j < numc; ++j)
+      {
+        buffer.contacts.push_back(
+            buffer.contactCollisions[buffer.indices[j]]);
+      }
+      result.count = numc;
     }
   }
 
-  private: std::vector< std::pair<ODECollision*, ODECollision*> > *colliders;
-  private: ODEPhysics *engine;
-  private: dContactGeom* contactCollisions;
+  private: ODEPhysicsPrivate *dataPtr;
+  private: unsigned int maxContacts;
 };
 
 //////////////////////////////////////////////////
@@ -156,6 +267,9 @@ ODEPhysics::ODEPhysics(WorldPtr _world)
 
   this->dataPtr->colliders.resize(100);
 
+  for (int i = 0; i < MAX_CONTACT_JOINTS; ++i)
+    this->dataPtr->identityIndices[i] = i;
+
   // Set random seed for physics engine based on gazebo's random seed.
   // Note: this was moved from physics::PhysicsEngine constructor.
   this->SetSeed(ignition::math::Rand::Seed());
@@ -235,6 +349,18 @@ void ODEPhysics::Load(sdf::ElementPtr _sdf)
     this->GetSORPGSIters());
   dWorldSetQuickStepW(this->dataPtr->worldId, this->GetSORPGSW());
 
+  if (solverElem->HasElement("island_threads"))
+  {
+    this->SetParam("island_threads",
+        solverElem->Get<int>("island_threads"));
+  }
+
+  if (solverElem->HasElement("narrowphase_threads"))
+  {
+    this->SetNarrowphaseThreads(
+        solverElem->Get<int>("narrowphase_threads"));
+  }
+
   // Set the physics update function
   this->SetStepType(this->dataPtr->stepType);
   if (this->dataPtr->physicsStepFunc == nullptr)
@@ -381,23 +507,31 @@ void ODEPhysics::UpdateCollision()
   dSpaceCollide(this->dataPtr->spaceId, this, CollisionCallback);
   DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "dSpaceCollide");
 
-  // Generate non-trimesh collisions.
-  for (i = 0; i < this->dataPtr->collidersCount; ++i)
+  if (this->dataPtr->narrowphaseArena)
   {
-    this->Collide(this->dataPtr->colliders[i].first,
-        this->dataPtr->colliders[i].second, this->dataPtr->contactCollisions);
+    this->ParallelCollide();
+    DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "collideParallel");
   }
-  DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "collideShapes");
-
-  // Generate trimesh collision.
-  // This must happen in this thread sequentially
-  for (i = 0; i < this->dataPtr->trimeshCollidersCount; ++i)
+  else
   {
-    ODECollision *collision1 = this->dataPtr->trimeshColliders[i].first;
-    ODECollision *collision2 = this->dataPtr->trimeshColliders[i].second;
-    this->Collide(collision1, collision2, this->dataPtr->contactCollisions);
+    // Generate non-trimesh collisions.
+    for (i = 0; i < this->dataPtr->collidersCount; ++i)
+    {
+      this->Collide(this->dataPtr->colliders[i].first,
+          this->dataPtr->colliders[i].second,
+          this->dataPtr->contactCollisions);
+    }
+    DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "collideShapes");
+
+    // Generate trimesh collision.
+    for (i = 0; i < this->dataPtr->trimeshCollidersCount; ++i)
+    {
+      ODECollision *collision1 = this->dataPtr->trimeshColliders[i].first;
+      ODECollision *collision2 = this->dataPtr->trimeshColliders[i].second;
+      this->Collide(collision1, collision2, this->dataPtr->contactCollisions);
+    }
+    DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "collideTrimeshes");
   }
-  DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "collideTrimeshes");
 
   DIAG_TIMER_STOP("ODEPhysics::UpdateCollision");
 }
@@ -454,6 +588,8 @@ void ODEPhysics::UpdatePhysics()
 //////////////////////////////////////////////////
 void ODEPhysics::Fini()
 {
+  this->dataPtr->narrowphaseArena.reset();
+
   dCloseODE();
 
   dJointGroupDestroy(this->dataPtr->contactGroup);
@@ -1003,83 +1139,67 @@ void ODEPhysics::CollisionCallback(void *_data, dGeomID _o1, dGeomID _o2)
 void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
                          dContactGeom *_contactCollisions)
 {
-  // Filter collisions based on collide bitmask.
-  if ((_collision1->GetSurface()->collideBitmask &
-        _collision2->GetSurface()->collideBitmask) == 0)
-    return;
-
-  // Filter collisions based on contact bitmask if collide_without_contact is
-  // on.The bitmask is set mainly for speed improvements otherwise a collision
-  // with collide_without_contact may potentially generate a large number of
-  // contacts.
-  if (_collision1->GetSurface()->collideWithoutContact ||
-      _collision2->GetSurface()->collideWithoutContact)
-  {
-    if ((_collision1->GetSurface()->collideWithoutContactBitmask &
-         _collision2->GetSurface()->collideWithoutContactBitmask) == 0)
-    {
-      return;
-    }
-  }
-
-  /*
-  if (_collision1->GetCollisionId() && _collision2->GetCollisionId())
-  {
-    const dVector3 *pos1 =
-      (const dVector3*)dGeomGetPosition(_collision1->GetCollisionId());
-    const dVector3 *pos2 =
-      (const dVector3*)dGeomGetPosition(_collision2->GetCollisionId());
-    std::cout << "1[" << (*pos1)[0]<< " " << (*pos1)[1] << " "
-              << (*pos1)[2] << "] "
-      << "2[" << (*pos2)[0]<< " " << (*pos2)[1] << " " << (*pos2)[2] << "]\n";
-  }*/
-
-  unsigned int numc = 0;
-  dContact contact;
-
-  // maxCollide must less than the size of this->dataPtr->indices
-  // Check the header
-  unsigned int maxCollide = MAX_CONTACT_JOINTS;
+  unsigned int numc = CollideShapes(_collision1, _collision2,
+      this->GetMaxContacts(), _contactCollisions, this->dataPtr->indices);
 
-  // max_contacts specified globally
-  if (this->GetMaxContacts() > 0 && this->GetMaxContacts() < MAX_CONTACT_JOINTS)
-    maxCollide = this->GetMaxContacts();
+  // Return if no contacts.
+  if (numc == 0)
+    return;
 
-  // over-ride with minimum of max_contacts from both collisions
-  if (_collision1->GetMaxContacts() < maxCollide)
-    maxCollide = _collision1->GetMaxContacts();
+  this->AddContactJoints(_collision1, _collision2, _contactCollisions,
+      this->dataPtr->indices, numc);
+}
 
-  if (_collision2->GetMaxContacts() < maxCollide)
-    maxCollide = _collision2->GetMaxContacts();
+//////////////////////////////////////////////////
+void ODEPhysics::ParallelCollide()
+{
+  const size_t pairCount = this->dataPtr->collidersCount +
+    this->dataPtr->trimeshCollidersCount;
+  if (pairCount == 0)
+    return;
 
-  // Generate the contacts
-  numc = dCollide(_collision1->GetCollisionId(), _collision2->GetCollisionId(),
-      MAX_COLLIDE_RETURNS, _contactCollisions, sizeof(_contactCollisions[0]));
+  if (this->dataPtr->narrowphaseResults.size() < pairCount)
+    this->dataPtr->narrowphaseResults.resize(pairCount);
 
-  // Return if no contacts.
-  if (numc == 0)
-    return;
+  for (auto &buffer : this->dataPtr->narrowphaseBuffers)
+    buffer.contacts.clear();
 
-  // Store the indices of the contacts.
-  for (int i = 0; i < MAX_CONTACT_JOINTS; i++)
-    this->dataPtr->indices[i] = i;
+  Colliders_TBB colliders(this->dataPtr, this->GetMaxContacts());
+  this->dataPtr->narrowphaseArena->execute([&colliders, pairCount]()
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, pairCount, 16),
+        colliders);
+  });
 
-  // Choose only the best contacts if too many were generated.
-  if (maxCollide > 0 && numc > maxCollide)
+  // Merge the results in collider order. Contact joints, joint feedbacks
+  // and the contact manager are only touched from this thread.
+  for (size_t i = 0; i < pairCount; ++i)
   {
-    double max = _contactCollisions[maxCollide-1].depth;
-    for (unsigned int i = maxCollide; i < numc; ++i)
+    const std::pair<ODECollision*, ODECollision*> &pair =
+      i < this->dataPtr->collidersCount ? this->dataPtr->colliders[i] :
+      this->dataPtr->trimeshColliders[i - this->dataPtr->collidersCount];
+    const ODENarrowphaseResult &result = this->dataPtr->narrowphaseResults[i];
+
+    if (result.deferred)
     {
-      if (_contactCollisions[i].depth > max)
-      {
-        max = _contactCollisions[i].depth;
-        this->dataPtr->indices[maxCollide-1] = i;
-      }
+      this->Collide(pair.first, pair.second,
+          this->dataPtr->contactCollisions);
+    }
+    else if (result.count > 0)
+    {
+      this->AddContactJoints(pair.first, pair.second,
+          &result.buffer->contacts[result.offset],
+          this->dataPtr->identityIndices, result.count);
     }
-
-    // Make sure numc has the valid number of contacts.
-    numc = maxCollide;
   }
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::AddContactJoints(ODECollision *_collision1,
+    ODECollision *_collision2, const dContactGeom *_contactCollisions,
+    const int *_indices, unsigned int _numc)
+{
+  dContact contact;
 
   // Set the contact surface parameter flags.
   contact.surface.mode = dContactBounce |
@@ -1270,9 +1390,9 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
   }
 
   // Create a joint for each contact
-  for (unsigned int j = 0; j < numc; ++j)
+  for (unsigned int j = 0; j < _numc; ++j)
   {
-    contact.geom = _contactCollisions[this->dataPtr->indices[j]];
+    contact.geom = _contactCollisions[_indices[j]];
 
     // Create the contact joint. This introduces the contact constraint to
     // ODE
@@ -1284,19 +1404,19 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
     {
       // Store the contact depth
       contactFeedback->depths[j] =
-        _contactCollisions[this->dataPtr->indices[j]].depth;
+        _contactCollisions[_indices[j]].depth;
 
       // Store the contact position
       contactFeedback->positions[j].Set(
-          _contactCollisions[this->dataPtr->indices[j]].pos[0],
-          _contactCollisions[this->dataPtr->indices[j]].pos[1],
-          _contactCollisions[this->dataPtr->indices[j]].pos[2]);
+          _contactCollisions[_indices[j]].pos[0],
+          _contactCollisions[_indices[j]].pos[1],
+          _contactCollisions[_indices[j]].pos[2]);
 
       // Store the contact normal
       contactFeedback->normals[j].Set(
-          _contactCollisions[this->dataPtr->indices[j]].normal[0],
-          _contactCollisions[this->dataPtr->indices[j]].normal[1],
-          _contactCollisions[this->dataPtr->indices[j]].normal[2]);
+          _contactCollisions[_indices[j]].normal[0],
+          _contactCollisions[_indices[j]].normal[1],
+          _contactCollisions[_indices[j]].normal[2]);
 
       // Set the joint feedback.
       dJointSetFeedback(contactJoint, &(jointFeedback->feedbacks[j]));
@@ -1393,6 +1513,118 @@ void ODEPhysics::DebugPrint() const
   }
 }
 
+/////////////////////////////////////////////////
+/// \brief Collect the links and joints of models and of their nested
+/// models, depth first.
+/// \param[in] _models The models.
+/// \param[out] _links The links.
+/// \param[out] _joints The joints.
+static void CollectLinksAndJoints(const Model_V &_models,
+    std::vector<ODELink *> &_links, std::vector<ODEJoint *> &_joints)
+{
+  for (auto const &model : _models)
+  {
+    for (auto const &link : model->GetLinks())
+      _links.push_back(static_cast<ODELink *>(link.get()));
+    for (auto const &joint : model->GetJoints())
+      _joints.push_back(static_cast<ODEJoint *>(joint.get()));
+    CollectLinksAndJoints(model->NestedModels(), _links, _joints);
+  }
+}
+
+/////////////////////////////////////////////////
+void ODEPhysics::SaveInternalState(std::vector<double> &_state) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  std::vector<ODELink *> links;
+  std::vector<ODEJoint *> joints;
+  CollectLinksAndJoints(this->world->Models(), links, joints);
+
+  // Link count, joint count, 3 values per link, and 12 values per joint.
+  _state.clear();
+  _state.reserve(2 + links.size() * 3 + joints.size() * 12);
+  _state.push_back(static_cast<double>(links.size()));
+  _state.push_back(static_cast<double>(joints.size()));
+
+  // Whether the body is enabled, and how long it still has to stay idle
+  // before it is disabled.
+  for (auto const link : links)
+  {
+    dBodyID body = link->GetODEId();
+    dReal timeLeft = 0;
+    int stepsLeft = 0;
+    if (body)
+      dBodyGetAutoDisableLeft(body, &timeLeft, &stepsLeft);
+    _state.push_back(body && dBodyIsEnabled(body) ? 1.0 : 0.0);
+    _state.push_back(timeLeft);
+    _state.push_back(static_cast<double>(stepsLeft));
+  }
+
+  dReal lambda[12];
+  for (auto const joint : joints)
+  {
+    if (joint->GetJointId())
+      dJointGetLambda(joint->GetJointId(), lambda, lambda + 6);
+    else
+      dSetZero(lambda, 12);
+    _state.insert(_state.end(), lambda, lambda + 12);
+  }
+}
+
+/////////////////////////////////////////////////
+bool ODEPhysics::RestoreInternalState(const std::vector<double> &_state)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  std::vector<ODELink *> links;
+  std::vector<ODEJoint *> joints;
+  CollectLinksAndJoints(this->world->Models(), links, joints);
+
+  if (_state.size() != 2 + links.size() * 3 + joints.size() * 12 ||
+      static_cast<size_t>(_state[0]) != links.size() ||
+      static_cast<size_t>(_state[1]) != joints.size())
+  {
+    return false;
+  }
+
+  const double *value = _state.data() + 2;
+  for (auto const link : links)
+  {
+    dBodyID body = link->GetODEId();
+    if (body)
+    {
+      // Enabling resets the idle counters, so set them afterwards.
+      if (value[0] != 0.0)
+        dBodyEnable(body);
+      else
+        dBodyDisable(body);
+      dBodySetAutoDisableLeft(body, value[1], static_cast<int>(value[2]));
+    }
+    value += 3;
+  }
+
+  dReal lambda[12];
+  for (auto const joint : joints)
+  {
+    if (joint->GetJointId())
+    {
+      std::copy(value, value + 12, lambda);
+      dJointSetLambda(joint->GetJointId(), lambda, lambda + 6);
+    }
+    value += 12;
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool ODEPhysics::SetNarrowphaseThreads(int _threads)
+{
+  return this->SetWorkerThreads(_threads, "narrowphase threads",
+      this->dataPtr->narrowphaseThreads, this->dataPtr->narrowphaseArena);
+}
+
 /////////////////////////////////////////////////
 void ODEPhysics::SetSeed(uint32_t _seed)
 {
@@ -1523,6 +1755,30 @@ bool ODEPhysics::SetParam(const std::string &_key, const boost::any &_value)
       dWorldSetQuickStepExtraFrictionIterations(this->dataPtr->worldId,
         boost::any_cast<int>(_value));
     }
+    else if (_key == "island_threads")
+    {
+      int value = boost::any_cast<int>(_value);
+      if (value < 0)
+      {
+        gzerr << "Invalid number of island threads[" << value
+              << "], must be zero or positive\n";
+        return false;
+      }
+
+      // Don't replace the island thread pool while a step is running.
+      boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+      if (odeElem->GetElement("solver")->HasElement("island_threads"))
+      {
+        odeElem->GetElement("solver")->GetElement("island_threads")->Set(
+            value);
+      }
+      dWorldSetIslandThreads(this->dataPtr->worldId, value);
+      this->dataPtr->islandThreads = value;
+    }
+    else if (_key == "narrowphase_threads")
+    {
+      return this->SetNarrowphaseThreads(boost::any_cast<int>(_value));
+    }
     else if (_key == "ode_quiet")
     {
       bool odeQuiet = boost::any_cast<bool>(_value);
@@ -1624,6 +1880,10 @@ bool ODEPhysics::GetParam(const std::string &_key, boost::any &_value) const
     _value = this->GetFrictionModel();
   else if (_key == "ode_quiet")
     _value = dGetMessageHandler() != 0;
+  else if (_key == "island_threads")
+    _value = this->dataPtr->islandThreads;
+  else if (_key == "narrowphase_threads")
+    _value = static_cast<int>(this->dataPtr->narrowphaseThreads);
   else if (_key == "world_step_solver")
     _value = this->GetWorldStepSolverType();
   else
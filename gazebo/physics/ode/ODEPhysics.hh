@@ -21,6 +21,7 @@
 #include <tbb/concurrent_vector.h>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <boost/thread/thread.hpp>
 
@@ -210,6 +211,20 @@ namespace gazebo
       // Documentation inherited
       public: virtual void DebugPrint() const;
 
+      /// \brief Save the enabled flag and the auto-disable idle counters of
+      /// each body, and the constraint forces each joint warm starts from on
+      /// the next step. The velocity samples ODE averages for auto-disable
+      /// are not saved. With the default of one sample they are replaced
+      /// before they are used, otherwise sleeping may diverge after a
+      /// restore.
+      /// \param[out] _state The state.
+      public: virtual void SaveInternalState(std::vector<double> &_state)
+              const;
+
+      // Documentation inherited
+      public: virtual bool RestoreInternalState(
+                  const std::vector<double> &_state);
+
       // Documentation inherited
       public: virtual void SetSeed(uint32_t _seed);
 
@@ -315,6 +330,32 @@ namespace gazebo
       private: void AddCollider(ODECollision *_collision1,
                                 ODECollision *_collision2);
 
+      /// \brief Create the ODE contact joints for contacts generated by
+      /// the narrowphase, and fill in contact feedback if requested.
+      /// \param[in] _collision1 First collision object.
+      /// \param[in] _collision2 Second collision object.
+      /// \param[in] _contactCollisions Contacts generated for the pair.
+      /// \param[in] _indices Indices into _contactCollisions of the
+      /// contacts to use.
+      /// \param[in] _numc Number of entries in _indices.
+      private: void AddContactJoints(ODECollision *_collision1,
+                                     ODECollision *_collision2,
+                                     const dContactGeom *_contactCollisions,
+                                     const int *_indices,
+                                     unsigned int _numc);
+
+      /// \brief Run the narrowphase for all the colliders found by
+      /// dSpaceCollide on the narrowphase worker pool, then create the
+      /// contact joints on the calling thread in collider order, so the
+      /// result does not depend on the number of threads.
+      private: void ParallelCollide();
+
+      /// \brief Set the number of narrowphase worker threads.
+      /// \param[in] _threads Number of threads, zero to disable the
+      /// parallel narrowphase.
+      /// \return False if the number of threads is negative.
+      private: bool SetNarrowphaseThreads(int _threads);
+
       /// \internal
       /// \brief Private data pointer.
       private: ODEPhysicsPrivate *dataPtr;
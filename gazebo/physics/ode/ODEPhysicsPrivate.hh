@@ -18,7 +18,11 @@
 #ifndef _ODEPHYSICS_PRIVATE_HH_
 #define _ODEPHYSICS_PRIVATE_HH_
 
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/task_arena.h>
+
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include <utility>
@@ -45,6 +49,38 @@ namespace gazebo
       public: dJointFeedback feedbacks[MAX_CONTACT_JOINTS];
     };
 
+    /// \brief Per-thread scratch space used by the parallel narrowphase.
+    class ODENarrowphaseBuffer
+    {
+      /// \brief Raw output of dCollide for the pair being processed.
+      public: dContactGeom contactCollisions[MAX_COLLIDE_RETURNS];
+
+      /// \brief Indices of the contacts kept from contactCollisions.
+      public: int indices[MAX_CONTACT_JOINTS];
+
+      /// \brief Contacts kept for every pair processed by this thread
+      /// during the current step, stored back to back.
+      public: std::vector<dContactGeom> contacts;
+    };
+
+    /// \brief Narrowphase output for a single collider pair.
+    class ODENarrowphaseResult
+    {
+      /// \brief Buffer holding the contacts of this pair.
+      public: ODENarrowphaseBuffer *buffer = nullptr;
+
+      /// \brief Index of the first contact in buffer->contacts.
+      public: size_t offset = 0;
+
+      /// \brief Number of contacts generated for this pair.
+      public: unsigned int count = 0;
+
+      /// \brief True if the pair must be collided on the physics thread
+      /// during the merge, because one of its geoms keeps mutable
+      /// per-geom scratch data (e.g. heightfields).
+      public: bool deferred = false;
+    };
+
     class ODEPhysicsPrivate
     {
       /// \brief Top-level world for all bodies
@@ -92,6 +128,30 @@ namespace gazebo
 
       /// \brief Maximum number of contact points per collision pair.
       public: unsigned int maxContacts;
+
+      /// \brief Number of threads used to step islands in parallel. Zero
+      /// means islands are stepped serially on the physics thread.
+      public: int islandThreads = 0;
+
+      /// \brief Number of worker threads used by the narrowphase. Zero
+      /// means the narrowphase runs serially on the physics thread.
+      public: unsigned int narrowphaseThreads = 0;
+
+      /// \brief Worker pool used by the parallel narrowphase, null when
+      /// narrowphaseThreads is zero.
+      public: std::unique_ptr<tbb::task_arena> narrowphaseArena;
+
+      /// \brief Per-thread contact buffers for the parallel narrowphase.
+      public: tbb::enumerable_thread_specific<ODENarrowphaseBuffer>
+              narrowphaseBuffers;
+
+      /// \brief Narrowphase results, indexed by collider pair. Normal
+      /// colliders come first, followed by the triangle mesh colliders.
+      public: std::vector<ODENarrowphaseResult> narrowphaseResults;
+
+      /// \brief Identity mapping used when adding contacts that were
+      /// already filtered by the parallel narrowphase.
+      public: int identityIndices[MAX_CONTACT_JOINTS];
     };
   }
 }
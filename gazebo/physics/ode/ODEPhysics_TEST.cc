@@ -17,6 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <map>
+#include <string>
+
 #include "gazebo/physics/physics.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/ode/ODEPhysics.hh"
@@ -463,6 +466,95 @@ TEST_F(ODEPhysics_TEST, PhysicsMsgParam)
   PhysicsMsgParam();
 }
 
+/////////////////////////////////////////////////
+/// Test that the parallel narrowphase produces the same motion as the
+/// serial one.
+TEST_F(ODEPhysics_TEST, NarrowphaseThreads)
+{
+  Load("worlds/shapes.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  ODEPhysicsPtr odePhysics =
+      boost::dynamic_pointer_cast<ODEPhysics>(world->Physics());
+  ASSERT_TRUE(odePhysics != nullptr);
+
+  // Serial by default
+  EXPECT_EQ(boost::any_cast<int>(odePhysics->GetParam("narrowphase_threads")),
+      0);
+  EXPECT_FALSE(odePhysics->SetParam("narrowphase_threads", 2.0));
+  EXPECT_FALSE(odePhysics->SetParam("narrowphase_threads", -1));
+  EXPECT_EQ(boost::any_cast<int>(odePhysics->GetParam("narrowphase_threads")),
+      0);
+
+  const unsigned int steps = 500;
+
+  // Run serially from the reset state
+  world->Reset();
+  world->Step(steps);
+  std::map<std::string, ignition::math::Pose3d> serialPoses;
+  for (auto const &model : world->Models())
+    serialPoses[model->GetName()] = model->WorldPose();
+  int serialContacts =
+      boost::any_cast<int>(odePhysics->GetParam("num_contacts"));
+  EXPECT_GT(serialContacts, 0);
+
+  // Run again in parallel from the same state
+  EXPECT_TRUE(odePhysics->SetParam("narrowphase_threads", 4));
+  EXPECT_EQ(boost::any_cast<int>(odePhysics->GetParam("narrowphase_threads")),
+      4);
+  world->Reset();
+  world->Step(steps);
+  for (auto const &model : world->Models())
+    EXPECT_EQ(model->WorldPose(), serialPoses[model->GetName()]);
+  EXPECT_EQ(boost::any_cast<int>(odePhysics->GetParam("num_contacts")),
+      serialContacts);
+
+  EXPECT_TRUE(odePhysics->SetParam("narrowphase_threads", 0));
+}
+
+/////////////////////////////////////////////////
+/// Test that stepping islands in parallel is reproducible and produces the
+/// same motion as the serial step.
+TEST_F(ODEPhysics_TEST, IslandThreads)
+{
+  Load("worlds/shapes.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  ODEPhysicsPtr odePhysics =
+      boost::dynamic_pointer_cast<ODEPhysics>(world->Physics());
+  ASSERT_TRUE(odePhysics != nullptr);
+
+  EXPECT_EQ(boost::any_cast<int>(odePhysics->GetParam("island_threads")), 0);
+  EXPECT_FALSE(odePhysics->SetParam("island_threads", -1));
+
+  const unsigned int steps = 500;
+
+  // Push the shapes so that each island has something to solve.
+  auto run = [&](const int _threads)
+      -> std::map<std::string, ignition::math::Pose3d>
+  {
+    EXPECT_TRUE(odePhysics->SetParam("island_threads", _threads));
+    world->Reset();
+    for (auto const &model : world->Models())
+      model->SetLinearVel(ignition::math::Vector3d(0.5, 0.2, 0));
+    world->Step(steps);
+
+    std::map<std::string, ignition::math::Pose3d> poses;
+    for (auto const &model : world->Models())
+      poses[model->GetName()] = model->WorldPose();
+    return poses;
+  };
+
+  auto serialPoses = run(0);
+  EXPECT_EQ(run(4), serialPoses);
+  EXPECT_EQ(run(2), serialPoses);
+  EXPECT_EQ(run(4), serialPoses);
+
+  EXPECT_TRUE(odePhysics->SetParam("island_threads", 0));
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
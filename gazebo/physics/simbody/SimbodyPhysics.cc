@@ -16,6 +16,10 @@
 */
 
 #include <string>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
 #include "gazebo/physics/simbody/SimbodyTypes.hh"
 #include "gazebo/physics/simbody/SimbodyModel.hh"
@@ -67,6 +71,80 @@ using namespace SimTK;
 
 GZ_REGISTER_PHYSICS_ENGINE("simbody", SimbodyPhysics)
 
+//////////////////////////////////////////////////
+/// \brief Set the dirty pose of a link from a state.
+/// \param[in] _link The link.
+/// \param[in] _state State the pose is read from.
+/// \param[in] _movedOnly True to leave the link alone if its pose did not
+/// change.
+/// \return True if the dirty pose of the link was set.
+static bool SyncLinkPose(SimbodyLink *_link, const SimTK::State &_state,
+    const bool _movedOnly)
+{
+  const ignition::math::Pose3d pose = SimbodyPhysics::Transform2PoseIgn(
+      _link->masterMobod.getBodyTransform(_state));
+
+  // Pose3d::operator== has a tolerance, the components are compared
+  // exactly so that small motions are not lost.
+  if (_movedOnly)
+  {
+    const ignition::math::Pose3d &current = _link->WorldPose();
+    if (pose.Pos().X() == current.Pos().X() &&
+        pose.Pos().Y() == current.Pos().Y() &&
+        pose.Pos().Z() == current.Pos().Z() &&
+        pose.Rot().W() == current.Rot().W() &&
+        pose.Rot().X() == current.Rot().X() &&
+        pose.Rot().Y() == current.Rot().Y() &&
+        pose.Rot().Z() == current.Rot().Z())
+    {
+      return false;
+    }
+  }
+
+  _link->SetDirtyPose(pose);
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Sync the poses of links on multiple threads.
+class SyncLinkPoses_TBB
+{
+  /// \brief Constructor.
+  /// \param[in] _links Links to sync.
+  /// \param[in] _state State the poses are read from.
+  /// \param[in] _movedOnly True to leave the links that did not move alone.
+  /// \param[out] _moved For each link, whether its dirty pose was set.
+  public: SyncLinkPoses_TBB(const std::vector<SimbodyLink *> &_links,
+              const SimTK::State &_state, const bool _movedOnly,
+              std::vector<char> &_moved)
+          : links(_links), state(_state), movedOnly(_movedOnly), moved(_moved)
+  {
+  }
+
+  /// \brief Sync the poses of a range of links.
+  /// \param[in] _r Range of links.
+  public: void operator() (const tbb::blocked_range<size_t> &_r) const
+  {
+    for (size_t i = _r.begin(); i != _r.end(); ++i)
+    {
+      this->moved[i] =
+        SyncLinkPose(this->links[i], this->state, this->movedOnly);
+    }
+  }
+
+  /// \brief Links to sync.
+  private: const std::vector<SimbodyLink *> &links;
+
+  /// \brief State the poses are read from.
+  private: const SimTK::State &state;
+
+  /// \brief True to leave the links that did not move alone.
+  private: const bool movedOnly;
+
+  /// \brief For each link, whether its dirty pose was set.
+  private: std::vector<char> &moved;
+};
+
 //////////////////////////////////////////////////
 SimbodyPhysics::SimbodyPhysics(WorldPtr _world)
     : PhysicsEngine(_world), system(), matter(system), forces(system),
@@ -675,36 +753,91 @@ void SimbodyPhysics::UpdatePhysics()
   // this->lastUpdateTime = currTime;
 
   // pushing new entity pose into dirtyPoses for visualization
-  physics::Model_V models = this->world->Models();
-  for (physics::Model_V::iterator mi = models.begin();
-       mi != models.end(); ++mi)
+  if (!this->syncBuilt ||
+      this->syncEntityVersion != this->world->_EntityVersion())
   {
-    physics::Link_V links = (*mi)->GetLinks();
-    for (physics::Link_V::iterator lx = links.begin();
-         lx != links.end(); ++lx)
+    this->RebuildPoseSync();
+  }
+  this->SyncLinkPoses(s);
+
+  for (auto const &simbodyJoint : this->syncJoints)
+    simbodyJoint->CacheForceTorque();
+
+  // FIXME:  this needs to happen before forces are applied for the next step
+  // FIXME:  but after we've gotten everything from current state
+  this->discreteForces.clearAllForces(this->integ->updAdvancedState());
+}
+
+//////////////////////////////////////////////////
+void SimbodyPhysics::RebuildPoseSync()
+{
+  this->syncLinks.clear();
+  this->syncJoints.clear();
+
+  for (auto const &model : this->world->Models())
+  {
+    for (auto const &link : model->GetLinks())
     {
-      physics::SimbodyLinkPtr simbodyLink =
-        boost::dynamic_pointer_cast<physics::SimbodyLink>(*lx);
-      auto pose = SimbodyPhysics::Transform2PoseIgn(
-        simbodyLink->masterMobod.getBodyTransform(s));
-      simbodyLink->SetDirtyPose(pose);
-      this->world->dataPtr->dirtyPoses.push_back(
-        boost::static_pointer_cast<Entity>(*lx).get());
+      SimbodyLinkPtr simbodyLink =
+        boost::dynamic_pointer_cast<SimbodyLink>(link);
+      if (simbodyLink)
+        this->syncLinks.push_back(simbodyLink.get());
     }
 
-    physics::Joint_V joints = (*mi)->GetJoints();
-    for (physics::Joint_V::iterator jx = joints.begin();
-         jx != joints.end(); ++jx)
+    for (auto const &joint : model->GetJoints())
     {
       SimbodyJointPtr simbodyJoint =
-        boost::dynamic_pointer_cast<physics::SimbodyJoint>(*jx);
-      simbodyJoint->CacheForceTorque();
+        boost::dynamic_pointer_cast<SimbodyJoint>(joint);
+      if (simbodyJoint)
+        this->syncJoints.push_back(simbodyJoint.get());
     }
   }
 
-  // FIXME:  this needs to happen before forces are applied for the next step
-  // FIXME:  but after we've gotten everything from current state
-  this->discreteForces.clearAllForces(this->integ->updAdvancedState());
+  this->syncMoved.assign(this->syncLinks.size(), 0);
+  this->syncDirty.reserve(this->syncLinks.size());
+  this->syncEntityVersion = this->world->_EntityVersion();
+  this->syncBuilt = true;
+}
+
+//////////////////////////////////////////////////
+void SimbodyPhysics::SyncLinkPoses(const SimTK::State &_state)
+{
+  // Below this, the threads cost more than they save.
+  const size_t minParallelLinks = 64;
+
+  if (this->poseSyncArena && this->syncLinks.size() >= minParallelLinks)
+  {
+    SyncLinkPoses_TBB sync(this->syncLinks, _state, this->poseSyncMovedOnly,
+        this->syncMoved);
+    this->poseSyncArena->execute([&]
+    {
+      tbb::parallel_for(
+          tbb::blocked_range<size_t>(0, this->syncLinks.size()), sync);
+    });
+  }
+  else
+  {
+    for (size_t i = 0; i < this->syncLinks.size(); ++i)
+    {
+      this->syncMoved[i] =
+        SyncLinkPose(this->syncLinks[i], _state, this->poseSyncMovedOnly);
+    }
+  }
+
+  this->syncDirty.clear();
+  for (size_t i = 0; i < this->syncLinks.size(); ++i)
+  {
+    if (this->syncMoved[i])
+      this->syncDirty.push_back(this->syncLinks[i]);
+  }
+  this->world->_AddDirty(this->syncDirty);
+}
+
+//////////////////////////////////////////////////
+bool SimbodyPhysics::SetPoseSyncThreads(int _threads)
+{
+  return this->SetWorkerThreads(_threads, "pose sync threads",
+      this->poseSyncThreads, this->poseSyncArena);
 }
 
 //////////////////////////////////////////////////
@@ -1641,6 +1774,14 @@ bool SimbodyPhysics::GetParam(const std::string &_key, boost::any &_value) const
   {
     _value = this->contact.getTransitionVelocity();
   }
+  else if (_key == "pose_sync_threads")
+  {
+    _value = static_cast<int>(this->poseSyncThreads);
+  }
+  else if (_key == "pose_sync_moved_only")
+  {
+    _value = this->poseSyncMovedOnly;
+  }
   else
   {
     return PhysicsEngine::GetParam(_key, _value);
@@ -1700,6 +1841,15 @@ bool SimbodyPhysics::SetParam(const std::string &_key, const boost::any &_value)
     {
       this->contactImpactCaptureVelocity = boost::any_cast<double>(_value);
     }
+    else if (_key == "pose_sync_threads")
+    {
+      if (!this->SetPoseSyncThreads(boost::any_cast<int>(_value)))
+        return false;
+    }
+    else if (_key == "pose_sync_moved_only")
+    {
+      this->poseSyncMovedOnly = boost::any_cast<bool>(_value);
+    }
     else
     {
       return PhysicsEngine::SetParam(_key, _value);
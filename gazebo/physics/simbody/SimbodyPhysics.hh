@@ -17,7 +17,11 @@
 
 #ifndef GAZEBO_PHYSICS_SIMBODY_SIMBODYPHYSICS_HH
 #define GAZEBO_PHYSICS_SIMBODY_SIMBODYPHYSICS_HH
+#include <memory>
 #include <string>
+#include <vector>
+
+#include <tbb/task_arena.h>
 
 #include <boost/thread/thread.hpp>
 #include <boost/thread/mutex.hpp>
@@ -207,6 +211,23 @@ namespace gazebo
       private: void AddCollisionsToLink(const physics::SimbodyLink *_link,
         SimTK::MobilizedBody &_mobod, SimTK::ContactCliqueId _modelClique);
 
+      /// \brief Rebuild the links whose poses are synced after each step,
+      /// and the joints whose forces are cached, from the models of the
+      /// world.
+      private: void RebuildPoseSync();
+
+      /// \brief Set the dirty poses of the links from a state, and add the
+      /// links to the dirty poses of the world.
+      /// \param[in] _state State the poses are read from.
+      private: void SyncLinkPoses(const SimTK::State &_state);
+
+      /// \brief Set the number of threads the poses of the links are synced
+      /// on after each step.
+      /// \param[in] _threads Number of threads, zero to sync them on the
+      /// physics thread.
+      /// \return False if the number of threads is negative.
+      private: bool SetPoseSyncThreads(int _threads);
+
       public: SimTK::MultibodySystem system;
       public: SimTK::SimbodyMatterSubsystem matter;
       public: SimTK::GeneralForceSubsystem forces;
@@ -282,6 +303,36 @@ namespace gazebo
       ///   SimTK::RungeKutta2Integrator(system)
       ///   SimTK::SemiExplicitEuler2Integrator(system)
       private: std::string integratorType;
+
+      /// \brief Links whose poses are synced after each step.
+      private: std::vector<SimbodyLink *> syncLinks;
+
+      /// \brief Joints whose forces are cached after each step.
+      private: std::vector<SimbodyJoint *> syncJoints;
+
+      /// \brief For each link, whether its pose was synced by the last
+      /// step.
+      private: std::vector<char> syncMoved;
+
+      /// \brief Links whose poses were synced by the last step.
+      private: std::vector<Entity *> syncDirty;
+
+      /// \brief Entity version of the world the links were gathered at.
+      private: uint64_t syncEntityVersion = 0;
+
+      /// \brief True once the links have been gathered.
+      private: bool syncBuilt = false;
+
+      /// \brief Number of threads the poses are synced on, zero to sync
+      /// them on the physics thread.
+      private: unsigned int poseSyncThreads = 0;
+
+      /// \brief True to only add the links whose poses changed to the
+      /// dirty poses of the world.
+      private: bool poseSyncMovedOnly = false;
+
+      /// \brief Workers of the pose sync, null if poseSyncThreads is zero.
+      private: std::unique_ptr<tbb::task_arena> poseSyncArena;
     };
   /// \}
   }
@@ -30,6 +30,7 @@ namespace gazebo
     /// \{
 
     class SimbodyCollision;
+    class SimbodyJoint;
     class SimbodyLink;
     class SimbodyModel;
     class SimbodyPhysics;
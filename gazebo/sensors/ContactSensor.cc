@@ -120,9 +120,11 @@ void ContactSensor::Load(const std::string &_worldName)
     physics::ContactManager *mgr = this->world->Physics()->GetContactManager();
     std::string topic = mgr->CreateFilter(this->dataPtr->filterName,
         this->dataPtr->collisions);
+    // The packed contacts of the filter identify collisions by id, which
+    // are named from the world of this sensor.
     if (!this->dataPtr->contactSub)
     {
-      this->dataPtr->contactSub = this->node->Subscribe(topic,
+      this->dataPtr->contactSub = this->node->Subscribe(topic + "/packed",
           &ContactSensor::OnContacts, this);
     }
   }
@@ -301,15 +303,49 @@ std::map<std::string, gazebo::physics::Contact> ContactSensor::Contacts(
 }
 
 //////////////////////////////////////////////////
-void ContactSensor::OnContacts(ConstContactsPtr &_msg)
+std::string ContactSensor::CollisionScopedName(const uint32_t _id)
+{
+  // Names change when entities do.
+  const uint64_t version = this->world->_EntityVersion();
+  if (version != this->dataPtr->collisionNamesVersion)
+  {
+    this->dataPtr->collisionNames.clear();
+    this->dataPtr->collisionNamesVersion = version;
+  }
+
+  auto iter = this->dataPtr->collisionNames.find(_id);
+  if (iter == this->dataPtr->collisionNames.end())
+  {
+    std::string name;
+    physics::BasePtr base = this->world->BaseById(_id);
+    if (base)
+      name = base->GetScopedName();
+    iter = this->dataPtr->collisionNames.emplace(_id, name).first;
+  }
+  return iter->second;
+}
+
+//////////////////////////////////////////////////
+void ContactSensor::OnContacts(ConstPackedContactsPtr &_msg)
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   // Only store information if the sensor is active
   if (this->IsActive())
   {
+    boost::shared_ptr<msgs::Contacts> contacts(new msgs::Contacts);
+    if (!msgs::UnpackContacts(*_msg,
+          [this](const uint32_t _id)
+          {
+            return this->CollisionScopedName(_id);
+          }, this->world->Name(), *contacts))
+    {
+      gzerr << "Contact message has invalid array sizes\n";
+      return;
+    }
+
     // Store the contacts message for processing in UpdateImpl
-    this->dataPtr->incomingContacts.push_back(_msg);
+    this->dataPtr->incomingContacts.push_back(contacts);
 
     // Prevent the incomingContacts list to grow indefinitely.
     if (this->dataPtr->incomingContacts.size() > 100)
@@ -133,8 +133,14 @@ namespace gazebo
       // Documentation inherited.
       public: virtual bool IsActive() const;
 
-      /// \brief Callback for contact messages from the physics engine.
-      private: void OnContacts(ConstContactsPtr &_msg);
+      /// \brief Callback for packed contact messages from the physics
+      /// engine.
+      private: void OnContacts(ConstPackedContactsPtr &_msg);
+
+      /// \brief Get the scoped name of a collision.
+      /// \param[in] _id Id of the collision.
+      /// \return The scoped name, empty if there is no such collision.
+      private: std::string CollisionScopedName(const uint32_t _id);
 
       /// \internal
       /// \brief Private data pointer
@@ -17,10 +17,12 @@
 #ifndef _GAZEBO_SENSORS_CONTACTSENSOR_PRIVATE_HH_
 #define _GAZEBO_SENSORS_CONTACTSENSOR_PRIVATE_HH_
 
+#include <cstdint>
 #include <vector>
 #include <list>
 #include <string>
 #include <mutex>
+#include <unordered_map>
 
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/msgs/msgs.hh"
@@ -57,6 +59,14 @@ namespace gazebo
 
       /// \brief Name of filter used to filter contact messages.
       public: std::string filterName;
+
+      /// \brief Scoped names of the collisions of the contacts received, by
+      /// id.
+      public: std::unordered_map<uint32_t, std::string> collisionNames;
+
+      /// \brief Entity version of the world the names in collisionNames
+      /// were found at, see physics::World::_EntityVersion.
+      public: uint64_t collisionNamesVersion = 0;
     };
   }
 }
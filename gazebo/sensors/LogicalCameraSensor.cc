@@ -101,6 +101,10 @@ void LogicalCameraSensor::Init()
         cameraSdf->Get<double>("aspect_ratio"));
   }
 
+  // Models are found through the spatial index of the world, instead of
+  // computing the bounding box of every model on each update.
+  this->world->EnableSpatialIndex();
+
   Sensor::Init();
 }
 
@@ -129,13 +133,12 @@ bool LogicalCameraSensor::UpdateImpl(const bool _force)
     // Set the camera's pose in the message.
     msgs::Set(this->dataPtr->msg.mutable_pose(), myPose);
 
-    // Check all models for inclusion in the frustum.
-    for (auto const &model : this->world->Models())
+    // Check the models in the frustum.
+    for (auto const &model :
+        this->world->ModelsInFrustum(this->dataPtr->frustum))
     {
-      // Add the the model to the output if it is in the frustum, and
-      // we are not detecting ourselves.
-      if (this->dataPtr->modelName != model->GetName() &&
-          this->dataPtr->frustum.Contains(model->BoundingBox()))
+      // Add the model to the output if we are not detecting ourselves.
+      if (this->dataPtr->modelName != model->GetName())
       {
         // Add new model msg
         msgs::LogicalCameraImage::Model *modelMsg =
@@ -20,9 +20,17 @@
   #include <Winsock2.h>
 #endif
 
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <atomic>
 #include <functional>
+#include <limits>
+#include <utility>
 #include <boost/bind.hpp>
 #include "gazebo/common/Assert.hh"
+#include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Time.hh"
 
 #include "gazebo/physics/PhysicsIface.hh"
@@ -40,6 +48,85 @@ using namespace sensors;
 /// for timing coordination.
 boost::mutex g_sensorTimingMutex;
 
+namespace gazebo
+{
+  namespace sensors
+  {
+    /// \internal
+    /// \brief Work stealing pool that updates the sensors of a container.
+    class SensorUpdatePool
+    {
+      /// \brief Constructor.
+      /// \param[in] _threads Number of threads.
+      public: explicit SensorUpdatePool(const unsigned int _threads)
+              : arena(static_cast<int>(_threads))
+              {
+              }
+
+      /// \brief Update sensors, and wait for the updates to finish.
+      /// \param[in] _sensors The sensors.
+      /// \param[in] _force True to force the sensors to update.
+      public: void Update(const Sensor_V &_sensors, const bool _force);
+
+      /// \brief The threads of the pool.
+      private: tbb::task_arena arena;
+
+      /// \brief Due time and index of each sensor, sorted by due time.
+      private: std::vector<std::pair<common::Time, size_t>> order;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+void SensorUpdatePool::Update(const Sensor_V &_sensors, const bool _force)
+{
+  // Sensors whose update is due first are started first. Each sensor is
+  // updated by one thread only, so its own updates keep their order.
+  this->order.clear();
+  for (size_t i = 0; i < _sensors.size(); ++i)
+  {
+    const SensorPtr &sensor = _sensors[i];
+    GZ_ASSERT(sensor != nullptr, "Sensor is null");
+    common::Time due(std::numeric_limits<int32_t>::max(), 0);
+    if (sensor->IsActive() || _force)
+    {
+      due = sensor->LastUpdateTime();
+      if (sensor->UpdateRate() > 0)
+        due += common::Time(1.0 / sensor->UpdateRate());
+    }
+    this->order.push_back(std::make_pair(due, i));
+  }
+  std::stable_sort(this->order.begin(), this->order.end(),
+      [](const std::pair<common::Time, size_t> &_a,
+         const std::pair<common::Time, size_t> &_b)
+      {
+        return _a.first < _b.first;
+      });
+
+  std::atomic<size_t> next(0);
+  const size_t workers = std::min(_sensors.size(),
+      static_cast<size_t>(std::max(this->arena.max_concurrency(), 1)));
+  this->arena.execute([&]()
+  {
+    tbb::parallel_for(static_cast<size_t>(0), workers, [&](size_t)
+    {
+      // Ray sensors may cast rays with the physics engine, which needs
+      // per thread data.
+      static thread_local bool threadInitialized = false;
+      if (!threadInitialized)
+      {
+        physics::WorldPtr world = physics::get_world();
+        if (world && world->Physics())
+          world->Physics()->InitForThread();
+        threadInitialized = true;
+      }
+
+      for (size_t i = next++; i < this->order.size(); i = next++)
+        _sensors[this->order[i].second]->Update(_force);
+    });
+  });
+}
+
 //////////////////////////////////////////////////
 SensorManager::SensorManager()
   : initialized(false), removeAllSensors(false)
@@ -52,6 +139,19 @@ SensorManager::SensorManager()
 
   // sensors::OTHER container
   this->sensorContainers.push_back(new SensorContainer());
+
+  const char *threads = common::getEnv("GAZEBO_SENSOR_THREADS");
+  if (threads)
+  {
+    try
+    {
+      this->SetSensorUpdateThreads(std::stoul(threads));
+    }
+    catch(...)
+    {
+      gzerr << "Invalid GAZEBO_SENSOR_THREADS[" << threads << "]\n";
+    }
+  }
 }
 
 //////////////////////////////////////////////////
@@ -191,6 +291,32 @@ void SensorManager::ResetLastUpdateTimes()
   }
 }
 
+//////////////////////////////////////////////////
+void SensorManager::SetSensorUpdateThreads(const unsigned int _threads)
+{
+  boost::recursive_mutex::scoped_lock lock(this->mutex);
+  this->sensorUpdateThreads = _threads > 1 ? _threads : 0;
+
+  // The first container holds the image sensors, which are updated by the
+  // rendering thread.
+  for (size_t i = 1; i < this->sensorContainers.size(); ++i)
+  {
+    GZ_ASSERT(this->sensorContainers[i] != nullptr,
+        "SensorContainer is null");
+    std::shared_ptr<SensorUpdatePool> pool;
+    if (this->sensorUpdateThreads > 0)
+      pool.reset(new SensorUpdatePool(this->sensorUpdateThreads));
+    this->sensorContainers[i]->SetUpdatePool(pool);
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int SensorManager::SensorUpdateThreads() const
+{
+  boost::recursive_mutex::scoped_lock lock(this->mutex);
+  return this->sensorUpdateThreads;
+}
+
 //////////////////////////////////////////////////
 void SensorManager::Init()
 {
@@ -578,6 +704,12 @@ void SensorManager::SensorContainer::Update(bool _force)
   if (this->sensors.empty())
     gzlog << "Updating a sensor container without any sensors.\n";
 
+  if (this->updatePool && this->sensors.size() > 1)
+  {
+    this->updatePool->Update(this->sensors, _force);
+    return;
+  }
+
   // Update all the sensors in this container.
   for (Sensor_V::iterator iter = this->sensors.begin();
        iter != this->sensors.end(); ++iter)
@@ -587,6 +719,14 @@ void SensorManager::SensorContainer::Update(bool _force)
   }
 }
 
+//////////////////////////////////////////////////
+void SensorManager::SensorContainer::SetUpdatePool(
+    std::shared_ptr<SensorUpdatePool> _pool)
+{
+  boost::recursive_mutex::scoped_lock lock(this->mutex);
+  this->updatePool = _pool;
+}
+
 //////////////////////////////////////////////////
 SensorPtr SensorManager::SensorContainer::GetSensor(const std::string &_name,
                                                     bool _useLeafName) const
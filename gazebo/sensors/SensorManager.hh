@@ -22,6 +22,7 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <memory>
 
 #include <sdf/sdf.hh>
 
@@ -81,6 +82,11 @@ namespace gazebo
     };
     /// \endcond
 
+    /// \cond
+    // Forward declare the pool that updates the sensors of a container.
+    class SensorUpdatePool;
+    /// \endcond
+
     /// \addtogroup gazebo_sensors
     /// \{
     /// \class SensorManager SensorManager.hh sensors/sensors.hh
@@ -165,6 +171,24 @@ namespace gazebo
       /// \brief Reset last update times in all sensors.
       public: void ResetLastUpdateTimes();
 
+      /// \brief Set the number of threads that update the non-image
+      /// sensors. By default, the sensors of each category are updated one
+      /// after the other, on the thread of their category. With threads,
+      /// each update of a category runs its sensors on a work stealing
+      /// pool, the sensors whose update is due first being started first.
+      /// The rate of each sensor, and the wait for simulation time between
+      /// updates, are unchanged. Sensor plugins of the same category may
+      /// then be called concurrently. The GAZEBO_SENSOR_THREADS environment
+      /// variable sets the initial value.
+      /// \param[in] _threads Number of threads of each category, 0 or 1
+      /// to update the sensors on the thread of their category.
+      public: void SetSensorUpdateThreads(const unsigned int _threads);
+
+      /// \brief Get the number of threads that update the non-image sensors.
+      /// \return Number of threads, 0 if sensors are updated serially.
+      /// \sa SetSensorUpdateThreads
+      public: unsigned int SensorUpdateThreads() const;
+
       /// \brief Add a new sensor to a sensor container.
       /// \param[in] _sensor Pointer to a sensor to add.
       private: void AddSensor(SensorPtr _sensor);
@@ -223,6 +247,12 @@ namespace gazebo
                  /// \brief Reset last update times in all sensors.
                  public: void ResetLastUpdateTimes();
 
+                 /// \brief Set the pool that updates the sensors.
+                 /// \param[in] _pool The pool, null to update the sensors
+                 /// on the calling thread.
+                 public: void SetUpdatePool(
+                             std::shared_ptr<SensorUpdatePool> _pool);
+
                  /// \brief A loop to update the sensor. Used by the
                  /// runThread.
                  private: void RunLoop();
@@ -246,6 +276,10 @@ namespace gazebo
                  /// \brief Condition used to block the RunLoop if no
                  /// sensors are present.
                  private: boost::condition_variable runCondition;
+
+                 /// \brief Pool that updates the sensors, null to update
+                 /// them on the calling thread.
+                 private: std::shared_ptr<SensorUpdatePool> updatePool;
                };
       /// \endcond
 
@@ -271,6 +305,9 @@ namespace gazebo
       /// \brief Mutex used when adding and removing sensors.
       private: mutable boost::recursive_mutex mutex;
 
+      /// \brief Number of threads that update the non-image sensors.
+      private: unsigned int sensorUpdateThreads = 0;
+
       /// \brief List of sensors that require initialization.
       private: Sensor_V initSensors;
 
@@ -159,6 +159,44 @@ TEST_F(SensorManager_TEST, InitRemove)
   printf("Done done\n");
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that sensors are updated by a pool of threads.
+TEST_F(SensorManager_TEST, UpdateThreads)
+{
+  Load("worlds/pr2.world");
+  sensors::SensorManager *mgr = sensors::SensorManager::Instance();
+  EXPECT_TRUE(mgr->SensorsInitialized());
+
+  EXPECT_EQ(mgr->SensorUpdateThreads(), 0u);
+  mgr->SetSensorUpdateThreads(1);
+  EXPECT_EQ(mgr->SensorUpdateThreads(), 0u);
+  mgr->SetSensorUpdateThreads(4);
+  EXPECT_EQ(mgr->SensorUpdateThreads(), 4u);
+
+  common::Time time = physics::get_world()->SimTime();
+
+  // Wait for 1 second
+  for (unsigned int i = 0; i < 10; ++i)
+    common::Time::MSleep(100);
+
+  // Every active non-image sensor was updated.
+  unsigned int updated = 0;
+  for (auto const &sensor : mgr->GetSensors())
+  {
+    if (sensor->Category() == sensors::IMAGE || !sensor->IsActive() ||
+        sensor->UpdateRate() <= 0)
+    {
+      continue;
+    }
+    EXPECT_GT(sensor->LastUpdateTime(), time) << sensor->ScopedName();
+    ++updated;
+  }
+  EXPECT_GT(updated, 1u);
+
+  mgr->SetSensorUpdateThreads(0);
+  EXPECT_EQ(mgr->SensorUpdateThreads(), 0u);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -20,6 +20,10 @@
   #include <Winsock2.h>
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
 #include <ignition/math/Rand.hh>
 
 #include "gazebo/msgs/msgs.hh"
@@ -43,6 +47,62 @@ const double WirelessTransmitterPrivate::ModelStdDev = 6.0;
 const double WirelessTransmitterPrivate::Step = 1.0;
 const double WirelessTransmitterPrivate::MaxRadius = 10.0;
 
+/// \brief Maximum number of cached rays to receivers.
+static const size_t kWirelessMaxReceiverRays = 64;
+
+/// \brief Offset of the end of a ray that would start and end at the same
+/// point. This prevents an assertion in bullet (issue #849).
+static const double kWirelessCoincidentOffset = 0.00001;
+
+/// \brief Get whether a segment crosses a box.
+/// \param[in] _start Start point of the segment.
+/// \param[in] _end End point of the segment.
+/// \param[in] _box The box, which can be infinite.
+/// \return True if the segment crosses or touches the box.
+static bool SegmentCrossesBox(const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end, const ignition::math::Box &_box)
+{
+  double tMin = 0;
+  double tMax = 1;
+  for (int i = 0; i < 3; ++i)
+  {
+    const double start = _start[i];
+    const double dir = _end[i] - start;
+    const double min = _box.Min()[i];
+    const double max = _box.Max()[i];
+
+    if (!(min <= max))
+      return false;
+
+    if (std::abs(dir) < 1e-12)
+    {
+      if (start < min || start > max)
+        return false;
+      continue;
+    }
+
+    double t1 = (min - start) / dir;
+    double t2 = (max - start) / dir;
+    if (t1 > t2)
+      std::swap(t1, t2);
+    tMin = std::max(tMin, t1);
+    tMax = std::min(tMax, t2);
+    if (tMin > tMax)
+      return false;
+  }
+  return true;
+}
+
+/// \brief Part of the propagation model that only depends on the
+/// frequency.
+/// \param[in] _freq Frequency in MHz.
+/// \return The gain in dB.
+static double WavelengthGain(const double _freq)
+{
+  const double wavelength = common::SpeedOfLight / (_freq * 1000000);
+  return 20 * log10(wavelength) - 20 * log10(4 * M_PI);
+}
+
 /////////////////////////////////////////////////
 WirelessTransmitter::WirelessTransmitter()
 : WirelessTransceiver(),
@@ -89,6 +149,13 @@ void WirelessTransmitter::Init()
   // between the transmitter and a given point.
   this->dataPtr->testRay = boost::dynamic_pointer_cast<RayShape>(
       this->world->Physics()->CreateShape("ray", CollisionPtr()));
+
+  // Obstacles are cast against in batches, without locking the physics
+  // engine, and their movements are found through the spatial index.
+  this->world->EnableRaySnapshots();
+  this->world->EnableSpatialIndex();
+
+  this->dataPtr->InitGrid();
 }
 
 //////////////////////////////////////////////////
@@ -98,39 +165,49 @@ bool WirelessTransmitter::UpdateImpl(const bool /*_force*/)
 
   if (this->dataPtr->visualize)
   {
-    msgs::PropagationGrid msg;
-    ignition::math::Pose3d pos;
-    ignition::math::Pose3d worldPose;
-    double strength;
-    msgs::PropagationParticle *p;
-
-    // Iterate using a rectangular grid, but only choose the points within
-    // a circunference of radius MaxRadius
-    for (double x = -this->dataPtr->MaxRadius;
-         x <= this->dataPtr->MaxRadius; x += this->dataPtr->Step)
+    const size_t cellCount = this->dataPtr->cellOffsets.size();
+    msgs::PropagationGrid &msg = this->dataPtr->gridMsg;
+    if (msg.particle_size() != static_cast<int>(cellCount))
     {
-      for (double y = -this->dataPtr->MaxRadius;
-           y <= this->dataPtr->MaxRadius; y += this->dataPtr->Step)
+      msg.clear_particle();
+      for (auto const &offset : this->dataPtr->cellOffsets)
       {
-        pos.Set(x, y, 0.0, 0, 0, 0);
+        msgs::PropagationParticle *p = msg.add_particle();
+        p->set_x(offset.X());
+        p->set_y(offset.Y());
+      }
+    }
 
-        worldPose = pos + this->referencePose;
+    // For the propagation model assume the receiver antenna has the same
+    // gain as the transmitter
+    const double gain = this->Power() + this->Gain() + this->Gain() +
+      WavelengthGain(this->Freq());
 
-        if (this->referencePose.Pos().Distance(worldPose.Pos()) <=
-            this->dataPtr->MaxRadius)
-        {
-          // For the propagation model assume the receiver antenna has the same
-          // gain as the transmitter
-          strength = this->SignalStrength(worldPose, this->Gain());
-
-          // Add a new particle to the grid
-          p = msg.add_particle();
-          p->set_x(x);
-          p->set_y(y);
-          p->set_signal_level(strength);
-        }
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+      this->dataPtr->Validate(this->world, this->referencePose);
+      this->dataPtr->UpdateGrid(this->world);
+
+      this->dataPtr->cellLevels.resize(cellCount);
+      const double *logDistances = this->dataPtr->cellLogDistances.data();
+      const char *occluded = this->dataPtr->cellOccluded.data();
+      double *levels = this->dataPtr->cellLevels.data();
+      for (size_t i = 0; i < cellCount; ++i)
+      {
+        const double n = occluded[i] ? WirelessTransmitterPrivate::NObstacle :
+          WirelessTransmitterPrivate::NEmpty;
+        levels[i] = gain - 10 * n * logDistances[i];
       }
     }
+
+    for (size_t i = 0; i < cellCount; ++i)
+    {
+      const double x = std::abs(ignition::math::Rand::DblNormal(0.0,
+            WirelessTransmitterPrivate::ModelStdDev));
+      msg.mutable_particle(static_cast<int>(i))->set_signal_level(
+          this->dataPtr->cellLevels[i] - x);
+    }
+
     this->pub->Publish(msg);
   }
 
@@ -154,44 +231,39 @@ double WirelessTransmitter::SignalStrength(
     const ignition::math::Pose3d &_receiver,
     const double _rxGain)
 {
-  std::string entityName;
-  double dist;
   ignition::math::Vector3d end = _receiver.Pos();
   ignition::math::Vector3d start = this->referencePose.Pos();
 
   // Avoid computing the intersection of coincident points
-  // This prevents an assertion in bullet (issue #849)
   if (start == end)
   {
-    end.Z() += 0.00001;
+    end.Z() += kWirelessCoincidentOffset;
   }
 
-  // Acquire the mutex for avoiding race condition with the physics engine
-  boost::recursive_mutex::scoped_lock lock(*(
-        this->world->Physics()->GetPhysicsUpdateMutex()));
-
   // Compute the value of n depending on the obstacles between Tx and Rx
   double n = WirelessTransmitterPrivate::NEmpty;
 
-  // Looking for obstacles between start and end points
-  this->dataPtr->testRay->SetPoints(start, end);
-  this->dataPtr->testRay->GetIntersection(dist, entityName);
-
+  // Looking for obstacles between start and end points, the ray is only
+  // cast again if something moved.
   // ToDo: The ray intersects with my own collision model. Fix it.
-  if (entityName != "")
+  bool occluded;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->Validate(this->world, this->referencePose);
+    occluded = this->dataPtr->Occluded(this->world, end);
+  }
+  if (occluded)
   {
     n = WirelessTransmitterPrivate::NObstacle;
   }
 
-  double distance = std::max(1.0,
-      this->referencePose.Pos().Distance(_receiver.Pos()));
+  double distance = std::max(1.0, start.Distance(_receiver.Pos()));
   double x = std::abs(ignition::math::Rand::DblNormal(0.0,
         WirelessTransmitterPrivate::ModelStdDev));
-  double wavelength = common::SpeedOfLight / (this->Freq() * 1000000);
 
   // Hata-Okumara propagation model
   double rxPower = this->Power() + this->Gain() + _rxGain - x +
-      20 * log10(wavelength) - 20 * log10(4 * M_PI) - 10 * n * log10(distance);
+      WavelengthGain(this->Freq()) - 10 * n * log10(distance);
 
   return rxPower;
 }
@@ -201,3 +273,271 @@ double WirelessTransmitter::ModelStdDev() const
 {
   return WirelessTransmitterPrivate::ModelStdDev;
 }
+
+/////////////////////////////////////////////////
+void WirelessTransmitterPrivate::InitGrid()
+{
+  this->cellOffsets.clear();
+  this->cellLogDistances.clear();
+
+  // Iterate using a rectangular grid, but only choose the points within
+  // a circunference of radius MaxRadius
+  for (double x = -MaxRadius; x <= MaxRadius; x += Step)
+  {
+    for (double y = -MaxRadius; y <= MaxRadius; y += Step)
+    {
+      const ignition::math::Vector3d offset(x, y, 0);
+      if (offset.Length() <= MaxRadius)
+      {
+        this->cellOffsets.push_back(offset);
+        this->cellLogDistances.push_back(
+            log10(std::max(1.0, offset.Length())));
+      }
+    }
+  }
+
+  this->cellEnds.resize(this->cellOffsets.size());
+  this->cellOccluded.assign(this->cellOffsets.size(), 0);
+  this->cellCached.assign(this->cellOffsets.size(), 0);
+  this->cacheValid = false;
+}
+
+/////////////////////////////////////////////////
+void WirelessTransmitterPrivate::Validate(const physics::WorldPtr &_world,
+    const ignition::math::Pose3d &_pose)
+{
+  // Obstacles can also be moved while paused, which updates the spatial
+  // index without a world iteration.
+  const uint64_t updates = _world->SpatialIndexUpdates();
+  const uint64_t version = _world->_EntityVersion();
+  const bool moved = !this->cacheValid || _pose != this->cachePose;
+  if (!moved && updates == this->validatedUpdates &&
+      version == this->validatedVersion)
+  {
+    return;
+  }
+  this->validatedUpdates = updates;
+  this->validatedVersion = version;
+
+  // After a translation of length d, each ray stays within d of its old
+  // segment. Its result only changes if a link that did not move with the
+  // transmitter is that close to the old segment.
+  const ignition::math::Vector3d shift = _pose.Pos() - this->cachePose.Pos();
+  const bool translated = moved && this->cacheValid &&
+    _pose.Rot() == this->cachePose.Rot() && shift.Length() < Step;
+  auto movedWith = [&](const WirelessObstacle &_obstacle)
+  {
+    return translated && _obstacle.current.Rot() == _obstacle.pose.Rot() &&
+      _obstacle.current.Pos() - _obstacle.pose.Pos() == shift;
+  };
+
+  if (moved && !translated)
+  {
+    std::fill(this->cellCached.begin(), this->cellCached.end(), 0);
+    this->receiverRays.clear();
+  }
+
+  // Links around the cached rays: the grid, and the cached receivers.
+  ignition::math::Vector3d min = _pose.Pos() -
+    ignition::math::Vector3d(MaxRadius, MaxRadius, MaxRadius);
+  ignition::math::Vector3d max = _pose.Pos() +
+    ignition::math::Vector3d(MaxRadius, MaxRadius, MaxRadius);
+  for (auto const &ray : this->receiverRays)
+  {
+    min.Min(ray.end);
+    max.Max(ray.end);
+  }
+
+  for (auto &obstacle : this->obstacles)
+    obstacle.second.seen = false;
+
+  const physics::Link_V links =
+    _world->LinksInBox(ignition::math::Box(min, max));
+  for (auto const &link : links)
+  {
+    auto iter = this->obstacles.find(link->GetId());
+    if (iter != this->obstacles.end())
+    {
+      iter->second.seen = true;
+      iter->second.current = link->WorldPose();
+    }
+  }
+
+  if (translated)
+  {
+    const double margin = shift.Length();
+    const ignition::math::Vector3d grow(margin, margin, margin);
+    for (auto const &obstacle : this->obstacles)
+    {
+      if (!obstacle.second.seen || !movedWith(obstacle.second))
+      {
+        this->Invalidate(ignition::math::Box(
+              obstacle.second.box.Min() - grow,
+              obstacle.second.box.Max() + grow));
+      }
+    }
+
+    // The cells are in the frame of the transmitter, the receivers stay.
+    for (size_t i = 0; i < this->cellEnds.size(); ++i)
+    {
+      if (this->cellCached[i])
+        this->cellEnds[i] += shift;
+    }
+  }
+  this->cachePose = _pose;
+  this->cacheValid = true;
+
+  for (auto const &link : links)
+  {
+    auto iter = this->obstacles.find(link->GetId());
+    if (iter == this->obstacles.end())
+    {
+      WirelessObstacle &obstacle = this->obstacles[link->GetId()];
+      obstacle.pose = link->WorldPose();
+      obstacle.box = link->BoundingBox();
+      obstacle.seen = true;
+      this->Invalidate(obstacle.box);
+    }
+    else if (iter->second.current != iter->second.pose)
+    {
+      // A link that moved with the transmitter, such as its own, keeps
+      // the same place along the rays.
+      const bool keep = movedWith(iter->second);
+      if (!keep)
+        this->Invalidate(iter->second.box);
+      iter->second.pose = iter->second.current;
+      iter->second.box = link->BoundingBox();
+      if (!keep)
+        this->Invalidate(iter->second.box);
+    }
+  }
+
+  // Links that left, or were removed
+  for (auto iter = this->obstacles.begin(); iter != this->obstacles.end();)
+  {
+    if (!iter->second.seen)
+    {
+      this->Invalidate(iter->second.box);
+      iter = this->obstacles.erase(iter);
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void WirelessTransmitterPrivate::Invalidate(const ignition::math::Box &_box)
+{
+  const ignition::math::Vector3d start = this->cachePose.Pos();
+  for (size_t i = 0; i < this->cellEnds.size(); ++i)
+  {
+    if (this->cellCached[i] &&
+        SegmentCrossesBox(start, this->cellEnds[i], _box))
+    {
+      this->cellCached[i] = 0;
+    }
+  }
+
+  this->receiverRays.erase(std::remove_if(this->receiverRays.begin(),
+        this->receiverRays.end(),
+        [&](const WirelessReceiverRay &_ray)
+        {
+          return SegmentCrossesBox(start, _ray.end, _box);
+        }), this->receiverRays.end());
+}
+
+/////////////////////////////////////////////////
+void WirelessTransmitterPrivate::UpdateGrid(const physics::WorldPtr &_world)
+{
+  this->rayCells.clear();
+  this->rayEnds.clear();
+  for (size_t i = 0; i < this->cellOffsets.size(); ++i)
+  {
+    if (this->cellCached[i])
+      continue;
+
+    ignition::math::Pose3d cell(this->cellOffsets[i],
+        ignition::math::Quaterniond::Identity);
+    this->cellEnds[i] = (cell + this->cachePose).Pos();
+    if (this->cellEnds[i] == this->cachePose.Pos())
+      this->cellEnds[i].Z() += kWirelessCoincidentOffset;
+
+    this->rayCells.push_back(i);
+    this->rayEnds.push_back(this->cellEnds[i]);
+  }
+
+  if (this->rayCells.empty())
+    return;
+
+  this->CastRays(_world, this->rayEnds, this->rayOccluded);
+  for (size_t i = 0; i < this->rayCells.size(); ++i)
+  {
+    this->cellOccluded[this->rayCells[i]] = this->rayOccluded[i];
+    this->cellCached[this->rayCells[i]] = 1;
+  }
+}
+
+/////////////////////////////////////////////////
+bool WirelessTransmitterPrivate::Occluded(const physics::WorldPtr &_world,
+    const ignition::math::Vector3d &_end)
+{
+  for (auto const &ray : this->receiverRays)
+  {
+    if (ray.end == _end)
+      return ray.occluded;
+  }
+
+  this->rayEnds.assign(1, _end);
+  this->CastRays(_world, this->rayEnds, this->rayOccluded);
+
+  if (this->receiverRays.size() >= kWirelessMaxReceiverRays)
+    this->receiverRays.erase(this->receiverRays.begin());
+
+  WirelessReceiverRay ray;
+  ray.end = _end;
+  ray.occluded = this->rayOccluded[0] != 0;
+  this->receiverRays.push_back(ray);
+
+  return ray.occluded;
+}
+
+/////////////////////////////////////////////////
+void WirelessTransmitterPrivate::CastRays(const physics::WorldPtr &_world,
+    const std::vector<ignition::math::Vector3d> &_ends,
+    std::vector<char> &_occluded)
+{
+  const ignition::math::Vector3d start = this->cachePose.Pos();
+  _occluded.resize(_ends.size());
+
+  // The world may have stepped once since the snapshot was built, and not
+  // yet built the next one.
+  std::shared_ptr<const physics::RaycastSnapshot> snapshot =
+    _world->RaySnapshot();
+  const uint64_t iterations = _world->Iterations();
+  if (snapshot && snapshot->Complete() &&
+      snapshot->EntityVersion() == _world->_EntityVersion() &&
+      iterations >= snapshot->Iterations() &&
+      iterations <= snapshot->Iterations() + 1)
+  {
+    this->rayStarts.assign(_ends.size(), start);
+    snapshot->CastRays(this->rayStarts, _ends, this->rayHits);
+    for (size_t i = 0; i < _ends.size(); ++i)
+      _occluded[i] = this->rayHits[i].collision >= 0;
+    return;
+  }
+
+  // Acquire the mutex for avoiding race condition with the physics engine
+  boost::recursive_mutex::scoped_lock lock(*(
+        _world->Physics()->GetPhysicsUpdateMutex()));
+
+  std::string entityName;
+  double dist;
+  for (size_t i = 0; i < _ends.size(); ++i)
+  {
+    this->testRay->SetPoints(start, _ends[i]);
+    this->testRay->GetIntersection(dist, entityName);
+    _occluded[i] = !entityName.empty();
+  }
+}
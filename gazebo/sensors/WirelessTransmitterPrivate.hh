@@ -17,13 +17,53 @@
 #ifndef _GAZEBO_SENSORS_WIRELESSTRANSMITTER_PRIVATE_HH_
 #define _GAZEBO_SENSORS_WIRELESSTRANSMITTER_PRIVATE_HH_
 
+#include <cstdint>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ignition/math/Box.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/physics/RaycastSnapshot.hh"
 
 namespace gazebo
 {
   namespace sensors
   {
+    /// \internal
+    /// \brief A link near a wireless transmitter. The cached rays that
+    /// cross its bounding box are cast again when it moves.
+    class WirelessObstacle
+    {
+      /// \brief World pose of the link when its box was computed.
+      public: ignition::math::Pose3d pose;
+
+      /// \brief Bounding box of the link.
+      public: ignition::math::Box box;
+
+      /// \brief World pose of the link found by the last validation.
+      public: ignition::math::Pose3d current;
+
+      /// \brief True if the link was found by the last validation.
+      public: bool seen = false;
+    };
+
+    /// \internal
+    /// \brief A cached ray from a wireless transmitter to a receiver.
+    class WirelessReceiverRay
+    {
+      /// \brief Position of the receiver.
+      public: ignition::math::Vector3d end;
+
+      /// \brief True if the ray hit an obstacle.
+      public: bool occluded = false;
+    };
+
     /// \internal
     /// \brief Wireless transmitter private data
     class WirelessTransmitterPrivate
@@ -59,6 +99,109 @@ namespace gazebo
 
       // \brief Ray used to test for collisions when placing entities
       public: physics::RayShapePtr testRay;
+
+      /// \brief Compute the cells of the propagation grid, in the frame of
+      /// the transmitter.
+      public: void InitGrid();
+
+      /// \brief Drop the cached rays that are no longer valid, the ones
+      /// that cross the bounding box of a link that moved. When the
+      /// transmitter is translated by less than Step, the rays are moved
+      /// with it, and the ones that come closer than the translation to a
+      /// link that did not move with it are dropped. All of them are dropped
+      /// when the transmitter moved otherwise. This is done at most once per
+      /// update of the spatial index or change of the entities of the world.
+      /// \param[in] _world The world.
+      /// \param[in] _pose Pose of the transmitter.
+      public: void Validate(const physics::WorldPtr &_world,
+                  const ignition::math::Pose3d &_pose);
+
+      /// \brief Drop the cached rays that cross a box.
+      /// \param[in] _box The box.
+      public: void Invalidate(const ignition::math::Box &_box);
+
+      /// \brief Cast the rays of the grid cells that are not cached.
+      /// \param[in] _world The world.
+      public: void UpdateGrid(const physics::WorldPtr &_world);
+
+      /// \brief Get whether the ray from the transmitter to a receiver hits
+      /// an obstacle. The result is cached until the receiver, the
+      /// transmitter or an obstacle on the way moves.
+      /// \param[in] _world The world.
+      /// \param[in] _end Position of the receiver.
+      /// \return True if an obstacle is hit.
+      public: bool Occluded(const physics::WorldPtr &_world,
+                  const ignition::math::Vector3d &_end);
+
+      /// \brief Cast rays from the transmitter, as one batch against the
+      /// ray snapshot of the world when it is current, or with testRay.
+      /// \param[in] _world The world.
+      /// \param[in] _ends End points of the rays.
+      /// \param[out] _occluded True for each ray that hits an obstacle.
+      public: void CastRays(const physics::WorldPtr &_world,
+                  const std::vector<ignition::math::Vector3d> &_ends,
+                  std::vector<char> &_occluded);
+
+      /// \brief Mutex to protect the cached rays, which are read by
+      /// receivers from their own threads.
+      public: std::mutex mutex;
+
+      /// \brief Offset of each cell of the grid, in the frame of the
+      /// transmitter.
+      public: std::vector<ignition::math::Vector3d> cellOffsets;
+
+      /// \brief Logarithm of the distance of each cell from the
+      /// transmitter, at least 1 meter, used by the propagation model.
+      public: std::vector<double> cellLogDistances;
+
+      /// \brief World position of each cached cell, for cachePose.
+      public: std::vector<ignition::math::Vector3d> cellEnds;
+
+      /// \brief True for each cell whose ray hits an obstacle.
+      public: std::vector<char> cellOccluded;
+
+      /// \brief True for each cell whose ray is cached.
+      public: std::vector<char> cellCached;
+
+      /// \brief Cached rays to receivers, oldest first.
+      public: std::vector<WirelessReceiverRay> receiverRays;
+
+      /// \brief Links around the cached rays, by id.
+      public: std::unordered_map<uint32_t, WirelessObstacle> obstacles;
+
+      /// \brief Pose of the transmitter the cached rays start from.
+      public: ignition::math::Pose3d cachePose;
+
+      /// \brief False until the first validation.
+      public: bool cacheValid = false;
+
+      /// \brief Updates of the spatial index of the world at the last
+      /// validation.
+      public: uint64_t validatedUpdates = 0;
+
+      /// \brief Entity version of the world at the last validation.
+      public: uint64_t validatedVersion = 0;
+
+      /// \brief Start points of a batch of rays.
+      public: std::vector<ignition::math::Vector3d> rayStarts;
+
+      /// \brief End points of a batch of rays.
+      public: std::vector<ignition::math::Vector3d> rayEnds;
+
+      /// \brief Hits of a batch of rays.
+      public: std::vector<physics::RaycastHit> rayHits;
+
+      /// \brief Results of a batch of rays.
+      public: std::vector<char> rayOccluded;
+
+      /// \brief Cells of a batch of rays.
+      public: std::vector<size_t> rayCells;
+
+      /// \brief Signal level of each cell, without noise.
+      public: std::vector<double> cellLevels;
+
+      /// \brief Propagation grid, whose cells are only set once.
+      public: msgs::PropagationGrid gridMsg;
     };
   }
 }
@@ -24,6 +24,7 @@ class WirelessTransmitter_TEST : public ServerFixture
     public: WirelessTransmitter_TEST();
     public: void TestCreateWirelessTransmitter();
     public: void TestSignalStrength();
+    public: void TestSignalStrengthObstacle();
     public: void TestUpdateImpl();
     public: void TestUpdateImplNoVisual();
     public: void TestInvalidFreq();
@@ -159,6 +160,72 @@ void WirelessTransmitter_TEST::TestSignalStrength()
   EXPECT_NEAR(signStrengthAvg, -62.0, this->tx->ModelStdDev());
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that the cached rays follow an obstacle that moves
+void WirelessTransmitter_TEST::TestSignalStrengthObstacle()
+{
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  world->SetPaused(true);
+
+  ignition::math::Pose3d rxPose(
+      ignition::math::Vector3d(3.0, 3.0, 0.055),
+      ignition::math::Quaterniond(0, 0, 0));
+
+  auto average = [&]()
+  {
+    int samples = 100;
+    double signStrengthAvg = 0.0;
+    for (int i = 0; i < samples; ++i)
+      signStrengthAvg += this->tx->SignalStrength(rxPose, tx->Gain());
+    return signStrengthAvg / samples;
+  };
+
+  this->tx->Update(true);
+  EXPECT_NEAR(average(), -62.0, this->tx->ModelStdDev());
+
+  // A box between the transmitter and the receiver
+  SpawnBox("obstacle", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(1.5, 1.5, 0.5),
+      ignition::math::Vector3d::Zero, true);
+  physics::ModelPtr obstacle = world->ModelByName("obstacle");
+  ASSERT_TRUE(obstacle != nullptr);
+  world->Step(1);
+  this->tx->Update(true);
+  EXPECT_NEAR(average(), -100.0, this->tx->ModelStdDev());
+
+  // Moved away
+  obstacle->SetWorldPose(ignition::math::Pose3d(10, -10, 0.5, 0, 0, 0));
+  world->Step(1);
+  this->tx->Update(true);
+  EXPECT_NEAR(average(), -62.0, this->tx->ModelStdDev());
+
+  // Moved back without a world iteration, the spatial index is updated
+  // while paused.
+  const uint64_t updates = world->SpatialIndexUpdates();
+  obstacle->SetWorldPose(ignition::math::Pose3d(1.5, 1.5, 0.5, 0, 0, 0));
+  for (int i = 0; i < 1000 && world->SpatialIndexUpdates() == updates; ++i)
+    common::Time::MSleep(1);
+  EXPECT_NE(world->SpatialIndexUpdates(), updates);
+  this->tx->Update(true);
+  EXPECT_NEAR(average(), -100.0, this->tx->ModelStdDev());
+
+  // The transmitter moved by less than a step of the grid, the obstacle is
+  // still on the way.
+  physics::ModelPtr txModel = world->ModelByName("tx");
+  ASSERT_TRUE(txModel != nullptr);
+  txModel->SetWorldPose(txModel->WorldPose() +
+      ignition::math::Pose3d(0.5, 0, 0, 0, 0, 0));
+  world->Step(1);
+  this->tx->Update(true);
+  EXPECT_NEAR(average(), -100.0, this->tx->ModelStdDev());
+
+  obstacle->SetWorldPose(ignition::math::Pose3d(10, -10, 0.5, 0, 0, 0));
+  world->Step(1);
+  this->tx->Update(true);
+  EXPECT_NEAR(average(), -62.0, this->tx->ModelStdDev());
+}
+
 /////////////////////////////////////////////////
 /// \brief Callback executed for every propagation grid message received
 void WirelessTransmitter_TEST::TxMsg(const ConstPropagationGridPtr &_msg)
@@ -254,6 +321,12 @@ TEST_F(WirelessTransmitter_TEST, TestSignalStrength)
   TestSignalStrength();
 }
 
+/////////////////////////////////////////////////
+TEST_F(WirelessTransmitter_TEST, TestSignalStrengthObstacle)
+{
+  TestSignalStrengthObstacle();
+}
+
 /////////////////////////////////////////////////
 TEST_F(WirelessTransmitter_TEST, TestUpdateImpl)
 {
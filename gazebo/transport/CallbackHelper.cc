@@ -15,6 +15,11 @@
  *
 */
 
+#include <algorithm>
+#include <map>
+#include <unordered_set>
+
+#include "gazebo/msgs/MsgFactory.hh"
 #include "gazebo/transport/CallbackHelper.hh"
 
 using namespace gazebo;
@@ -22,6 +27,48 @@ using namespace transport;
 
 unsigned int CallbackHelper::idCounter = 0;
 
+/// \brief Merge held back msgs::PosesStamped by pose id, see
+/// physics::PosePublisher, which only publishes the poses that changed.
+/// \param[in] _older The message held back.
+/// \param[in,out] _newer The newer message.
+static void MergePoses(const google::protobuf::Message &_older,
+    google::protobuf::Message &_newer)
+{
+  const msgs::PosesStamped &older =
+    static_cast<const msgs::PosesStamped &>(_older);
+  msgs::PosesStamped &newer = static_cast<msgs::PosesStamped &>(_newer);
+
+  std::unordered_set<uint32_t> ids;
+  for (int i = 0; i < newer.pose_size(); ++i)
+    ids.insert(newer.pose(i).id());
+
+  for (int i = 0; i < older.pose_size(); ++i)
+  {
+    if (ids.count(older.pose(i).id()) == 0)
+      newer.add_pose()->CopyFrom(older.pose(i));
+  }
+}
+
+/// \brief Merge functions by message type name.
+static std::map<std::string, CallbackHelper::MergeFunction> g_merges = {
+  {"gazebo.msgs.PosesStamped", MergePoses}};
+
+/// \brief Mutex to protect g_merges.
+static std::mutex g_mergesMutex;
+
+/// \brief Get the merge function of a message type.
+/// \param[in] _msgType Type name of the messages.
+/// \return The function, empty if the type has none.
+static CallbackHelper::MergeFunction MergeFunctionOf(
+    const std::string &_msgType)
+{
+  std::lock_guard<std::mutex> lock(g_mergesMutex);
+  auto iter = g_merges.find(_msgType);
+  if (iter == g_merges.end())
+    return CallbackHelper::MergeFunction();
+  return iter->second;
+}
+
 /////////////////////////////////////////////////
 CallbackHelper::CallbackHelper(bool _latching)
   : latching(_latching), id(idCounter++)
@@ -58,3 +105,184 @@ unsigned int CallbackHelper::GetId() const
 {
   return this->id;
 }
+
+/////////////////////////////////////////////////
+void CallbackHelper::SetQoS(const double _maxRate, const unsigned int _depth,
+    const Reliability _reliability)
+{
+  std::lock_guard<std::mutex> lock(this->qosMutex);
+  this->maxRate = std::max(_maxRate, 0.0);
+  this->depth = _depth;
+  this->reliability = _reliability;
+}
+
+/////////////////////////////////////////////////
+double CallbackHelper::MaxRate() const
+{
+  std::lock_guard<std::mutex> lock(this->qosMutex);
+  return this->maxRate;
+}
+
+/////////////////////////////////////////////////
+unsigned int CallbackHelper::Depth() const
+{
+  std::lock_guard<std::mutex> lock(this->qosMutex);
+  return this->depth;
+}
+
+/////////////////////////////////////////////////
+Reliability CallbackHelper::GetReliability() const
+{
+  std::lock_guard<std::mutex> lock(this->qosMutex);
+  return this->reliability;
+}
+
+/////////////////////////////////////////////////
+std::size_t CallbackHelper::FirstDelivered(const std::size_t _count)
+{
+  if (_count == 0)
+    return 0;
+
+  if (this->MaxRate() > 0)
+  {
+    if (this->MergesPending())
+      return _count;
+    return this->RateReady() ? _count - 1 : _count;
+  }
+
+  const unsigned int keep = this->Depth();
+  return keep > 0 && _count > keep ? _count - keep : 0;
+}
+
+/////////////////////////////////////////////////
+bool CallbackHelper::RateReady()
+{
+  std::lock_guard<std::mutex> lock(this->qosMutex);
+  if (this->maxRate <= 0)
+    return true;
+
+  const common::Time now = common::Time::GetWallTime();
+  if (this->lastDelivery != common::Time::Zero &&
+      (now - this->lastDelivery).Double() < 1.0 / this->maxRate)
+  {
+    return false;
+  }
+
+  this->lastDelivery = now;
+  this->hasPending = false;
+  this->pendingMsg.reset();
+  this->pendingData.clear();
+  return true;
+}
+
+/////////////////////////////////////////////////
+void CallbackHelper::KeepPending(const std::string &_data)
+{
+  // Merged messages are kept parsed.
+  const std::string msgType = this->GetMsgType();
+  if (Merges(msgType))
+  {
+    MessagePtr msg = msgs::MsgFactory::NewMsg(msgType);
+    if (msg && msg->ParseFromString(_data))
+    {
+      this->KeepPending(msg);
+      return;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(this->qosMutex);
+  this->hasPending = true;
+  this->pendingMsg.reset();
+  this->pendingData = _data;
+}
+
+/////////////////////////////////////////////////
+void CallbackHelper::KeepPending(MessagePtr _msg)
+{
+  const MergeFunction merge =
+    _msg ? MergeFunctionOf(_msg->GetTypeName()) : MergeFunction();
+
+  std::lock_guard<std::mutex> lock(this->qosMutex);
+  if (merge && this->hasPending)
+  {
+    MessagePtr older = this->pendingMsg;
+    if (!older)
+    {
+      older.reset(_msg->New());
+      if (!older->ParseFromString(this->pendingData))
+        older.reset();
+    }
+
+    // The message may be shared with other subscribers.
+    if (older)
+    {
+      MessagePtr merged(_msg->New());
+      merged->CopyFrom(*_msg);
+      merge(*older, *merged);
+      _msg = merged;
+    }
+  }
+
+  this->hasPending = true;
+  this->pendingMsg = _msg;
+  this->pendingData.clear();
+}
+
+/////////////////////////////////////////////////
+void CallbackHelper::SetMergeFunction(const std::string &_msgType,
+    const MergeFunction &_merge)
+{
+  std::lock_guard<std::mutex> lock(g_mergesMutex);
+  if (_merge)
+    g_merges[_msgType] = _merge;
+  else
+    g_merges.erase(_msgType);
+}
+
+/////////////////////////////////////////////////
+bool CallbackHelper::Merges(const std::string &_msgType)
+{
+  return static_cast<bool>(MergeFunctionOf(_msgType));
+}
+
+/////////////////////////////////////////////////
+bool CallbackHelper::MergesPending() const
+{
+  return this->MaxRate() > 0 && Merges(this->GetMsgType());
+}
+
+/////////////////////////////////////////////////
+bool CallbackHelper::HasPending(common::Time &_due) const
+{
+  std::lock_guard<std::mutex> lock(this->qosMutex);
+  if (!this->hasPending)
+    return false;
+
+  _due = this->lastDelivery;
+  if (this->maxRate > 0)
+    _due += common::Time(1.0 / this->maxRate);
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool CallbackHelper::TakePending(MessagePtr &_msg, std::string &_data)
+{
+  std::lock_guard<std::mutex> lock(this->qosMutex);
+  if (!this->hasPending)
+    return false;
+
+  const common::Time now = common::Time::GetWallTime();
+  if (this->maxRate > 0 && this->lastDelivery != common::Time::Zero &&
+      (now - this->lastDelivery).Double() < 1.0 / this->maxRate)
+  {
+    return false;
+  }
+
+  this->lastDelivery = now;
+  this->hasPending = false;
+  _msg = this->pendingMsg;
+  this->pendingMsg.reset();
+  _data.swap(this->pendingData);
+  this->pendingData.clear();
+  return true;
+}
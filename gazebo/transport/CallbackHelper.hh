@@ -21,6 +21,7 @@
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <functional>
 #include <vector>
 #include <string>
 #include <mutex>
@@ -28,6 +29,7 @@
 #include "gazebo/common/Console.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/Time.hh"
 
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/util/system.hh"
@@ -43,6 +45,15 @@ namespace gazebo
     /// \brief A helper class to handle callbacks when messages arrive
     class GZ_TRANSPORT_VISIBLE CallbackHelper
     {
+      /// \brief Function that merges a message held back by the maximum
+      /// rate into a newer message of the same type.
+      /// \param[in] _older The message held back.
+      /// \param[in,out] _newer The newer message, which gets the content of
+      /// _older it does not override.
+      public: typedef std::function<void(
+                  const google::protobuf::Message &_older,
+                  google::protobuf::Message &_newer)> MergeFunction;
+
       /// \brief Constructor
       /// \param[in] _latching Set to true to make the callback helper
       /// latching.
@@ -87,6 +98,94 @@ namespace gazebo
       /// \return The unique ID of this callback.
       public: unsigned int GetId() const;
 
+      /// \brief Set the quality of service of the callback.
+      /// \param[in] _maxRate Maximum rate of messages, in Hz. 0 for no
+      /// limit.
+      /// \param[in] _depth Number of queued messages to keep, the oldest
+      /// are dropped. 0 to keep all the messages.
+      /// \param[in] _reliability Whether every message is needed.
+      public: void SetQoS(const double _maxRate, const unsigned int _depth,
+                  const Reliability _reliability);
+
+      /// \brief Get the maximum rate of messages.
+      /// \return Rate in Hz, 0 if there is no limit.
+      public: double MaxRate() const;
+
+      /// \brief Get the number of queued messages to keep.
+      /// \return Depth, 0 if all the messages are kept.
+      public: unsigned int Depth() const;
+
+      /// \brief Get whether every message is needed.
+      /// \return The reliability, RELIABLE by default.
+      public: Reliability GetReliability() const;
+
+      /// \brief Get which of a number of queued messages to deliver. With
+      /// a maximum rate, only the latest message is delivered, if the
+      /// period since the last delivery has elapsed. Otherwise it should be
+      /// kept with KeepPending. None is delivered if the messages are
+      /// merged, they should all be kept, see MergesPending. Without a
+      /// maximum rate, the last Depth() messages are delivered.
+      /// \param[in] _count Number of queued messages.
+      /// \return Index of the first message to deliver, _count if none.
+      public: std::size_t FirstDelivered(const std::size_t _count);
+
+      /// \brief Keep the latest message held back by the maximum rate, to
+      /// deliver it once the period has elapsed. It replaces the message
+      /// kept before, and is dropped if a newer message is delivered first.
+      /// Messages of a type that has a merge function are merged with the
+      /// message kept before instead, see SetMergeFunction.
+      /// \param[in] _data The serialized message.
+      public: void KeepPending(const std::string &_data);
+
+      /// \brief Keep the latest message held back by the maximum rate.
+      /// \param[in] _msg The message.
+      /// \sa KeepPending(const std::string &)
+      public: void KeepPending(MessagePtr _msg);
+
+      /// \brief Set how the messages of a type are merged while a callback
+      /// with a maximum rate holds them back, for messages that only carry
+      /// changes. The callbacks then get every message of the type through
+      /// KeepPending and TakePending, and none of the changes is lost.
+      /// msgs::PosesStamped, which only carries the poses that changed, is
+      /// merged by pose id by default. This can be called from any thread.
+      /// \param[in] _msgType Type name of the messages.
+      /// \param[in] _merge The merge function, empty to keep only the
+      /// latest message again.
+      public: static void SetMergeFunction(const std::string &_msgType,
+                  const MergeFunction &_merge);
+
+      /// \brief Get whether the messages of a type are merged while held
+      /// back.
+      /// \param[in] _msgType Type name of the messages.
+      /// \return True if the type has a merge function.
+      /// \sa SetMergeFunction
+      public: static bool Merges(const std::string &_msgType);
+
+      /// \brief Get whether the messages of this callback are merged while
+      /// held back: it has a maximum rate, and its message type has a merge
+      /// function.
+      /// \return True if the messages are merged.
+      public: bool MergesPending() const;
+
+      /// \brief Get whether a message is kept, and when it is due.
+      /// \param[out] _due Wall time at which the message can be delivered.
+      /// \return True if a message is kept.
+      public: bool HasPending(common::Time &_due) const;
+
+      /// \brief Take the kept message, and record a delivery, if the period
+      /// since the last delivery has elapsed.
+      /// \param[out] _msg The message, if it was kept as a message.
+      /// \param[out] _data The serialized message, if it was kept
+      /// serialized.
+      /// \return True if a message was taken.
+      public: bool TakePending(MessagePtr &_msg, std::string &_data);
+
+      /// \brief Check the maximum rate, and record a delivery if the
+      /// period since the last delivery has elapsed. A delivery drops the
+      /// kept message.
+      /// \return True if a message can be delivered.
+      protected: bool RateReady();
+
       /// \brief True means that the callback helper will get the last
       /// published message on the topic.
       protected: bool latching;
@@ -94,6 +193,30 @@ namespace gazebo
       /// \brief Mutex to protect the latching variable.
       protected: mutable std::mutex latchingMutex;
 
+      /// \brief Maximum rate of messages, 0 for no limit.
+      private: double maxRate = 0;
+
+      /// \brief Number of queued messages to keep, 0 to keep all.
+      private: unsigned int depth = 0;
+
+      /// \brief Whether every message is needed.
+      private: Reliability reliability = Reliability::RELIABLE;
+
+      /// \brief Wall time of the last delivery, used with maxRate.
+      private: common::Time lastDelivery;
+
+      /// \brief True if a message held back by maxRate is kept.
+      private: bool hasPending = false;
+
+      /// \brief Message held back by maxRate, if kept as a message.
+      private: MessagePtr pendingMsg;
+
+      /// \brief Message held back by maxRate, if kept serialized.
+      private: std::string pendingData;
+
+      /// \brief Mutex to protect the quality of service.
+      private: mutable std::mutex qosMutex;
+
       /// \brief A counter to generate the unique id of this callback.
       private: static unsigned int idCounter;
 
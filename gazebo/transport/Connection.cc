@@ -57,8 +57,8 @@
 #include "gazebo/msgs/msgs.hh"
 
 #include "gazebo/transport/IOManager.hh"
-#include "gazebo/transport/ConnectionManager.hh"
 #include "gazebo/transport/Connection.hh"
+#include "gazebo/transport/ShmRing.hh"
 
 using namespace gazebo;
 using namespace transport;
@@ -68,6 +68,10 @@ extern void dummy_callback_fn(uint32_t);
 unsigned int Connection::idCounter = 0;
 IOManager *Connection::iomanager = NULL;
 
+/// \brief Size of the shared memory ring of same host connections. Larger
+/// messages go through the socket.
+static const std::size_t kShmRingCapacity = 8 * 1024 * 1024;
+
 // Version 1.52 of boost has an address::is_unspecfied function, but
 // Version 1.46.1 (installed on ubuntu) does not. So this helper function
 // is stolen from adress::is_unspecified function in boost v1.52.
@@ -298,7 +302,7 @@ void Connection::EnqueueMsg(const std::string &_buffer, bool _force)
 
 //////////////////////////////////////////////////
 void Connection::EnqueueMsg(const std::string &_buffer,
-    boost::function<void(uint32_t)> _cb, uint32_t _id, bool _force)
+    boost::function<void(uint32_t)> _cb, uint32_t _id, bool /*_force*/)
 {
   // Don't enqueue empty messages
   if (_buffer.empty() || !this->IsOpen())
@@ -312,24 +316,33 @@ void Connection::EnqueueMsg(const std::string &_buffer,
   {
     boost::recursive_mutex::scoped_lock lock(this->writeMutex);
 
+    // Messages to a same host connection are written to shared memory, and
+    // the socket only carries their header, in order with the others.
+    std::string msg;
+    if (this->shmWrite && _buffer.size() < HEADER_SHM_FLAG &&
+        this->shmRing->Write(_buffer.data(), _buffer.size()))
+    {
+      snprintf(this->headerBuffer, HEADER_LENGTH + 1, "%08x",
+          static_cast<unsigned int>(_buffer.size()) | HEADER_SHM_FLAG);
+      msg = this->headerBuffer;
+    }
+    else
+    {
+      msg = std::string(this->headerBuffer) + _buffer;
+    }
+
     if (this->writeQueue.empty() ||
         (this->writeCount > 0 && this->writeQueue.size() == 1) ||
-        (this->writeQueue.back().size()+_buffer.size() > 4096))
-      this->writeQueue.push_back(std::string(headerBuffer) + _buffer);
+        (this->writeQueue.back().size() + msg.size() > 4096))
+      this->writeQueue.push_back(msg);
     else
-      this->writeQueue.back() += std::string(headerBuffer) + _buffer;
+      this->writeQueue.back() += msg;
     this->callbacks.push_back(std::make_pair(_cb, _id));
   }
 
-  if (_force)
-  {
-    this->ProcessWriteQueue();
-  }
-  else
-  {
-    // Tell the connection manager that it needs to update
-    ConnectionManager::Instance()->TriggerUpdate();
-  }
+  // Start writing right away if the socket is idle. Otherwise the write
+  // in progress starts the next one when it completes, see OnWrite.
+  this->ProcessWriteQueue();
 }
 
 /////////////////////////////////////////////////
@@ -385,6 +398,13 @@ void Connection::ProcessWriteQueue(bool _blocking)
   }
 }
 
+//////////////////////////////////////////////////
+std::size_t Connection::GetWriteQueueSize() const
+{
+  boost::recursive_mutex::scoped_lock lock(this->writeMutex);
+  return this->writeQueue.size();
+}
+
 //////////////////////////////////////////////////
 std::string Connection::GetLocalURI() const
 {
@@ -423,6 +443,11 @@ void Connection::OnWrite(const boost::system::error_code &_e)
     // It will reach this point if the remote connection disconnects.
     this->Shutdown();
   }
+  else
+  {
+    // Write the messages that were enqueued during this write.
+    this->ProcessWriteQueue();
+  }
 }
 
 //////////////////////////////////////////////////
@@ -639,6 +664,14 @@ std::size_t Connection::ParseHeader(const std::string &header)
   return data_size;
 }
 
+//////////////////////////////////////////////////
+bool Connection::ReadSharedMemory(const std::size_t _size, std::string &_data)
+{
+  boost::recursive_mutex::scoped_lock lock(this->readMutex);
+  return this->shmRing && !this->shmWrite && this->shmRing->Read(_data) &&
+      _data.size() == _size;
+}
+
 //////////////////////////////////////////////////
 void Connection::ReadLoop(const ReadCallback &cb)
 {
@@ -938,6 +971,69 @@ std::string Connection::GetLocalHostname()
   return GetHostname(GetLocalEndpoint());
 }
 
+//////////////////////////////////////////////////
+bool Connection::IsSameHost() const
+{
+  boost::mutex::scoped_lock lock(this->socketMutex);
+  if (!this->socket || !this->socket->is_open())
+    return false;
+
+  boost::system::error_code ec;
+  boost::asio::ip::tcp::endpoint local = this->socket->local_endpoint(ec);
+  if (ec)
+    return false;
+  boost::asio::ip::tcp::endpoint remote = this->socket->remote_endpoint(ec);
+  if (ec)
+    return false;
+
+  return remote.address() == local.address() ||
+    (remote.address().is_v4() && addressIsLoopback(remote.address().to_v4()));
+}
+
+//////////////////////////////////////////////////
+bool Connection::CreateSharedMemory()
+{
+  const char *env = getenv("GAZEBO_SHM_TRANSPORT");
+  if (env && std::string(env) == "0")
+    return false;
+
+  boost::recursive_mutex::scoped_lock lock(this->readMutex);
+  std::unique_ptr<ShmRing> ring(new ShmRing());
+  if (!ring->Create(kShmRingCapacity))
+    return false;
+
+  this->shmRing = std::move(ring);
+  this->shmWrite = false;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Connection::AttachSharedMemory(const std::string &_name)
+{
+  const char *env = getenv("GAZEBO_SHM_TRANSPORT");
+  if (env && std::string(env) == "0")
+    return false;
+
+  boost::recursive_mutex::scoped_lock lock(this->writeMutex);
+  std::unique_ptr<ShmRing> ring(new ShmRing());
+  if (!ring->Open(_name))
+  {
+    gzlog << "Unable to attach to shared memory[" << _name
+          << "], using the socket" << std::endl;
+    return false;
+  }
+
+  this->shmRing = std::move(ring);
+  this->shmWrite = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::string Connection::GetSharedMemoryName() const
+{
+  return this->shmRing ? this->shmRing->Name() : std::string();
+}
+
 //////////////////////////////////////////////////
 void Connection::OnConnect(const boost::system::error_code &_error,
     boost::asio::ip::tcp::resolver::iterator /*_endPointIter*/)
@@ -31,6 +31,7 @@
 #include <iostream>
 #include <iomanip>
 #include <deque>
+#include <memory>
 #include <utility>
 
 #include "gazebo/common/Event.hh"
@@ -40,6 +41,10 @@
 
 #define HEADER_LENGTH 8
 
+/// \brief Flag set in the size of a header when the message is in the
+/// shared memory of the connection rather than in the socket.
+#define HEADER_SHM_FLAG 0x80000000u
+
 namespace gazebo
 {
   namespace transport
@@ -47,6 +52,7 @@ namespace gazebo
     extern GZ_TRANSPORT_VISIBLE bool is_stopped();
 
     class IOManager;
+    class ShmRing;
     class Connection;
     typedef boost::shared_ptr<Connection> ConnectionPtr;
 
@@ -94,6 +100,9 @@ namespace gazebo
     /// IP lookup.
     ///   - GAZEBO_HOSTNAME: Hostame to export. Setting this will override
     /// both GAZEBO_IP and the default IP lookup.
+    ///   - GAZEBO_SHM_TRANSPORT: Set to 0 to send all the messages between
+    /// processes of the same host through sockets, rather than shared
+    /// memory.
     ///
     /// \class Connection Connection.hh transport/transport.hh
     /// \brief Single TCP/IP connection manager
@@ -152,8 +161,8 @@ namespace gazebo
 
       /// \brief Write data to the socket
       /// \param[in] _buffer Data to write
-      /// \param[in] _force If true, block until the data has been written
-      /// to the socket, otherwise just enqueue the data for asynchronous write
+      /// \param[in] _force Unused, the data is always written
+      /// asynchronously as soon as the socket is available.
       /// \param[in] _cb If non-null, callback to be invoked after
       /// transmission is complete.
       /// \param[in] _id ID associated with the message data.
@@ -163,8 +172,8 @@ namespace gazebo
 
       /// \brief Write data to the socket
       /// \param[in] _buffer Data to write
-      /// \param[in] _force If true, block until the data has been written
-      /// to the socket, otherwise just enqueue the data for asynchronous write
+      /// \param[in] _force Unused, the data is always written
+      /// asynchronously as soon as the socket is available.
       public: void EnqueueMsg(const std::string &_buffer, bool _force = false);
 
       /// \brief Get the local URI
@@ -199,6 +208,32 @@ namespace gazebo
       /// \return The local hostname
       public: static std::string GetLocalHostname();
 
+      /// \brief Get whether both ends of the connection are on the same
+      /// host, which is the case if the socket is connected to one of the
+      /// addresses of the host, or to a loopback address.
+      /// \return True if the remote end is on this host.
+      public: bool IsSameHost() const;
+
+      /// \brief Create a shared memory ring to receive the messages of the
+      /// remote end, which has to attach to it with AttachSharedMemory.
+      /// Until then, messages keep coming through the socket. Does nothing
+      /// if GAZEBO_SHM_TRANSPORT is 0.
+      /// \return True if the ring was created.
+      public: bool CreateSharedMemory();
+
+      /// \brief Attach to the shared memory ring created by the remote end
+      /// of a same host connection. The payload of the messages enqueued
+      /// from then on is written to the ring, and the socket only carries
+      /// their headers. A message that does not fit in the ring is sent
+      /// through the socket.
+      /// \param[in] _name Name of the ring, see GetSharedMemoryName.
+      /// \return True if the ring was found.
+      public: bool AttachSharedMemory(const std::string &_name);
+
+      /// \brief Get the name of the shared memory ring of the connection.
+      /// \return The name, empty if the connection has no ring.
+      public: std::string GetSharedMemoryName() const;
+
       /// \brief Peform an asyncronous read
       /// param[in] _handler Callback to invoke on received data
       public: template<typename Handler>
@@ -247,7 +282,26 @@ namespace gazebo
 
                   inboundData_size = this->ParseHeader(header);
 
-                 if (inboundData_size > 0)
+                  if (inboundData_size & HEADER_SHM_FLAG)
+                  {
+                    // The payload is in shared memory, and the socket only
+                    // carries the header.
+                    std::string data;
+                    if (!this->ReadSharedMemory(
+                          inboundData_size & ~HEADER_SHM_FLAG, data))
+                    {
+                      gzerr << "Missing message in shared memory\n";
+                      boost::get<0>(_handler)("");
+                    }
+                    else if (!transport::is_stopped())
+                    {
+                      ConnectionReadTask *task =
+                        new(tbb::task::allocate_root())
+                        ConnectionReadTask(boost::get<0>(_handler), data);
+                      tbb::task::enqueue(*task);
+                    }
+                  }
+                  else if (inboundData_size > 0)
                   {
                     // Start the asynchronous call to receive data
                     this->inboundData.resize(inboundData_size);
@@ -332,6 +386,11 @@ namespace gazebo
       /// \return The connection's unique ID.
       public: unsigned int GetId() const;
 
+      /// \brief Get the number of buffers waiting to be written, including
+      /// the one being written. Small messages share buffers.
+      /// \return Number of buffers.
+      public: std::size_t GetWriteQueueSize() const;
+
       /// \brief Return true if the _ip is a valid.
       /// \param[in] _ip Dotted quad to validate.
       /// \return True if the _ip is a valid.
@@ -355,6 +414,13 @@ namespace gazebo
       /// \param[in] _header Header as a string
       private: std::size_t ParseHeader(const std::string &_header);
 
+      /// \brief Read the next message from the shared memory ring.
+      /// \param[in] _size Size of the message, from its header.
+      /// \param[out] _data The message.
+      /// \return False if the ring has no message of this size.
+      private: bool ReadSharedMemory(const std::size_t _size,
+                   std::string &_data);
+
       /// \brief the read thread
       private: void ReadLoop(const ReadCallback &_cb);
 
@@ -395,7 +461,7 @@ namespace gazebo
       private: boost::mutex connectMutex;
 
       /// \brief Mutex to protect write.
-      private: boost::recursive_mutex writeMutex;
+      private: mutable boost::recursive_mutex writeMutex;
 
       /// \brief Mutex to protect reads.
       private: boost::recursive_mutex readMutex;
@@ -466,6 +532,14 @@ namespace gazebo
 
       /// \brief True if the connection is open.
       private: bool isOpen;
+
+      /// \brief Shared memory ring of a same host connection, to read from
+      /// if created by CreateSharedMemory, or to write to if attached by
+      /// AttachSharedMemory.
+      private: std::unique_ptr<ShmRing> shmRing;
+
+      /// \brief True if shmRing was attached, to write to.
+      private: bool shmWrite = false;
     };
     /// \}
   }
@@ -20,6 +20,9 @@
   #include <Winsock2.h>
 #endif
 
+#include <algorithm>
+#include <cmath>
+
 #include <boost/bind.hpp>
 
 #include "gazebo/msgs/msgs.hh"
@@ -33,17 +36,6 @@
 using namespace gazebo;
 using namespace transport;
 
-/// TBB task to process nodes.
-class TopicManagerProcessTask : public tbb::task
-{
-  /// Implements the necessary execute function
-  public: tbb::task *execute()
-          {
-            TopicManager::Instance()->ProcessNodes();
-            return NULL;
-          }
-};
-
 /// TBB task to establish subscriber to publisher connection.
 class TopicManagerConnectionTask : public tbb::task
 {
@@ -244,7 +236,7 @@ void ConnectionManager::Fini()
 void ConnectionManager::Stop()
 {
   this->stop = true;
-  this->updateCondition.notify_all();
+  this->TriggerUpdate();
   if (this->initialized)
     while (this->stopped == false)
       common::Time::MSleep(100);
@@ -272,15 +264,10 @@ void ConnectionManager::RunUpdate()
     }
   }
 
-  if (this->masterConn)
-    this->masterConn->ProcessWriteQueue();
-
-  // Use TBB to process nodes. Need more testing to see if this makes
-  // a difference.
-  // TopicManagerProcessTask *task = new(tbb::task::allocate_root())
-  //   TopicManagerProcessTask();
-  // tbb::task::enqueue(*task);
   TopicManager::Instance()->ProcessNodes();
+
+  // Outgoing messages are written by the connections as soon as they are
+  // enqueued, only closed connections are left to remove.
   {
     boost::recursive_mutex::scoped_lock lock(this->connectionMutex);
     iter = this->connections.begin();
@@ -290,10 +277,7 @@ void ConnectionManager::RunUpdate()
   while (iter != endIter)
   {
     if ((*iter)->IsOpen())
-    {
-      (*iter)->ProcessWriteQueue();
       ++iter;
-    }
     else
     {
       boost::recursive_mutex::scoped_lock lock(this->connectionMutex);
@@ -311,10 +295,31 @@ void ConnectionManager::Run()
 
   while (!this->stop && this->masterConn && this->masterConn->IsOpen())
   {
+    // Updates triggered while running are not lost: the flag is set again,
+    // and the next update starts without waiting. The timeout only bounds
+    // the time before noticing a closed master connection.
+    this->updatePending = false;
+    this->nextUpdate = common::Time::Zero;
+    lock.unlock();
     this->RunUpdate();
-    this->updateCondition.timed_wait(lock,
-       boost::posix_time::milliseconds(100));
+    lock.lock();
+
+    if (!this->updatePending && !this->stop)
+    {
+      // Wake up earlier if an update was requested for a given time.
+      int timeout = 100;
+      if (this->nextUpdate != common::Time::Zero)
+      {
+        const double ms = (this->nextUpdate -
+            common::Time::GetWallTime()).Double() * 1000.0;
+        timeout = std::max(0, std::min(timeout,
+              static_cast<int>(std::ceil(ms))));
+      }
+      this->updateCondition.timed_wait(lock,
+         boost::posix_time::milliseconds(timeout));
+    }
   }
+  lock.unlock();
   this->RunUpdate();
 
   this->stopped = true;
@@ -482,18 +487,55 @@ void ConnectionManager::OnRead(ConnectionPtr _connection,
     msgs::Subscribe sub;
     sub.ParseFromString(packet.serialized_data());
 
+    // Send the messages through the shared memory of a same host subscriber
+    if (sub.has_shm_name() && _connection->IsSameHost())
+      _connection->AttachSharedMemory(sub.shm_name());
+
     // Create a transport link for the publisher to the remote subscriber
     // via the connection
     SubscriptionTransportPtr subLink(new SubscriptionTransport());
-    subLink->Init(_connection, sub.latching());
+    subLink->Init(_connection, sub.latching(), sub.batching());
+    subLink->SetQoS(sub.max_rate(), 0, sub.best_effort() ?
+        Reliability::BEST_EFFORT : Reliability::RELIABLE);
 
     // Connect the publisher to this transport mechanism
     TopicManager::Instance()->ConnectPubToSub(sub.topic(), subLink);
+
+    // The subscriber sends the subscription again when its quality of
+    // service changes.
+    _connection->AsyncRead(boost::bind(&ConnectionManager::OnSubscriptionRead,
+          this, boost::weak_ptr<SubscriptionTransport>(subLink), _1));
   }
   else
     gzerr << "Error est here\n";
 }
 
+//////////////////////////////////////////////////
+void ConnectionManager::OnSubscriptionRead(
+    boost::weak_ptr<SubscriptionTransport> _subLink, const std::string &_data)
+{
+  SubscriptionTransportPtr subLink = _subLink.lock();
+  if (!subLink || !subLink->GetConnection())
+    return;
+
+  msgs::Packet packet;
+  if (!_data.empty() && packet.ParseFromString(_data) &&
+      packet.type() == "sub")
+  {
+    msgs::Subscribe sub;
+    sub.ParseFromString(packet.serialized_data());
+    subLink->SetQoS(sub.max_rate(), 0, sub.best_effort() ?
+        Reliability::BEST_EFFORT : Reliability::RELIABLE);
+  }
+
+  ConnectionPtr conn = subLink->GetConnection();
+  if (conn->IsOpen())
+  {
+    conn->AsyncRead(boost::bind(&ConnectionManager::OnSubscriptionRead,
+          this, _subLink, _1));
+  }
+}
+
 //////////////////////////////////////////////////
 void ConnectionManager::Advertise(const std::string &topic,
                                   const std::string &msgType)
@@ -645,6 +687,11 @@ ConnectionPtr ConnectionManager::ConnectToRemoteHost(const std::string &_host,
     conn.reset(new Connection());
     if (conn->Connect(_host, _port))
     {
+      // Offer the remote host a shared memory ring to send messages
+      // through, see PublicationTransport::Init.
+      if (conn->IsSameHost())
+        conn->CreateSharedMemory();
+
       boost::recursive_mutex::scoped_lock lock(this->connectionMutex);
       this->connections.push_back(conn);
     }
@@ -701,5 +748,27 @@ ConnectionPtr ConnectionManager::FindConnection(const std::string &_host,
 //////////////////////////////////////////////////
 void ConnectionManager::TriggerUpdate()
 {
+  {
+    boost::mutex::scoped_lock lock(this->updateMutex);
+    this->updatePending = true;
+  }
+  this->updateCondition.notify_all();
+}
+
+//////////////////////////////////////////////////
+void ConnectionManager::TriggerUpdateAt(const common::Time &_wallTime)
+{
+  {
+    boost::mutex::scoped_lock lock(this->updateMutex);
+    if (this->nextUpdate != common::Time::Zero &&
+        this->nextUpdate <= _wallTime)
+    {
+      return;
+    }
+    this->nextUpdate = _wallTime;
+  }
+
+  // Only wakes up the manager if it is waiting. Otherwise the time is used
+  // once the current update completes.
   this->updateCondition.notify_all();
 }
@@ -19,6 +19,7 @@
 
 
 #include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
 #include <boost/interprocess/sync/interprocess_semaphore.hpp>
 #include <string>
 #include <list>
@@ -26,6 +27,7 @@
 
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/common/SingletonT.hh"
+#include "gazebo/common/Time.hh"
 
 #include "gazebo/transport/Publisher.hh"
 #include "gazebo/transport/Connection.hh"
@@ -133,8 +135,17 @@ namespace gazebo
                                                   unsigned int _port);
 
       /// \brief Inform the connection manager that it needs an update.
+      /// The update runs immediately if the manager is idle, otherwise as
+      /// soon as the current update completes.
       public: void TriggerUpdate();
 
+      /// \brief Inform the connection manager that it needs an update at a
+      /// wall time, such as when a message held back by the maximum rate
+      /// of a subscriber is due. Only the earliest time is kept, until the
+      /// next update starts.
+      /// \param[in] _wallTime Wall time of the update.
+      public: void TriggerUpdateAt(const common::Time &_wallTime);
+
       /// \brief Callback function called when we have read data from the
       /// master
       /// \param[in] _data String of incoming data
@@ -150,6 +161,15 @@ namespace gazebo
       private: void OnRead(ConnectionPtr _newConnection,
                            const std::string &_data);
 
+      /// \brief Callback function called when a subscription is read from
+      /// a connection that was already subscribed, to update its quality of
+      /// service.
+      /// \param[in] _subLink The subscription of the connection.
+      /// \param[in] _data Data that has been read.
+      private: void OnSubscriptionRead(
+                   boost::weak_ptr<SubscriptionTransport> _subLink,
+                   const std::string &_data);
+
       /// \brief Process a raw message.
       /// \param[in] _packet The raw message data.
       private: void ProcessMessage(const std::string &_packet);
@@ -160,9 +180,17 @@ namespace gazebo
       /// \brief Condition used to trigger an update.
       private: boost::condition_variable updateCondition;
 
-      /// \brief Mutex for updateCondition
+      /// \brief Mutex for updateCondition and updatePending
       private: boost::mutex updateMutex;
 
+      /// \brief True if an update was triggered since the last update
+      /// started.
+      private: bool updatePending = false;
+
+      /// \brief Wall time of the next update requested with
+      /// TriggerUpdateAt, zero if there is none.
+      private: common::Time nextUpdate;
+
       private: ConnectionPtr masterConn;
       private: Connection *serverConn;
 
@@ -14,6 +14,8 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <cstdlib>
 #include <boost/bind.hpp>
 #include <iostream>
 #include "gazebo/transport/IOManager.hh"
@@ -21,14 +23,33 @@
 using namespace gazebo;
 using namespace transport;
 
+/// \brief Default number of threads running the IO service.
+static const unsigned int kDefaultIOThreads = 2;
+
+/// \brief Maximum number of threads running the IO service.
+static const unsigned int kMaxIOThreads = 64;
+
 /////////////////////////////////////////////////
 IOManager::IOManager()
   : count(0)
 {
   this->io_service = new boost::asio::io_service;
   this->work = new boost::asio::io_service::work(*this->io_service);
-  this->thread = new boost::thread(boost::bind(&boost::asio::io_service::run,
-                                                this->io_service));
+
+  unsigned int threadCount = kDefaultIOThreads;
+  const char *env = std::getenv("GAZEBO_IO_THREADS");
+  if (env)
+  {
+    const int value = std::atoi(env);
+    if (value > 0)
+      threadCount = std::min(static_cast<unsigned int>(value), kMaxIOThreads);
+  }
+
+  for (unsigned int i = 0; i < threadCount; ++i)
+  {
+    this->threads.push_back(new boost::thread(
+          boost::bind(&boost::asio::io_service::run, this->io_service)));
+  }
 }
 
 /////////////////////////////////////////////////
@@ -48,12 +69,12 @@ void IOManager::Stop()
 {
   this->io_service->reset();
   this->io_service->stop();
-  if (this->thread)
+  for (auto thread : this->threads)
   {
-    this->thread->join();
-    delete this->thread;
-    this->thread = NULL;
+    thread->join();
+    delete thread;
   }
+  this->threads.clear();
 }
 
 /////////////////////////////////////////////////
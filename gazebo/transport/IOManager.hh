@@ -17,6 +17,8 @@
 #ifndef _IOMANAGER_HH_
 #define _IOMANAGER_HH_
 
+#include <atomic>
+#include <vector>
 #include <boost/thread/thread.hpp>
 #include <boost/asio.hpp>
 #include "gazebo/util/system.hh"
@@ -30,6 +32,10 @@ namespace gazebo
 
     /// \class IOManager IOManager.hh transport/transport.hh
     /// \brief Manages boost::asio IO
+    ///
+    /// The IO service runs on several threads, so that a slow handler on one
+    /// connection does not delay the others. The number of threads is read
+    /// from the GAZEBO_IO_THREADS environment variable, and defaults to 2.
     class GZ_TRANSPORT_VISIBLE IOManager
     {
       /// \brief Constructor
@@ -58,9 +64,10 @@ namespace gazebo
 
       // Use io_service::work to keep the io_service running in thread
       private: boost::asio::io_service::work *work;
-      private: unsigned int count;
+      private: std::atomic<unsigned int> count;
 
-      private: boost::thread *thread;
+      /// \brief Threads running the IO service.
+      private: std::vector<boost::thread *> threads;
     };
     /// \}
   }
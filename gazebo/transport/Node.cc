@@ -21,6 +21,8 @@
   #include <Winsock2.h>
 #endif
 
+#include <algorithm>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/bind.hpp>
 #include "gazebo/transport/TransportIface.hh"
@@ -73,6 +75,7 @@ void Node::Fini()
   {
     boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
     this->callbacks.clear();
+    this->pendingCallbacks.clear();
   }
 }
 
@@ -164,7 +167,17 @@ void Node::ProcessPublishers()
 bool Node::HandleData(const std::string &_topic, const std::string &_msg)
 {
   boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-  this->incomingMsgs[_topic].push_back(_msg);
+  std::list<std::string> &msgs = this->incomingMsgs[_topic];
+  msgs.push_back(_msg);
+
+  std::map<std::string, unsigned int>::const_iterator depthIter =
+    this->incomingDepths.find(_topic);
+  if (depthIter != this->incomingDepths.end())
+  {
+    while (msgs.size() > depthIter->second)
+      msgs.pop_front();
+  }
+
   ConnectionManager::Instance()->TriggerUpdate();
   return true;
 }
@@ -173,7 +186,17 @@ bool Node::HandleData(const std::string &_topic, const std::string &_msg)
 bool Node::HandleMessage(const std::string &_topic, MessagePtr _msg)
 {
   boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-  this->incomingMsgsLocal[_topic].push_back(_msg);
+  std::list<MessagePtr> &msgs = this->incomingMsgsLocal[_topic];
+  msgs.push_back(_msg);
+
+  std::map<std::string, unsigned int>::const_iterator depthIter =
+    this->incomingDepths.find(_topic);
+  if (depthIter != this->incomingDepths.end())
+  {
+    while (msgs.size() > depthIter->second)
+      msgs.pop_front();
+  }
+
   ConnectionManager::Instance()->TriggerUpdate();
   return true;
 }
@@ -184,12 +207,16 @@ void Node::ProcessIncoming()
   boost::recursive_mutex::scoped_lock lock(this->processIncomingMutex);
 
   if (!this->initialized ||
-      (this->incomingMsgs.empty() && this->incomingMsgsLocal.empty()))
+      (this->incomingMsgs.empty() && this->incomingMsgsLocal.empty() &&
+       this->pendingCallbacks.empty()))
     return;
 
   Callback_M::iterator cbIter;
   Callback_L::iterator liter;
 
+  // Index of the first message delivered to each callback of a topic
+  std::vector<std::size_t> first;
+
   // For each topic
   {
     std::list<std::string>::iterator msgIter;
@@ -212,15 +239,46 @@ void Node::ProcessIncoming()
         msgInIter = inIter->second.begin();
         msgEndIter = inIter->second.end();
 
+        // The quality of service of each callback selects the latest
+        // messages it gets.
+        first.clear();
+        for (liter = cbIter->second.begin();
+            liter != cbIter->second.end(); ++liter)
+        {
+          first.push_back((*liter)->FirstDelivered(inIter->second.size()));
+
+          // Keep the latest message held back by the maximum rate, or
+          // all of them if they are merged.
+          if (first.back() == inIter->second.size() &&
+              (*liter)->MaxRate() > 0)
+          {
+            if ((*liter)->MergesPending())
+            {
+              for (auto const &msg : inIter->second)
+                (*liter)->KeepPending(msg);
+            }
+            else
+            {
+              (*liter)->KeepPending(inIter->second.back());
+            }
+            this->pendingCallbacks.insert(*liter);
+          }
+        }
+
         // For each message in the buffer
-        for (msgIter = msgInIter; msgIter != msgEndIter; ++msgIter)
+        std::size_t index = 0;
+        for (msgIter = msgInIter; msgIter != msgEndIter; ++msgIter, ++index)
         {
           // Send the message to all callbacks
+          std::vector<std::size_t>::const_iterator firstIter = first.begin();
           for (liter = cbIter->second.begin();
-              liter != cbIter->second.end(); ++liter)
+              liter != cbIter->second.end(); ++liter, ++firstIter)
           {
-            (*liter)->HandleData(*msgIter,
-                boost::bind(&dummy_callback_fn, _1), 0);
+            if (index >= *firstIter)
+            {
+              (*liter)->HandleData(*msgIter,
+                  boost::bind(&dummy_callback_fn, _1), 0);
+            }
           }
         }
       }
@@ -250,14 +308,41 @@ void Node::ProcessIncoming()
         msgInIter = inIter->second.begin();
         msgEndIter = inIter->second.end();
 
+        first.clear();
+        for (liter = cbIter->second.begin();
+            liter != cbIter->second.end(); ++liter)
+        {
+          first.push_back((*liter)->FirstDelivered(inIter->second.size()));
+
+          // Keep the latest message held back by the maximum rate, or
+          // all of them if they are merged.
+          if (first.back() == inIter->second.size() &&
+              (*liter)->MaxRate() > 0)
+          {
+            if ((*liter)->MergesPending())
+            {
+              for (auto const &msg : inIter->second)
+                (*liter)->KeepPending(msg);
+            }
+            else
+            {
+              (*liter)->KeepPending(inIter->second.back());
+            }
+            this->pendingCallbacks.insert(*liter);
+          }
+        }
+
         // For each message in the buffer
-        for (msgIter = msgInIter; msgIter != msgEndIter; ++msgIter)
+        std::size_t index = 0;
+        for (msgIter = msgInIter; msgIter != msgEndIter; ++msgIter, ++index)
         {
           // Send the message to all callbacks
+          std::vector<std::size_t>::const_iterator firstIter = first.begin();
           for (liter = cbIter->second.begin();
-              liter != cbIter->second.end(); ++liter)
+              liter != cbIter->second.end(); ++liter, ++firstIter)
           {
-            (*liter)->HandleMessage(*msgIter);
+            if (index >= *firstIter)
+              (*liter)->HandleMessage(*msgIter);
           }
         }
       }
@@ -265,6 +350,39 @@ void Node::ProcessIncoming()
 
     this->incomingMsgsLocal.clear();
   }
+
+  // Deliver the messages held back by the maximum rate of their callback,
+  // once the period has elapsed. Otherwise ask for an update when they
+  // are due.
+  {
+    boost::recursive_mutex::scoped_lock lock2(this->incomingMutex);
+    auto pendingIter = this->pendingCallbacks.begin();
+    while (pendingIter != this->pendingCallbacks.end())
+    {
+      const CallbackHelperPtr cb = *pendingIter;
+      MessagePtr msg;
+      std::string data;
+      common::Time due;
+      if (cb->TakePending(msg, data))
+      {
+        if (msg)
+          cb->HandleMessage(msg);
+        else
+          cb->HandleData(data, boost::bind(&dummy_callback_fn, _1), 0);
+        pendingIter = this->pendingCallbacks.erase(pendingIter);
+      }
+      else if (cb->HasPending(due))
+      {
+        ConnectionManager::Instance()->TriggerUpdateAt(due);
+        ++pendingIter;
+      }
+      else
+      {
+        // A newer message was delivered in the meantime.
+        pendingIter = this->pendingCallbacks.erase(pendingIter);
+      }
+    }
+  }
 }
 
 //////////////////////////////////////////////////
@@ -349,10 +467,86 @@ void Node::RemoveCallback(const std::string &_topic, unsigned int _id)
     {
       if ((*liter)->GetId() == _id)
       {
+        this->pendingCallbacks.erase(*liter);
         (*liter).reset();
         iter->second.erase(liter);
         break;
       }
     }
+
+    this->UpdateIncomingDepth(_topic);
+  }
+}
+
+/////////////////////////////////////////////////
+bool Node::LoosestQoS(const std::string &_topic, double &_maxRate,
+    Reliability &_reliability) const
+{
+  Callback_M::const_iterator iter = this->callbacks.find(_topic);
+  if (iter == this->callbacks.end() || iter->second.empty())
+    return false;
+
+  _maxRate = 0;
+  _reliability = Reliability::BEST_EFFORT;
+
+  bool unlimited = false;
+  for (auto const &cb : iter->second)
+  {
+    const double rate = cb->MaxRate();
+    unlimited = unlimited || rate <= 0;
+    _maxRate = std::max(_maxRate, rate);
+
+    if (cb->GetReliability() == Reliability::RELIABLE)
+      _reliability = Reliability::RELIABLE;
+  }
+
+  if (unlimited)
+    _maxRate = 0;
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+SubscriberPtr Node::AddSubscription(const SubscribeOptions &_ops,
+    CallbackHelperPtr _cb)
+{
+  _cb->SetQoS(_ops.MaxRate(), _ops.Depth(), _ops.GetReliability());
+
+  {
+    boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+    this->callbacks[_ops.GetTopic()].push_back(_cb);
+    this->UpdateIncomingDepth(_ops.GetTopic());
+  }
+
+  SubscriberPtr result = transport::TopicManager::Instance()->Subscribe(_ops);
+  result->SetCallbackId(_cb->GetId());
+
+  return result;
+}
+
+/////////////////////////////////////////////////
+void Node::UpdateIncomingDepth(const std::string &_topic)
+{
+  // Keep enough messages for the callback that needs the most. A rate
+  // limited callback only needs the latest message.
+  unsigned int depth = 0;
+  Callback_M::const_iterator iter = this->callbacks.find(_topic);
+  if (iter != this->callbacks.end())
+  {
+    for (auto const &cb : iter->second)
+    {
+      const unsigned int cbDepth = cb->MaxRate() > 0 ? 1 : cb->Depth();
+      if (cbDepth == 0)
+      {
+        depth = 0;
+        break;
+      }
+      depth = std::max(depth, cbDepth);
+    }
   }
+
+  if (depth > 0)
+    this->incomingDepths[_topic] = depth;
+  else
+    this->incomingDepths.erase(_topic);
 }
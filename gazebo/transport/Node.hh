@@ -23,6 +23,7 @@
 #include <boost/enable_shared_from_this.hpp>
 #include <map>
 #include <list>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -123,6 +124,16 @@ namespace gazebo
       /// \return True if a latched subscriber exists.
       public: bool HasLatchedSubscriber(const std::string &_topic) const;
 
+      /// \brief Get the loosest quality of service of the subscriptions to
+      /// a topic.
+      /// \param[in] _topic Name of the topic.
+      /// \param[out] _maxRate Highest maximum rate, 0 if a subscription
+      /// has no limit.
+      /// \param[out] _reliability RELIABLE if a subscription is reliable.
+      /// \return False if the node has no subscription to the topic.
+      public: bool LoosestQoS(const std::string &_topic, double &_maxRate,
+                  Reliability &_reliability) const;
+
 
       /// \brief A convenience function for a one-time publication of
       /// a message. This is inefficient, compared to
@@ -166,6 +177,33 @@ namespace gazebo
         return publisher;
       }
 
+      /// \brief Set how the messages of a topic are delivered in this
+      /// process. Both the publishing and the subscribing processes should
+      /// set the class of a topic to get the lowest latency.
+      /// \param[in] _topic The topic
+      /// \param[in] _class The latency class
+      public: template<typename M>
+      void SetLatencyClass(const std::string &_topic,
+                           const LatencyClass _class)
+      {
+        M msgtype;
+        transport::TopicManager::Instance()->SetLatencyClass(
+            this->DecodeTopicName(_topic), msgtype.GetTypeName(), _class);
+      }
+
+      /// \brief Set how the queued messages of a topic are sent by the
+      /// publishers of this process.
+      /// \param[in] _topic The topic
+      /// \param[in] _mode The batching mode
+      public: template<typename M>
+      void SetBatchingMode(const std::string &_topic,
+                           const BatchingMode _mode)
+      {
+        M msgtype;
+        transport::TopicManager::Instance()->SetBatchingMode(
+            this->DecodeTopicName(_topic), msgtype.GetTypeName(), _mode);
+      }
+
       /// \brief Subscribe to a topic using a class method as the callback
       /// \param[in] _topic The topic to subscribe to
       /// \param[in] _fp Class method to be called on receipt of new message
@@ -179,21 +217,30 @@ namespace gazebo
           bool _latching = false)
       {
         SubscribeOptions ops;
-        std::string decodedTopic = this->DecodeTopicName(_topic);
-        ops.template Init<M>(decodedTopic, shared_from_this(), _latching);
-
-        {
-          boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-          this->callbacks[decodedTopic].push_back(CallbackHelperPtr(
-                new CallbackHelperT<M>(boost::bind(_fp, _obj, _1), _latching)));
-        }
-
-        SubscriberPtr result =
-          transport::TopicManager::Instance()->Subscribe(ops);
+        ops.SetLatching(_latching);
+        return this->Subscribe(_topic, _fp, _obj, ops);
+      }
 
-        result->SetCallbackId(this->callbacks[decodedTopic].back()->GetId());
+      /// \brief Subscribe to a topic using a class method as the callback,
+      /// with a quality of service.
+      /// \param[in] _topic The topic to subscribe to
+      /// \param[in] _fp Class method to be called on receipt of new message
+      /// \param[in] _obj Class instance to be used on receipt of new message
+      /// \param[in] _options Latching and quality of service of the
+      /// subscription. The topic and node of the options are ignored.
+      /// \return Pointer to new Subscriber object
+      public: template<typename M, typename T>
+      SubscriberPtr Subscribe(const std::string &_topic,
+          void(T::*_fp)(const boost::shared_ptr<M const> &), T *_obj,
+          const SubscribeOptions &_options)
+      {
+        SubscribeOptions ops(_options);
+        ops.template Init<M>(this->DecodeTopicName(_topic),
+            shared_from_this(), _options.GetLatching());
 
-        return result;
+        return this->AddSubscription(ops, CallbackHelperPtr(
+              new CallbackHelperT<M>(boost::bind(_fp, _obj, _1),
+                _options.GetLatching())));
       }
 
       /// \brief Subscribe to a topic using a bare function as the callback
@@ -208,21 +255,28 @@ namespace gazebo
                      bool _latching = false)
       {
         SubscribeOptions ops;
-        std::string decodedTopic = this->DecodeTopicName(_topic);
-        ops.template Init<M>(decodedTopic, shared_from_this(), _latching);
-
-        {
-          boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-          this->callbacks[decodedTopic].push_back(
-              CallbackHelperPtr(new CallbackHelperT<M>(_fp, _latching)));
-        }
-
-        SubscriberPtr result =
-          transport::TopicManager::Instance()->Subscribe(ops);
+        ops.SetLatching(_latching);
+        return this->Subscribe(_topic, _fp, ops);
+      }
 
-        result->SetCallbackId(this->callbacks[decodedTopic].back()->GetId());
+      /// \brief Subscribe to a topic using a bare function as the callback,
+      /// with a quality of service.
+      /// \param[in] _topic The topic to subscribe to
+      /// \param[in] _fp Function to be called on receipt of new message
+      /// \param[in] _options Latching and quality of service of the
+      /// subscription. The topic and node of the options are ignored.
+      /// \return Pointer to new Subscriber object
+      public: template<typename M>
+      SubscriberPtr Subscribe(const std::string &_topic,
+          void(*_fp)(const boost::shared_ptr<M const> &),
+          const SubscribeOptions &_options)
+      {
+        SubscribeOptions ops(_options);
+        ops.template Init<M>(this->DecodeTopicName(_topic),
+            shared_from_this(), _options.GetLatching());
 
-        return result;
+        return this->AddSubscription(ops, CallbackHelperPtr(
+              new CallbackHelperT<M>(_fp, _options.GetLatching())));
       }
 
       /// \brief Subscribe to a topic using a class method as the callback
@@ -238,21 +292,11 @@ namespace gazebo
           bool _latching = false)
       {
         SubscribeOptions ops;
-        std::string decodedTopic = this->DecodeTopicName(_topic);
-        ops.Init(decodedTopic, shared_from_this(), _latching);
-
-        {
-          boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-          this->callbacks[decodedTopic].push_back(CallbackHelperPtr(
-                new RawCallbackHelper(boost::bind(_fp, _obj, _1))));
-        }
+        ops.Init(this->DecodeTopicName(_topic), shared_from_this(),
+            _latching);
 
-        SubscriberPtr result =
-          transport::TopicManager::Instance()->Subscribe(ops);
-
-        result->SetCallbackId(this->callbacks[decodedTopic].back()->GetId());
-
-        return result;
+        return this->AddSubscription(ops, CallbackHelperPtr(
+              new RawCallbackHelper(boost::bind(_fp, _obj, _1))));
       }
 
 
@@ -266,21 +310,11 @@ namespace gazebo
           void(*_fp)(const std::string &), bool _latching = false)
       {
         SubscribeOptions ops;
-        std::string decodedTopic = this->DecodeTopicName(_topic);
-        ops.Init(decodedTopic, shared_from_this(), _latching);
-
-        {
-          boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-          this->callbacks[decodedTopic].push_back(
-              CallbackHelperPtr(new RawCallbackHelper(_fp)));
-        }
-
-        SubscriberPtr result =
-          transport::TopicManager::Instance()->Subscribe(ops);
-
-        result->SetCallbackId(this->callbacks[decodedTopic].back()->GetId());
+        ops.Init(this->DecodeTopicName(_topic), shared_from_this(),
+            _latching);
 
-        return result;
+        return this->AddSubscription(ops, CallbackHelperPtr(
+              new RawCallbackHelper(_fp)));
       }
 
       /// \brief Handle incoming data.
@@ -326,6 +360,19 @@ namespace gazebo
       /// \param[in] _id Id of the callback.
       public: void RemoveCallback(const std::string &_topic, unsigned int _id);
 
+      /// \brief Add the callback of a subscription.
+      /// \param[in] _ops Options of the subscription, initialized.
+      /// \param[in] _cb The callback.
+      /// \return Pointer to new Subscriber object
+      private: SubscriberPtr AddSubscription(const SubscribeOptions &_ops,
+                   CallbackHelperPtr _cb);
+
+      /// \brief Update the number of incoming messages to keep for a
+      /// topic, from the quality of service of its callbacks. Must be
+      /// called with incomingMutex locked.
+      /// \param[in] _topic Name of the topic.
+      private: void UpdateIncomingDepth(const std::string &_topic);
+
       private: std::string topicNamespace;
       private: std::vector<PublisherPtr> publishers;
       private: std::vector<PublisherPtr>::iterator publishersIter;
@@ -340,6 +387,15 @@ namespace gazebo
       /// \brief List of newly arrive messages
       private: std::map<std::string, std::list<MessagePtr> > incomingMsgsLocal;
 
+      /// \brief Number of incoming messages to keep for each topic, the
+      /// oldest are dropped. Topics that keep all their messages are not
+      /// in the map.
+      private: std::map<std::string, unsigned int> incomingDepths;
+
+      /// \brief Callbacks that keep a message held back by their maximum
+      /// rate, see CallbackHelper::KeepPending.
+      private: std::set<CallbackHelperPtr> pendingCallbacks;
+
       private: boost::mutex publisherMutex;
       private: boost::mutex publisherDeleteMutex;
       private: boost::recursive_mutex incomingMutex;
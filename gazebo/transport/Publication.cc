@@ -17,9 +17,11 @@
 
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
+#include "ConnectionManager.hh"
 #include "SubscriptionTransport.hh"
 #include "Publication.hh"
 #include "Node.hh"
+#include "TopicManager.hh"
 
 using namespace gazebo;
 using namespace transport;
@@ -29,7 +31,9 @@ unsigned int Publication::idCounter = 0;
 
 //////////////////////////////////////////////////
 Publication::Publication(const std::string &_topic, const std::string &_msgType)
-  : topic(_topic), msgType(_msgType), locallyAdvertised(false)
+  : topic(_topic), msgType(_msgType), locallyAdvertised(false),
+    latencyClass(LatencyClass::NORMAL), batchingMode(BatchingMode::NONE),
+    pending(false)
 {
   this->id = idCounter++;
 }
@@ -246,6 +250,8 @@ void Publication::RemoveSubscription(const std::string &_host,
 void Publication::LocalPublish(const std::string &_data)
 {
   std::list<NodePtr>::iterator iter, endIter;
+  const bool lowLatency = this->latencyClass == LatencyClass::LOW_LATENCY;
+  std::vector<NodePtr> toProcess;
 
   {
     boost::mutex::scoped_lock lock(this->nodeMutex);
@@ -255,7 +261,11 @@ void Publication::LocalPublish(const std::string &_data)
     while (iter != endIter)
     {
       if ((*iter)->HandleData(this->topic, _data))
+      {
+        if (lowLatency)
+          toProcess.push_back(*iter);
         ++iter;
+      }
       else
         this->nodes.erase(iter++);
     }
@@ -266,6 +276,8 @@ void Publication::LocalPublish(const std::string &_data)
   // will clean up the nodes that have then been marked for removal
   this->RemoveNodes();
 
+  this->ProcessIncoming(toProcess);
+
   {
     boost::mutex::scoped_lock lock(this->callbackMutex);
     std::list< CallbackHelperPtr >::iterator cbIter;
@@ -292,6 +304,8 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
 {
   int result = 0;
   std::list<NodePtr>::iterator iter, endIter;
+  const bool lowLatency = this->latencyClass == LatencyClass::LOW_LATENCY;
+  std::vector<NodePtr> toProcess;
 
   {
     boost::mutex::scoped_lock lock(this->nodeMutex);
@@ -301,7 +315,11 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
     while (iter != endIter)
     {
       if ((*iter)->HandleMessage(this->topic, _msg))
+      {
+        if (lowLatency)
+          toProcess.push_back(*iter);
         ++iter;
+      }
       else
         this->nodes.erase(iter++);
     }
@@ -312,28 +330,69 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
   // will clean up the nodes that have then been marked for removal
   this->RemoveNodes();
 
+  this->ProcessIncoming(toProcess);
+
   {
     boost::mutex::scoped_lock lock(this->callbackMutex);
 
     if (!this->callbacks.empty())
     {
+      // Serialized only once, and only if a remote subscriber needs it.
       std::string data;
-      _msg->SerializeToString(&data);
+      bool serialized = false;
+
       std::list<CallbackHelperPtr>::iterator cbIter;
       cbIter = this->callbacks.begin();
 
       while (cbIter != this->callbacks.end())
       {
-        if ((*cbIter)->HandleData(data, _cb, _id))
+        bool handled;
+        if ((*cbIter)->IsLocal())
         {
-          ++result;
-          ++cbIter;
+          // Local callbacks share the message, and complete immediately.
+          handled = (*cbIter)->HandleMessage(_msg);
         }
+        else
+        {
+          // Skip subscribers that don't need the message, such as rate
+          // limited subscribers, before serializing it.
+          SubscriptionTransportPtr subptr =
+            boost::dynamic_pointer_cast<SubscriptionTransport>(*cbIter);
+          if (subptr && subptr->MaxRate() > 0 &&
+              CallbackHelper::Merges(_msg->GetTypeName()))
+          {
+            // Merged with the message held back, sent when due.
+            this->KeepPending(subptr, _msg);
+            this->SendPending(subptr);
+            ++cbIter;
+            continue;
+          }
+
+          if (subptr && !subptr->Accept())
+          {
+            this->KeepPending(subptr, _msg);
+            ++cbIter;
+            continue;
+          }
+
+          if (!serialized)
+          {
+            _msg->SerializeToString(&data);
+            serialized = true;
+          }
+
+          handled = (*cbIter)->HandleData(data, _cb, _id);
+          if (handled)
+            ++result;
+        }
+
+        if (handled)
+          ++cbIter;
         else
           this->callbacks.erase(cbIter++);
       }
 
-      if (this->callbacks.empty() && !_cb.empty())
+      if (result == 0 && !_cb.empty())
       {
         _cb(_id);
       }
@@ -347,6 +406,112 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
   return result;
 }
 
+//////////////////////////////////////////////////
+int Publication::Publish(const std::list<MessagePtr> &_msgs,
+    boost::function<void(uint32_t)> _cb, uint32_t _id)
+{
+  int result = 0;
+  std::list<NodePtr>::iterator iter, endIter;
+  const bool lowLatency = this->latencyClass == LatencyClass::LOW_LATENCY;
+  std::vector<NodePtr> toProcess;
+
+  {
+    boost::mutex::scoped_lock lock(this->nodeMutex);
+
+    iter = this->nodes.begin();
+    endIter = this->nodes.end();
+    while (iter != endIter)
+    {
+      bool handled = true;
+      for (auto const &msg : _msgs)
+        handled = (*iter)->HandleMessage(this->topic, msg) && handled;
+
+      if (handled)
+      {
+        if (lowLatency)
+          toProcess.push_back(*iter);
+        ++iter;
+      }
+      else
+        this->nodes.erase(iter++);
+    }
+  }
+
+  this->RemoveNodes();
+
+  this->ProcessIncoming(toProcess);
+
+  {
+    boost::mutex::scoped_lock lock(this->callbackMutex);
+
+    // Serialized only once, and only if a remote subscriber needs it.
+    std::vector<std::string> data;
+    bool serialized = false;
+
+    std::list<CallbackHelperPtr>::iterator cbIter;
+    cbIter = this->callbacks.begin();
+
+    while (cbIter != this->callbacks.end())
+    {
+      bool handled = true;
+      if ((*cbIter)->IsLocal())
+      {
+        for (auto const &msg : _msgs)
+          handled = (*cbIter)->HandleMessage(msg) && handled;
+      }
+      else
+      {
+        SubscriptionTransportPtr subptr =
+          boost::dynamic_pointer_cast<SubscriptionTransport>(*cbIter);
+        if (subptr && subptr->MaxRate() > 0 && !_msgs.empty() &&
+            CallbackHelper::Merges(_msgs.back()->GetTypeName()))
+        {
+          // Merged with the message held back, sent when due.
+          for (auto const &msg : _msgs)
+            this->KeepPending(subptr, msg);
+          this->SendPending(subptr);
+          ++cbIter;
+          continue;
+        }
+
+        if (subptr && !subptr->Accept())
+        {
+          this->KeepPending(subptr, _msgs.back());
+          ++cbIter;
+          continue;
+        }
+
+        if (!serialized)
+        {
+          data.resize(_msgs.size());
+          std::vector<std::string>::iterator dataIter = data.begin();
+          for (auto const &msg : _msgs)
+            msg->SerializeToString(&(*dataIter++));
+          serialized = true;
+        }
+
+        // Rate limited subscribers only get the latest message.
+        if (subptr && subptr->MaxRate() > 0)
+          handled = subptr->HandleData(data.back(), _cb, _id);
+        else
+          handled = subptr && subptr->HandleBatch(data, _cb, _id);
+        if (handled)
+          ++result;
+      }
+
+      if (handled)
+        ++cbIter;
+      else
+        this->callbacks.erase(cbIter++);
+    }
+  }
+
+  if (result == 0 && !_cb.empty())
+    _cb(_id);
+
+  return result;
+}
+
 //////////////////////////////////////////////////
 std::string Publication::GetMsgType() const
 {
@@ -522,3 +687,105 @@ MessagePtr Publication::GetPrevMsg(uint32_t _pubId)
     return MessagePtr();
 }
 
+
+//////////////////////////////////////////////////
+void Publication::SetLatencyClass(const LatencyClass _class)
+{
+  this->latencyClass = _class;
+}
+
+//////////////////////////////////////////////////
+LatencyClass Publication::GetLatencyClass() const
+{
+  return this->latencyClass;
+}
+
+//////////////////////////////////////////////////
+void Publication::ProcessIncoming(const std::vector<NodePtr> &_nodes)
+{
+  // While paused, the messages stay queued in the nodes, and are processed
+  // by the connection manager once resumed.
+  if (_nodes.empty() || TopicManager::Instance()->IncomingPaused())
+    return;
+
+  for (auto const &node : _nodes)
+    node->ProcessIncoming();
+}
+
+//////////////////////////////////////////////////
+void Publication::KeepPending(const SubscriptionTransportPtr &_sub,
+    MessagePtr _msg)
+{
+  common::Time due;
+  if (_sub->MaxRate() <= 0 || !_msg)
+    return;
+
+  _sub->KeepPending(_msg);
+  this->pending = true;
+  if (_sub->HasPending(due))
+    ConnectionManager::Instance()->TriggerUpdateAt(due);
+}
+
+//////////////////////////////////////////////////
+bool Publication::HasPending() const
+{
+  return this->pending;
+}
+
+//////////////////////////////////////////////////
+void Publication::FlushPending()
+{
+  if (!this->pending)
+    return;
+
+  boost::mutex::scoped_lock lock(this->callbackMutex);
+
+  bool stillPending = false;
+  for (auto const &cb : this->callbacks)
+  {
+    if (!cb->IsLocal())
+      stillPending = this->SendPending(cb) || stillPending;
+  }
+
+  this->pending = stillPending;
+}
+
+//////////////////////////////////////////////////
+bool Publication::SendPending(const CallbackHelperPtr &_cb)
+{
+  MessagePtr msg;
+  std::string data;
+  common::Time due;
+  if (_cb->TakePending(msg, data))
+  {
+    if (msg)
+      msg->SerializeToString(&data);
+    _cb->HandleData(data, boost::bind(&dummy_callback_fn, _1), 0);
+  }
+  else if (_cb->HasPending(due))
+  {
+    ConnectionManager::Instance()->TriggerUpdateAt(due);
+    return true;
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+void Publication::SetBatchingMode(const BatchingMode _mode)
+{
+  this->batchingMode = _mode;
+}
+
+//////////////////////////////////////////////////
+BatchingMode Publication::GetBatchingMode() const
+{
+  return this->batchingMode;
+}
+
+//////////////////////////////////////////////////
+void Publication::SetTransportQoS(const double _maxRate,
+    const Reliability _reliability)
+{
+  for (auto const &transport : this->transports)
+    transport->SetQoS(_maxRate, _reliability);
+}
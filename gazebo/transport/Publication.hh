@@ -18,6 +18,7 @@
 #ifndef _PUBLICATION_HH_
 #define _PUBLICATION_HH_
 
+#include <atomic>
 #include <utility>
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
@@ -125,6 +126,18 @@ namespace gazebo
                   boost::function<void(uint32_t)> _cb,
                   uint32_t _id);
 
+      /// \brief Publish a batch of messages. Remote subscribers receive the
+      /// batch at once, and each message is serialized only once.
+      /// \param[in] _msgs Messages to be published, in order
+      /// \param[in] _cb Callback to be invoked after publishing
+      /// is completed
+      /// \param[in] _id ID associated with the batch
+      /// \return Number of remote subscribers that will receive the
+      /// batch.
+      public: int Publish(const std::list<MessagePtr> &_msgs,
+                  boost::function<void(uint32_t)> _cb,
+                  uint32_t _id);
+
       /// \brief Remove a publisher.
       /// \param[in] _pub Pointer to publisher object to remove.
       public: void RemovePublisher(PublisherPtr _pub);
@@ -163,9 +176,62 @@ namespace gazebo
       /// \param[in,out] _pub Pointer to publisher object to be added
       public: void AddPublisher(PublisherPtr _pub);
 
+      /// \brief Change the quality of service asked to the remote
+      /// publishers of the topic.
+      /// \param[in] _maxRate Maximum rate of messages, 0 for no limit.
+      /// \param[in] _reliability Whether every message is needed.
+      public: void SetTransportQoS(const double _maxRate,
+                  const Reliability _reliability);
+
+      /// \brief Set how the messages of the topic are delivered.
+      /// \param[in] _class The latency class.
+      public: void SetLatencyClass(const LatencyClass _class);
+
+      /// \brief Get how the messages of the topic are delivered.
+      /// \return The latency class, NORMAL by default.
+      public: LatencyClass GetLatencyClass() const;
+
+      /// \brief Set how the queued messages of the topic are sent.
+      /// \param[in] _mode The batching mode.
+      public: void SetBatchingMode(const BatchingMode _mode);
+
+      /// \brief Get how the queued messages of the topic are sent.
+      /// \return The batching mode, NONE by default.
+      public: BatchingMode GetBatchingMode() const;
+
+      /// \brief Get whether a remote subscriber keeps a message held back
+      /// by its maximum rate.
+      /// \return True if FlushPending should be called.
+      public: bool HasPending() const;
+
+      /// \brief Send the messages held back by the maximum rate of remote
+      /// subscribers, once their period has elapsed. Otherwise ask the
+      /// connection manager for an update when they are due.
+      public: void FlushPending();
+
+      /// \brief Keep the latest message for a remote subscriber that
+      /// rejected it, if the subscriber has a maximum rate. Messages that
+      /// are merged are all kept, see CallbackHelper::SetMergeFunction.
+      /// \param[in] _sub The remote subscriber.
+      /// \param[in] _msg The message.
+      private: void KeepPending(const SubscriptionTransportPtr &_sub,
+                   MessagePtr _msg);
+
+      /// \brief Send the message held back by the maximum rate of a remote
+      /// subscriber, if its period has elapsed. Otherwise ask the
+      /// connection manager for an update when it is due.
+      /// \param[in] _cb The remote subscriber.
+      /// \return True if the message is still held back.
+      private: bool SendPending(const CallbackHelperPtr &_cb);
+
       /// \brief Remove nodes that have been marked for removal
       private: void RemoveNodes();
 
+      /// \brief Run the callbacks of nodes that just received a message
+      /// of a LOW_LATENCY topic, unless incoming messages are paused.
+      /// \param[in] _nodes The nodes.
+      private: void ProcessIncoming(const std::vector<NodePtr> &_nodes);
+
       /// \brief Unique if of the publication.
       private: unsigned int id;
 
@@ -210,6 +276,16 @@ namespace gazebo
 
       /// \brief Publishers and their last messages.
       private: std::map<uint32_t, MessagePtr> prevMsgs;
+
+      /// \brief How the messages of the topic are delivered.
+      private: std::atomic<LatencyClass> latencyClass;
+
+      /// \brief How the queued messages of the topic are sent.
+      private: std::atomic<BatchingMode> batchingMode;
+
+      /// \brief True if a remote subscriber keeps a message held back by
+      /// its maximum rate.
+      private: std::atomic<bool> pending;
     };
     /// \}
   }
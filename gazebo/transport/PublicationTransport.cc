@@ -21,6 +21,7 @@
   #include <Winsock2.h>
 #endif
 
+#include <cstdlib>
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include "gazebo/transport/TopicManager.hh"
@@ -61,17 +62,15 @@ PublicationTransport::~PublicationTransport()
 }
 
 /////////////////////////////////////////////////
-void PublicationTransport::Init(const ConnectionPtr &_conn, bool _latched)
+void PublicationTransport::Init(const ConnectionPtr &_conn, bool _latched,
+    const double _maxRate, const Reliability _reliability)
 {
   this->connection = _conn;
-  msgs::Subscribe sub;
-  sub.set_topic(this->topic);
-  sub.set_msg_type(this->msgType);
-  sub.set_host(this->connection->GetLocalAddress());
-  sub.set_port(this->connection->GetLocalPort());
-  sub.set_latching(_latched);
+  this->latched = _latched;
+  this->maxRate = _maxRate;
+  this->reliability = _reliability;
 
-  this->connection->EnqueueMsg(msgs::Package("sub", sub));
+  this->SendSubscribe();
 
   // Put this in PublicationTransportPtr
   // Start reading messages from the remote publisher
@@ -80,6 +79,41 @@ void PublicationTransport::Init(const ConnectionPtr &_conn, bool _latched)
 }
 
 
+/////////////////////////////////////////////////
+void PublicationTransport::SetQoS(const double _maxRate,
+    const Reliability _reliability)
+{
+  if (_maxRate == this->maxRate && _reliability == this->reliability)
+    return;
+
+  this->maxRate = _maxRate;
+  this->reliability = _reliability;
+
+  // Publishers keep reading the connection for updated subscriptions.
+  if (this->connection && this->connection->IsOpen())
+    this->SendSubscribe();
+}
+
+/////////////////////////////////////////////////
+void PublicationTransport::SendSubscribe()
+{
+  msgs::Subscribe sub;
+  sub.set_topic(this->topic);
+  sub.set_msg_type(this->msgType);
+  sub.set_host(this->connection->GetLocalAddress());
+  sub.set_port(this->connection->GetLocalPort());
+  sub.set_latching(this->latched);
+  if (!this->connection->GetSharedMemoryName().empty())
+    sub.set_shm_name(this->connection->GetSharedMemoryName());
+  sub.set_batching(true);
+  if (this->maxRate > 0)
+    sub.set_max_rate(this->maxRate);
+  if (this->reliability == Reliability::BEST_EFFORT)
+    sub.set_best_effort(true);
+
+  this->connection->EnqueueMsg(msgs::Package("sub", sub));
+}
+
 /////////////////////////////////////////////////
 void PublicationTransport::AddCallback(
     const boost::function<void(const std::string &)> &cb_)
@@ -95,9 +129,33 @@ void PublicationTransport::OnPublish(const std::string &_data)
     this->connection->AsyncRead(
         boost::bind(&PublicationTransport::OnPublish, this, _1));
 
-    if (!_data.empty())
+    if (!_data.empty() && this->callback)
     {
-      if (this->callback)
+      // A batch of messages, see the batching field of msgs::Subscribe.
+      if (_data[0] == '\0')
+      {
+        char header[HEADER_LENGTH + 1];
+        header[HEADER_LENGTH] = '\0';
+
+        std::size_t pos = 1;
+        while (pos + HEADER_LENGTH <= _data.size())
+        {
+          _data.copy(header, HEADER_LENGTH, pos);
+          pos += HEADER_LENGTH;
+
+          const std::size_t size = std::strtoul(header, NULL, 16);
+          if (size > _data.size() - pos)
+          {
+            gzerr << "Truncated batch on topic[" << this->topic << "]\n";
+            break;
+          }
+
+          if (size > 0)
+            (this->callback)(_data.substr(pos, size));
+          pos += size;
+        }
+      }
+      else
         (this->callback)(_data);
     }
   }
@@ -23,6 +23,7 @@
 #include <string>
 
 #include "gazebo/transport/Connection.hh"
+#include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/common/Event.hh"
 #include "gazebo/util/system.hh"
 
@@ -52,7 +53,19 @@ namespace gazebo
       /// \param[in] _conn The underlying connection.
       /// \param[in] _latched True to grab the last message sent on the
       /// topic.
-      public: void Init(const ConnectionPtr &_conn, bool _latched);
+      /// \param[in] _maxRate Maximum rate of messages to ask the remote
+      /// publisher for, 0 for no limit.
+      /// \param[in] _reliability Whether every message is needed.
+      public: void Init(const ConnectionPtr &_conn, bool _latched,
+                  const double _maxRate = 0,
+                  const Reliability _reliability = Reliability::RELIABLE);
+
+      /// \brief Change the quality of service asked to the remote
+      /// publisher.
+      /// \param[in] _maxRate Maximum rate of messages, 0 for no limit.
+      /// \param[in] _reliability Whether every message is needed.
+      public: void SetQoS(const double _maxRate,
+                  const Reliability _reliability);
 
       /// \brief Finalize the transport
       public: void Fini();
@@ -78,6 +91,9 @@ namespace gazebo
       /// \param[in] _data Data to be published.
       private: void OnPublish(const std::string &_data);
 
+      /// \brief Send the subscription to the remote publisher.
+      private: void SendSubscribe();
+
       /// \brief The topic for this publication transport.
       private: std::string topic;
 
@@ -95,6 +111,15 @@ namespace gazebo
 
       /// \brief The unique id for the publication transport.
       private: int id;
+
+      /// \brief True to grab the last message sent on the topic.
+      private: bool latched = false;
+
+      /// \brief Maximum rate of messages asked to the publisher.
+      private: double maxRate = 0;
+
+      /// \brief Reliability asked to the publisher.
+      private: Reliability reliability = Reliability::RELIABLE;
     };
     /// \}
   }
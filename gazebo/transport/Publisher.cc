@@ -91,6 +91,35 @@ bool Publisher::WaitForConnection(const common::Time &_timeout) const
 //////////////////////////////////////////////////
 void Publisher::PublishImpl(const google::protobuf::Message &_message,
                             bool _block)
+{
+  if (!this->CheckPublish(_message))
+    return;
+
+  // Copy the message, since the caller is free to modify it
+  MessagePtr msgPtr(_message.New());
+  msgPtr->CopyFrom(_message);
+
+  this->EnqueueMessage(msgPtr, _block);
+}
+
+//////////////////////////////////////////////////
+void Publisher::PublishImpl(MessagePtr _message, bool _block)
+{
+  if (!_message)
+  {
+    gzerr << "Publishing a null message on topic[" << this->topic << "]\n";
+    return;
+  }
+
+  if (!this->CheckPublish(*_message))
+    return;
+
+  // The message is shared with the caller and with local subscribers
+  this->EnqueueMessage(_message, _block);
+}
+
+//////////////////////////////////////////////////
+bool Publisher::CheckPublish(const google::protobuf::Message &_message)
 {
   if (_message.GetTypeName() != this->msgType)
     gzthrow("Invalid message type\n");
@@ -100,7 +129,7 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
     gzerr << "Publishing an uninitialized message on topic[" <<
       this->topic << "]. Required field [" <<
       _message.InitializationErrorString() << "] missing.\n";
-    return;
+    return false;
   }
 
   // Check if a throttling rate has been set
@@ -114,23 +143,29 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
         (this->currentTime - this->prevPublishTime).Double() <
         this->updatePeriod)
     {
-      return;
+      return false;
     }
 
     // Set the previous time a message was published
     this->prevPublishTime = this->currentTime;
   }
 
-  // Save the latest message
-  MessagePtr msgPtr(_message.New());
-  msgPtr->CopyFrom(_message);
+  return true;
+}
 
-  this->publication->SetPrevMsg(this->id, msgPtr);
+//////////////////////////////////////////////////
+void Publisher::EnqueueMessage(MessagePtr _message, bool _block)
+{
+  this->publication->SetPrevMsg(this->id, _message);
 
   {
     boost::mutex::scoped_lock lock(this->mutex);
 
-    this->messages.push_back(msgPtr);
+    // Stale messages are dropped before they are serialized.
+    if (this->publication->GetBatchingMode() == BatchingMode::LATEST_ONLY)
+      this->messages.clear();
+
+    this->messages.push_back(_message);
 
     if (this->messages.size() > this->queueLimit)
     {
@@ -149,7 +184,9 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
 
   TopicManager::Instance()->AddNodeToProcess(this->node);
 
-  if (_block)
+  // Low latency topics skip the connection manager thread.
+  if (_block ||
+      this->publication->GetLatencyClass() == LatencyClass::LOW_LATENCY)
   {
     this->SendMessage();
   }
@@ -166,12 +203,17 @@ void Publisher::SendMessage()
   std::list<MessagePtr> localBuffer;
   std::list<uint32_t> localIds;
 
+  // A batch is published with a single id.
+  const bool batch =
+    this->publication->GetBatchingMode() == BatchingMode::BATCH;
+
   {
     boost::mutex::scoped_lock lock(this->mutex);
     if (!this->pubIds.empty() || this->messages.empty())
       return;
 
-    for (unsigned int i = 0; i < this->messages.size(); ++i)
+    const std::size_t idCount = batch ? 1 : this->messages.size();
+    for (std::size_t i = 0; i < idCount; ++i)
     {
       this->pubId = (this->pubId + 1) % 10000;
       this->pubIds[this->pubId] = 0;
@@ -183,8 +225,19 @@ void Publisher::SendMessage()
     this->messages.clear();
   }
 
+  if (batch)
+  {
+    int result = this->publication->Publish(localBuffer,
+        boost::bind(&Publisher::OnPublishComplete, this, _1),
+        localIds.front());
+
+    if (result > 0)
+      this->pubIds[localIds.front()] = result;
+    else
+      this->pubIds.erase(localIds.front());
+  }
   // Only send messages if there is something to send
-  if (!localBuffer.empty())
+  else if (!localBuffer.empty())
   {
     std::list<uint32_t>::iterator pubIter = localIds.begin();
 
@@ -206,6 +259,11 @@ void Publisher::SendMessage()
     localBuffer.clear();
     localIds.clear();
   }
+
+  // Messages held back by the maximum rate of remote subscribers are sent
+  // later by the connection manager.
+  if (this->publication->HasPending())
+    TopicManager::Instance()->AddPublicationToFlush(this->publication);
 }
 
 //////////////////////////////////////////////////
@@ -22,6 +22,7 @@
 #define _PUBLISHER_HH_
 
 #include <google/protobuf/message.h>
+#include <boost/shared_ptr.hpp>
 #include <boost/thread.hpp>
 #include <string>
 #include <list>
@@ -89,6 +90,17 @@ namespace gazebo
               void Publish(M _message, bool _block = false)
               { this->PublishImpl(_message, _block); }
 
+      /// \brief Publish a shared message on the topic without copying it.
+      /// Local subscribers receive the same message instance, so the
+      /// message must not be modified after it has been published.
+      /// \param[in] _message Message to be published
+      /// \param[in] _block Whether to block until the message is actually
+      /// written out
+      public: template<typename M>
+              void Publish(const boost::shared_ptr<M> &_message,
+                  bool _block = false)
+              { this->PublishImpl(MessagePtr(_message), _block); }
+
       /// \brief Get the number of outgoing messages
       /// \return The number of outgoing messages
       public: unsigned int GetOutgoingCount() const;
@@ -131,6 +143,25 @@ namespace gazebo
       private: void PublishImpl(const google::protobuf::Message &_message,
                                 bool _block);
 
+      /// \brief Implementation of Publish for shared messages. The message
+      /// is queued without being copied.
+      /// \param[in] _message Message to be published.
+      /// \param[in] _block Whether to block until the message is actually
+      /// written out.
+      private: void PublishImpl(MessagePtr _message, bool _block);
+
+      /// \brief Check that a message can be published, and apply the
+      /// throttling rate.
+      /// \param[in] _message Message to be published.
+      /// \return True if the message should be published.
+      private: bool CheckPublish(const google::protobuf::Message &_message);
+
+      /// \brief Add a message to the outgoing queue.
+      /// \param[in] _message Message to be published.
+      /// \param[in] _block Whether to block until the message is actually
+      /// written out.
+      private: void EnqueueMessage(MessagePtr _message, bool _block);
+
       /// \brief Callback when a publish is completed
       /// \param[in] _id ID associated with the publication.
       private: void OnPublishComplete(uint32_t _id);
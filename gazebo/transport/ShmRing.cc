@@ -0,0 +1,318 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <random>
+#include <sstream>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/transport/ShmRing.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+/// \brief Identifies a ring segment, "gzsr".
+static const uint32_t kShmRingMagic = 0x677a7372;
+
+/// \brief Start of a ring segment. The positions grow without wrapping, the
+/// ring is full when head - tail equals the capacity. Each position is on
+/// its own cache line, since each is written by a different process.
+struct ShmRingHeader
+{
+  /// \brief kShmRingMagic once the segment is initialized.
+  uint32_t magic;
+
+  /// \brief Number of bytes of the ring, which follows the header.
+  uint64_t capacity;
+
+  /// \brief Position of the next write, only changed by the writer.
+  alignas(64) std::atomic<uint64_t> head;
+
+  /// \brief Position of the next read, only changed by the reader.
+  alignas(64) std::atomic<uint64_t> tail;
+};
+
+/// \brief Prefix of the names of the segments created by ShmRing::Create.
+static const char kShmRingPrefix[] = "/gz";
+
+/// \brief Get whether a name is one ShmRing::Create could have made. The
+/// name comes from another process, and the segment is removed once
+/// opened, so segments of other programs must never be opened.
+/// \param[in] _name Name of a segment.
+/// \return True if the name has the prefix of the rings, followed only by
+/// hexadecimal digits and dashes.
+static bool ValidName(const std::string &_name)
+{
+  const std::size_t prefix = sizeof(kShmRingPrefix) - 1;
+  if (_name.size() <= prefix || _name.compare(0, prefix, kShmRingPrefix) != 0)
+    return false;
+
+  return _name.find_first_not_of("0123456789abcdef-", prefix) ==
+    std::string::npos;
+}
+
+//////////////////////////////////////////////////
+ShmRing::ShmRing()
+{
+}
+
+//////////////////////////////////////////////////
+ShmRing::~ShmRing()
+{
+  this->Close();
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Create(const std::size_t _capacity)
+{
+  this->Close();
+
+#ifdef _WIN32
+  (void)_capacity;
+  return false;
+#else
+  if (_capacity == 0)
+    return false;
+
+  static std::atomic<unsigned int> counter(0);
+  std::random_device random;
+
+  // Names are limited to 31 characters on some systems.
+  std::ostringstream stream;
+  stream << kShmRingPrefix << std::hex << getpid() << "-" << counter++ << "-"
+         << (random() & 0xffffff);
+  const std::string segmentName = stream.str();
+
+  int fd = shm_open(segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0)
+  {
+    gzlog << "Unable to create shared memory[" << segmentName << "]: "
+          << strerror(errno) << std::endl;
+    return false;
+  }
+
+  const std::size_t size = sizeof(ShmRingHeader) + _capacity;
+  void *mem = MAP_FAILED;
+  if (ftruncate(fd, size) == 0)
+    mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (mem == MAP_FAILED)
+  {
+    gzlog << "Unable to map shared memory[" << segmentName << "]: "
+          << strerror(errno) << std::endl;
+    shm_unlink(segmentName.c_str());
+    return false;
+  }
+
+  ShmRingHeader *header = new (mem) ShmRingHeader();
+  header->capacity = _capacity;
+  header->head = 0;
+  header->tail = 0;
+  header->magic = kShmRingMagic;
+
+  this->segment = mem;
+  this->segmentSize = size;
+  this->ring = static_cast<char *>(mem) + sizeof(ShmRingHeader);
+  this->name = segmentName;
+  this->owner = true;
+  return true;
+#endif
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Open(const std::string &_name)
+{
+  this->Close();
+
+#ifdef _WIN32
+  (void)_name;
+  return false;
+#else
+  if (!ValidName(_name))
+  {
+    gzerr << "Invalid shared memory name[" << _name << "]" << std::endl;
+    return false;
+  }
+
+  int fd = shm_open(_name.c_str(), O_RDWR, 0);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  void *mem = MAP_FAILED;
+  if (fstat(fd, &st) == 0 &&
+      static_cast<std::size_t>(st.st_size) > sizeof(ShmRingHeader))
+  {
+    mem = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+        0);
+  }
+  close(fd);
+
+  if (mem == MAP_FAILED)
+    return false;
+
+  // The segment is left alone unless it is a ring.
+  const ShmRingHeader *header = static_cast<ShmRingHeader *>(mem);
+  if (header->magic != kShmRingMagic ||
+      header->capacity + sizeof(ShmRingHeader) !=
+      static_cast<uint64_t>(st.st_size))
+  {
+    gzerr << "Invalid shared memory[" << _name << "]" << std::endl;
+    munmap(mem, st.st_size);
+    return false;
+  }
+
+  // Both ends have the segment mapped, the name is no longer needed.
+  shm_unlink(_name.c_str());
+
+  this->segment = mem;
+  this->segmentSize = st.st_size;
+  this->ring = static_cast<char *>(mem) + sizeof(ShmRingHeader);
+  this->name = _name;
+  this->owner = false;
+  return true;
+#endif
+}
+
+//////////////////////////////////////////////////
+void ShmRing::Close()
+{
+#ifndef _WIN32
+  if (this->segment)
+    munmap(this->segment, this->segmentSize);
+  if (this->owner)
+    shm_unlink(this->name.c_str());
+#endif
+
+  this->segment = nullptr;
+  this->segmentSize = 0;
+  this->ring = nullptr;
+  this->name.clear();
+  this->owner = false;
+}
+
+//////////////////////////////////////////////////
+std::string ShmRing::Name() const
+{
+  return this->name;
+}
+
+//////////////////////////////////////////////////
+std::size_t ShmRing::Capacity() const
+{
+  return this->segment ? this->segmentSize - sizeof(ShmRingHeader) : 0;
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Write(const char *_data, const std::size_t _size)
+{
+  if (!this->segment || _size > std::numeric_limits<uint32_t>::max())
+    return false;
+
+  ShmRingHeader *header = static_cast<ShmRingHeader *>(this->segment);
+  const uint64_t head = header->head.load(std::memory_order_relaxed);
+  const uint64_t tail = header->tail.load(std::memory_order_acquire);
+  const uint64_t needed = sizeof(uint32_t) + _size;
+
+  if (head - tail > this->Capacity() ||
+      needed > this->Capacity() - (head - tail))
+  {
+    return false;
+  }
+
+  const uint32_t size = static_cast<uint32_t>(_size);
+  this->CopyIn(head, reinterpret_cast<const char *>(&size), sizeof(size));
+  this->CopyIn(head + sizeof(size), _data, _size);
+
+  header->head.store(head + needed, std::memory_order_release);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Read(std::string &_data)
+{
+  if (!this->segment)
+    return false;
+
+  ShmRingHeader *header = static_cast<ShmRingHeader *>(this->segment);
+  const uint64_t tail = header->tail.load(std::memory_order_relaxed);
+  const uint64_t head = header->head.load(std::memory_order_acquire);
+
+  // The header is shared with the writer, which is not trusted: the ring
+  // is closed as soon as the positions or a size do not fit in it.
+  const std::size_t capacity = this->Capacity();
+  uint32_t size = 0;
+  if (head - tail > capacity)
+  {
+    gzerr << "Corrupted shared memory[" << this->name << "]" << std::endl;
+    this->Close();
+    return false;
+  }
+
+  if (head - tail < sizeof(size))
+    return false;
+
+  this->CopyOut(tail, reinterpret_cast<char *>(&size), sizeof(size));
+  if (size > capacity - sizeof(size) || size > head - tail - sizeof(size))
+  {
+    gzerr << "Corrupted shared memory[" << this->name << "]" << std::endl;
+    this->Close();
+    return false;
+  }
+
+  _data.resize(size);
+  if (size > 0)
+    this->CopyOut(tail + sizeof(size), &_data[0], size);
+
+  header->tail.store(tail + sizeof(size) + size, std::memory_order_release);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void ShmRing::CopyIn(const uint64_t _pos, const char *_data,
+    const std::size_t _size)
+{
+  const std::size_t capacity = this->Capacity();
+  const std::size_t offset = _pos % capacity;
+  const std::size_t first = std::min(_size, capacity - offset);
+  memcpy(this->ring + offset, _data, first);
+  memcpy(this->ring, _data + first, _size - first);
+}
+
+//////////////////////////////////////////////////
+void ShmRing::CopyOut(const uint64_t _pos, char *_data,
+    const std::size_t _size) const
+{
+  const std::size_t capacity = this->Capacity();
+  const std::size_t offset = _pos % capacity;
+  const std::size_t first = std::min(_size, capacity - offset);
+  memcpy(_data, this->ring + offset, first);
+  memcpy(_data + first, this->ring, _size - first);
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_SHMRING_HH_
+#define GAZEBO_TRANSPORT_SHMRING_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \internal
+    /// \brief A ring buffer of messages in a POSIX shared memory segment,
+    /// with one writer process and one reader process.
+    ///
+    /// The reader creates the segment and sends its name to the writer,
+    /// which opens it and removes the name, so that the segment is freed
+    /// once both processes close it. Messages are read in the order they
+    /// were written. Nothing is ever blocking: Write fails when the ring is
+    /// full, and Read fails when it is empty.
+    class GZ_TRANSPORT_VISIBLE ShmRing
+    {
+      /// \brief Constructor.
+      public: ShmRing();
+
+      /// \brief Destructor. Closes the segment, and removes its name if it
+      /// is still there and this ring created it.
+      public: ~ShmRing();
+
+      /// \brief Create a new segment, with a unique name, to read from.
+      /// \param[in] _capacity Number of bytes of the ring. Each message
+      /// takes 4 bytes more than its size.
+      /// \return False if the segment could not be created.
+      public: bool Create(const std::size_t _capacity);
+
+      /// \brief Open a segment created by another ring, to write to, and
+      /// remove its name. Names that Create does not make are rejected,
+      /// and the name is only removed once the segment is checked to be a
+      /// ring.
+      /// \param[in] _name Name of the segment.
+      /// \return False if no ring segment has this name.
+      public: bool Open(const std::string &_name);
+
+      /// \brief Close the segment.
+      public: void Close();
+
+      /// \brief Get the name of the segment.
+      /// \return The name, empty if the ring is not open.
+      public: std::string Name() const;
+
+      /// \brief Get the number of bytes of the ring.
+      /// \return Capacity of the ring, 0 if it is not open.
+      public: std::size_t Capacity() const;
+
+      /// \brief Append a message to the ring.
+      /// \param[in] _data The message.
+      /// \param[in] _size Size of the message.
+      /// \return False if there is not enough free space.
+      public: bool Write(const char *_data, const std::size_t _size);
+
+      /// \brief Remove the oldest message from the ring. The ring is
+      /// closed if the writer left it corrupted.
+      /// \param[out] _data The message.
+      /// \return False if the ring is empty or corrupted.
+      public: bool Read(std::string &_data);
+
+      /// \brief Copy bytes into the ring, wrapping around its end.
+      /// \param[in] _pos Position in the ring, not wrapped.
+      /// \param[in] _data Bytes to copy.
+      /// \param[in] _size Number of bytes.
+      private: void CopyIn(const uint64_t _pos, const char *_data,
+                   const std::size_t _size);
+
+      /// \brief Copy bytes out of the ring, wrapping around its end.
+      /// \param[in] _pos Position in the ring, not wrapped.
+      /// \param[out] _data Destination of the bytes.
+      /// \param[in] _size Number of bytes.
+      private: void CopyOut(const uint64_t _pos, char *_data,
+                   const std::size_t _size) const;
+
+      /// \brief Mapped segment, nullptr if not open.
+      private: void *segment = nullptr;
+
+      /// \brief Size of the mapping.
+      private: std::size_t segmentSize = 0;
+
+      /// \brief Data of the ring, in the segment.
+      private: char *ring = nullptr;
+
+      /// \brief Name of the segment.
+      private: std::string name;
+
+      /// \brief True if this ring created the segment, and still has to
+      /// remove its name.
+      private: bool owner = false;
+    };
+  }
+}
+#endif
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+
+#include "gazebo/transport/ShmRing.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ShmRing : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(ShmRing, WriteRead)
+{
+  transport::ShmRing reader;
+  EXPECT_TRUE(reader.Name().empty());
+  EXPECT_EQ(reader.Capacity(), 0u);
+  EXPECT_FALSE(reader.Write("a", 1));
+
+  ASSERT_TRUE(reader.Create(64));
+  EXPECT_FALSE(reader.Name().empty());
+  EXPECT_EQ(reader.Capacity(), 64u);
+
+  transport::ShmRing writer;
+  ASSERT_TRUE(writer.Open(reader.Name()));
+  EXPECT_EQ(writer.Capacity(), 64u);
+
+  // The name is removed once opened.
+  transport::ShmRing other;
+  EXPECT_FALSE(other.Open(reader.Name()));
+
+  std::string data;
+  EXPECT_FALSE(reader.Read(data));
+
+  // Messages come out in order, including across the end of the ring.
+  for (int i = 0; i < 10; ++i)
+  {
+    const std::string first = "message " + std::to_string(i);
+    const std::string second(20, 'a' + i);
+    EXPECT_TRUE(writer.Write(first.data(), first.size()));
+    EXPECT_TRUE(writer.Write(second.data(), second.size()));
+
+    EXPECT_TRUE(reader.Read(data));
+    EXPECT_EQ(data, first);
+    EXPECT_TRUE(reader.Read(data));
+    EXPECT_EQ(data, second);
+    EXPECT_FALSE(reader.Read(data));
+  }
+
+  // A message takes 4 more bytes than its size.
+  const std::string large(60, 'x');
+  EXPECT_TRUE(writer.Write(large.data(), large.size()));
+  EXPECT_FALSE(writer.Write("a", 1));
+  EXPECT_TRUE(reader.Read(data));
+  EXPECT_EQ(data, large);
+  EXPECT_FALSE(writer.Write(large.data(), large.size() + 1));
+
+  EXPECT_TRUE(writer.Write("", 0));
+  EXPECT_TRUE(reader.Read(data));
+  EXPECT_TRUE(data.empty());
+}
+
+/////////////////////////////////////////////////
+TEST_F(ShmRing, Invalid)
+{
+  transport::ShmRing ring;
+  EXPECT_FALSE(ring.Create(0));
+  EXPECT_FALSE(ring.Open("/gazebo_no_such_ring"));
+
+  // A closed ring removes its name.
+  ASSERT_TRUE(ring.Create(16));
+  const std::string name = ring.Name();
+  ring.Close();
+  EXPECT_TRUE(ring.Name().empty());
+  EXPECT_FALSE(ring.Open(name));
+}
+
+#ifndef _WIN32
+/////////////////////////////////////////////////
+TEST_F(ShmRing, ForeignSegment)
+{
+  // Segments of other programs are neither opened nor removed.
+  const std::string foreign = "/gazebo_test_foreign_" +
+    std::to_string(getpid());
+  int fd = shm_open(foreign.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(ftruncate(fd, 4096), 0);
+  close(fd);
+
+  transport::ShmRing ring;
+  EXPECT_FALSE(ring.Open(foreign));
+  fd = shm_open(foreign.c_str(), O_RDWR, 0);
+  EXPECT_GE(fd, 0);
+  close(fd);
+  shm_unlink(foreign.c_str());
+
+  // Nor are segments with the prefix of the rings that are not rings.
+  const std::string fake = "/gz" + std::to_string(getpid()) + "-ffff";
+  fd = shm_open(fake.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(ftruncate(fd, 4096), 0);
+  close(fd);
+
+  EXPECT_FALSE(ring.Open(fake));
+  fd = shm_open(fake.c_str(), O_RDWR, 0);
+  EXPECT_GE(fd, 0);
+  close(fd);
+  shm_unlink(fake.c_str());
+
+  EXPECT_FALSE(ring.Open("/gz/../dev"));
+  EXPECT_FALSE(ring.Open("/gz"));
+}
+
+/////////////////////////////////////////////////
+TEST_F(ShmRing, CorruptedHead)
+{
+  transport::ShmRing reader;
+  ASSERT_TRUE(reader.Create(64));
+
+  // Map the segment as a hostile writer would, before the name is removed.
+  int fd = shm_open(reader.Name().c_str(), O_RDWR, 0);
+  ASSERT_GE(fd, 0);
+  void *mem = mmap(nullptr, 128, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+      0);
+  close(fd);
+  ASSERT_NE(mem, MAP_FAILED);
+
+  transport::ShmRing writer;
+  ASSERT_TRUE(writer.Open(reader.Name()));
+  ASSERT_TRUE(writer.Write("abcd", 4));
+
+  // The head is on the second cache line of the header. A head too far
+  // ahead of the tail closes the ring instead of reading past its end.
+  uint64_t *head = reinterpret_cast<uint64_t *>(
+      static_cast<char *>(mem) + 64);
+  *head = 1u << 20;
+  std::string data;
+  EXPECT_FALSE(reader.Read(data));
+  EXPECT_EQ(reader.Capacity(), 0u);
+  EXPECT_FALSE(reader.Read(data));
+
+  munmap(mem, 128);
+}
+#endif
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
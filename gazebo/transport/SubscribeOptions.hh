@@ -32,6 +32,12 @@ namespace gazebo
 
     /// \class SubscribeOptions SubscribeOptions.hh transport/transport.hh
     /// \brief Options for a subscription
+    ///
+    /// Besides latching, the options hold the quality of service of the
+    /// subscription: a maximum rate, a number of queued messages to keep,
+    /// and the reliability. Remote publishers apply the loosest quality of
+    /// service of the subscriptions to a topic in a process, and the node
+    /// applies the quality of service of each subscription.
     class GZ_TRANSPORT_VISIBLE SubscribeOptions
     {
       /// \brief Constructor
@@ -103,10 +109,75 @@ namespace gazebo
                 return this->latching;
               }
 
+      /// \brief Set whether to latch the latest message.
+      /// \param[in] _latching True to latch the latest message.
+      public: void SetLatching(const bool _latching)
+              {
+                this->latching = _latching;
+              }
+
+      /// \brief Set the maximum rate of messages. Only the latest message
+      /// is delivered once per period, the others are dropped. A message
+      /// that arrives within the period is delivered when it ends, unless
+      /// a newer one arrives first, so the last message is not lost.
+      /// Messages that only carry changes, such as the msgs::PosesStamped
+      /// of ~/pose/info, are merged instead of dropped, see
+      /// CallbackHelper::SetMergeFunction.
+      /// \param[in] _hz Rate in Hz, 0 for no limit.
+      public: void SetMaxRate(const double _hz)
+              {
+                this->maxRate = _hz;
+              }
+
+      /// \brief Get the maximum rate of messages.
+      /// \return Rate in Hz, 0 if there is no limit.
+      public: double MaxRate() const
+              {
+                return this->maxRate;
+              }
+
+      /// \brief Set the number of queued messages to keep. When more
+      /// messages arrive before they are delivered, the oldest are dropped.
+      /// \param[in] _depth Number of messages, 0 to keep all.
+      public: void SetDepth(const unsigned int _depth)
+              {
+                this->depth = _depth;
+              }
+
+      /// \brief Get the number of queued messages to keep.
+      /// \return Number of messages, 0 if all are kept.
+      public: unsigned int Depth() const
+              {
+                return this->depth;
+              }
+
+      /// \brief Set whether every message is needed.
+      /// \param[in] _reliability The reliability.
+      public: void SetReliability(const Reliability _reliability)
+              {
+                this->reliability = _reliability;
+              }
+
+      /// \brief Get whether every message is needed.
+      /// \return The reliability, RELIABLE by default.
+      public: Reliability GetReliability() const
+              {
+                return this->reliability;
+              }
+
       private: std::string topic;
       private: std::string msgType;
       private: NodePtr node;
       private: bool latching;
+
+      /// \brief Maximum rate of messages, 0 for no limit.
+      private: double maxRate = 0;
+
+      /// \brief Number of queued messages to keep, 0 to keep all.
+      private: unsigned int depth = 0;
+
+      /// \brief Whether every message is needed.
+      private: Reliability reliability = Reliability::RELIABLE;
     };
     /// \}
   }
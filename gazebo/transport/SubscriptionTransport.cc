@@ -21,6 +21,7 @@
   #include <Winsock2.h>
 #endif
 
+#include <cstdio>
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include "gazebo/transport/ConnectionManager.hh"
@@ -44,10 +45,12 @@ SubscriptionTransport::~SubscriptionTransport()
 }
 
 //////////////////////////////////////////////////
-void SubscriptionTransport::Init(ConnectionPtr _conn, bool _latching)
+void SubscriptionTransport::Init(ConnectionPtr _conn, bool _latching,
+    bool _batching)
 {
   this->connection = _conn;
   this->latching = _latching;
+  this->batching = _batching;
 }
 
 //////////////////////////////////////////////////
@@ -74,6 +77,66 @@ bool SubscriptionTransport::HandleData(const std::string &_newdata,
   return result;
 }
 
+//////////////////////////////////////////////////
+bool SubscriptionTransport::Accept()
+{
+  if (this->GetReliability() == Reliability::BEST_EFFORT &&
+      this->connection && this->connection->GetWriteQueueSize() > 1)
+  {
+    return false;
+  }
+
+  return this->RateReady();
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionTransport::HandleBatch(const std::vector<std::string> &_data,
+    boost::function<void(uint32_t)> _cb, uint32_t _id)
+{
+  if (!this->connection->IsOpen())
+  {
+    this->connection.reset();
+    return false;
+  }
+
+  if (_data.empty())
+  {
+    if (!_cb.empty())
+      _cb(_id);
+    return true;
+  }
+
+  if (!this->batching)
+  {
+    // Only the last message completes the batch.
+    for (std::size_t i = 0; i + 1 < _data.size(); ++i)
+      this->connection->EnqueueMsg(_data[i]);
+    this->connection->EnqueueMsg(_data.back(), _cb, _id);
+    return true;
+  }
+
+  // See the batching field of msgs::Subscribe for the format.
+  std::size_t size = 1;
+  for (auto const &data : _data)
+    size += HEADER_LENGTH + data.size();
+
+  std::string batch;
+  batch.reserve(size);
+  batch.push_back('\0');
+
+  char header[HEADER_LENGTH + 1];
+  for (auto const &data : _data)
+  {
+    snprintf(header, sizeof(header), "%08x",
+        static_cast<unsigned int>(data.size()));
+    batch.append(header, HEADER_LENGTH);
+    batch += data;
+  }
+
+  this->connection->EnqueueMsg(batch, _cb, _id);
+  return true;
+}
+
 //////////////////////////////////////////////////
 const ConnectionPtr &SubscriptionTransport::GetConnection() const
 {
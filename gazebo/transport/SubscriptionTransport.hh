@@ -20,6 +20,7 @@
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
 #include <string>
+#include <vector>
 
 #include "Connection.hh"
 #include "CallbackHelper.hh"
@@ -48,7 +49,10 @@ namespace gazebo
       /// \param[in] _conn The connection to use
       /// \param[in] _latching If true, latch the latest message; if false,
       /// don't latch
-      public: void Init(ConnectionPtr _conn, bool _latching);
+      /// \param[in] _batching True if the remote subscriber accepts
+      /// batches of messages.
+      public: void Init(ConnectionPtr _conn, bool _latching,
+                        bool _batching = false);
 
       /// \brief Output a message to a connection
       /// \param[in] _newdata The message to be handled
@@ -62,6 +66,26 @@ namespace gazebo
       // Documentation inherited
       public: virtual bool HandleMessage(MessagePtr _newMsg);
 
+      /// \brief Output a batch of messages to the connection. The batch is
+      /// written as a single message if the remote subscriber accepts
+      /// batches, otherwise each message is written on its own.
+      /// \param[in] _data The serialized messages, in order
+      /// \param[in] _cb If non-null, callback to be invoked after
+      /// transmission of the whole batch is complete.
+      /// \param[in] _id ID associated with the batch.
+      /// \return true if the batch was handled successfully, false otherwise
+      public: bool HandleBatch(const std::vector<std::string> &_data,
+                  boost::function<void(uint32_t)> _cb, uint32_t _id);
+
+      /// \brief Check whether the next message should be sent, given the
+      /// quality of service of the remote subscriber. This is checked
+      /// before the message is serialized.
+      /// \return False if the message should not be sent now, because of
+      /// the maximum rate, or because the connection is busy and the
+      /// subscriber is best effort. A message held back by the maximum rate
+      /// is kept, see Publication::FlushPending.
+      public: bool Accept();
+
       /// \brief Get the connection we're using
       /// \return Pointer to the connection we're using
       public: const ConnectionPtr &GetConnection() const;
@@ -72,6 +96,9 @@ namespace gazebo
       public: virtual bool IsLocal() const;
 
       private: ConnectionPtr connection;
+
+      /// \brief True if the remote subscriber accepts batches.
+      private: bool batching = false;
     };
     /// \}
   }
@@ -21,6 +21,8 @@
   #include <Winsock2.h>
 #endif
 
+#include <algorithm>
+
 #include <tbb/parallel_for.h>
 #include <tbb/blocked_range.h>
 
@@ -150,6 +152,16 @@ void TopicManager::AddNodeToProcess(NodePtr _ptr)
   }
 }
 
+//////////////////////////////////////////////////
+void TopicManager::AddPublicationToFlush(PublicationPtr _pub)
+{
+  if (_pub)
+  {
+    boost::mutex::scoped_lock lock(this->processNodesMutex);
+    this->publicationsToFlush.insert(_pub);
+  }
+}
+
 //////////////////////////////////////////////////
 void TopicManager::ProcessNodes(bool _onlyOut)
 {
@@ -164,6 +176,23 @@ void TopicManager::ProcessNodes(bool _onlyOut)
     this->nodesToProcess.clear();
   }
 
+  // Send the messages held back by the maximum rate of remote subscribers
+  // that are due, and keep the publications that still have some.
+  {
+    boost::unordered_set<PublicationPtr> pubs;
+    {
+      boost::mutex::scoped_lock lock(this->processNodesMutex);
+      pubs.swap(this->publicationsToFlush);
+    }
+
+    for (auto const &pub : pubs)
+    {
+      pub->FlushPending();
+      if (pub->HasPending())
+        this->AddPublicationToFlush(pub);
+    }
+  }
+
   // Note: In general there are very few nodes. So, parallelization is not
   // needed. Keeping this code for posterity.
   // int s;
@@ -209,7 +238,11 @@ void TopicManager::Publish(const std::string &_topic, MessagePtr _message,
   PublicationPtr pub = this->FindPublication(_topic);
 
   if (pub)
+  {
     pub->Publish(_message, _cb, _id);
+    if (pub->HasPending())
+      this->AddPublicationToFlush(pub);
+  }
   else if (!_cb.empty())
     _cb(_id);
 }
@@ -241,8 +274,15 @@ SubscriberPtr TopicManager::Subscribe(const SubscribeOptions &_ops)
 
   // If the publication exits, just add the subscription to it
   if (pub)
+  {
     pub->AddSubscription(_ops.GetNode());
 
+    double maxRate;
+    Reliability reliability;
+    this->SubscriptionQoS(_ops.GetTopic(), maxRate, reliability);
+    pub->SetTransportQoS(maxRate, reliability);
+  }
+
   // Use this to find other remote publishers
   ConnectionManager::Instance()->Subscribe(_ops.GetTopic(), _ops.GetMsgType(),
                                            _ops.GetLatching());
@@ -353,7 +393,11 @@ void TopicManager::ConnectSubToPub(const msgs::Publish &_pub)
         }
       }
 
-      publink->Init(conn, latched);
+      double maxRate;
+      Reliability reliability;
+      this->SubscriptionQoS(_pub.topic(), maxRate, reliability);
+
+      publink->Init(conn, latched, maxRate, reliability);
 
       publication->AddTransport(publink);
     }
@@ -362,6 +406,39 @@ void TopicManager::ConnectSubToPub(const msgs::Publish &_pub)
   this->ConnectSubscribers(_pub.topic());
 }
 
+//////////////////////////////////////////////////
+void TopicManager::SubscriptionQoS(const std::string &_topic,
+    double &_maxRate, Reliability &_reliability)
+{
+  _maxRate = 0;
+  _reliability = Reliability::RELIABLE;
+
+  SubNodeMap::iterator nodeIter = this->subscribedNodes.find(_topic);
+  if (nodeIter == this->subscribedNodes.end())
+    return;
+
+  bool found = false;
+  bool unlimited = false;
+  bool reliable = false;
+  for (auto const &node : nodeIter->second)
+  {
+    double rate;
+    Reliability nodeReliability;
+    if (!node->LoosestQoS(_topic, rate, nodeReliability))
+      continue;
+
+    found = true;
+    unlimited = unlimited || rate <= 0;
+    reliable = reliable || nodeReliability == Reliability::RELIABLE;
+    _maxRate = std::max(_maxRate, rate);
+  }
+
+  if (!found || unlimited)
+    _maxRate = 0;
+  if (found && !reliable)
+    _reliability = Reliability::BEST_EFFORT;
+}
+
 //////////////////////////////////////////////////
 PublicationPtr TopicManager::UpdatePublications(const std::string &_topic,
                                                 const std::string &_msgType)
@@ -452,3 +529,23 @@ void TopicManager::PauseIncoming(bool _pause)
 {
   this->pauseIncoming = _pause;
 }
+
+//////////////////////////////////////////////////
+bool TopicManager::IncomingPaused() const
+{
+  return this->pauseIncoming;
+}
+
+//////////////////////////////////////////////////
+void TopicManager::SetLatencyClass(const std::string &_topic,
+    const std::string &_msgType, const LatencyClass _class)
+{
+  this->UpdatePublications(_topic, _msgType)->SetLatencyClass(_class);
+}
+
+//////////////////////////////////////////////////
+void TopicManager::SetBatchingMode(const std::string &_topic,
+    const std::string &_msgType, const BatchingMode _mode)
+{
+  this->UpdatePublications(_topic, _msgType)->SetBatchingMode(_mode);
+}
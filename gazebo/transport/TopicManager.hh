@@ -227,10 +227,48 @@ namespace gazebo
       /// \param[in] _pause If true pause processing; otherwse unpause
       public: void PauseIncoming(bool _pause);
 
+      /// \brief Get whether processing of incoming messages is paused.
+      /// \return True if paused.
+      public: bool IncomingPaused() const;
+
+      /// \brief Set how the messages of a topic are delivered in this
+      /// process. The class applies to the publication of the topic, which
+      /// is created if needed.
+      /// \param[in] _topic Fully qualified name of the topic.
+      /// \param[in] _msgType Type of the messages of the topic.
+      /// \param[in] _class The latency class.
+      public: void SetLatencyClass(const std::string &_topic,
+                                   const std::string &_msgType,
+                                   const LatencyClass _class);
+
+      /// \brief Set how the queued messages of a topic are sent by the
+      /// publishers of this process. The mode applies to the publication of
+      /// the topic, which is created if needed.
+      /// \param[in] _topic Fully qualified name of the topic.
+      /// \param[in] _msgType Type of the messages of the topic.
+      /// \param[in] _mode The batching mode.
+      public: void SetBatchingMode(const std::string &_topic,
+                                   const std::string &_msgType,
+                                   const BatchingMode _mode);
+
+      /// \brief Get the loosest quality of service of the subscriptions of
+      /// this process to a topic, to ask remote publishers for.
+      /// \param[in] _topic Fully qualified name of the topic.
+      /// \param[out] _maxRate Highest maximum rate, 0 if a subscription
+      /// has no limit.
+      /// \param[out] _reliability RELIABLE if a subscription is reliable.
+      private: void SubscriptionQoS(const std::string &_topic,
+                   double &_maxRate, Reliability &_reliability);
+
       /// \brief Add a node to the list of nodes that requires processing.
       /// \param[in] _ptr Node to process.
       public: void AddNodeToProcess(NodePtr _ptr);
 
+      /// \brief Add a publication whose remote subscribers keep messages
+      /// held back by their maximum rate, see Publication::FlushPending.
+      /// \param[in] _pub The publication.
+      public: void AddPublicationToFlush(PublicationPtr _pub);
+
       /// \brief A map of string->list of Node pointers
       typedef std::map<std::string, std::list<NodePtr> > SubNodeMap;
 
@@ -243,6 +281,10 @@ namespace gazebo
       /// \brief Nodes that require processing.
       private: boost::unordered_set<NodePtr> nodesToProcess;
 
+      /// \brief Publications with messages held back by the maximum rate
+      /// of remote subscribers.
+      private: boost::unordered_set<PublicationPtr> publicationsToFlush;
+
       private: boost::recursive_mutex nodeMutex;
 
       /// \brief Used to protect subscription connection creation.
@@ -67,6 +67,50 @@ namespace gazebo
     /// \def SubscriptionTransportPtr
     /// \brief Shared_ptr to SubscriptionTransportPtr
     typedef boost::shared_ptr<SubscriptionTransport> SubscriptionTransportPtr;
+
+    /// \enum LatencyClass
+    /// \brief How the messages of a topic are delivered.
+    enum class LatencyClass
+    {
+      /// \brief Messages are queued, and delivered by the connection
+      /// manager thread.
+      NORMAL,
+
+      /// \brief Messages are sent by the thread that publishes them, and
+      /// subscriber callbacks run on the thread that receives them. Meant
+      /// for small messages on which a control loop waits, such as
+      /// commands.
+      LOW_LATENCY
+    };
+
+    /// \enum BatchingMode
+    /// \brief How the queued messages of a topic are sent.
+    enum class BatchingMode
+    {
+      /// \brief Each message is sent on its own.
+      NONE,
+
+      /// \brief The messages queued by a publisher are sent together, as
+      /// a single batch per remote subscriber. Meant for high rate topics.
+      BATCH,
+
+      /// \brief Only the latest message queued by a publisher is sent,
+      /// older ones are dropped before serialization. Meant for state
+      /// topics, such as poses, where only the latest value matters.
+      LATEST_ONLY
+    };
+
+    /// \enum Reliability
+    /// \brief Whether a subscriber needs every message.
+    enum class Reliability
+    {
+      /// \brief Every message is sent to the subscriber, however slow.
+      RELIABLE,
+
+      /// \brief Remote publishers drop messages for the subscriber while
+      /// its connection is busy writing earlier messages.
+      BEST_EFFORT
+    };
   }
 }
 
@@ -22,6 +22,7 @@
 #endif
 
 #include <functional>
+#include <sstream>
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Events.hh"
@@ -37,6 +38,9 @@ using namespace util;
 DiagnosticManager::DiagnosticManager()
 : dataPtr(new DiagnosticManagerPrivate)
 {
+  // Create the tracer first, so that it is destroyed last.
+  Tracer *tracer = Tracer::Instance();
+
 #ifndef _WIN32
   const char *homePath = common::getEnv("HOME");
 #else
@@ -68,12 +72,22 @@ DiagnosticManager::DiagnosticManager()
   // Make sure the path exists.
   if (!boost::filesystem::exists(this->dataPtr->logPath))
     boost::filesystem::create_directories(this->dataPtr->logPath);
+
+  if (tracer->Enabled())
+  {
+    gzlog << "Tracing enabled, the trace will be saved to "
+          << (this->dataPtr->logPath / "trace.json").string() << std::endl;
+  }
 }
 
 //////////////////////////////////////////////////
 DiagnosticManager::~DiagnosticManager()
 {
   this->dataPtr->updateConnection.reset();
+
+  Tracer *tracer = Tracer::Instance();
+  if (tracer->EventCount() > 0)
+    tracer->SaveChromeTrace((this->dataPtr->logPath / "trace.json").string());
 }
 
 //////////////////////////////////////////////////
@@ -86,6 +100,11 @@ void DiagnosticManager::Init(const std::string &_worldName)
   this->dataPtr->pub =
     this->dataPtr->node->Advertise<msgs::Diagnostics>("~/diagnostics");
 
+  this->dataPtr->tracePub =
+    this->dataPtr->node->Advertise<msgs::GzString>("~/diagnostics/trace");
+  this->dataPtr->traceSub = this->dataPtr->node->Subscribe(
+      "~/diagnostics/trace_request", &DiagnosticManager::OnTraceRequest, this);
+
   this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
       std::bind(&DiagnosticManager::Update, this, std::placeholders::_1));
 }
@@ -96,6 +115,17 @@ boost::filesystem::path DiagnosticManager::LogPath() const
   return this->dataPtr->logPath;
 }
 
+//////////////////////////////////////////////////
+void DiagnosticManager::OnTraceRequest(ConstEmptyPtr &/*_msg*/)
+{
+  std::ostringstream stream;
+  Tracer::Instance()->WriteChromeTrace(stream);
+
+  msgs::GzString msg;
+  msg.set_data(stream.str());
+  this->dataPtr->tracePub->Publish(msg);
+}
+
 //////////////////////////////////////////////////
 void DiagnosticManager::Update(const common::UpdateInfo &_info)
 {
@@ -293,10 +323,10 @@ void DiagnosticTimer::Stop()
     common::Time elapsed = this->GetElapsed();
     common::Time currTime = common::Time::GetWallTime();
 
-    // Write out the total elapsed time.
+    // Write out the total elapsed time. The log is flushed when its
+    // buffer fills up and when the timer is destroyed, not on every stop.
     this->dataPtr->log << this->dataPtr->name << " " << currTime << " "
-      << elapsed.Double() << std::endl;
-    this->dataPtr->log.flush();
+      << elapsed.Double() << '\n';
 
     DiagnosticManager::Instance()->AddTime(this->dataPtr->name,
         currTime, elapsed);
@@ -316,7 +346,7 @@ void DiagnosticTimer::Lap(const std::string &_prefix)
 
   // Write out the delta time.
   this->dataPtr->log << this->dataPtr->name << ":" << _prefix << " " <<
-    currTime << " " << delta.Double() << std::endl;
+    currTime << " " << delta.Double() << '\n';
 
   DiagnosticManager::Instance()->AddTime(this->dataPtr->name + ":" + _prefix,
       currTime, delta);
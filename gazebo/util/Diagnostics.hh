@@ -25,7 +25,9 @@
 #include "gazebo/common/UpdateInfo.hh"
 #include "gazebo/common/SingletonT.hh"
 #include "gazebo/common/Timer.hh"
+#include "gazebo/msgs/msgs.hh"
 
+#include "gazebo/util/Tracer.hh"
 #include "gazebo/util/UtilTypes.hh"
 #include "gazebo/util/system.hh"
 
@@ -45,11 +47,29 @@ namespace gazebo
     /// \{
 
 #ifdef ENABLE_DIAGNOSTICS
+    /// \internal
+    /// \brief Forward a DIAG_TIMER macro to the DiagnosticManager, which
+    /// publishes the times on ~/diagnostics and logs them.
+    /// \param[in] _call Call on the DiagnosticManager.
+    #define GZ_DIAG_TIMER_FORWARD(_call) \
+      gazebo::util::DiagnosticManager::Instance()->_call
+#else
+    #define GZ_DIAG_TIMER_FORWARD(_call) ((void) 0)
+#endif
+
     /// \brief Start a diagnostic timer. Make sure to run DIAG_TIMER_STOP to
-    /// stop the timer.
+    /// stop the timer. The timer is recorded by the Tracer, and its name is
+    /// interned on the first call, so it must be the same on every call.
+    /// With ENABLE_DIAGNOSTICS, it is also timed by the DiagnosticManager.
     /// \param[in] _name Name of the timer to start.
     #define DIAG_TIMER_START(_name) \
-    gazebo::util::DiagnosticManager::Instance()->StartTimer(_name);
+    do \
+    { \
+      static const uint32_t gzTraceId = \
+        gazebo::util::Tracer::Instance()->Intern(_name); \
+      gazebo::util::Tracer::Instance()->Begin(gzTraceId); \
+      GZ_DIAG_TIMER_FORWARD(StartTimer(_name)); \
+    } while (0)
 
     /// \brief Output a lap time annotated with a prefix string. A lap is
     /// the time from last call to DIAG_TIMER_LAP or DIAG_TIMER_START, which
@@ -57,17 +77,26 @@ namespace gazebo
     /// \param[in] _name Name of the timer.
     /// \param[in] _prefix String for annotation.
     #define DIAG_TIMER_LAP(_name, _prefix) \
-    gazebo::util::DiagnosticManager::Instance()->Lap(_name, _prefix);
+    do \
+    { \
+      static const uint32_t gzTraceId = \
+        gazebo::util::Tracer::Instance()->Intern(_name); \
+      static const uint32_t gzTraceLapId = \
+        gazebo::util::Tracer::Instance()->Intern(_name, _prefix); \
+      gazebo::util::Tracer::Instance()->Lap(gzTraceId, gzTraceLapId); \
+      GZ_DIAG_TIMER_FORWARD(Lap(_name, _prefix)); \
+    } while (0)
 
     /// \brief Stop a diagnostic timer.
     /// \param[in] name Name of the timer to stop
     #define DIAG_TIMER_STOP(_name) \
-    gazebo::util::DiagnosticManager::Instance()->StopTimer(_name);
-#else
-    #define DIAG_TIMER_START(_name) ((void) 0)
-    #define DIAG_TIMER_LAP(_name, _prefix) ((void)0)
-    #define DIAG_TIMER_STOP(_name) ((void) 0)
-#endif
+    do \
+    { \
+      static const uint32_t gzTraceId = \
+        gazebo::util::Tracer::Instance()->Intern(_name); \
+      gazebo::util::Tracer::Instance()->End(gzTraceId); \
+      GZ_DIAG_TIMER_FORWARD(StopTimer(_name)); \
+    } while (0)
 
     /// \class DiagnosticManager Diagnostics.hh util/util.hh
     /// \brief A diagnostic manager class
@@ -80,7 +109,9 @@ namespace gazebo
       /// \brief Destructor
       private: virtual ~DiagnosticManager();
 
-      /// \brief Initialize to report diagnostics about a world.
+      /// \brief Initialize to report diagnostics about a world. Any message
+      /// on ~/diagnostics/trace_request then publishes the trace of the
+      /// Tracer on ~/diagnostics/trace, as Chrome trace JSON.
       /// \param[in] _worldName Name of the world.
       public: void Init(const std::string &_worldName);
 
@@ -123,6 +154,11 @@ namespace gazebo
       /// \return The path in which logs are stored.
       public: boost::filesystem::path LogPath() const;
 
+      /// \brief Publish the trace of the Tracer as Chrome trace JSON on
+      /// ~/diagnostics/trace.
+      /// \param[in] _msg Request, unused.
+      private: void OnTraceRequest(ConstEmptyPtr &_msg);
+
       /// \brief Publishes diagnostic information.
       /// \param[in] _info World update information.
       private: void Update(const common::UpdateInfo &_info);
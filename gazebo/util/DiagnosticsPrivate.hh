@@ -46,6 +46,12 @@ namespace gazebo
       /// \brief Publisher of diagnostic data.
       public: transport::PublisherPtr pub;
 
+      /// \brief Publisher of Chrome traces.
+      public: transport::PublisherPtr tracePub;
+
+      /// \brief Subscriber to trace requests.
+      public: transport::SubscriberPtr traceSub;
+
       /// \brief The message to output
       public: msgs::Diagnostics msg;
 
@@ -102,6 +102,14 @@ std::set<std::string> IntrospectionClient::Managers() const
 bool IntrospectionClient::NewFilter(const std::string &_managerId,
     const std::set<std::string> &_newItems, std::string &_filterId,
     std::string &_newTopic) const
+{
+  return this->NewFilter(_managerId, _newItems, 0, _filterId, _newTopic);
+}
+
+//////////////////////////////////////////////////
+bool IntrospectionClient::NewFilter(const std::string &_managerId,
+    const std::set<std::string> &_newItems, const double _rate,
+    std::string &_filterId, std::string &_newTopic) const
 {
   if (_newItems.empty())
   {
@@ -123,6 +131,15 @@ bool IntrospectionClient::NewFilter(const std::string &_managerId,
     nextParam->mutable_value()->set_string_value(itemName);
   }
 
+  // Limit the rate of the updates.
+  if (_rate > 0)
+  {
+    auto nextParam = req.add_param();
+    nextParam->set_name("rate");
+    nextParam->mutable_value()->set_type(gazebo::msgs::Any::DOUBLE);
+    nextParam->mutable_value()->set_double_value(_rate);
+  }
+
   // Request the service.
   auto service = "/introspection/" + _managerId + "/filter_new";
   if (!this->dataPtr->node.Request(service, req,
@@ -251,6 +268,56 @@ bool IntrospectionClient::UpdateFilter(const std::string &_managerId,
   return result;
 }
 
+//////////////////////////////////////////////////
+bool IntrospectionClient::UpdateFilter(const std::string &_managerId,
+    const std::string &_filterId, const std::set<std::string> &_newItems,
+    const double _rate) const
+{
+  if (_newItems.empty() || !(_rate >= 0))
+  {
+    gzerr << "Unable to request an introspection filter update on manager ["
+          << _managerId << "] and filter ID [" << _filterId << "]. The list"
+          << " of items was empty or the rate was negative" << std::endl;
+    return false;
+  }
+
+  gazebo::msgs::Param_V req;
+  gazebo::msgs::Empty rep;
+  bool result;
+
+  // Add the filter_id and the rate to the message.
+  auto nextParam = req.add_param();
+  nextParam->set_name("filter_id");
+  nextParam->mutable_value()->set_type(gazebo::msgs::Any::STRING);
+  nextParam->mutable_value()->set_string_value(_filterId);
+
+  nextParam = req.add_param();
+  nextParam->set_name("rate");
+  nextParam->mutable_value()->set_type(gazebo::msgs::Any::DOUBLE);
+  nextParam->mutable_value()->set_double_value(_rate);
+
+  // Add to the message the list of items to include in the filter.
+  for (auto const &itemName : _newItems)
+  {
+    nextParam = req.add_param();
+    nextParam->set_name("item");
+    nextParam->mutable_value()->set_type(gazebo::msgs::Any::STRING);
+    nextParam->mutable_value()->set_string_value(itemName);
+  }
+
+  // Request the service.
+  auto service = "/introspection/" + _managerId + "/filter_update";
+  if (!this->dataPtr->node.Request(service, req,
+          this->dataPtr->kTimeout, rep, result))
+  {
+    gzerr << "Unable to request an introspection filter update on manager ["
+          << _managerId << "] and filter ID [" << _filterId << "]" << std::endl;
+    return false;
+  }
+
+  return result;
+}
+
 //////////////////////////////////////////////////
 bool IntrospectionClient::UpdateFilter(const std::string &_managerId,
     const std::string &_filterId, const std::set<std::string> &_newItems,
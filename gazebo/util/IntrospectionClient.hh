@@ -77,6 +77,24 @@ namespace gazebo
                              std::string &_filterId,
                              std::string &_newTopic) const;
 
+      /// \brief Create a new filter for observing item updates, with a
+      /// limited rate. This function will block until the result is
+      /// received.
+      /// \param[in] _managerID ID of the manager to request the operation.
+      /// \param[in] _newItems Non-empty set of items to observe.
+      /// \param[in] _rate Maximum number of updates per second of wall clock
+      /// time, 0 to receive an update on every world update.
+      /// \param[out] _filterId Unique ID of the filter. You'll need this ID
+      /// for future filter updates or for removing it.
+      /// \param[out] _newTopic After the filter creation, a client should
+      /// subscribe to this topic for receiving updates.
+      /// \return True if the filter was successfully created or false otherwise
+      public: bool NewFilter(const std::string &_managerId,
+                             const std::set<std::string> &_newItems,
+                             const double _rate,
+                             std::string &_filterId,
+                             std::string &_newTopic) const;
+
       /// \brief Create a new filter for observing item updates. This function
       /// will create a new topic for sending periodic updates of the items
       /// specified in the filter. This function will not block, the result
@@ -109,6 +127,19 @@ namespace gazebo
                                 const std::string &_filterId,
                                 const std::set<std::string> &_newItems) const;
 
+      /// \brief Update an existing filter with a different set of items and
+      /// rate. This function will block until the result is received.
+      /// \param[in] _managerID ID of the manager to request the operation.
+      /// \param[in] _filterId ID of the filter to update.
+      /// \param[in] _newItems Non-empty set of items to be observed.
+      /// \param[in] _rate Maximum number of updates per second of wall clock
+      /// time, 0 to receive an update on every world update.
+      /// \return True if the filter was successfuly updated or false otherwise.
+      public: bool UpdateFilter(const std::string &_managerId,
+                                const std::string &_filterId,
+                                const std::set<std::string> &_newItems,
+                                const double _rate) const;
+
       /// \brief Update an existing filter with a different set of items.
       /// This function will not block, the result will be received in a
       /// callback function.
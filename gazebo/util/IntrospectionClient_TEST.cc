@@ -460,6 +460,43 @@ TEST_F(IntrospectionClientTest, ItemsAsync)
         std::set<std::string> {"item1", "item2"}));
 }
 
+/////////////////////////////////////////////////
+TEST_F(IntrospectionClientTest, FilterRate)
+{
+  std::string filterId;
+  std::string topic;
+
+  // A filter with at most one update per second.
+  std::set<std::string> items = {"item1", "item2"};
+  EXPECT_TRUE(this->client.NewFilter(this->managerId, items, 1.0, filterId,
+      topic));
+  this->Subscribe(topic);
+
+  // The first update is published, the next one is too early.
+  this->manager->Update();
+  EXPECT_TRUE(this->callbackExecuted);
+  this->callbackExecuted = false;
+
+  this->manager->Update();
+  EXPECT_FALSE(this->callbackExecuted);
+
+  // Negative rates are rejected.
+  EXPECT_FALSE(this->client.UpdateFilter(this->managerId, filterId, items,
+      -1.0));
+
+  // Without limit, every update is published.
+  EXPECT_TRUE(this->client.UpdateFilter(this->managerId, filterId, items,
+      0.0));
+  for (int i = 0; i < 3; ++i)
+  {
+    this->manager->Update();
+    EXPECT_TRUE(this->callbackExecuted);
+    this->callbackExecuted = false;
+  }
+
+  EXPECT_TRUE(this->client.RemoveFilter(this->managerId, filterId));
+}
+
 /////////////////////////////////////////////////
 TEST_F(IntrospectionClientTest, Exception)
 {
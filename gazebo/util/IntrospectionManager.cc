@@ -120,6 +120,13 @@ bool IntrospectionManager::Register(const std::string &_item,
 
   this->dataPtr->itemsUpdated = true;
 
+  // A filter may be waiting for this item.
+  if (this->dataPtr->observedItems.find(_item) !=
+      this->dataPtr->observedItems.end())
+  {
+    this->dataPtr->planDirty = true;
+  }
+
   return true;
 }
 
@@ -140,6 +147,12 @@ bool IntrospectionManager::Unregister(const std::string &_item)
 
   this->dataPtr->itemsUpdated = true;
 
+  if (this->dataPtr->observedItems.find(_item) !=
+      this->dataPtr->observedItems.end())
+  {
+    this->dataPtr->planDirty = true;
+  }
+
   return true;
 }
 
@@ -149,6 +162,8 @@ void IntrospectionManager::Clear()
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
   this->dataPtr->allItems.clear();
   this->dataPtr->itemsUpdated = true;
+  if (!this->dataPtr->observedItems.empty())
+    this->dataPtr->planDirty = true;
 }
 
 //////////////////////////////////////////////////
@@ -169,89 +184,144 @@ std::set<std::string> IntrospectionManager::Items() const
 //////////////////////////////////////////////////
 void IntrospectionManager::Update()
 {
-  std::map<std::string, IntrospectionFilter> filtersCopy;
-  std::map<std::string, std::function <gazebo::msgs::Any ()>> allItemsCopy;
-  std::map<std::string, ObservedItem> observedItemsCopy;
+  std::lock_guard<std::mutex> updateLock(this->dataPtr->updateMutex);
 
+  std::shared_ptr<const IntrospectionPlan> plan;
   {
     std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    if (this->dataPtr->planDirty)
+      this->RebuildPlan();
 
-    // Make a copy of these members for avoiding locking a mutex while calling a
-    // user callback (we could create a deadlock).
-    // More creative solutions are welcome.
-    filtersCopy = this->dataPtr->filters;
-    allItemsCopy = this->dataPtr->allItems;
-    observedItemsCopy = this->dataPtr->observedItems;
+    // Keep the plan alive while using it without the mutex, so that user
+    // callbacks can be called without locking it (we could create a
+    // deadlock).
+    plan = this->dataPtr->plan;
   }
 
-  for (auto &observedItem : observedItemsCopy)
+  if (!plan->filters.empty())
   {
-    auto &item = observedItem.first;
-    auto itemIter = allItemsCopy.find(item);
+    // The buffers are only resized when the plan changes.
+    auto &values = this->dataPtr->values;
+    auto &evaluated = this->dataPtr->evaluated;
+    if (values.size() != plan->callbacks.size())
+      values.resize(plan->callbacks.size());
+    evaluated.assign(plan->callbacks.size(), 0);
 
-    // Sanity check: Make sure that we can update the item.
-    if (itemIter == allItemsCopy.end())
-      continue;
+    const auto now = std::chrono::steady_clock::now();
 
-    try
-    {
-      // Update the values of the items under observation.
-      gazebo::msgs::Any value = itemIter->second();
-      auto &lastValue = observedItem.second.lastValue;
-      lastValue.CopyFrom(value);
-    }
-    catch(...)
+    for (auto const &filter : plan->filters)
     {
-      gzerr << "Exception caught calling user callback" << std::endl;
-      continue;
+      auto &state = *filter.state;
+      if (filter.period != std::chrono::steady_clock::duration::zero())
+      {
+        if (now < state.nextUpdate)
+          continue;
+        state.nextUpdate = now + filter.period;
+      }
+
+      // Clearing the message keeps its parameters allocated for reuse.
+      auto &nextMsg = state.msg;
+      nextMsg.Clear();
+
+      // Insert the last value of each item under observation for this
+      // filter. Items shared by several filters are only evaluated once.
+      for (auto const index : filter.items)
+      {
+        if (!evaluated[index])
+        {
+          evaluated[index] = 1;
+          try
+          {
+            values[index] = plan->callbacks[index]();
+          }
+          catch(...)
+          {
+            gzerr << "Exception caught calling user callback" << std::endl;
+            evaluated[index] = 2;
+          }
+        }
+
+        // Sanity check: Make sure that the value was updated.
+        // (e.g.: an exception was not raised).
+        if (evaluated[index] != 1 ||
+            values[index].type() == gazebo::msgs::Any::NONE)
+        {
+          continue;
+        }
+
+        auto nextParam = nextMsg.add_param();
+        nextParam->set_name(plan->names[index]);
+        nextParam->mutable_value()->CopyFrom(values[index]);
+      }
+
+      // Sanity check: Make sure that we have at least one item updated.
+      if (nextMsg.param_size() == 0)
+        continue;
+
+      // Publish the update for this filter. Copies of a publisher share its
+      // topic, and publishing needs a non-const one.
+      auto pub = filter.pub;
+      if (!pub.Publish(nextMsg))
+      {
+        gzerr << "Error publishing update for topic [" << filter.topic << "]"
+          << std::endl;
+      }
     }
   }
 
-  // Prepare the next message to be sent in each filter.
-  for (auto &filter : filtersCopy)
+  this->NotifyUpdates();
+}
+
+//////////////////////////////////////////////////
+void IntrospectionManager::RebuildPlan()
+{
+  auto plan = std::make_shared<IntrospectionPlan>();
+  std::map<std::string, size_t> indices;
+
+  for (auto const &filter : this->dataPtr->filters)
   {
-    // First of all, clear the old message.
-    auto &nextMsg = filter.second.msg;
-    nextMsg.Clear();
+    IntrospectionPlanFilter planFilter;
+    planFilter.topic = this->dataPtr->prefix + "filter/" + filter.first;
+
+    auto pubIter = this->dataPtr->filterPubs.find(planFilter.topic);
+    if (pubIter == this->dataPtr->filterPubs.end())
+      continue;
+    planFilter.pub = pubIter->second;
 
-    // Insert the last value of each item under observation for this filter.
     for (auto const &item : filter.second.items)
     {
       // Sanity check: Make sure that someone registered this item.
-      if (allItemsCopy.find(item) == allItemsCopy.end())
+      auto itemIter = this->dataPtr->allItems.find(item);
+      if (itemIter == this->dataPtr->allItems.end())
         continue;
 
-      // Sanity check: Make sure that the value was updated.
-      // (e.g.: an exception was not raised).
-      auto &lastValue = observedItemsCopy[item].lastValue;
-      if (lastValue.type() == gazebo::msgs::Any::NONE)
-        continue;
-
-      auto nextParam = nextMsg.add_param();
-      nextParam->set_name(item);
-      nextParam->mutable_value()->CopyFrom(lastValue);
+      auto indexIter = indices.find(item);
+      if (indexIter == indices.end())
+      {
+        indexIter = indices.emplace(item, plan->names.size()).first;
+        plan->names.push_back(item);
+        plan->callbacks.push_back(itemIter->second);
+      }
+      planFilter.items.push_back(indexIter->second);
     }
 
-    // Sanity check: Make sure that we have at least one item updated.
-    if (nextMsg.param_size() == 0)
+    if (planFilter.items.empty())
       continue;
 
-    // Publish the update for this filter.
-    std::string topicName = this->dataPtr->prefix + "filter/" + filter.first;
-
+    planFilter.period = std::chrono::steady_clock::duration::zero();
+    if (filter.second.rate > 0)
     {
-      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-      if (this->dataPtr->filterPubs.find(topicName) ==
-          this->dataPtr->filterPubs.end() ||
-          !this->dataPtr->filterPubs[topicName].Publish(nextMsg))
-      {
-        gzerr << "Error publishing update for topic [" << topicName << "]"
-          << std::endl;
-      }
+      planFilter.period =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / filter.second.rate));
     }
+    planFilter.state = filter.second.state;
+
+    plan->filters.push_back(planFilter);
   }
 
-  this->NotifyUpdates();
+  this->dataPtr->plan = plan;
+  this->dataPtr->planDirty = false;
 }
 
 //////////////////////////////////////////////////
@@ -283,7 +353,7 @@ void IntrospectionManager::NotifyUpdates()
 
 //////////////////////////////////////////////////
 bool IntrospectionManager::NewFilter(const std::set<std::string> &_newItems,
-    std::string &_filterId)
+    const double _rate, std::string &_filterId)
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
@@ -316,11 +386,14 @@ bool IntrospectionManager::NewFilter(const std::set<std::string> &_newItems,
 
   // Add the items to the new filter.
   this->dataPtr->filters[_filterId].items = _newItems;
+  this->dataPtr->filters[_filterId].rate = _rate;
 
   // Register the new filter in the list of observed items.
   for (auto const &item : _newItems)
     this->dataPtr->observedItems[item].filters.emplace(_filterId);
 
+  this->dataPtr->planDirty = true;
+
   return true;
 }
 
@@ -378,6 +451,29 @@ bool IntrospectionManager::UpdateFilter(const std::string &_filterId,
     }
   }
 
+  this->dataPtr->planDirty = true;
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool IntrospectionManager::SetFilterRate(const std::string &_filterId,
+    const double _rate)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  // Sanity check: Make sure that filter ID exists.
+  auto iter = this->dataPtr->filters.find(_filterId);
+  if (iter == this->dataPtr->filters.end())
+  {
+    gzwarn << "Unknown ID [" << _filterId << "] in filter update" << std::endl;
+    gzwarn << "Ignoring request." << std::endl;
+    return false;
+  }
+
+  iter->second.rate = _rate;
+  this->dataPtr->planDirty = true;
+
   return true;
 }
 
@@ -426,6 +522,8 @@ bool IntrospectionManager::RemoveFilter(const std::string &_filterId)
       this->dataPtr->observedItems.erase(oldItem);
   }
 
+  this->dataPtr->planDirty = true;
+
   return true;
 }
 
@@ -445,11 +543,22 @@ void IntrospectionManager::NewFilter(const gazebo::msgs::Param_V &_req,
   }
 
   std::set<std::string> requestedItems;
+  double rate = 0;
 
   // Store the new filter.
   for (auto i = 0; i < _req.param_size(); ++i)
   {
     auto param = _req.param(i);
+    if (param.name() == "rate")
+    {
+      if (!this->ParseRate(param, rate))
+      {
+        gzwarn << "Ignoring request." << std::endl;
+        return;
+      }
+      continue;
+    }
+
     if (!this->ValidateParameter(param, {"item"}))
     {
       gzwarn << "Invalid parameter[" << param.name() << "] "
@@ -462,7 +571,14 @@ void IntrospectionManager::NewFilter(const gazebo::msgs::Param_V &_req,
   }
 
   std::string topicName;
-  if (!this->NewFilter(requestedItems, topicName))
+  if (requestedItems.empty())
+  {
+    gzwarn << "Filter request without items." << std::endl;
+    gzwarn << "Ignoring request." << std::endl;
+    return;
+  }
+
+  if (!this->NewFilter(requestedItems, rate, topicName))
   {
     gzwarn << "Ignoring request." << std::endl;
     return;
@@ -489,10 +605,23 @@ void IntrospectionManager::UpdateFilter(const gazebo::msgs::Param_V &_req,
 
   std::set<std::string> newItems;
   std::string filterId;
+  bool hasRate = false;
+  double rate = 0;
 
   for (auto i = 0; i < _req.param_size(); ++i)
   {
     auto param = _req.param(i);
+    if (param.name() == "rate")
+    {
+      if (!this->ParseRate(param, rate))
+      {
+        gzwarn << "Ignoring request." << std::endl;
+        return;
+      }
+      hasRate = true;
+      continue;
+    }
+
     if (!this->ValidateParameter(param, {"item", "filter_id"}))
     {
       gzwarn << "Ignoring request." << std::endl;
@@ -536,6 +665,9 @@ void IntrospectionManager::UpdateFilter(const gazebo::msgs::Param_V &_req,
   if (!this->UpdateFilter(filterId, newItems))
     return;
 
+  if (hasRate && !this->SetFilterRate(filterId, rate))
+    return;
+
   _result = true;
 }
 
@@ -638,3 +770,26 @@ bool IntrospectionManager::ValidateParameter(const gazebo::msgs::Param &_msg,
 
   return true;
 }
+
+//////////////////////////////////////////////////
+bool IntrospectionManager::ParseRate(const gazebo::msgs::Param &_msg,
+    double &_rate) const
+{
+  if (!_msg.has_value() ||
+      _msg.value().type() != gazebo::msgs::Any::DOUBLE ||
+      !_msg.value().has_double_value())
+  {
+    gzwarn << "Expected a 'rate' parameter with DOUBLE value." << std::endl;
+    return false;
+  }
+
+  if (!(_msg.value().double_value() >= 0))
+  {
+    gzwarn << "Invalid rate [" << _msg.value().double_value() << "]."
+          << std::endl;
+    return false;
+  }
+
+  _rate = _msg.value().double_value();
+  return true;
+}
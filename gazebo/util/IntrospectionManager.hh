@@ -87,6 +87,9 @@ namespace gazebo
       /// If there are changes in the items list since the last update,
       /// a new message is published under the topic
       /// "/introspection/<manager_id>/items_update".
+      /// Only the items of the filters due for an update are evaluated,
+      /// once per update, and the messages of the filters are reused. When
+      /// no filter exists, this only checks for changes in the items list.
       public: void Update();
 
       /// \brief If there are changes in the items list since the last update,
@@ -116,8 +119,11 @@ namespace gazebo
       /// for future filter updates or for removing it. After the filter
       /// creation, a client should subscribe to the topic
       /// /introspection/filter/<filter_id> for receiving updates.
+      /// \param[in] _rate Maximum number of updates per second of wall
+      /// clock time, 0 to publish on every update.
       /// \return True if the filter was successfully created or false otherwise
       private: bool NewFilter(const std::set<std::string> &_newItems,
+                              const double _rate,
                               std::string &_filterId);
 
       /// \brief Update an existing filter with a different set of items.
@@ -127,15 +133,29 @@ namespace gazebo
       private: bool UpdateFilter(const std::string &_filterId,
                                  const std::set<std::string> &_newItems);
 
+      /// \brief Change the rate of an existing filter.
+      /// \param[in] _filterId ID of the filter to update.
+      /// \param[in] _rate Maximum number of updates per second of wall
+      /// clock time, 0 to publish on every update.
+      /// \return True if the filter was successfuly updated or false otherwise.
+      private: bool SetFilterRate(const std::string &_filterId,
+                                  const double _rate);
+
       /// \brief Remove an existing filter.
       /// \param[in] _filterId ID of the filter to remove.
       /// \return True if the filter was successfully removed or false otherwise
       private: bool RemoveFilter(const std::string &_filterId);
 
+      /// \brief Rebuild the update plan from the filters and the registered
+      /// items. The mutex must be locked.
+      private: void RebuildPlan();
+
       /// \brief Internal callback for creating a filter via service request.
       /// \param[in] _req Input parameter of the service request. The service
       /// expects a collection of one or more parameters with name "item" and a
       /// value of type STRING containing the name of the item to observe.
+      /// An optional parameter with name "rate" and a value of type DOUBLE
+      /// limits the number of updates per second, see NewFilter.
       /// \param[out] _rep Output parameter of the service request. It contains
       /// the filter ID created.
       /// \param[out] _result True when the operation succeed or false
@@ -150,6 +170,8 @@ namespace gazebo
       /// containing the filter ID to be updated. Also, it's expected to have
       /// a collection of one or more parameters with name "item" and a
       /// value of type STRING containing the name of the item to observe.
+      /// An optional parameter with name "rate" and a value of type DOUBLE
+      /// changes the rate of the filter, which is kept otherwise.
       /// \param[out] _rep Not used.
       /// \param[out] _result True when the filter was successfully updated or
       /// false otherwise.
@@ -194,6 +216,13 @@ namespace gazebo
       private: bool ValidateParameter(const gazebo::msgs::Param &_msg,
                              const std::set<std::string> &_allowedValues) const;
 
+      /// \brief Helper function for reading the "rate" parameter of a filter.
+      /// \param[in] _msg Parameter named "rate".
+      /// \param[out] _rate The rate.
+      /// \return True when the value is a non-negative DOUBLE.
+      private: bool ParseRate(const gazebo::msgs::Param &_msg,
+                              double &_rate) const;
+
       /// \brief This is a singleton.
       private: friend class SingletonT<IntrospectionManager>;
 
@@ -17,11 +17,14 @@
 #ifndef GAZEBO_UTIL_INTROSPECTION_MANAGER_PRIVATE_HH_
 #define GAZEBO_UTIL_INTROSPECTION_MANAGER_PRIVATE_HH_
 
+#include <chrono>
 #include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <string>
+#include <vector>
 #include <ignition/transport.hh>
 #include "gazebo/msgs/any.pb.h"
 #include "gazebo/msgs/param_v.pb.h"
@@ -31,27 +34,74 @@ namespace gazebo
 {
   namespace util
   {
+    /// \brief State of a filter used by the updates only.
+    struct IntrospectionFilterState
+    {
+      /// \brief Message containing the next update. A message is a collection
+      /// of items and values. It is reused by every update, so that its
+      /// parameters are only allocated once.
+      msgs::Param_V msg;
+
+      /// \brief Wall clock time of the next update, for rate limited filters.
+      std::chrono::steady_clock::time_point nextUpdate;
+    };
+
     /// \brief Private data for the IntrospectionFilter class.
     struct IntrospectionFilter
     {
       /// \brief Items observed by this filter.
       std::set<std::string> items;
 
-      /// \brief Message containing the next update. A message is a collection
-      /// of items and values.
-      msgs::Param_V msg;
+      /// \brief Maximum number of updates per second, 0 for no limit.
+      double rate = 0;
+
+      /// \brief State shared with the update plans.
+      std::shared_ptr<IntrospectionFilterState> state =
+        std::make_shared<IntrospectionFilterState>();
     };
 
-    /// \brief Todo.
+    /// \brief An item with at least one filter.
     struct ObservedItem
     {
-      /// \brief ToDo.
-      gazebo::msgs::Any lastValue;
-
-      /// \brief ToDo.
+      /// \brief Filters containing the item.
       std::set<std::string> filters;
     };
 
+    /// \brief A filter of an update plan.
+    struct IntrospectionPlanFilter
+    {
+      /// \brief Topic of the filter.
+      std::string topic;
+
+      /// \brief Publisher of the filter.
+      ignition::transport::Node::Publisher pub;
+
+      /// \brief Indices of the registered items of the filter in the plan.
+      std::vector<size_t> items;
+
+      /// \brief Time between updates, zero for no limit.
+      std::chrono::steady_clock::duration period;
+
+      /// \brief Message buffer and time of the next update.
+      std::shared_ptr<IntrospectionFilterState> state;
+    };
+
+    /// \brief What an update evaluates and publishes. A plan is never
+    /// modified: the registries build a new one when their observed items
+    /// or filters change, and updates keep using the plan they started
+    /// with, without copying the registries nor holding the mutex.
+    struct IntrospectionPlan
+    {
+      /// \brief Names of the observed registered items.
+      std::vector<std::string> names;
+
+      /// \brief Callbacks of the observed registered items.
+      std::vector<std::function <gazebo::msgs::Any ()>> callbacks;
+
+      /// \brief Filters with at least one registered item.
+      std::vector<IntrospectionPlanFilter> filters;
+    };
+
     /// \brief Private data for the IntrospectionManager class.
     class IntrospectionManagerPrivate
     {
@@ -77,6 +127,24 @@ namespace gazebo
       /// \brief Mutex to make this class thread-safe.
       public: mutable std::mutex mutex;
 
+      /// \brief Current update plan, replaced when it is rebuilt.
+      public: std::shared_ptr<const IntrospectionPlan> plan =
+        std::make_shared<IntrospectionPlan>();
+
+      /// \brief True when the plan must be rebuilt before the next update.
+      public: bool planDirty = false;
+
+      /// \brief Serializes updates. Held while calling the item callbacks,
+      /// unlike mutex, so that the callbacks can register items.
+      public: std::mutex updateMutex;
+
+      /// \brief Values of the plan items in the current update.
+      public: std::vector<gazebo::msgs::Any> values;
+
+      /// \brief Whether each plan item was evaluated in the current update:
+      /// 0 if not yet, 1 if evaluated, 2 if its callback failed.
+      public: std::vector<char> evaluated;
+
       /// \brief Node used for communications.
       public: ignition::transport::Node node;
 
@@ -0,0 +1,802 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+#include <ignition/math/Quaternion.hh>
+#include <ignition/math/Vector3.hh>
+#include <sdf/sdf.hh>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/util/LogChunkPrivate.hh"
+#include "gazebo/util/LogChunk.hh"
+
+using namespace gazebo;
+using namespace util;
+
+namespace
+{
+  /// \brief Magic bytes at the start of a binary log file.
+  const char kMagic[8] = {'G', 'Z', 'L', 'O', 'G', 'B', 'I', 'N'};
+
+  /// \brief Magic bytes at the end of a binary log file.
+  const char kFooterMagic[8] = {'G', 'Z', 'L', 'O', 'G', 'I', 'D', 'X'};
+
+  /// \brief Written after kMagic to detect files from a machine with a
+  /// different byte order.
+  const uint32_t kByteOrderMark = 0x01020304;
+
+  /// \brief Append the bytes of a value to a buffer.
+  /// \param[out] _out The buffer.
+  /// \param[in] _value Value to append.
+  template<typename T>
+  void Append(std::string &_out, const T &_value)
+  {
+    _out.append(reinterpret_cast<const char *>(&_value), sizeof(T));
+  }
+
+  /// \brief Append a string, prefixed by its size, to a buffer.
+  /// \param[out] _out The buffer.
+  /// \param[in] _value String to append.
+  void AppendString(std::string &_out, const std::string &_value)
+  {
+    Append(_out, static_cast<uint32_t>(_value.size()));
+    _out.append(_value);
+  }
+
+  /// \brief Append a record header to a buffer.
+  /// \param[out] _out The buffer.
+  /// \param[in] _type Type of the record.
+  /// \param[in] _size Size of the payload.
+  void AppendRecord(std::string &_out, const LogChunk::RecordType _type,
+      const uint64_t _size)
+  {
+    Append(_out, static_cast<uint32_t>(_type));
+    Append(_out, _size);
+  }
+
+  /// \brief Append the summary of a chunk to a buffer.
+  /// \param[out] _out The buffer.
+  /// \param[in] _summary The summary.
+  void AppendSummary(std::string &_out, const LogChunk::Summary &_summary)
+  {
+    Append(_out, _summary.frameCount);
+    Append(_out, _summary.firstIterations);
+    Append(_out, _summary.lastIterations);
+    Append(_out, _summary.startTime.sec);
+    Append(_out, _summary.startTime.nsec);
+    Append(_out, _summary.endTime.sec);
+    Append(_out, _summary.endTime.nsec);
+  }
+
+  /// \brief Reads values from a buffer, with bounds checking.
+  class Reader
+  {
+    /// \brief Constructor
+    /// \param[in] _data Pointer to the buffer.
+    /// \param[in] _size Size of the buffer.
+    public: Reader(const char *_data, const uint64_t _size)
+            : data(_data), size(_size)
+            {
+            }
+
+    /// \brief Read a value.
+    /// \param[out] _value The value.
+    /// \return False if the buffer is too short.
+    public: template<typename T>
+            bool Read(T &_value)
+            {
+              if (this->size - this->pos < sizeof(T))
+                return false;
+              std::memcpy(&_value, this->data + this->pos, sizeof(T));
+              this->pos += sizeof(T);
+              return true;
+            }
+
+    /// \brief Read a string prefixed by its size.
+    /// \param[out] _value The string.
+    /// \return False if the buffer is too short.
+    public: bool ReadString(std::string &_value)
+            {
+              uint32_t length;
+              if (!this->Read(length) || this->size - this->pos < length)
+                return false;
+              _value.assign(this->data + this->pos, length);
+              this->pos += length;
+              return true;
+            }
+
+    /// \brief Read the summary of a chunk.
+    /// \param[out] _summary The summary.
+    /// \return False if the buffer is too short.
+    public: bool ReadSummary(LogChunk::Summary &_summary)
+            {
+              return this->Read(_summary.frameCount) &&
+                  this->Read(_summary.firstIterations) &&
+                  this->Read(_summary.lastIterations) &&
+                  this->Read(_summary.startTime.sec) &&
+                  this->Read(_summary.startTime.nsec) &&
+                  this->Read(_summary.endTime.sec) &&
+                  this->Read(_summary.endTime.nsec);
+            }
+
+    /// \brief Number of bytes left.
+    /// \return Bytes left in the buffer.
+    public: uint64_t Remaining() const
+            {
+              return this->size - this->pos;
+            }
+
+    /// \brief The buffer.
+    private: const char *data;
+
+    /// \brief Size of the buffer.
+    private: uint64_t size;
+
+    /// \brief Current read position.
+    private: uint64_t pos = 0;
+  };
+
+  /// \brief Output a pose stored as position and quaternion (w x y z).
+  /// \param[out] _out Stream to output to.
+  /// \param[in] _v Pointer to the seven values of the pose.
+  void OutputPose(std::ostream &_out, const double *_v)
+  {
+    ignition::math::Vector3d euler =
+        ignition::math::Quaterniond(_v[3], _v[4], _v[5], _v[6]).Euler();
+    _out << "<pose>" << _v[0] << " " << _v[1] << " " << _v[2] << " "
+         << euler.X() << " " << euler.Y() << " " << euler.Z() << "</pose>";
+  }
+
+  /// \brief Output values separated by spaces.
+  /// \param[out] _out Stream to output to.
+  /// \param[in] _v Pointer to the values.
+  /// \param[in] _count Number of values.
+  void OutputValues(std::ostream &_out, const double *_v,
+      const unsigned int _count)
+  {
+    for (unsigned int i = 0; i < _count; ++i)
+      _out << (i > 0 ? " " : "") << _v[i];
+  }
+}
+
+//////////////////////////////////////////////////
+LogChunk::LogChunk()
+  : dataPtr(new LogChunkPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+LogChunk::~LogChunk()
+{
+}
+
+//////////////////////////////////////////////////
+void LogChunk::Clear()
+{
+  this->dataPtr->world.clear();
+  this->dataPtr->entities.clear();
+  this->dataPtr->columnCount = 0;
+  this->dataPtr->frames.clear();
+  this->dataPtr->values.clear();
+  this->dataPtr->pendingEntities.clear();
+  this->dataPtr->pendingValues.clear();
+  this->dataPtr->ready.clear();
+  this->dataPtr->readyCount = 0;
+}
+
+//////////////////////////////////////////////////
+void LogChunk::BeginFrame(const std::string &_world,
+    const uint64_t _iterations, const common::Time &_simTime,
+    const common::Time &_realTime, const common::Time &_wallTime,
+    const std::vector<std::string> &_insertions,
+    const std::vector<std::string> &_deletions)
+{
+  this->dataPtr->pendingWorld = _world;
+  this->dataPtr->pendingFrame.iterations = _iterations;
+  this->dataPtr->pendingFrame.simTime = _simTime;
+  this->dataPtr->pendingFrame.realTime = _realTime;
+  this->dataPtr->pendingFrame.wallTime = _wallTime;
+  this->dataPtr->pendingFrame.insertions = _insertions;
+  this->dataPtr->pendingFrame.deletions = _deletions;
+  this->dataPtr->pendingEntities.clear();
+  this->dataPtr->pendingValues.clear();
+}
+
+//////////////////////////////////////////////////
+int LogChunk::AddEntity(const EntityType _type, const int _parent,
+    const std::string &_name, const double *_values,
+    const unsigned int _count)
+{
+  LogChunkEntity entity;
+  entity.type = _type;
+  entity.parent = _parent;
+  entity.width = _count;
+  entity.name = _name;
+  entity.column = this->dataPtr->pendingValues.size();
+
+  this->dataPtr->pendingEntities.push_back(entity);
+  this->dataPtr->pendingValues.insert(this->dataPtr->pendingValues.end(),
+      _values, _values + _count);
+
+  return static_cast<int>(this->dataPtr->pendingEntities.size()) - 1;
+}
+
+//////////////////////////////////////////////////
+void LogChunk::EndFrame()
+{
+  // Close the chunk if the frame does not fit in it.
+  if (!this->dataPtr->frames.empty() &&
+      (this->dataPtr->frames.size() >= kMaxFrames ||
+       this->dataPtr->world != this->dataPtr->pendingWorld ||
+       this->dataPtr->entities != this->dataPtr->pendingEntities))
+  {
+    this->dataPtr->Serialize(this->dataPtr->ready);
+    this->dataPtr->readyCount++;
+  }
+
+  if (this->dataPtr->frames.empty())
+  {
+    this->dataPtr->world = this->dataPtr->pendingWorld;
+    this->dataPtr->entities = this->dataPtr->pendingEntities;
+    this->dataPtr->columnCount = this->dataPtr->pendingValues.size();
+  }
+
+  this->dataPtr->frames.push_back(this->dataPtr->pendingFrame);
+  this->dataPtr->values.insert(this->dataPtr->values.end(),
+      this->dataPtr->pendingValues.begin(),
+      this->dataPtr->pendingValues.end());
+}
+
+//////////////////////////////////////////////////
+unsigned int LogChunk::Write(std::ostream &_out, const bool _flush)
+{
+  if (_flush && !this->dataPtr->frames.empty())
+  {
+    this->dataPtr->Serialize(this->dataPtr->ready);
+    this->dataPtr->readyCount++;
+  }
+
+  unsigned int count = this->dataPtr->readyCount;
+  _out.write(this->dataPtr->ready.data(), this->dataPtr->ready.size());
+
+  this->dataPtr->ready.clear();
+  this->dataPtr->readyCount = 0;
+
+  return count;
+}
+
+//////////////////////////////////////////////////
+void LogChunkPrivate::Serialize(std::string &_out)
+{
+  const uint32_t frameCount = this->frames.size();
+
+  LogChunk::Summary summary;
+  summary.frameCount = frameCount;
+  summary.firstIterations = this->frames.front().iterations;
+  summary.lastIterations = this->frames.back().iterations;
+  summary.startTime = this->frames.front().simTime;
+  summary.endTime = this->frames.back().simTime;
+
+  // Write the payload after a record header, which is filled in last.
+  const size_t recordStart = _out.size();
+  AppendRecord(_out, LogChunk::CHUNK, 0);
+  const size_t payloadStart = _out.size();
+
+  AppendSummary(_out, summary);
+  AppendString(_out, this->world);
+
+  Append(_out, static_cast<uint32_t>(this->entities.size()));
+  for (auto const &entity : this->entities)
+  {
+    Append(_out, static_cast<uint8_t>(entity.type));
+    Append(_out, static_cast<int32_t>(entity.parent));
+    Append(_out, entity.width);
+    AppendString(_out, entity.name);
+  }
+  Append(_out, this->columnCount);
+
+  // Frame header columns
+  for (auto const &frame : this->frames)
+    Append(_out, frame.iterations);
+  for (auto const &frame : this->frames)
+    Append(_out, frame.simTime.sec);
+  for (auto const &frame : this->frames)
+    Append(_out, frame.simTime.nsec);
+  for (auto const &frame : this->frames)
+    Append(_out, frame.realTime.sec);
+  for (auto const &frame : this->frames)
+    Append(_out, frame.realTime.nsec);
+  for (auto const &frame : this->frames)
+    Append(_out, frame.wallTime.sec);
+  for (auto const &frame : this->frames)
+    Append(_out, frame.wallTime.nsec);
+
+  // Value columns. Each column holds one value for every frame.
+  for (uint32_t c = 0; c < this->columnCount; ++c)
+  {
+    for (uint32_t f = 0; f < frameCount; ++f)
+      Append(_out, this->values[f * this->columnCount + c]);
+  }
+
+  // Insertions and deletions are rare, and stored per frame.
+  for (auto const &frame : this->frames)
+  {
+    Append(_out, static_cast<uint32_t>(frame.insertions.size()));
+    for (auto const &insertion : frame.insertions)
+      AppendString(_out, insertion);
+
+    Append(_out, static_cast<uint32_t>(frame.deletions.size()));
+    for (auto const &deletion : frame.deletions)
+      AppendString(_out, deletion);
+  }
+
+  // Fill in the payload size.
+  const uint64_t payloadSize = _out.size() - payloadStart;
+  std::memcpy(&_out[recordStart + sizeof(uint32_t)], &payloadSize,
+      sizeof(payloadSize));
+
+  this->frames.clear();
+  this->values.clear();
+  this->entities.clear();
+  this->columnCount = 0;
+}
+
+//////////////////////////////////////////////////
+bool LogChunk::Load(const char *_data, const uint64_t _size)
+{
+  this->Clear();
+
+  Reader reader(_data, _size);
+
+  Summary summary;
+  uint32_t entityCount;
+  if (!reader.ReadSummary(summary) ||
+      !reader.ReadString(this->dataPtr->world) ||
+      !reader.Read(entityCount))
+  {
+    return false;
+  }
+
+  const uint32_t frameCount = summary.frameCount;
+
+  // Make sure the entities fit before allocating memory for them. Each
+  // takes at least its type, parent, width and the size of its name.
+  const uint64_t entityBytes = sizeof(uint8_t) + sizeof(int32_t) +
+      sizeof(uint32_t) + sizeof(uint32_t);
+  if (reader.Remaining() / entityBytes < entityCount)
+  {
+    this->Clear();
+    return false;
+  }
+
+  // The widths are summed on 64 bits, so that they can't wrap around.
+  uint64_t columns = 0;
+  this->dataPtr->entities.resize(entityCount);
+  for (auto &entity : this->dataPtr->entities)
+  {
+    uint8_t type;
+    int32_t parent;
+    if (!reader.Read(type) || !reader.Read(parent) ||
+        !reader.Read(entity.width) || !reader.ReadString(entity.name) ||
+        type > LIGHT || parent < -1 ||
+        parent >= static_cast<int32_t>(entityCount))
+    {
+      this->Clear();
+      return false;
+    }
+    entity.type = static_cast<EntityType>(type);
+    entity.parent = parent;
+    entity.column = static_cast<uint32_t>(columns);
+    columns += entity.width;
+    if (columns > std::numeric_limits<uint32_t>::max())
+    {
+      this->Clear();
+      return false;
+    }
+  }
+
+  if (!reader.Read(this->dataPtr->columnCount) ||
+      this->dataPtr->columnCount != columns)
+  {
+    this->Clear();
+    return false;
+  }
+
+  // Make sure the columns fit before allocating memory for them.
+  const uint64_t columnBytes = sizeof(uint64_t) + 6 * sizeof(int32_t) +
+      static_cast<uint64_t>(columns) * sizeof(double);
+  if (reader.Remaining() / columnBytes < frameCount)
+  {
+    this->Clear();
+    return false;
+  }
+
+  auto &frames = this->dataPtr->frames;
+  frames.resize(frameCount);
+  for (auto &frame : frames)
+    reader.Read(frame.iterations);
+  for (auto &frame : frames)
+    reader.Read(frame.simTime.sec);
+  for (auto &frame : frames)
+    reader.Read(frame.simTime.nsec);
+  for (auto &frame : frames)
+    reader.Read(frame.realTime.sec);
+  for (auto &frame : frames)
+    reader.Read(frame.realTime.nsec);
+  for (auto &frame : frames)
+    reader.Read(frame.wallTime.sec);
+  for (auto &frame : frames)
+    reader.Read(frame.wallTime.nsec);
+
+  this->dataPtr->values.resize(static_cast<size_t>(frameCount) * columns);
+  for (uint32_t c = 0; c < columns; ++c)
+  {
+    for (uint32_t f = 0; f < frameCount; ++f)
+      reader.Read(this->dataPtr->values[f * columns + c]);
+  }
+
+  for (auto &frame : frames)
+  {
+    uint32_t count;
+    if (!reader.Read(count) || count > reader.Remaining())
+    {
+      this->Clear();
+      return false;
+    }
+    frame.insertions.resize(count);
+    for (auto &insertion : frame.insertions)
+    {
+      if (!reader.ReadString(insertion))
+      {
+        this->Clear();
+        return false;
+      }
+    }
+
+    if (!reader.Read(count) || count > reader.Remaining())
+    {
+      this->Clear();
+      return false;
+    }
+    frame.deletions.resize(count);
+    for (auto &deletion : frame.deletions)
+    {
+      if (!reader.ReadString(deletion))
+      {
+        this->Clear();
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+unsigned int LogChunk::FrameCount() const
+{
+  return this->dataPtr->frames.size();
+}
+
+//////////////////////////////////////////////////
+uint64_t LogChunk::Iterations(const unsigned int _frame) const
+{
+  if (_frame >= this->dataPtr->frames.size())
+    return 0;
+  return this->dataPtr->frames[_frame].iterations;
+}
+
+//////////////////////////////////////////////////
+common::Time LogChunk::SimTime(const unsigned int _frame) const
+{
+  if (_frame >= this->dataPtr->frames.size())
+    return common::Time::Zero;
+  return this->dataPtr->frames[_frame].simTime;
+}
+
+//////////////////////////////////////////////////
+unsigned int LogChunk::EntityCount() const
+{
+  return this->dataPtr->entities.size();
+}
+
+//////////////////////////////////////////////////
+std::string LogChunk::EntityName(const unsigned int _entity) const
+{
+  if (_entity >= this->dataPtr->entities.size())
+    return std::string();
+  return this->dataPtr->entities[_entity].name;
+}
+
+//////////////////////////////////////////////////
+LogChunk::EntityType LogChunk::EntityTypeAt(const unsigned int _entity) const
+{
+  if (_entity >= this->dataPtr->entities.size())
+    return MODEL;
+  return this->dataPtr->entities[_entity].type;
+}
+
+//////////////////////////////////////////////////
+double LogChunk::Value(const unsigned int _frame, const unsigned int _entity,
+    const unsigned int _index) const
+{
+  if (_frame >= this->dataPtr->frames.size() ||
+      _entity >= this->dataPtr->entities.size() ||
+      _index >= this->dataPtr->entities[_entity].width)
+  {
+    return 0;
+  }
+
+  return this->dataPtr->values[_frame * this->dataPtr->columnCount +
+      this->dataPtr->entities[_entity].column + _index];
+}
+
+//////////////////////////////////////////////////
+bool LogChunk::FrameSDF(const unsigned int _frame, std::string &_data) const
+{
+  if (_frame >= this->dataPtr->frames.size())
+    return false;
+
+  const LogChunkFrame &frame = this->dataPtr->frames[_frame];
+  const double *values =
+      this->dataPtr->values.data() + _frame * this->dataPtr->columnCount;
+
+  std::ostringstream out;
+  out.precision(std::numeric_limits<double>::max_digits10);
+
+  out << "<sdf version='" << SDF_VERSION << "'>"
+      << "<state world_name='" << this->dataPtr->world << "'>"
+      << "<sim_time>" << frame.simTime << "</sim_time>"
+      << "<wall_time>" << frame.wallTime << "</wall_time>"
+      << "<real_time>" << frame.realTime << "</real_time>"
+      << "<iterations>" << frame.iterations << "</iterations>";
+
+  if (!frame.insertions.empty())
+  {
+    out << "<insertions>";
+    for (auto const &insertion : frame.insertions)
+      out << insertion;
+    out << "</insertions>";
+  }
+
+  if (!frame.deletions.empty())
+  {
+    out << "<deletions>";
+    for (auto const &deletion : frame.deletions)
+      out << "<name>" << deletion << "</name>";
+    out << "</deletions>";
+  }
+
+  // Entities are stored depth first, so a stack of open elements is
+  // enough to close them in the right order.
+  std::vector<int> open;
+  for (unsigned int i = 0; i < this->dataPtr->entities.size(); ++i)
+  {
+    const LogChunkEntity &entity = this->dataPtr->entities[i];
+
+    while (!open.empty() && open.back() != entity.parent)
+    {
+      out << "</model>";
+      open.pop_back();
+    }
+
+    const double *v = values + entity.column;
+    switch (entity.type)
+    {
+      case LogChunk::MODEL:
+        out << "<model name='" << entity.name << "'>";
+        if (entity.width >= kModelWidth)
+        {
+          OutputPose(out, v);
+          out << "<scale>";
+          OutputValues(out, v + 7, 3);
+          out << "</scale>";
+        }
+        open.push_back(i);
+        break;
+      case LogChunk::LINK:
+        out << "<link name='" << entity.name << "'>";
+        if (entity.width >= kLinkWidth)
+        {
+          OutputPose(out, v);
+          out << "<velocity>";
+          OutputValues(out, v + 7, 6);
+          out << "</velocity>";
+        }
+        out << "</link>";
+        break;
+      case LogChunk::JOINT:
+        out << "<joint name='" << entity.name << "'>";
+        for (unsigned int axis = 0; axis < entity.width; ++axis)
+          out << "<angle axis='" << axis << "'>" << v[axis] << "</angle>";
+        out << "</joint>";
+        break;
+      case LogChunk::LIGHT:
+        out << "<light name='" << entity.name << "'>";
+        if (entity.width >= kLightWidth)
+          OutputPose(out, v);
+        out << "</light>";
+        break;
+    }
+  }
+
+  for (size_t i = 0; i < open.size(); ++i)
+    out << "</model>";
+
+  out << "</state></sdf>";
+
+  _data = out.str();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void LogChunk::WriteSDF(std::ostream &_out, const std::string &_sdf)
+{
+  std::string record;
+  AppendRecord(record, SDF, _sdf.size());
+  record.append(_sdf);
+  _out.write(record.data(), record.size());
+}
+
+//////////////////////////////////////////////////
+void LogChunk::WriteHeader(std::ostream &_out, const std::string &_logVersion,
+    const std::string &_gazeboVersion, const uint32_t _randSeed)
+{
+  std::string payload;
+  AppendString(payload, _logVersion);
+  AppendString(payload, _gazeboVersion);
+  Append(payload, _randSeed);
+
+  std::string record(kMagic, sizeof(kMagic));
+  Append(record, kByteOrderMark);
+  AppendRecord(record, HEADER, payload.size());
+  record.append(payload);
+  _out.write(record.data(), record.size());
+}
+
+//////////////////////////////////////////////////
+void LogChunk::WriteIndex(std::ostream &_out, const uint64_t _offset,
+    const std::vector<Summary> &_index)
+{
+  std::string payload;
+  Append(payload, static_cast<uint64_t>(_index.size()));
+  for (auto const &summary : _index)
+  {
+    Append(payload, summary.offset);
+    Append(payload, summary.size);
+    AppendSummary(payload, summary);
+  }
+
+  std::string record;
+  AppendRecord(record, INDEX, payload.size());
+  record.append(payload);
+
+  // The footer points back to the index record.
+  Append(record, _offset);
+  record.append(kFooterMagic, sizeof(kFooterMagic));
+
+  _out.write(record.data(), record.size());
+}
+
+//////////////////////////////////////////////////
+bool LogChunk::IsBinaryLog(const char *_data, const uint64_t _size)
+{
+  if (_size < MagicSize() || std::memcmp(_data, kMagic, sizeof(kMagic)) != 0)
+    return false;
+
+  uint32_t mark;
+  std::memcpy(&mark, _data + sizeof(kMagic), sizeof(mark));
+  if (mark != kByteOrderMark)
+  {
+    gzerr << "Binary log file was recorded on a machine with a different "
+          << "byte order.\n";
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+uint64_t LogChunk::MagicSize()
+{
+  return sizeof(kMagic) + sizeof(kByteOrderMark);
+}
+
+//////////////////////////////////////////////////
+bool LogChunk::ReadRecord(const char *_data, const uint64_t _size,
+    RecordType &_type, uint64_t &_payloadSize)
+{
+  Reader reader(_data, _size);
+
+  uint32_t type;
+  if (!reader.Read(type) || !reader.Read(_payloadSize) ||
+      type < HEADER || type > INDEX || reader.Remaining() < _payloadSize)
+  {
+    return false;
+  }
+
+  _type = static_cast<RecordType>(type);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool LogChunk::ReadHeader(const char *_data, const uint64_t _size,
+    std::string &_logVersion, std::string &_gazeboVersion,
+    uint32_t &_randSeed)
+{
+  Reader reader(_data, _size);
+  return reader.ReadString(_logVersion) &&
+      reader.ReadString(_gazeboVersion) &&
+      reader.Read(_randSeed);
+}
+
+//////////////////////////////////////////////////
+bool LogChunk::ReadSummary(const char *_data, const uint64_t _size,
+    Summary &_summary)
+{
+  Reader reader(_data, _size);
+  return reader.ReadSummary(_summary);
+}
+
+//////////////////////////////////////////////////
+bool LogChunk::ReadIndex(const char *_data, const uint64_t _size,
+    std::vector<Summary> &_index)
+{
+  _index.clear();
+
+  if (_size < MagicSize() + kFooterSize ||
+      std::memcmp(_data + _size - sizeof(kFooterMagic), kFooterMagic,
+        sizeof(kFooterMagic)) != 0)
+  {
+    return false;
+  }
+
+  uint64_t offset;
+  std::memcpy(&offset, _data + _size - kFooterSize, sizeof(offset));
+
+  RecordType type;
+  uint64_t payloadSize;
+  if (offset >= _size - kFooterSize ||
+      !ReadRecord(_data + offset, _size - kFooterSize - offset, type,
+        payloadSize) || type != INDEX)
+  {
+    return false;
+  }
+
+  Reader reader(_data + offset + kRecordHeaderSize, payloadSize);
+
+  uint64_t count;
+  if (!reader.Read(count))
+    return false;
+
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    Summary summary;
+    if (!reader.Read(summary.offset) || !reader.Read(summary.size) ||
+        !reader.ReadSummary(summary) || summary.offset >= offset ||
+        summary.size > offset - summary.offset)
+    {
+      _index.clear();
+      return false;
+    }
+    _index.push_back(summary);
+  }
+
+  return true;
+}
@@ -0,0 +1,311 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_UTIL_LOGCHUNK_HH_
+#define GAZEBO_UTIL_LOGCHUNK_HH_
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace util
+  {
+    // Forward declare private data class
+    class LogChunkPrivate;
+
+    /// \addtogroup gazebo_util
+    /// \{
+
+    /// \class LogChunk LogChunk.hh util/util.hh
+    /// \brief A block of consecutive world states stored by column. This is
+    /// the unit of data of the "binary" log encoding.
+    ///
+    /// All the frames of a chunk share the same entity layout. Each value
+    /// of an entity, such as the X position of a link, is stored as a
+    /// column that holds one entry per frame.
+    ///
+    /// A binary log file is a sequence of records. Each record starts with
+    /// a RecordType and the size of its payload. The file ends with an
+    /// index of all the chunks, so that LogPlay can find a frame without
+    /// reading the whole file.
+    ///
+    /// \sa LogRecord, LogPlay
+    class GZ_UTIL_VISIBLE LogChunk
+    {
+      /// \brief Type of an entity stored in a chunk.
+      public: enum EntityType
+      {
+        /// \brief Model: pose (position and quaternion w x y z) and scale.
+        MODEL = 0,
+
+        /// \brief Link: pose (position and quaternion w x y z), linear
+        /// velocity and angular velocity.
+        LINK = 1,
+
+        /// \brief Joint: one position per axis.
+        JOINT = 2,
+
+        /// \brief Light: pose (position and quaternion w x y z).
+        LIGHT = 3
+      };
+
+      /// \brief Type of a record in a binary log file.
+      public: enum RecordType
+      {
+        /// \brief Log header: log version, Gazebo version and random seed.
+        HEADER = 1,
+
+        /// \brief SDF text, used for the initial world description.
+        SDF = 2,
+
+        /// \brief A chunk of world states.
+        CHUNK = 3,
+
+        /// \brief Index of all the chunks in the file.
+        INDEX = 4
+      };
+
+      /// \brief Summary of a chunk, which is stored at the start of a
+      /// chunk and in the index of a log file.
+      public: class Summary
+      {
+        /// \brief Offset of the chunk record in the log file.
+        public: uint64_t offset = 0;
+
+        /// \brief Size of the chunk record, including its header.
+        public: uint64_t size = 0;
+
+        /// \brief Number of frames in the chunk.
+        public: uint32_t frameCount = 0;
+
+        /// \brief Iterations of the first frame.
+        public: uint64_t firstIterations = 0;
+
+        /// \brief Iterations of the last frame.
+        public: uint64_t lastIterations = 0;
+
+        /// \brief Simulation time of the first frame.
+        public: common::Time startTime;
+
+        /// \brief Simulation time of the last frame.
+        public: common::Time endTime;
+      };
+
+      /// \brief Number of values stored for a model.
+      public: static const unsigned int kModelWidth = 10;
+
+      /// \brief Number of values stored for a link.
+      public: static const unsigned int kLinkWidth = 13;
+
+      /// \brief Number of values stored for a light.
+      public: static const unsigned int kLightWidth = 7;
+
+      /// \brief Maximum number of frames in a chunk.
+      public: static const unsigned int kMaxFrames = 1000;
+
+      /// \brief Size of the header of each record, in bytes.
+      public: static const unsigned int kRecordHeaderSize = 12;
+
+      /// \brief Size of the footer of a log file, in bytes.
+      public: static const unsigned int kFooterSize = 16;
+
+      /// \brief Constructor
+      public: LogChunk();
+
+      /// \brief Destructor
+      public: virtual ~LogChunk();
+
+      /// \brief Remove all the frames.
+      public: void Clear();
+
+      /// \brief Start a new frame. Add the entities of the frame with
+      /// AddEntity, and finish the frame with EndFrame.
+      /// \param[in] _world Name of the world.
+      /// \param[in] _iterations Simulation iterations.
+      /// \param[in] _simTime Simulation time.
+      /// \param[in] _realTime Real time.
+      /// \param[in] _wallTime Wall time.
+      /// \param[in] _insertions SDF of the models inserted in this frame.
+      /// \param[in] _deletions Names of the models deleted in this frame.
+      public: void BeginFrame(const std::string &_world,
+                  const uint64_t _iterations, const common::Time &_simTime,
+                  const common::Time &_realTime,
+                  const common::Time &_wallTime,
+                  const std::vector<std::string> &_insertions,
+                  const std::vector<std::string> &_deletions);
+
+      /// \brief Add an entity to the current frame. Children must be added
+      /// right after their parent.
+      /// \param[in] _type Type of the entity.
+      /// \param[in] _parent Index of the parent entity in the frame, -1 for
+      /// entities at the top level.
+      /// \param[in] _name Name of the entity, relative to its parent.
+      /// \param[in] _values Values of the entity, see EntityType.
+      /// \param[in] _count Number of values.
+      /// \return Index of the entity in the frame.
+      public: int AddEntity(const EntityType _type, const int _parent,
+                  const std::string &_name, const double *_values,
+                  const unsigned int _count);
+
+      /// \brief Finish the current frame. The chunk is closed, and the frame
+      /// starts a new chunk, if the entities of the frame differ from the
+      /// entities of the chunk, or if the chunk is full.
+      public: void EndFrame();
+
+      /// \brief Write the frames as chunk records, and remove them.
+      /// \param[out] _out Stream to write to.
+      /// \param[in] _flush True to also write the chunk that is still open.
+      /// Otherwise only closed chunks are written.
+      /// \return Number of chunk records written.
+      public: unsigned int Write(std::ostream &_out, const bool _flush = true);
+
+      /// \brief Load a chunk from the payload of a chunk record.
+      /// \param[in] _data Pointer to the payload.
+      /// \param[in] _size Size of the payload.
+      /// \return True if the chunk was valid.
+      public: bool Load(const char *_data, const uint64_t _size);
+
+      /// \brief Get the number of frames.
+      /// \return Number of frames in the chunk.
+      public: unsigned int FrameCount() const;
+
+      /// \brief Get the iterations of a frame.
+      /// \param[in] _frame Index of the frame.
+      /// \return Simulation iterations.
+      public: uint64_t Iterations(const unsigned int _frame) const;
+
+      /// \brief Get the simulation time of a frame.
+      /// \param[in] _frame Index of the frame.
+      /// \return Simulation time.
+      public: common::Time SimTime(const unsigned int _frame) const;
+
+      /// \brief Get the number of entities in each frame.
+      /// \return Number of entities.
+      public: unsigned int EntityCount() const;
+
+      /// \brief Get the name of an entity.
+      /// \param[in] _entity Index of the entity.
+      /// \return Name of the entity, relative to its parent.
+      public: std::string EntityName(const unsigned int _entity) const;
+
+      /// \brief Get the type of an entity.
+      /// \param[in] _entity Index of the entity.
+      /// \return Type of the entity.
+      public: EntityType EntityTypeAt(const unsigned int _entity) const;
+
+      /// \brief Get a value of an entity.
+      /// \param[in] _frame Index of the frame.
+      /// \param[in] _entity Index of the entity.
+      /// \param[in] _index Index of the value, see EntityType.
+      /// \return The value, or 0 if the indices are invalid.
+      public: double Value(const unsigned int _frame,
+                  const unsigned int _entity,
+                  const unsigned int _index) const;
+
+      /// \brief Get a frame as a world state in SDF.
+      /// \param[in] _frame Index of the frame.
+      /// \param[out] _data The <sdf><state> string of the frame.
+      /// \return True if the frame exists.
+      public: bool FrameSDF(const unsigned int _frame,
+                  std::string &_data) const;
+
+      /// \brief Write a record that holds SDF text.
+      /// \param[out] _out Stream to write to.
+      /// \param[in] _sdf The SDF text.
+      public: static void WriteSDF(std::ostream &_out,
+                  const std::string &_sdf);
+
+      /// \brief Write the magic bytes and the header record of a binary
+      /// log file.
+      /// \param[out] _out Stream to write to.
+      /// \param[in] _logVersion Version of the log format.
+      /// \param[in] _gazeboVersion Version of Gazebo.
+      /// \param[in] _randSeed Random number seed.
+      public: static void WriteHeader(std::ostream &_out,
+                  const std::string &_logVersion,
+                  const std::string &_gazeboVersion,
+                  const uint32_t _randSeed);
+
+      /// \brief Write the index record and the footer of a binary log file.
+      /// \param[out] _out Stream to write to.
+      /// \param[in] _offset Offset at which the index record is written.
+      /// \param[in] _index Summary of every chunk in the file.
+      public: static void WriteIndex(std::ostream &_out,
+                  const uint64_t _offset,
+                  const std::vector<Summary> &_index);
+
+      /// \brief Check if data starts with the magic bytes of a binary log.
+      /// \param[in] _data Pointer to the data.
+      /// \param[in] _size Size of the data.
+      /// \return True if the data is a binary log file.
+      public: static bool IsBinaryLog(const char *_data, const uint64_t _size);
+
+      /// \brief Get the size of the magic bytes at the start of a file.
+      /// \return Size in bytes.
+      public: static uint64_t MagicSize();
+
+      /// \brief Read the header of a record.
+      /// \param[in] _data Pointer to the record.
+      /// \param[in] _size Number of bytes available.
+      /// \param[out] _type Type of the record.
+      /// \param[out] _payloadSize Size of the payload of the record.
+      /// \return True if the record is complete.
+      public: static bool ReadRecord(const char *_data, const uint64_t _size,
+                  RecordType &_type, uint64_t &_payloadSize);
+
+      /// \brief Read the payload of a header record.
+      /// \param[in] _data Pointer to the payload.
+      /// \param[in] _size Size of the payload.
+      /// \param[out] _logVersion Version of the log format.
+      /// \param[out] _gazeboVersion Version of Gazebo.
+      /// \param[out] _randSeed Random number seed.
+      /// \return True if the payload was valid.
+      public: static bool ReadHeader(const char *_data, const uint64_t _size,
+                  std::string &_logVersion, std::string &_gazeboVersion,
+                  uint32_t &_randSeed);
+
+      /// \brief Read the summary at the start of a chunk payload.
+      /// \param[in] _data Pointer to the payload.
+      /// \param[in] _size Size of the payload.
+      /// \param[out] _summary The summary. Offset and size are not set.
+      /// \return True if the payload was valid.
+      public: static bool ReadSummary(const char *_data, const uint64_t _size,
+                  Summary &_summary);
+
+      /// \brief Read the index from the end of a binary log file.
+      /// \param[in] _data Pointer to the whole file.
+      /// \param[in] _size Size of the file.
+      /// \param[out] _index Summary of every chunk in the file.
+      /// \return False if the file has no valid index, which happens when
+      /// recording was interrupted.
+      public: static bool ReadIndex(const char *_data, const uint64_t _size,
+                  std::vector<Summary> &_index);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<LogChunkPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_UTIL_LOGCHUNK_PRIVATE_HH_
+#define GAZEBO_UTIL_LOGCHUNK_PRIVATE_HH_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/util/LogChunk.hh"
+
+namespace gazebo
+{
+  namespace util
+  {
+    /// \internal
+    /// \brief An entity in the layout of a chunk.
+    class LogChunkEntity
+    {
+      /// \brief Type of the entity.
+      public: LogChunk::EntityType type = LogChunk::MODEL;
+
+      /// \brief Index of the parent entity, -1 for none.
+      public: int parent = -1;
+
+      /// \brief Number of values.
+      public: uint32_t width = 0;
+
+      /// \brief Name relative to the parent.
+      public: std::string name;
+
+      /// \brief Index of the first column of the entity.
+      public: uint32_t column = 0;
+
+      /// \brief Compare the layout of two entities.
+      /// \param[in] _other Entity to compare to.
+      /// \return True if both entities have the same layout.
+      public: bool operator==(const LogChunkEntity &_other) const
+              {
+                return this->type == _other.type &&
+                    this->parent == _other.parent &&
+                    this->width == _other.width &&
+                    this->name == _other.name;
+              }
+    };
+
+    /// \internal
+    /// \brief Header data of a frame.
+    class LogChunkFrame
+    {
+      /// \brief Simulation iterations.
+      public: uint64_t iterations = 0;
+
+      /// \brief Simulation time.
+      public: common::Time simTime;
+
+      /// \brief Real time.
+      public: common::Time realTime;
+
+      /// \brief Wall time.
+      public: common::Time wallTime;
+
+      /// \brief SDF of the inserted models.
+      public: std::vector<std::string> insertions;
+
+      /// \brief Names of the deleted models.
+      public: std::vector<std::string> deletions;
+    };
+
+    /// \internal
+    /// \brief Private data for LogChunk.
+    class LogChunkPrivate
+    {
+      /// \brief Serialize the frames of the chunk as a chunk record, and
+      /// remove them.
+      /// \param[out] _out Buffer to append the record to.
+      public: void Serialize(std::string &_out);
+
+      /// \brief Name of the world.
+      public: std::string world;
+
+      /// \brief Entity layout shared by all the frames.
+      public: std::vector<LogChunkEntity> entities;
+
+      /// \brief Number of values in a frame.
+      public: uint32_t columnCount = 0;
+
+      /// \brief Header data of each frame.
+      public: std::vector<LogChunkFrame> frames;
+
+      /// \brief Values of all the frames, one frame after the other.
+      public: std::vector<double> values;
+
+      /// \brief Name of the world of the frame being recorded.
+      public: std::string pendingWorld;
+
+      /// \brief Header data of the frame being recorded.
+      public: LogChunkFrame pendingFrame;
+
+      /// \brief Entities of the frame being recorded.
+      public: std::vector<LogChunkEntity> pendingEntities;
+
+      /// \brief Values of the frame being recorded.
+      public: std::vector<double> pendingValues;
+
+      /// \brief Chunk records that are closed and waiting for Write.
+      public: std::string ready;
+
+      /// \brief Number of records in ready.
+      public: unsigned int readyCount = 0;
+    };
+  }
+}
+#endif
@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gazebo/common/Time.hh"
+#include "gazebo/util/LogChunk.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class LogChunk_TEST : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Record a frame with a model, a link and a light.
+/// \param[in] _chunk Chunk to record to.
+/// \param[in] _i Index of the frame, used to generate the values.
+/// \param[in] _link Name of the link.
+void AddFrame(util::LogChunk &_chunk, const unsigned int _i,
+    const std::string &_link = "link")
+{
+  _chunk.BeginFrame("default", 100 + _i, common::Time(_i, 0),
+      common::Time(_i, 1), common::Time(_i, 2),
+      std::vector<std::string>(), std::vector<std::string>());
+
+  const double model[util::LogChunk::kModelWidth] =
+      {0.0 + _i, 1, 2, 1, 0, 0, 0, 1, 1, 1};
+  const double link[util::LogChunk::kLinkWidth] =
+      {0, 0, 0.5 * _i, 1, 0, 0, 0, 0, 0, -1, 0, 0, 0};
+  const double light[util::LogChunk::kLightWidth] =
+      {0, 0, 10, 1, 0, 0, 0};
+
+  int parent = _chunk.AddEntity(util::LogChunk::MODEL, -1, "box", model,
+      util::LogChunk::kModelWidth);
+  _chunk.AddEntity(util::LogChunk::LINK, parent, _link, link,
+      util::LogChunk::kLinkWidth);
+  _chunk.AddEntity(util::LogChunk::LIGHT, -1, "sun", light,
+      util::LogChunk::kLightWidth);
+  _chunk.EndFrame();
+}
+
+/////////////////////////////////////////////////
+/// \brief Write frames, and read them back.
+TEST_F(LogChunk_TEST, RoundTrip)
+{
+  util::LogChunk chunk;
+  for (unsigned int i = 0; i < 5; ++i)
+    AddFrame(chunk, i);
+
+  std::ostringstream stream;
+  EXPECT_EQ(chunk.Write(stream), 1u);
+
+  const std::string data = stream.str();
+  util::LogChunk::RecordType type;
+  uint64_t payloadSize;
+  ASSERT_TRUE(util::LogChunk::ReadRecord(data.data(), data.size(), type,
+        payloadSize));
+  EXPECT_EQ(type, util::LogChunk::CHUNK);
+  EXPECT_EQ(payloadSize + util::LogChunk::kRecordHeaderSize, data.size());
+
+  const char *payload = data.data() + util::LogChunk::kRecordHeaderSize;
+
+  util::LogChunk::Summary summary;
+  ASSERT_TRUE(util::LogChunk::ReadSummary(payload, payloadSize, summary));
+  EXPECT_EQ(summary.frameCount, 5u);
+  EXPECT_EQ(summary.firstIterations, 100u);
+  EXPECT_EQ(summary.lastIterations, 104u);
+  EXPECT_EQ(summary.startTime, common::Time(0, 0));
+  EXPECT_EQ(summary.endTime, common::Time(4, 0));
+
+  util::LogChunk loaded;
+  ASSERT_TRUE(loaded.Load(payload, payloadSize));
+  EXPECT_EQ(loaded.FrameCount(), 5u);
+  EXPECT_EQ(loaded.EntityCount(), 3u);
+  EXPECT_EQ(loaded.EntityName(1), "link");
+  EXPECT_EQ(loaded.EntityTypeAt(2), util::LogChunk::LIGHT);
+
+  for (unsigned int i = 0; i < 5; ++i)
+  {
+    EXPECT_EQ(loaded.Iterations(i), 100u + i);
+    EXPECT_EQ(loaded.SimTime(i), common::Time(i, 0));
+    EXPECT_DOUBLE_EQ(loaded.Value(i, 0, 0), i);
+    EXPECT_DOUBLE_EQ(loaded.Value(i, 1, 2), 0.5 * i);
+    EXPECT_DOUBLE_EQ(loaded.Value(i, 1, 9), -1);
+  }
+
+  // Invalid indices
+  EXPECT_DOUBLE_EQ(loaded.Value(5, 0, 0), 0);
+  EXPECT_DOUBLE_EQ(loaded.Value(0, 0, util::LogChunk::kModelWidth), 0);
+
+  // The frame is rendered as a world state.
+  std::string sdf;
+  EXPECT_FALSE(loaded.FrameSDF(5, sdf));
+  ASSERT_TRUE(loaded.FrameSDF(2, sdf));
+  EXPECT_NE(sdf.find("<state world_name='default'>"), std::string::npos);
+  EXPECT_NE(sdf.find("<iterations>102</iterations>"), std::string::npos);
+  EXPECT_NE(sdf.find("<model name='box'><pose>2 1 2 0 0 0</pose>"),
+      std::string::npos);
+  EXPECT_NE(sdf.find("<link name='link'><pose>0 0 1 0 0 0</pose>"),
+      std::string::npos);
+  EXPECT_NE(sdf.find("</link></model><light name='sun'>"),
+      std::string::npos);
+
+  // A truncated payload is rejected.
+  EXPECT_FALSE(loaded.Load(payload, payloadSize / 2));
+  EXPECT_EQ(loaded.FrameCount(), 0u);
+}
+
+/////////////////////////////////////////////////
+/// \brief Append a value to a payload.
+/// \param[in,out] _payload The payload.
+/// \param[in] _value The value.
+template<typename T>
+void Append(std::string &_payload, const T _value)
+{
+  _payload.append(reinterpret_cast<const char *>(&_value), sizeof(_value));
+}
+
+/////////////////////////////////////////////////
+/// \brief Build the payload of a chunk without frames.
+/// \param[in] _entityCount Number of entities, as stored.
+/// \param[in] _entities Parent and width of each entity.
+/// \param[in] _columnCount Number of columns, as stored.
+/// \return The payload.
+std::string Payload(const uint32_t _entityCount,
+    const std::vector<std::pair<int32_t, uint32_t>> &_entities,
+    const uint32_t _columnCount)
+{
+  // Summary: frame count, first and last iterations, start and end times.
+  std::string payload(4 + 8 + 8 + 16, '\0');
+  Append(payload, static_cast<uint32_t>(7));
+  payload += "default";
+  Append(payload, _entityCount);
+  for (auto const &entity : _entities)
+  {
+    Append(payload, static_cast<uint8_t>(util::LogChunk::MODEL));
+    Append(payload, entity.first);
+    Append(payload, entity.second);
+    Append(payload, static_cast<uint32_t>(1));
+    payload += "m";
+  }
+  Append(payload, _columnCount);
+  return payload;
+}
+
+/////////////////////////////////////////////////
+/// \brief Counts, widths and parents read from a file are checked.
+TEST_F(LogChunk_TEST, Corrupted)
+{
+  util::LogChunk loaded;
+  std::string payload = Payload(2, {{-1, 10}, {0, 3}}, 13);
+  EXPECT_TRUE(loaded.Load(payload.data(), payload.size()));
+  EXPECT_EQ(loaded.EntityCount(), 2u);
+
+  // More entities than the payload can hold
+  payload = Payload(0xffffffff, {{-1, 10}}, 10);
+  EXPECT_FALSE(loaded.Load(payload.data(), payload.size()));
+  EXPECT_EQ(loaded.EntityCount(), 0u);
+
+  // Widths whose sum wraps around
+  payload = Payload(2, {{-1, 0x80000000}, {-1, 0x80000000}}, 0);
+  EXPECT_FALSE(loaded.Load(payload.data(), payload.size()));
+
+  // Parents out of range
+  payload = Payload(2, {{-1, 10}, {-2, 3}}, 13);
+  EXPECT_FALSE(loaded.Load(payload.data(), payload.size()));
+  payload = Payload(2, {{-1, 10}, {2, 3}}, 13);
+  EXPECT_FALSE(loaded.Load(payload.data(), payload.size()));
+}
+
+/////////////////////////////////////////////////
+/// \brief A new chunk starts when the entities change, or when a chunk is
+/// full.
+TEST_F(LogChunk_TEST, Split)
+{
+  util::LogChunk chunk;
+  AddFrame(chunk, 0);
+  AddFrame(chunk, 1);
+  AddFrame(chunk, 2, "other_link");
+
+  // Only the closed chunk is written without a flush.
+  std::ostringstream stream;
+  EXPECT_EQ(chunk.Write(stream, false), 1u);
+  EXPECT_EQ(chunk.Write(stream), 1u);
+  EXPECT_EQ(chunk.Write(stream), 0u);
+
+  for (unsigned int i = 0; i < util::LogChunk::kMaxFrames + 1; ++i)
+    AddFrame(chunk, i);
+  EXPECT_EQ(chunk.Write(stream), 2u);
+}
+
+/////////////////////////////////////////////////
+/// \brief Write and read the header and the index of a log file.
+TEST_F(LogChunk_TEST, HeaderIndex)
+{
+  std::ostringstream stream;
+  util::LogChunk::WriteHeader(stream, "1.0", "9.0.0", 1234);
+
+  std::string data = stream.str();
+  ASSERT_TRUE(util::LogChunk::IsBinaryLog(data.data(), data.size()));
+  EXPECT_FALSE(util::LogChunk::IsBinaryLog("<?xml version", 13));
+
+  // No index yet
+  std::vector<util::LogChunk::Summary> index;
+  EXPECT_FALSE(util::LogChunk::ReadIndex(data.data(), data.size(), index));
+
+  const char *record = data.data() + util::LogChunk::MagicSize();
+  util::LogChunk::RecordType type;
+  uint64_t payloadSize;
+  ASSERT_TRUE(util::LogChunk::ReadRecord(record,
+        data.size() - util::LogChunk::MagicSize(), type, payloadSize));
+  EXPECT_EQ(type, util::LogChunk::HEADER);
+
+  std::string logVersion, gazeboVersion;
+  uint32_t seed = 0;
+  EXPECT_TRUE(util::LogChunk::ReadHeader(
+        record + util::LogChunk::kRecordHeaderSize, payloadSize, logVersion,
+        gazeboVersion, seed));
+  EXPECT_EQ(logVersion, "1.0");
+  EXPECT_EQ(gazeboVersion, "9.0.0");
+  EXPECT_EQ(seed, 1234u);
+
+  util::LogChunk::Summary summary;
+  summary.offset = data.size();
+  summary.size = 42;
+  summary.frameCount = 3;
+  summary.firstIterations = 10;
+  summary.lastIterations = 12;
+  summary.startTime = common::Time(1, 0);
+  summary.endTime = common::Time(1, 2000000);
+  index.push_back(summary);
+
+  util::LogChunk::WriteIndex(stream, data.size(), index);
+  data = stream.str();
+
+  std::vector<util::LogChunk::Summary> readIndex;
+  ASSERT_TRUE(util::LogChunk::ReadIndex(data.data(), data.size(),
+        readIndex));
+  ASSERT_EQ(readIndex.size(), 1u);
+  EXPECT_EQ(readIndex[0].offset, summary.offset);
+  EXPECT_EQ(readIndex[0].size, 42u);
+  EXPECT_EQ(readIndex[0].frameCount, 3u);
+  EXPECT_EQ(readIndex[0].lastIterations, 12u);
+  EXPECT_EQ(readIndex[0].endTime, summary.endTime);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
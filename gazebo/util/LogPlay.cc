@@ -28,6 +28,8 @@
 #endif
 
 #include <algorithm>
+#include <fstream>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/iostreams/filter/bzip2.hpp>
@@ -77,6 +79,30 @@ void LogPlay::Open(const std::string &_logFile)
   if (boost::filesystem::is_directory(path))
     gzthrow("Invalid logfile [" + _logFile + "]. This is a directory.");
 
+  // Forget a previously opened binary log.
+  this->dataPtr->binary = false;
+  if (this->dataPtr->binaryFile.is_open())
+    this->dataPtr->binaryFile.close();
+  this->dataPtr->binaryIndex.clear();
+  this->dataPtr->binaryFirstFrames.clear();
+  this->dataPtr->binaryFrameCount = 0;
+  this->dataPtr->binaryWorld.clear();
+  this->dataPtr->binaryChunk.Clear();
+  this->dataPtr->binaryChunkIndex = -1;
+
+  // Binary logs are memory mapped instead of parsed.
+  {
+    std::vector<char> magic(LogChunk::MagicSize());
+    std::ifstream inFile(_logFile, std::ios::binary);
+    inFile.read(magic.data(), magic.size());
+    if (inFile.gcount() == static_cast<std::streamsize>(magic.size()) &&
+        LogChunk::IsBinaryLog(magic.data(), magic.size()))
+    {
+      this->OpenBinary(_logFile);
+      return;
+    }
+  }
+
   // Flag use to indicate if a parser failure has occurred
   bool xmlParserFail = this->dataPtr->xmlDoc.LoadFile(_logFile.c_str()) !=
     tinyxml2::XML_SUCCESS;
@@ -172,6 +198,110 @@ void LogPlay::Open(const std::string &_logFile)
   this->dataPtr->end = -1 * this->dataPtr->kEndFrame.size();
 }
 
+/////////////////////////////////////////////////
+void LogPlay::OpenBinary(const std::string &_logFile)
+{
+  this->dataPtr->logStartXml = nullptr;
+  this->dataPtr->logCurrXml = nullptr;
+  this->dataPtr->xmlDoc.Clear();
+
+  try
+  {
+    this->dataPtr->binaryFile.open(_logFile);
+  }
+  catch(std::exception &_e)
+  {
+    gzthrow("Unable to map log file[" + _logFile + "]: " + _e.what());
+  }
+
+  const char *data = this->dataPtr->binaryFile.data();
+  const uint64_t size = this->dataPtr->binaryFile.size();
+  uint64_t pos = LogChunk::MagicSize();
+
+  LogChunk::RecordType type;
+  uint64_t payloadSize;
+
+  // Read the header
+  if (!LogChunk::ReadRecord(data + pos, size - pos, type, payloadSize) ||
+      type != LogChunk::HEADER ||
+      !LogChunk::ReadHeader(data + pos + LogChunk::kRecordHeaderSize,
+        payloadSize, this->dataPtr->logVersion,
+        this->dataPtr->gazeboVersion, this->dataPtr->randSeed))
+  {
+    this->dataPtr->binaryFile.close();
+    gzthrow("Log file has no header");
+  }
+  pos += LogChunk::kRecordHeaderSize + payloadSize;
+
+  if (this->dataPtr->logVersion != GZ_LOG_VERSION)
+  {
+    gzwarn << "Log version[" << this->dataPtr->logVersion << "] in file["
+           << _logFile << "] does not match Gazebo's log version["
+           << GZ_LOG_VERSION << "]\n";
+  }
+
+  // Set the random number seed for simulation
+  ignition::math::Rand::Seed(this->dataPtr->randSeed);
+
+  // The world description is recorded right after the header.
+  if (LogChunk::ReadRecord(data + pos, size - pos, type, payloadSize) &&
+      type == LogChunk::SDF)
+  {
+    this->dataPtr->binaryWorld.assign(
+        data + pos + LogChunk::kRecordHeaderSize, payloadSize);
+  }
+
+  // Use the chunk index at the end of the file. A log whose recording was
+  // interrupted has no index, so rebuild it from the records.
+  if (!LogChunk::ReadIndex(data, size, this->dataPtr->binaryIndex))
+  {
+    gzwarn << "Log file[" << _logFile << "] has no chunk index. "
+           << "Rebuilding the index.\n";
+
+    while (LogChunk::ReadRecord(data + pos, size - pos, type, payloadSize))
+    {
+      const uint64_t recordSize = LogChunk::kRecordHeaderSize + payloadSize;
+      LogChunk::Summary summary;
+      if (type == LogChunk::CHUNK &&
+          LogChunk::ReadSummary(data + pos + LogChunk::kRecordHeaderSize,
+            payloadSize, summary))
+      {
+        summary.offset = pos;
+        summary.size = recordSize;
+        this->dataPtr->binaryIndex.push_back(summary);
+      }
+      pos += recordSize;
+    }
+  }
+
+  for (auto const &summary : this->dataPtr->binaryIndex)
+  {
+    this->dataPtr->binaryFirstFrames.push_back(
+        this->dataPtr->binaryFrameCount);
+    this->dataPtr->binaryFrameCount += summary.frameCount;
+  }
+
+  if (!this->dataPtr->binaryIndex.empty())
+  {
+    this->dataPtr->logStartTime = this->dataPtr->binaryIndex.front().startTime;
+    this->dataPtr->logEndTime = this->dataPtr->binaryIndex.back().endTime;
+    this->dataPtr->initialIterations =
+        this->dataPtr->binaryIndex.front().firstIterations;
+    this->dataPtr->iterationsFound = true;
+  }
+  else
+  {
+    this->dataPtr->logStartTime = this->dataPtr->logEndTime = common::Time();
+    this->dataPtr->initialIterations = 0;
+    this->dataPtr->iterationsFound = false;
+  }
+
+  this->dataPtr->filename = _logFile;
+  this->dataPtr->encoding = "binary";
+  this->dataPtr->binaryFrame = -2;
+  this->dataPtr->binary = true;
+}
+
 /////////////////////////////////////////////////
 std::string LogPlay::Header() const
 {
@@ -378,7 +508,7 @@ bool LogPlay::ReadIterations()
 /////////////////////////////////////////////////
 bool LogPlay::IsOpen() const
 {
-  return this->dataPtr->logStartXml != NULL;
+  return this->dataPtr->logStartXml != NULL || this->dataPtr->binary;
 }
 
 /////////////////////////////////////////////////
@@ -436,6 +566,19 @@ bool LogPlay::Step(std::string &_data)
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
+  if (this->dataPtr->binary)
+  {
+    int64_t next = this->dataPtr->binaryFrame + 1;
+    if (next == -1 && this->dataPtr->binaryWorld.empty())
+      next = 0;
+
+    if (!this->dataPtr->BinaryFrame(next, _data))
+      return false;
+
+    this->dataPtr->binaryFrame = next;
+    return true;
+  }
+
   auto from = this->dataPtr->currentChunk.find(this->dataPtr->kStartFrame,
       this->dataPtr->end + this->dataPtr->kEndFrame.size());
   auto to = this->dataPtr->currentChunk.find(this->dataPtr->kEndFrame,
@@ -497,6 +640,17 @@ bool LogPlay::StepBack(std::string &_data)
 
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
+  if (this->dataPtr->binary)
+  {
+    // The world description can't be reached by stepping back.
+    const int64_t prev = this->dataPtr->binaryFrame - 1;
+    if (prev < 0 || !this->dataPtr->BinaryFrame(prev, _data))
+      return false;
+
+    this->dataPtr->binaryFrame = prev;
+    return true;
+  }
+
   if (this->dataPtr->start > 0)
   {
     from = this->dataPtr->currentChunk.rfind(
@@ -535,6 +689,13 @@ bool LogPlay::Rewind()
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
+  if (this->dataPtr->binary)
+  {
+    // Skip the world description.
+    this->dataPtr->binaryFrame = -1;
+    return true;
+  }
+
   this->dataPtr->currentChunk.clear();
   this->dataPtr->logCurrXml =
     this->dataPtr->logStartXml->FirstChildElement("chunk");
@@ -575,6 +736,12 @@ bool LogPlay::Forward()
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
+  if (this->dataPtr->binary)
+  {
+    this->dataPtr->binaryFrame = this->dataPtr->binaryFrameCount;
+    return true;
+  }
+
   // Get the last chunk.
   this->dataPtr->logCurrXml =
     this->dataPtr->logStartXml->LastChildElement("chunk");
@@ -600,6 +767,31 @@ bool LogPlay::Forward()
 /////////////////////////////////////////////////
 bool LogPlay::Seek(const common::Time &_time)
 {
+  if (this->dataPtr->binary)
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+    if (_time >= this->dataPtr->logEndTime)
+    {
+      // Same as Forward() followed by two steps back.
+      this->dataPtr->binaryFrame =
+          std::max<int64_t>(this->dataPtr->binaryFrameCount - 2, -1);
+      return true;
+    }
+
+    // The next step returns the first frame at or after the target time.
+    this->dataPtr->binaryFrame = this->dataPtr->FindBinaryFrame(
+        [&_time](const LogChunk::Summary &_summary)
+        {
+          return _summary.endTime < _time;
+        },
+        [this, &_time](const unsigned int _f)
+        {
+          return this->dataPtr->binaryChunk.SimTime(_f) < _time;
+        }) - 1;
+    return true;
+  }
+
   if (_time >= this->dataPtr->logEndTime)
   {
     this->Forward();
@@ -687,9 +879,87 @@ bool LogPlay::Seek(const common::Time &_time)
   return true;
 }
 
+/////////////////////////////////////////////////
+bool LogPlay::SeekIterations(const uint64_t _iterations)
+{
+  if (this->dataPtr->binary)
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+    this->dataPtr->binaryFrame = this->dataPtr->FindBinaryFrame(
+        [_iterations](const LogChunk::Summary &_summary)
+        {
+          return _summary.lastIterations < _iterations;
+        },
+        [this, _iterations](const unsigned int _f)
+        {
+          return this->dataPtr->binaryChunk.Iterations(_f) < _iterations;
+        }) - 1;
+    return true;
+  }
+
+  // Other encodings don't have an index, so step through the frames.
+  const std::string kStartDelim = "<iterations>";
+  const std::string kEndDelim = "</iterations>";
+
+  if (!this->Rewind())
+    return false;
+
+  std::string frame;
+  while (this->Step(frame))
+  {
+    auto from = frame.find(kStartDelim);
+    auto to = frame.find(kEndDelim, from + kStartDelim.size());
+    if (from == std::string::npos || to == std::string::npos)
+      continue;
+
+    uint64_t iterations = 0;
+    std::stringstream ss(frame.substr(from + kStartDelim.size(),
+          to - from - kStartDelim.size()));
+    ss >> iterations;
+
+    if (iterations >= _iterations)
+    {
+      // Make the next step return this frame.
+      this->StepBack(frame);
+      return true;
+    }
+  }
+
+  return true;
+}
+
 /////////////////////////////////////////////////
 bool LogPlay::Chunk(unsigned int _index, std::string &_data) const
 {
+  if (this->dataPtr->binary)
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+    // The world description is the first chunk, like in other encodings.
+    if (!this->dataPtr->binaryWorld.empty())
+    {
+      if (_index == 0)
+      {
+        _data = this->dataPtr->binaryWorld;
+        return true;
+      }
+      --_index;
+    }
+
+    if (!this->dataPtr->LoadBinaryChunk(_index))
+      return false;
+
+    _data.clear();
+    std::string frame;
+    for (unsigned int i = 0; i < this->dataPtr->binaryChunk.FrameCount(); ++i)
+    {
+      this->dataPtr->binaryChunk.FrameSDF(i, frame);
+      _data += frame;
+    }
+    return true;
+  }
+
   unsigned int count = 0;
   this->dataPtr->logCurrXml =
     this->dataPtr->logStartXml->FirstChildElement("chunk");
@@ -778,6 +1048,82 @@ bool LogPlayPrivate::ChunkData(
   return true;
 }
 
+/////////////////////////////////////////////////
+bool LogPlayPrivate::LoadBinaryChunk(const size_t _index)
+{
+  if (_index >= this->binaryIndex.size())
+    return false;
+
+  if (this->binaryChunkIndex == static_cast<int64_t>(_index))
+    return true;
+
+  const LogChunk::Summary &summary = this->binaryIndex[_index];
+  if (!this->binaryChunk.Load(this->binaryFile.data() + summary.offset +
+        LogChunk::kRecordHeaderSize,
+        summary.size - LogChunk::kRecordHeaderSize))
+  {
+    gzerr << "Invalid chunk[" << _index << "] in log file["
+          << this->filename << "]\n";
+    this->binaryChunkIndex = -1;
+    return false;
+  }
+
+  this->binaryChunkIndex = _index;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LogPlayPrivate::BinaryFrame(const int64_t _frame, std::string &_data)
+{
+  if (_frame == -1)
+  {
+    _data = this->binaryWorld;
+    return !_data.empty();
+  }
+
+  if (_frame < 0 || _frame >= this->binaryFrameCount)
+    return false;
+
+  // Find the chunk that holds the frame.
+  auto iter = std::upper_bound(this->binaryFirstFrames.begin(),
+      this->binaryFirstFrames.end(), _frame);
+  const size_t index = (iter - this->binaryFirstFrames.begin()) - 1;
+
+  return this->LoadBinaryChunk(index) &&
+      this->binaryChunk.FrameSDF(_frame - this->binaryFirstFrames[index],
+          _data);
+}
+
+/////////////////////////////////////////////////
+int64_t LogPlayPrivate::FindBinaryFrame(
+    const std::function<bool (const LogChunk::Summary &)> &_chunkBefore,
+    const std::function<bool (const unsigned int)> &_frameBefore)
+{
+  // Find the first chunk that ends at or after the target.
+  auto chunkIter = std::partition_point(this->binaryIndex.begin(),
+      this->binaryIndex.end(), _chunkBefore);
+  if (chunkIter == this->binaryIndex.end())
+    return this->binaryFrameCount;
+
+  const size_t index = chunkIter - this->binaryIndex.begin();
+  if (!this->LoadBinaryChunk(index))
+    return this->binaryFrameCount;
+
+  // Then the first frame of that chunk at or after the target.
+  unsigned int low = 0;
+  unsigned int high = this->binaryChunk.FrameCount();
+  while (low < high)
+  {
+    unsigned int mid = low + (high - low) / 2;
+    if (_frameBefore(mid))
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  return this->binaryFirstFrames[index] + low;
+}
+
 /////////////////////////////////////////////////
 std::string LogPlay::Encoding() const
 {
@@ -787,6 +1133,12 @@ std::string LogPlay::Encoding() const
 /////////////////////////////////////////////////
 unsigned int LogPlay::ChunkCount() const
 {
+  if (this->dataPtr->binary)
+  {
+    return this->dataPtr->binaryIndex.size() +
+        (this->dataPtr->binaryWorld.empty() ? 0 : 1);
+  }
+
   unsigned int count = 0;
   auto xml = this->dataPtr->logStartXml->FirstChildElement("chunk");
 
@@ -118,6 +118,14 @@ namespace gazebo
       /// \return True if operation succeed or false otherwise.
       public: bool Seek(const common::Time &_time);
 
+      /// \brief Jump to the first sample whose simulation iterations are
+      /// greater than or equal to the value specified as a parameter. The
+      /// next Step() call will return that sample. Logs with the binary
+      /// encoding are searched through their chunk index.
+      /// \param[in] _iterations Target simulation iterations.
+      /// \return True if operation succeed or false otherwise.
+      public: bool SeekIterations(const uint64_t _iterations);
+
       /// \brief Jump to the beginning of the log file. The next step() call
       /// will return the first data "chunk".
       /// \return True If the function succeed or false otherwise.
@@ -161,6 +169,11 @@ namespace gazebo
       /// \brief Read the header from the log file.
       private: void ReadHeader();
 
+      /// \brief Open a log file that uses the binary encoding.
+      /// \param[in] _logFile The file to load.
+      /// \throws Exception When the log file is not valid.
+      private: void OpenBinary(const std::string &_logFile);
+
       /// \brief Update the internal variables that keep track of the times
       /// where the log started and finished (simulation time).
       private: void ReadLogTimes();
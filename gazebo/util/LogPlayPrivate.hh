@@ -25,10 +25,15 @@
 #include <tinyxml2.h>
 #endif
 
+#include <functional>
 #include <mutex>
 #include <string>
+#include <vector>
+
+#include <boost/iostreams/device/mapped_file.hpp>
 
 #include "gazebo/common/Time.hh"
+#include "gazebo/util/LogChunk.hh"
 #include "gazebo/util/system.hh"
 
 namespace gazebo
@@ -47,6 +52,32 @@ namespace gazebo
                   tinyxml2::XMLElement *_xml,
                   std::string &_data);
 
+      /// \brief Decode a chunk of a binary log into binaryChunk, unless it
+      /// is already decoded.
+      /// \param[in] _index Index of the chunk in binaryIndex.
+      /// \return True if the chunk is valid.
+      public: bool LoadBinaryChunk(const size_t _index);
+
+      /// \brief Get a frame of a binary log.
+      /// \param[in] _frame Index of the frame, -1 for the world description.
+      /// \param[out] _data The frame, as SDF.
+      /// \return True if the frame exists.
+      public: bool BinaryFrame(const int64_t _frame, std::string &_data);
+
+      /// \brief Find the first frame of a binary log that is not before a
+      /// target, using the chunk index and then the frames of one chunk.
+      /// \param[in] _chunkBefore Returns true if all the frames of a chunk
+      /// are before the target.
+      /// \param[in] _frameBefore Returns true if a frame of binaryChunk is
+      /// before the target.
+      /// \return Index of the frame, or binaryFrameCount if all the frames
+      /// are before the target.
+      public: int64_t FindBinaryFrame(
+                  const std::function<bool (const LogChunk::Summary &)>
+                  &_chunkBefore,
+                  const std::function<bool (const unsigned int)>
+                  &_frameBefore);
+
       /// \brief Max number of chunks to inspect when looking for XML elements.
       public: const unsigned int kNumChunksToTry = 2u;
 
@@ -111,6 +142,34 @@ namespace gazebo
       /// may not include this tag in the log files.
       public: bool iterationsFound = false;
 
+      /// \brief True if the open log file uses the binary encoding.
+      public: bool binary = false;
+
+      /// \brief Memory mapping of a binary log file.
+      public: boost::iostreams::mapped_file_source binaryFile;
+
+      /// \brief Summary of each chunk of a binary log file.
+      public: std::vector<LogChunk::Summary> binaryIndex;
+
+      /// \brief Index of the first frame of each chunk of a binary log.
+      public: std::vector<int64_t> binaryFirstFrames;
+
+      /// \brief Number of frames in a binary log.
+      public: int64_t binaryFrameCount = 0;
+
+      /// \brief World description stored at the start of a binary log.
+      public: std::string binaryWorld;
+
+      /// \brief Index of the last frame returned from a binary log. -1 is
+      /// the world description, and -2 is before it.
+      public: int64_t binaryFrame = -2;
+
+      /// \brief The decoded chunk of a binary log.
+      public: LogChunk binaryChunk;
+
+      /// \brief Index of the decoded chunk, -1 for none.
+      public: int64_t binaryChunkIndex = -1;
+
       /// \brief A mutex to avoid race conditions.
       public: std::mutex mutex;
     };
@@ -175,9 +175,12 @@ bool LogRecord::Start(const std::string &_encoding, const std::string &_path)
   if (!boost::filesystem::exists(this->dataPtr->logCompletePath))
     boost::filesystem::create_directories(this->dataPtr->logCompletePath);
 
-  if (_encoding != "bz2" && _encoding != "txt" && _encoding != "zlib")
+  if (_encoding != "bz2" && _encoding != "txt" && _encoding != "zlib" &&
+      _encoding != "binary")
+  {
     gzthrow("Invalid log encoding[" + _encoding +
-            "]. Must be one of [bz2, zlib, txt]");
+            "]. Must be one of [bz2, zlib, txt, binary]");
+  }
 
   this->dataPtr->encoding = _encoding;
 
@@ -233,6 +236,40 @@ const std::string &LogRecord::Encoding() const
   return this->dataPtr->encoding;
 }
 
+//////////////////////////////////////////////////
+bool LogRecord::SetQueuePolicy(const std::string &_policy,
+    const unsigned int _size)
+{
+  if (_policy != "block" && _policy != "drop" && _policy != "decimate")
+  {
+    gzerr << "Invalid log queue policy[" << _policy
+          << "]. Must be one of [block, drop, decimate]\n";
+    return false;
+  }
+
+  if (_size == 0)
+  {
+    gzerr << "Log queue size must be greater than zero\n";
+    return false;
+  }
+
+  this->dataPtr->queuePolicy = _policy;
+  this->dataPtr->queueSize = _size;
+  return true;
+}
+
+//////////////////////////////////////////////////
+const std::string &LogRecord::QueuePolicy() const
+{
+  return this->dataPtr->queuePolicy;
+}
+
+//////////////////////////////////////////////////
+unsigned int LogRecord::QueueSize() const
+{
+  return this->dataPtr->queueSize;
+}
+
 //////////////////////////////////////////////////
 void LogRecord::Fini()
 {
@@ -595,7 +632,11 @@ unsigned int LogRecordPrivate::Log::Update()
   if (this->logCB(stream))
   {
     std::string data = stream.str();
-    if (!data.empty())
+    if (!data.empty() && this->parent->Encoding() == "binary")
+    {
+      this->AppendRecords(data);
+    }
+    else if (!data.empty())
     {
       const std::string &encodingLocal = this->parent->Encoding();
 
@@ -648,6 +689,45 @@ unsigned int LogRecordPrivate::Log::Update()
   return this->buffer.size();
 }
 
+//////////////////////////////////////////////////
+void LogRecordPrivate::Log::AppendRecords(const std::string &_data)
+{
+  // Walk the records to add each chunk to the index. Only the record
+  // headers and chunk summaries are read.
+  uint64_t pos = 0;
+  while (pos < _data.size())
+  {
+    LogChunk::RecordType type;
+    uint64_t payloadSize;
+    if (!LogChunk::ReadRecord(_data.data() + pos, _data.size() - pos, type,
+          payloadSize))
+    {
+      gzerr << "Invalid binary log record for log file["
+            << this->relativeFilename << "]\n";
+      break;
+    }
+
+    const uint64_t recordSize = LogChunk::kRecordHeaderSize + payloadSize;
+    if (type == LogChunk::CHUNK)
+    {
+      LogChunk::Summary summary;
+      if (LogChunk::ReadSummary(
+            _data.data() + pos + LogChunk::kRecordHeaderSize, payloadSize,
+            summary))
+      {
+        summary.offset = this->offset + pos;
+        summary.size = recordSize;
+        this->index.push_back(summary);
+      }
+    }
+
+    pos += recordSize;
+  }
+
+  this->buffer.append(_data, 0, pos);
+  this->offset += pos;
+}
+
 //////////////////////////////////////////////////
 void LogRecordPrivate::Log::ClearBuffer()
 {
@@ -680,8 +760,17 @@ void LogRecordPrivate::Log::Stop()
     this->Update();
     this->Write();
 
-    std::string xmlEnd = "</gazebo_log>";
-    this->logFile.write(xmlEnd.c_str(), xmlEnd.size());
+    if (this->parent->Encoding() == "binary")
+    {
+      // Finish with the chunk index, so that the log can be searched
+      // without reading it.
+      LogChunk::WriteIndex(this->logFile, this->offset, this->index);
+    }
+    else
+    {
+      std::string xmlEnd = "</gazebo_log>";
+      this->logFile.write(xmlEnd.c_str(), xmlEnd.size());
+    }
 
     this->logFile.close();
   }
@@ -701,15 +790,27 @@ void LogRecordPrivate::Log::Start(const boost::filesystem::path &_path)
           << " The log file will be overwritten.\n";
 
   std::ostringstream stream;
-  stream << "<?xml version='1.0'?>\n"
-         << "<gazebo_log>\n"
-         << "<header>\n"
-         << "<log_version>" << GZ_LOG_VERSION << "</log_version>\n"
-         << "<gazebo_version>" << GAZEBO_VERSION_FULL << "</gazebo_version>\n"
-         << "<rand_seed>" << ignition::math::Rand::Seed() << "</rand_seed>\n"
-         << "</header>\n";
+  if (this->parent->Encoding() == "binary")
+  {
+    LogChunk::WriteHeader(stream, GZ_LOG_VERSION, GAZEBO_VERSION_FULL,
+        ignition::math::Rand::Seed());
+  }
+  else
+  {
+    stream << "<?xml version='1.0'?>\n"
+           << "<gazebo_log>\n"
+           << "<header>\n"
+           << "<log_version>" << GZ_LOG_VERSION << "</log_version>\n"
+           << "<gazebo_version>" << GAZEBO_VERSION_FULL
+           << "</gazebo_version>\n"
+           << "<rand_seed>" << ignition::math::Rand::Seed()
+           << "</rand_seed>\n"
+           << "</header>\n";
+  }
 
   this->buffer.append(stream.str());
+  this->offset = this->buffer.size();
+  this->index.clear();
 }
 
 //////////////////////////////////////////////////
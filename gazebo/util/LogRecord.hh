@@ -121,14 +121,17 @@ namespace gazebo
       public: bool Running() const;
 
       /// \brief Start the logger.
-      /// \param[in] _encoding The type of encoding (txt, zlib, or bz2).
+      /// \param[in] _encoding The type of encoding (txt, zlib, bz2, or
+      /// binary). The binary encoding stores world states by column, with
+      /// an index of chunks, see LogChunk.
       /// \param[in] _path Path in which to store log files.
       public: bool Start(const std::string &_encoding="zlib",
                          const std::string &_path="");
 
       /// \brief Get the encoding used.
-      /// \return Either [txt, zlib, or bz2], where txt is plain txt and bz2
-      /// and zlib are compressed data with Base64 encoding.
+      /// \return Either [txt, zlib, bz2, or binary], where txt is plain txt,
+      /// bz2 and zlib are compressed data with Base64 encoding, and binary is
+      /// the columnar format of LogChunk.
       public: const std::string &Encoding() const;
 
       /// \brief Get the filename for a log object.
@@ -149,6 +152,33 @@ namespace gazebo
       /// \return Path for log recording.
       public: std::string BasePath() const;
 
+      /// \brief Set what a world does when its log worker falls behind.
+      /// Each world hands its states to the log worker through a bounded
+      /// queue, and the policy applies when that queue is full:
+      ///   - "block": wait for the log worker, so no state is lost.
+      ///   - "drop": skip the state, and count it.
+      ///   - "decimate": skip the state, and then only queue every Nth
+      ///     state. N doubles each time the queue is full, and goes back
+      ///     to one once the log worker catches up.
+      ///
+      /// The queue is sized when recording starts.
+      /// \param[in] _policy One of [block, drop, decimate].
+      /// \param[in] _size Number of states the queue can hold.
+      /// \return False if the policy or the size is invalid.
+      /// \sa physics::World::DroppedLogStates
+      public: bool SetQueuePolicy(const std::string &_policy,
+                  const unsigned int _size = 256);
+
+      /// \brief Get the policy applied when a log queue is full.
+      /// \return One of [block, drop, decimate].
+      /// \sa SetQueuePolicy
+      public: const std::string &QueuePolicy() const;
+
+      /// \brief Get the number of states a log queue can hold.
+      /// \return Size of the queue.
+      /// \sa SetQueuePolicy
+      public: unsigned int QueueSize() const;
+
       /// \brief Get the run time in sim time.
       /// \return Run sim time.
       public: common::Time RunTime() const;
@@ -22,8 +22,11 @@
 #include <thread>
 #include <functional>
 #include <condition_variable>
+#include <vector>
 #include <boost/filesystem.hpp>
 
+#include "gazebo/util/LogChunk.hh"
+
 namespace gazebo
 {
   namespace util
@@ -66,6 +69,11 @@ namespace gazebo
         /// \return The size of the data buffer.
         public: unsigned int Update();
 
+        /// \brief Add binary log records to the data buffer, and index the
+        /// chunk records.
+        /// \param[in] _data Log records from the log callback.
+        public: void AppendRecords(const std::string &_data);
+
         /// \brief Clear the data buffer.
         public: void ClearBuffer();
 
@@ -99,6 +107,13 @@ namespace gazebo
 
         /// \brief Complete file path.
         public: boost::filesystem::path completePath;
+
+        /// \brief Number of bytes added to the log since it was started,
+        /// which is the file offset of the next byte in the buffer.
+        public: uint64_t offset = 0;
+
+        /// \brief Summary of each chunk in a binary log.
+        public: std::vector<LogChunk::Summary> index;
       };
 
       /// \def Log_M
@@ -161,9 +176,17 @@ namespace gazebo
       /// logBasePath.
       public: std::string logSubDir;
 
-      /// \brief Encoding format for each chunk.
+      /// \brief Encoding format for each chunk, or "binary" for the
+      /// binary log format.
       public: std::string encoding;
 
+      /// \brief Policy applied when a log queue is full: block, drop or
+      /// decimate.
+      public: std::string queuePolicy = "block";
+
+      /// \brief Number of states a log queue can hold.
+      public: unsigned int queueSize = 256;
+
       /// \brief True if initialized.
       public: bool initialized;
 
@@ -58,6 +58,30 @@ TEST_F(LogRecord_TEST, Constructor)
   EXPECT_FALSE(recorder->Init(""));
 }
 
+/////////////////////////////////////////////////
+/// \brief Test LogRecord queue policy
+TEST_F(LogRecord_TEST, QueuePolicy)
+{
+  gazebo::util::LogRecord *recorder = gazebo::util::LogRecord::Instance();
+
+  EXPECT_EQ(recorder->QueuePolicy(), "block");
+  EXPECT_EQ(recorder->QueueSize(), 256u);
+
+  EXPECT_TRUE(recorder->SetQueuePolicy("drop", 16));
+  EXPECT_EQ(recorder->QueuePolicy(), "drop");
+  EXPECT_EQ(recorder->QueueSize(), 16u);
+
+  // Invalid values leave the policy unchanged
+  EXPECT_FALSE(recorder->SetQueuePolicy("garbage"));
+  EXPECT_FALSE(recorder->SetQueuePolicy("decimate", 0));
+  EXPECT_EQ(recorder->QueuePolicy(), "drop");
+  EXPECT_EQ(recorder->QueueSize(), 16u);
+
+  EXPECT_TRUE(recorder->SetQueuePolicy("block"));
+  EXPECT_EQ(recorder->QueuePolicy(), "block");
+  EXPECT_EQ(recorder->QueueSize(), 256u);
+}
+
 /////////////////////////////////////////////////
 /// \brief Test LogRecord Start errors
 TEST_F(LogRecord_TEST, StartErrors)
@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifdef _WIN32
+  #include <process.h>
+  #define getpid _getpid
+#else
+  #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+#include "gazebo/gazebo_config.h"
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/util/TracerPrivate.hh"
+#include "gazebo/util/Tracer.hh"
+
+using namespace gazebo;
+using namespace util;
+
+/// \brief Number of events kept by each thread. Events are 24 bytes.
+static const std::size_t kTraceBufferCapacity = 1 << 15;
+
+/// \brief Phase of the event that starts a span.
+static const uint64_t kPhaseBegin = 'B';
+
+/// \brief Phase of the event that ends a span.
+static const uint64_t kPhaseEnd = 'E';
+
+/// \brief Phase of a span recorded as a whole, used for laps.
+static const uint64_t kPhaseComplete = 'X';
+
+/// \brief Copy of an event, made by exports.
+struct TraceRecord
+{
+  /// \brief Nanoseconds since the tracer epoch.
+  uint64_t time;
+
+  /// \brief Duration in nanoseconds.
+  uint64_t duration;
+
+  /// \brief Name id and phase.
+  uint64_t info;
+};
+
+//////////////////////////////////////////////////
+/// \brief Write a time in nanoseconds as microseconds, the unit of the
+/// Chrome trace format.
+/// \param[out] _out Stream to write to.
+/// \param[in] _ns Nanoseconds.
+static void writeMicroseconds(std::ostream &_out, const uint64_t _ns)
+{
+  const char fill = _out.fill('0');
+  _out << _ns / 1000 << '.' << std::setw(3) << _ns % 1000;
+  _out.fill(fill);
+}
+
+//////////////////////////////////////////////////
+/// \brief Write a string as a JSON string.
+/// \param[out] _out Stream to write to.
+/// \param[in] _str String to write.
+static void writeJsonString(std::ostream &_out, const std::string &_str)
+{
+  _out << '"';
+  for (const char c : _str)
+  {
+    if (c == '"' || c == '\\')
+    {
+      _out << '\\' << c;
+    }
+    else if (static_cast<unsigned char>(c) < 0x20)
+    {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      _out << escaped;
+    }
+    else
+    {
+      _out << c;
+    }
+  }
+  _out << '"';
+}
+
+//////////////////////////////////////////////////
+TraceBuffer *TracerPrivate::Buffer()
+{
+  static thread_local TraceBuffer *buffer = nullptr;
+  if (!buffer)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->buffers.emplace_back(new TraceBuffer(kTraceBufferCapacity,
+          static_cast<uint32_t>(this->buffers.size() + 1)));
+    buffer = this->buffers.back().get();
+  }
+  return buffer;
+}
+
+//////////////////////////////////////////////////
+Tracer::Tracer()
+: dataPtr(new TracerPrivate)
+{
+  this->dataPtr->epoch = std::chrono::steady_clock::now();
+
+#ifdef ENABLE_DIAGNOSTICS
+  bool enabled = true;
+#else
+  bool enabled = false;
+#endif
+  const char *env = common::getEnv("GAZEBO_TRACE");
+  if (env)
+    enabled = std::string(env) != "0";
+  this->dataPtr->enabled = enabled;
+}
+
+//////////////////////////////////////////////////
+Tracer::~Tracer()
+{
+}
+
+//////////////////////////////////////////////////
+uint32_t Tracer::Intern(const std::string &_name)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto iter = this->dataPtr->ids.find(_name);
+  if (iter != this->dataPtr->ids.end())
+    return iter->second;
+
+  const uint32_t id = static_cast<uint32_t>(this->dataPtr->names.size());
+  this->dataPtr->names.push_back(_name);
+  this->dataPtr->ids[_name] = id;
+  return id;
+}
+
+//////////////////////////////////////////////////
+uint32_t Tracer::Intern(const std::string &_name, const std::string &_prefix)
+{
+  return this->Intern(_name + ":" + _prefix);
+}
+
+//////////////////////////////////////////////////
+std::string Tracer::Name(const uint32_t _id) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (_id < this->dataPtr->names.size())
+    return this->dataPtr->names[_id];
+  return std::string();
+}
+
+//////////////////////////////////////////////////
+void Tracer::Begin(const uint32_t _id)
+{
+  if (!this->dataPtr->enabled.load(std::memory_order_relaxed))
+    return;
+
+  TraceBuffer *buffer = this->dataPtr->Buffer();
+  const uint64_t now = this->dataPtr->Now();
+  if (_id >= buffer->marks.size())
+    buffer->marks.resize(_id + 1, 0);
+  buffer->marks[_id] = now;
+  buffer->Push(now, 0, _id | (kPhaseBegin << 32));
+}
+
+//////////////////////////////////////////////////
+void Tracer::End(const uint32_t _id)
+{
+  if (!this->dataPtr->enabled.load(std::memory_order_relaxed))
+    return;
+
+  this->dataPtr->Buffer()->Push(this->dataPtr->Now(), 0,
+      _id | (kPhaseEnd << 32));
+}
+
+//////////////////////////////////////////////////
+void Tracer::Lap(const uint32_t _id, const uint32_t _lapId)
+{
+  if (!this->dataPtr->enabled.load(std::memory_order_relaxed))
+    return;
+
+  TraceBuffer *buffer = this->dataPtr->Buffer();
+  const uint64_t now = this->dataPtr->Now();
+  if (_id >= buffer->marks.size())
+    buffer->marks.resize(_id + 1, 0);
+
+  // A lap of a span that was not started on this thread is empty.
+  const uint64_t prev = buffer->marks[_id] ? buffer->marks[_id] : now;
+  buffer->marks[_id] = now;
+  buffer->Push(prev, now - prev, _lapId | (kPhaseComplete << 32));
+}
+
+//////////////////////////////////////////////////
+void Tracer::SetEnabled(const bool _enabled)
+{
+  this->dataPtr->enabled = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool Tracer::Enabled() const
+{
+  return this->dataPtr->enabled;
+}
+
+//////////////////////////////////////////////////
+std::size_t Tracer::BufferCapacity() const
+{
+  return kTraceBufferCapacity;
+}
+
+//////////////////////////////////////////////////
+std::size_t Tracer::EventCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  std::size_t count = 0;
+  for (const auto &buffer : this->dataPtr->buffers)
+  {
+    const uint64_t end = buffer->committed.load();
+    const uint64_t start = buffer->start.load();
+    count += static_cast<std::size_t>(
+        std::min<uint64_t>(end - start, kTraceBufferCapacity));
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+void Tracer::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  for (auto &buffer : this->dataPtr->buffers)
+    buffer->start = buffer->committed.load();
+}
+
+//////////////////////////////////////////////////
+void Tracer::WriteChromeTrace(std::ostream &_out) const
+{
+  std::vector<std::string> names;
+  std::vector<std::pair<uint32_t, std::vector<TraceRecord>>> threads;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    names = this->dataPtr->names;
+
+    for (const auto &buffer : this->dataPtr->buffers)
+    {
+      const uint64_t end =
+        buffer->committed.load(std::memory_order_acquire);
+      uint64_t begin = std::max<uint64_t>(buffer->start.load(),
+          end > kTraceBufferCapacity ? end - kTraceBufferCapacity : 0);
+      if (begin >= end)
+        continue;
+
+      std::vector<TraceRecord> records;
+      records.reserve(end - begin);
+      for (uint64_t i = begin; i < end; ++i)
+      {
+        const TraceEvent &event = buffer->events[i & buffer->mask];
+        records.push_back({event.time.load(std::memory_order_relaxed),
+            event.duration.load(std::memory_order_relaxed),
+            event.info.load(std::memory_order_relaxed)});
+      }
+
+      // Drop the events the writer may have overwritten during the copy.
+      std::atomic_thread_fence(std::memory_order_acquire);
+      const uint64_t claimed =
+        buffer->claimed.load(std::memory_order_relaxed);
+      if (claimed > kTraceBufferCapacity &&
+          claimed - kTraceBufferCapacity > begin)
+      {
+        const uint64_t overwritten = std::min<uint64_t>(
+            claimed - kTraceBufferCapacity - begin, records.size());
+        records.erase(records.begin(), records.begin() + overwritten);
+      }
+
+      threads.emplace_back(buffer->threadId, std::move(records));
+    }
+  }
+
+  const int pid = static_cast<int>(getpid());
+  bool first = true;
+  _out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  for (const auto &thread : threads)
+  {
+    for (const auto &record : thread.second)
+    {
+      const uint32_t id = static_cast<uint32_t>(record.info & 0xffffffff);
+      const uint64_t phase = record.info >> 32;
+
+      _out << (first ? "\n" : ",\n") << "{\"name\":";
+      writeJsonString(_out, id < names.size() ? names[id] : std::string());
+      _out << ",\"ph\":\"" << static_cast<char>(phase) << "\",\"ts\":";
+      writeMicroseconds(_out, record.time);
+      if (phase == kPhaseComplete)
+      {
+        _out << ",\"dur\":";
+        writeMicroseconds(_out, record.duration);
+      }
+      _out << ",\"pid\":" << pid << ",\"tid\":" << thread.first << "}";
+      first = false;
+    }
+  }
+  _out << "\n]}\n";
+}
+
+//////////////////////////////////////////////////
+bool Tracer::SaveChromeTrace(const std::string &_path) const
+{
+  std::ofstream out(_path.c_str(), std::ios::out | std::ios::trunc);
+  if (!out.is_open())
+    return false;
+
+  this->WriteChromeTrace(out);
+  return out.good();
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_UTIL_TRACER_HH_
+#define GAZEBO_UTIL_TRACER_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "gazebo/common/SingletonT.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace util
+  {
+    // Forward declare private data class
+    class TracerPrivate;
+
+    /// \addtogroup gazebo_util Utility
+    /// \{
+
+    /// \class Tracer Tracer.hh util/util.hh
+    /// \brief Records timed spans in per thread ring buffers, and exports
+    /// them in the Chrome trace event format, which can be opened with
+    /// chrome://tracing or Perfetto.
+    ///
+    /// Span names are interned once, usually in a static variable at the
+    /// call site, see the DIAG_TIMER macros. Recording a span then only
+    /// reads the clock and writes to a buffer owned by the calling thread,
+    /// without locks nor allocations. Each buffer keeps the last
+    /// BufferCapacity() events of its thread.
+    ///
+    /// Tracing is enabled by default if Gazebo is built with
+    /// ENABLE_DIAGNOSTICS. The GAZEBO_TRACE environment variable, set to 0
+    /// or 1, overrides the default.
+    class GZ_UTIL_VISIBLE Tracer : public SingletonT<Tracer>
+    {
+      /// \brief Constructor
+      private: Tracer();
+
+      /// \brief Destructor
+      private: virtual ~Tracer();
+
+      /// \brief Get the id of a span name, adding the name if needed.
+      /// \param[in] _name Name of the span.
+      /// \return Id of the name.
+      public: uint32_t Intern(const std::string &_name);
+
+      /// \brief Get the id of a lap name, "_name:_prefix".
+      /// \param[in] _name Name of the span the lap belongs to.
+      /// \param[in] _prefix Name of the lap.
+      /// \return Id of the name.
+      public: uint32_t Intern(const std::string &_name,
+                  const std::string &_prefix);
+
+      /// \brief Get the name of an id returned by Intern.
+      /// \param[in] _id Id of the name.
+      /// \return The name, empty if the id is unknown.
+      public: std::string Name(const uint32_t _id) const;
+
+      /// \brief Start a span on the calling thread.
+      /// \param[in] _id Id of the span name.
+      public: void Begin(const uint32_t _id);
+
+      /// \brief End a span started on the calling thread.
+      /// \param[in] _id Id of the span name.
+      public: void End(const uint32_t _id);
+
+      /// \brief Record a lap of a span started on the calling thread: a
+      /// span from the last lap, or the start of the span, to now.
+      /// \param[in] _id Id of the span name.
+      /// \param[in] _lapId Id of the lap name.
+      public: void Lap(const uint32_t _id, const uint32_t _lapId);
+
+      /// \brief Enable or disable recording.
+      /// \param[in] _enabled True to record spans.
+      public: void SetEnabled(const bool _enabled);
+
+      /// \brief Get whether spans are recorded.
+      /// \return True if enabled.
+      public: bool Enabled() const;
+
+      /// \brief Get the number of events each thread keeps.
+      /// \return Capacity of the buffer of a thread.
+      public: std::size_t BufferCapacity() const;
+
+      /// \brief Get the number of events currently kept, in all threads.
+      /// \return Number of events.
+      public: std::size_t EventCount() const;
+
+      /// \brief Drop the recorded events. Interned names are kept.
+      public: void Clear();
+
+      /// \brief Write the recorded events as a Chrome trace JSON object.
+      /// This can be called from any thread while spans are recorded.
+      /// \param[out] _out Stream to write to.
+      public: void WriteChromeTrace(std::ostream &_out) const;
+
+      /// \brief Write the recorded events to a Chrome trace JSON file.
+      /// \param[in] _path Path of the file.
+      /// \return False if the file could not be written.
+      public: bool SaveChromeTrace(const std::string &_path) const;
+
+      // Singleton implementation
+      private: friend class SingletonT<Tracer>;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<TracerPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
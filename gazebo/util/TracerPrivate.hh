@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_UTIL_TRACERPRIVATE_HH_
+#define GAZEBO_UTIL_TRACERPRIVATE_HH_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gazebo
+{
+  namespace util
+  {
+    /// \internal
+    /// \brief A recorded event. The fields are atomic because exports read
+    /// them while the owner thread may overwrite them.
+    class TraceEvent
+    {
+      /// \brief Nanoseconds since the tracer epoch.
+      public: std::atomic<uint64_t> time;
+
+      /// \brief Duration in nanoseconds, for complete events.
+      public: std::atomic<uint64_t> duration;
+
+      /// \brief Name id in the low 32 bits, phase character above.
+      public: std::atomic<uint64_t> info;
+    };
+
+    /// \internal
+    /// \brief Ring of events written by one thread only.
+    ///
+    /// The writer bumps claimed before it writes a slot, and committed
+    /// after. A reader copies the events below committed, then reads
+    /// claimed again to drop the copies the writer may have overwritten
+    /// meanwhile.
+    class TraceBuffer
+    {
+      /// \brief Constructor.
+      /// \param[in] _capacity Number of events, a power of two.
+      /// \param[in] _threadId Id of the thread in exports.
+      public: TraceBuffer(const std::size_t _capacity,
+                  const uint32_t _threadId)
+              : events(new TraceEvent[_capacity]),
+                mask(_capacity - 1),
+                threadId(_threadId)
+              {
+              }
+
+      /// \brief Append an event, only called by the owner thread.
+      /// \param[in] _time Time of the event.
+      /// \param[in] _duration Duration of the event.
+      /// \param[in] _info Name id and phase.
+      public: void Push(const uint64_t _time, const uint64_t _duration,
+                  const uint64_t _info)
+              {
+                const uint64_t index =
+                  this->committed.load(std::memory_order_relaxed);
+                this->claimed.store(index + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+
+                TraceEvent &event = this->events[index & this->mask];
+                event.time.store(_time, std::memory_order_relaxed);
+                event.duration.store(_duration, std::memory_order_relaxed);
+                event.info.store(_info, std::memory_order_relaxed);
+
+                this->committed.store(index + 1, std::memory_order_release);
+              }
+
+      /// \brief Events, indexed by position modulo the capacity.
+      public: std::unique_ptr<TraceEvent[]> events;
+
+      /// \brief Capacity minus one.
+      public: const uint64_t mask;
+
+      /// \brief Id of the thread in exports.
+      public: const uint32_t threadId;
+
+      /// \brief Number of events whose slot the writer started to write.
+      public: std::atomic<uint64_t> claimed{0};
+
+      /// \brief Number of events fully written.
+      public: std::atomic<uint64_t> committed{0};
+
+      /// \brief Position of the first event to export, moved by Clear.
+      public: std::atomic<uint64_t> start{0};
+
+      /// \brief Time of the last start or lap of each span name, only used
+      /// by the owner thread.
+      public: std::vector<uint64_t> marks;
+    };
+
+    /// \internal
+    /// \brief Private data for the Tracer class
+    class TracerPrivate
+    {
+      /// \brief Get the buffer of the calling thread, creating it on the
+      /// first call from the thread.
+      /// \return The buffer.
+      public: TraceBuffer *Buffer();
+
+      /// \brief Get the time since the epoch.
+      /// \return Nanoseconds since the epoch.
+      public: uint64_t Now() const
+              {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - this->epoch).count();
+              }
+
+      /// \brief Time origin of the events.
+      public: std::chrono::steady_clock::time_point epoch;
+
+      /// \brief True if spans are recorded.
+      public: std::atomic<bool> enabled{false};
+
+      /// \brief Protects the names and the list of buffers.
+      public: mutable std::mutex mutex;
+
+      /// \brief Interned names, indexed by id.
+      public: std::vector<std::string> names;
+
+      /// \brief Ids of the interned names.
+      public: std::unordered_map<std::string, uint32_t> ids;
+
+      /// \brief Buffers of all the threads that recorded a span. Buffers
+      /// outlive their threads, so that their events can be exported.
+      public: std::vector<std::unique_ptr<TraceBuffer>> buffers;
+    };
+  }
+}
+#endif
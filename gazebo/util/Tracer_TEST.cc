@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "gazebo/util/Diagnostics.hh"
+#include "gazebo/util/Tracer.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class TracerTest : public gazebo::testing::AutoLogFixture
+{
+  /// \brief Start each test with an empty trace.
+  protected: void SetUp()
+  {
+    gazebo::testing::AutoLogFixture::SetUp();
+    util::Tracer::Instance()->SetEnabled(true);
+    util::Tracer::Instance()->Clear();
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(TracerTest, Intern)
+{
+  util::Tracer *tracer = util::Tracer::Instance();
+
+  const uint32_t id = tracer->Intern("TracerTest::Intern");
+  EXPECT_EQ(id, tracer->Intern("TracerTest::Intern"));
+  EXPECT_EQ("TracerTest::Intern", tracer->Name(id));
+
+  const uint32_t lapId = tracer->Intern("TracerTest::Intern", "lap");
+  EXPECT_NE(id, lapId);
+  EXPECT_EQ(lapId, tracer->Intern("TracerTest::Intern:lap"));
+
+  EXPECT_TRUE(tracer->Name(lapId + 1000).empty());
+}
+
+/////////////////////////////////////////////////
+TEST_F(TracerTest, Macros)
+{
+  util::Tracer *tracer = util::Tracer::Instance();
+
+  for (int i = 0; i < 3; ++i)
+  {
+    DIAG_TIMER_START("TracerTest::Macros");
+    DIAG_TIMER_LAP("TracerTest::Macros", "first");
+    DIAG_TIMER_LAP("TracerTest::Macros", "second");
+    DIAG_TIMER_STOP("TracerTest::Macros");
+  }
+  EXPECT_EQ(12u, tracer->EventCount());
+
+  std::ostringstream stream;
+  tracer->WriteChromeTrace(stream);
+  const std::string json = stream.str();
+  EXPECT_EQ(0u, json.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+  EXPECT_NE(std::string::npos, json.find(
+        "{\"name\":\"TracerTest::Macros\",\"ph\":\"B\""));
+  EXPECT_NE(std::string::npos, json.find(
+        "{\"name\":\"TracerTest::Macros\",\"ph\":\"E\""));
+  EXPECT_NE(std::string::npos, json.find(
+        "{\"name\":\"TracerTest::Macros:second\",\"ph\":\"X\""));
+  EXPECT_NE(std::string::npos, json.find("\"dur\":"));
+
+  tracer->Clear();
+  EXPECT_EQ(0u, tracer->EventCount());
+
+  // Nothing is recorded while disabled.
+  tracer->SetEnabled(false);
+  EXPECT_FALSE(tracer->Enabled());
+  DIAG_TIMER_START("TracerTest::Macros");
+  DIAG_TIMER_STOP("TracerTest::Macros");
+  EXPECT_EQ(0u, tracer->EventCount());
+}
+
+/////////////////////////////////////////////////
+TEST_F(TracerTest, Threads)
+{
+  util::Tracer *tracer = util::Tracer::Instance();
+  const uint32_t id = tracer->Intern("TracerTest::Threads");
+
+  const unsigned int threadCount = 4;
+  const unsigned int spanCount = 1000;
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < threadCount; ++i)
+  {
+    threads.push_back(std::thread([&]()
+    {
+      for (unsigned int j = 0; j < spanCount; ++j)
+      {
+        tracer->Begin(id);
+        tracer->End(id);
+      }
+    }));
+  }
+
+  // Exports can run while threads record spans.
+  std::ostringstream stream;
+  tracer->WriteChromeTrace(stream);
+
+  for (auto &thread : threads)
+    thread.join();
+
+  EXPECT_EQ(threadCount * spanCount * 2, tracer->EventCount());
+}
+
+/////////////////////////////////////////////////
+TEST_F(TracerTest, Overflow)
+{
+  util::Tracer *tracer = util::Tracer::Instance();
+  const uint32_t id = tracer->Intern("TracerTest::Overflow");
+
+  // The oldest events are dropped.
+  for (std::size_t i = 0; i < tracer->BufferCapacity(); ++i)
+  {
+    tracer->Begin(id);
+    tracer->End(id);
+  }
+  EXPECT_EQ(tracer->BufferCapacity(), tracer->EventCount());
+
+  std::ostringstream stream;
+  tracer->WriteChromeTrace(stream);
+  const std::string json = stream.str();
+  std::size_t count = 0;
+  for (std::size_t pos = json.find("\"ph\""); pos != std::string::npos;
+       pos = json.find("\"ph\"", pos + 1))
+  {
+    ++count;
+  }
+  EXPECT_EQ(tracer->BufferCapacity(), count);
+}
+
+/////////////////////////////////////////////////
+TEST_F(TracerTest, Save)
+{
+  util::Tracer *tracer = util::Tracer::Instance();
+
+  DIAG_TIMER_START("TracerTest::Save \"quoted\"");
+  DIAG_TIMER_STOP("TracerTest::Save \"quoted\"");
+
+  std::ostringstream path;
+  path << "/tmp/__gz_tracer_test" << std::this_thread::get_id() << ".json";
+  ASSERT_TRUE(tracer->SaveChromeTrace(path.str()));
+
+  std::ifstream in(path.str());
+  std::stringstream json;
+  json << in.rdbuf();
+  EXPECT_NE(std::string::npos,
+      json.str().find("\"TracerTest::Save \\\"quoted\\\"\""));
+  std::remove(path.str().c_str());
+
+  EXPECT_FALSE(tracer->SaveChromeTrace("/__gz_no_such_dir/trace.json"));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,6 +16,10 @@
 */
 
 #include <unistd.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 #include "gazebo/test/ServerFixture.hh"
 
 using namespace gazebo;
@@ -689,6 +693,310 @@ TEST_F(TransportTest, Latching)
   EXPECT_EQ(g_latchCreatedAfterPub2, 3);
 }
 
+/////////////////////////////////////////////////
+std::mutex g_sharedMsgMutex;
+std::vector<const msgs::GzString *> g_sharedMsgs;
+void ReceiveSharedMsg(ConstGzStringPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_sharedMsgMutex);
+  g_sharedMsgs.push_back(_msg.get());
+}
+
+/////////////////////////////////////////////////
+// Publishing a shared message hands the same instance to local subscribers
+TEST_F(TransportTest, SharedMessagePublish)
+{
+  Load("worlds/empty.world");
+
+  transport::NodePtr node = transport::NodePtr(new transport::Node());
+  node->Init();
+  transport::PublisherPtr pub =
+    node->Advertise<msgs::GzString>("~/test/shared");
+  transport::SubscriberPtr sub =
+    node->Subscribe("~/test/shared", &ReceiveSharedMsg);
+  transport::SubscriberPtr sub2 =
+    node->Subscribe("~/test/shared", &ReceiveSharedMsg);
+
+  boost::shared_ptr<msgs::GzString> msg(new msgs::GzString);
+  msg->set_data("shared");
+  pub->Publish(msg, true);
+
+  // The latest message is kept without a copy
+  EXPECT_EQ(msg.get(), pub->GetPrevMsgPtr().get());
+
+  int i = 0;
+  while (i < 100)
+  {
+    {
+      std::lock_guard<std::mutex> lock(g_sharedMsgMutex);
+      if (g_sharedMsgs.size() >= 2u)
+        break;
+    }
+    common::Time::MSleep(10);
+    ++i;
+  }
+
+  std::lock_guard<std::mutex> lock(g_sharedMsgMutex);
+  ASSERT_EQ(2u, g_sharedMsgs.size());
+  EXPECT_EQ(msg.get(), g_sharedMsgs[0]);
+  EXPECT_EQ(msg.get(), g_sharedMsgs[1]);
+
+  // A null message is rejected
+  pub->Publish(boost::shared_ptr<msgs::GzString>(), true);
+  EXPECT_EQ(msg.get(), pub->GetPrevMsgPtr().get());
+}
+
+/////////////////////////////////////////////////
+std::thread::id g_lowLatencyThread;
+int g_lowLatencyMsgs = 0;
+void ReceiveLowLatencyMsg(ConstGzStringPtr &/*_msg*/)
+{
+  g_lowLatencyThread = std::this_thread::get_id();
+  g_lowLatencyMsgs++;
+}
+
+/////////////////////////////////////////////////
+// Messages of a low latency topic are delivered by the publishing thread
+TEST_F(TransportTest, LowLatency)
+{
+  Load("worlds/empty.world");
+
+  transport::NodePtr node = transport::NodePtr(new transport::Node());
+  node->Init();
+  node->SetLatencyClass<msgs::GzString>("~/test/low_latency",
+      transport::LatencyClass::LOW_LATENCY);
+
+  transport::PublisherPtr pub =
+    node->Advertise<msgs::GzString>("~/test/low_latency");
+  transport::SubscriberPtr sub =
+    node->Subscribe("~/test/low_latency", &ReceiveLowLatencyMsg);
+
+  msgs::GzString msg;
+  msg.set_data("low latency");
+  for (int i = 1; i <= 10; ++i)
+  {
+    pub->Publish(msg);
+    EXPECT_EQ(i, g_lowLatencyMsgs);
+    EXPECT_EQ(std::this_thread::get_id(), g_lowLatencyThread);
+  }
+
+  // Other topics are still delivered by the connection manager
+  g_stringMsg = false;
+  transport::PublisherPtr pub2 =
+    node->Advertise<msgs::GzString>("~/test/normal_latency");
+  transport::SubscriberPtr sub2 =
+    node->Subscribe("~/test/normal_latency", &ReceiveStringMsg);
+  pub2->Publish(msg);
+
+  int i = 0;
+  while (!g_stringMsg && i < 100)
+  {
+    common::Time::MSleep(10);
+    ++i;
+  }
+  EXPECT_TRUE(g_stringMsg);
+}
+
+/////////////////////////////////////////////////
+std::mutex g_batchMutex;
+std::vector<std::string> g_batchMsgs;
+void ReceiveBatchMsg(ConstGzStringPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_batchMutex);
+  g_batchMsgs.push_back(_msg->data());
+}
+
+/////////////////////////////////////////////////
+// Batched topics deliver every message in order, latest only topics
+// deliver at least the last message.
+TEST_F(TransportTest, Batching)
+{
+  Load("worlds/empty.world");
+
+  transport::NodePtr node = transport::NodePtr(new transport::Node());
+  node->Init();
+
+  for (auto mode : {transport::BatchingMode::BATCH,
+                    transport::BatchingMode::LATEST_ONLY})
+  {
+    const std::string topic = mode == transport::BatchingMode::BATCH ?
+      "~/test/batch" : "~/test/latest_only";
+    node->SetBatchingMode<msgs::GzString>(topic, mode);
+
+    transport::PublisherPtr pub = node->Advertise<msgs::GzString>(topic);
+    transport::SubscriberPtr sub = node->Subscribe(topic, &ReceiveBatchMsg);
+
+    {
+      std::lock_guard<std::mutex> lock(g_batchMutex);
+      g_batchMsgs.clear();
+    }
+
+    msgs::GzString msg;
+    for (int i = 0; i < 100; ++i)
+    {
+      msg.set_data(std::to_string(i));
+      pub->Publish(msg);
+    }
+
+    int i = 0;
+    while (i < 100)
+    {
+      {
+        std::lock_guard<std::mutex> lock(g_batchMutex);
+        if (!g_batchMsgs.empty() && g_batchMsgs.back() == "99")
+          break;
+      }
+      common::Time::MSleep(10);
+      ++i;
+    }
+
+    std::lock_guard<std::mutex> lock(g_batchMutex);
+    ASSERT_FALSE(g_batchMsgs.empty());
+    EXPECT_EQ("99", g_batchMsgs.back());
+    if (mode == transport::BatchingMode::BATCH)
+    {
+      ASSERT_EQ(100u, g_batchMsgs.size());
+      for (int j = 0; j < 100; ++j)
+        EXPECT_EQ(std::to_string(j), g_batchMsgs[j]);
+    }
+    else
+      EXPECT_LE(g_batchMsgs.size(), 100u);
+  }
+}
+
+/////////////////////////////////////////////////
+std::mutex g_qosMutex;
+std::vector<std::string> g_qosMsgs;
+void ReceiveQoSMsg(ConstGzStringPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_qosMutex);
+  g_qosMsgs.push_back(_msg->data());
+}
+
+int g_rateMsgs = 0;
+void ReceiveRateMsg(ConstGzStringPtr &/*_msg*/)
+{
+  g_rateMsgs++;
+}
+
+/////////////////////////////////////////////////
+// Subscribers only get the messages allowed by their quality of service
+TEST_F(TransportTest, SubscriberQoS)
+{
+  Load("worlds/empty.world");
+
+  transport::NodePtr node = transport::NodePtr(new transport::Node());
+  node->Init();
+  transport::PublisherPtr pub = node->Advertise<msgs::GzString>("~/test/qos");
+
+  // Keep the last 2 messages
+  transport::SubscribeOptions depthOps;
+  depthOps.SetDepth(2);
+  transport::SubscriberPtr depthSub =
+    node->Subscribe("~/test/qos", &ReceiveQoSMsg, depthOps);
+
+  transport::TopicManager::Instance()->PauseIncoming(true);
+  msgs::GzString msg;
+  for (int i = 0; i < 10; ++i)
+  {
+    msg.set_data(std::to_string(i));
+    pub->Publish(msg, true);
+  }
+  transport::TopicManager::Instance()->PauseIncoming(false);
+
+  int i = 0;
+  while (i < 100)
+  {
+    {
+      std::lock_guard<std::mutex> lock(g_qosMutex);
+      if (g_qosMsgs.size() >= 2u)
+        break;
+    }
+    common::Time::MSleep(10);
+    ++i;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(g_qosMutex);
+    ASSERT_EQ(2u, g_qosMsgs.size());
+    EXPECT_EQ("8", g_qosMsgs[0]);
+    EXPECT_EQ("9", g_qosMsgs[1]);
+  }
+  depthSub.reset();
+
+  // At most 10 Hz
+  transport::SubscribeOptions rateOps;
+  rateOps.SetMaxRate(10);
+  rateOps.SetReliability(transport::Reliability::BEST_EFFORT);
+  EXPECT_DOUBLE_EQ(10.0, rateOps.MaxRate());
+  transport::SubscriberPtr rateSub =
+    node->Subscribe("~/test/qos", &ReceiveRateMsg, rateOps);
+
+  common::Time start = common::Time::GetWallTime();
+  for (i = 0; i < 50; ++i)
+  {
+    pub->Publish(msg);
+    common::Time::MSleep(10);
+  }
+  common::Time::MSleep(200);
+  const double elapsed = (common::Time::GetWallTime() - start).Double();
+
+  EXPECT_GT(g_rateMsgs, 0);
+  EXPECT_LE(g_rateMsgs, static_cast<int>(elapsed * 10) + 1);
+}
+
+/////////////////////////////////////////////////
+std::vector<std::string> g_burstMsgs;
+void ReceiveBurstMsg(ConstGzStringPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_qosMutex);
+  g_burstMsgs.push_back(_msg->data());
+}
+
+/////////////////////////////////////////////////
+// A rate limited subscriber gets the last message of a burst once the
+// period has elapsed
+TEST_F(TransportTest, SubscriberMaxRateLast)
+{
+  Load("worlds/empty.world");
+
+  transport::NodePtr node = transport::NodePtr(new transport::Node());
+  node->Init();
+  transport::PublisherPtr pub =
+    node->Advertise<msgs::GzString>("~/test/qos_burst");
+
+  // A period of 0.5 s, much longer than the burst
+  transport::SubscribeOptions ops;
+  ops.SetMaxRate(2);
+  transport::SubscriberPtr sub =
+    node->Subscribe("~/test/qos_burst", &ReceiveBurstMsg, ops);
+
+  msgs::GzString msg;
+  for (int i = 0; i < 10; ++i)
+  {
+    msg.set_data(std::to_string(i));
+    pub->Publish(msg);
+    common::Time::MSleep(10);
+  }
+
+  // Nothing else is published, the last message is delivered anyway.
+  for (int i = 0; i < 200; ++i)
+  {
+    {
+      std::lock_guard<std::mutex> lock(g_qosMutex);
+      if (!g_burstMsgs.empty() && g_burstMsgs.back() == "9")
+        break;
+    }
+    common::Time::MSleep(10);
+  }
+
+  std::lock_guard<std::mutex> lock(g_qosMutex);
+  ASSERT_FALSE(g_burstMsgs.empty());
+  EXPECT_EQ("0", g_burstMsgs.front());
+  EXPECT_EQ("9", g_burstMsgs.back());
+  EXPECT_EQ(2u, g_burstMsgs.size());
+}
+
 /////////////////////////////////////////////////
 // Test error cases
 // This test must be run after all the others, because it messes up
@@ -831,6 +831,10 @@ void LogCommand::Output(const std::string &_outFilename,
   std::string stateString, bufferString;
 
   std::string encoding = _encoding.empty() ? play->Encoding() : _encoding;
+
+  // Binary logs are written back as XML logs.
+  if (encoding == "binary")
+    encoding = "zlib";
   if (encoding != "txt" && encoding != "zlib" && encoding != "bz2")
   {
     std::cerr << "Invalid log file encoding[" << encoding << "]. "